@@ -39,6 +39,7 @@
 #include "../cfillion/cfillion.hpp" // CF_ShellExecute
 #include "../SnM/SnM_Dlg.h"
 #include "../Prompt.h"
+#include "../SnM/SnM_Util.h" // FNV64, GetFileOrDirInfo
 
 #include <time.h>
 #include <WDL/localize/localize.h>
@@ -78,6 +79,7 @@ string g_tag_genre;
 int g_tag_year = GetCurrentYear();
 string g_tag_comment;
 bool g_doing_render = false;
+map<string, WDL_UINT64> g_region_fingerprints; // output file name (without extension) -> fingerprint of its last render
 
 //Pref globals
 string g_pref_default_render_path;
@@ -417,7 +419,7 @@ void NukeDirFiles( string dir, string ext = "" ){
 	closedir( dp );
 }
 
-void GetRenderedFiles(string dir, vector<RenderRegion> regions, map <string, RenderRegion> &files){
+void GetRenderedFiles(string dir, vector<RenderRegion> &regions, int regionNumberPad, map <string, RenderRegion> &files){
 	DIR *dp;
 	struct dirent *dirp;
 	if ((dp = opendir(dir.c_str())) != NULL){
@@ -429,8 +431,7 @@ void GetRenderedFiles(string dir, vector<RenderRegion> regions, map <string, Ren
 			}
 
 			for (std::vector<RenderRegion>::iterator region = regions.begin(); region != regions.end(); ++region) {
-				string regionFileNamePrefix = region->getFileName("", 0);
-				//TODO make sure filename sanitizing works as expected (REAPER internally handling during region rendering
+				string regionFileNamePrefix = region->getFileName("", regionNumberPad) + ".";
 				if (!fileName.compare(0, regionFileNamePrefix.length(), regionFileNamePrefix)) {
 					string path = string(dir + PATH_SLASH_CHAR + fileName);
 					files.insert(pair <string, RenderRegion>(path, *region));
@@ -540,15 +541,292 @@ void MakeMediaFilesAbsolute( WDL_FastString *prjStr ){
 }
 
 
-void AutorenderRegions(COMMAND_T*)
+// Region fingerprints: hash of everything in the saved project that can change a region's render.
+// Items, automation items and envelope points are only hashed into the regions they overlap
+// (envelope points also hash their neighbours outside the region, as they shape the segments
+// inside it), other render related state (FX, routing, master, tempo map, render settings, etc)
+// is common to all regions. Automation items hash the points of their pooled envelope too, so
+// editing a pool changes the regions that contain one of its instances.
+static bool IsFingerprintIgnoredToken( const char* token ){
+	// view/selection state, saved with the project but not rendered
+	static const char* ignored[] = { "CURSOR", "ZOOM", "VZOOMEX", "SELECTION", "SELECTION2", "SEL", "TRACKHEIGHT", "LANEHEIGHT", "VIS", "ARM", "MARKER", NULL };
+	for( int i = 0; ignored[i]; i++ )
+		if( !strcmp( token, ignored[i] ) )
+			return true;
+	return false;
+}
+
+static bool IsFingerprintProjectChunk( const char* chunk ){
+	return !strcmp( chunk, "<TRACK" ) || hasPrefix( chunk, "<MASTER" ) || hasPrefix( chunk, "<TEMPOENV" ) ||
+		hasPrefix( chunk, "<RENDER_" ) || !strcmp( chunk, "<POOLEDENV" );
+}
+
+static WDL_UINT64 FingerprintLine( WDL_UINT64 h, const char* line ){
+	while( *line == ' ' || *line == '\t' ) line++; // indentation is not content
+	return FNV64( h, (const unsigned char*)line, (int)strlen( line ) + 1 );
+}
+
+static void AddToOverlappingRegions( vector<RenderRegion> &regions, double start, double end, WDL_UINT64 h ){
+	for( unsigned int i = 0; i < regions.size(); i++ ){
+		if( start < regions[i].endPos && end > regions[i].startPos )
+			regions[i].fingerprint = FNV64( regions[i].fingerprint, (const unsigned char*)&h, sizeof(h) );
+	}
+}
+
+struct PooledEnvInstance {
+	int poolId;
+	double start, end;
+	WDL_UINT64 hash; // POOLEDENVINST line
+};
+
+static void AddEnvelopePointsToRegions( vector<RenderRegion> &regions, vector< pair<double, WDL_UINT64> > &points ){
+	for( unsigned int i = 0; i < regions.size(); i++ ){
+		int first = -1, last = -1;
+		for( int j = 0; j < (int)points.size(); j++ ){
+			if( points[j].first < regions[i].startPos ) first = j;
+			else if( points[j].first <= regions[i].endPos ) { if( first < 0 ) first = j; last = j; }
+			else { last = j; break; }
+		}
+		if( first < 0 ) first = last; // all points after the region
+		if( last < 0 ) last = first; // all points before the region
+		for( int j = first; j >= 0 && j <= last; j++ )
+			regions[i].fingerprint = FNV64( regions[i].fingerprint, (const unsigned char*)&points[j].second, sizeof(WDL_UINT64) );
+	}
+	points.clear();
+}
+
+void ComputeRegionFingerprints( WDL_FastString *prjStr, vector<RenderRegion> &regions ){
+	char line[4096];
+	int pos = 0;
+	LineParser lp(false);
+
+	WDL_UINT64 global = FNV64_IV;
+	for( unsigned int i = 0; i < regions.size(); i++ ){
+		regions[i].fingerprint = FNV64_IV;
+		regions[i].fingerprint = FNV64( regions[i].fingerprint, (const unsigned char*)&regions[i].startPos, sizeof(double) );
+		regions[i].fingerprint = FNV64( regions[i].fingerprint, (const unsigned char*)&regions[i].endPos, sizeof(double) );
+	}
+
+	int depth = 0; // 1 = project root
+	int skipDepth = 0; // > 0: inside a chunk ignored for the fingerprint
+	int itemDepth = 0; // > 0: inside an item
+	WDL_UINT64 itemHash = 0;
+	double itemPos = 0.0, itemLen = 0.0;
+	vector< pair<double, WDL_UINT64> > envPoints;
+	int poolDepth = 0, poolId = -1; // poolDepth > 0: inside a pooled envelope (automation item source)
+	WDL_UINT64 poolHash = 0;
+	map<int, WDL_UINT64> pools; // pool id -> hash of its points, pools can come after their instances
+	vector<PooledEnvInstance> poolInstances;
+
+	while( GetChunkLine( prjStr->Get(), line, 4096, &pos, false ) ){
+		if( lp.parse( line ) || !lp.getnumtokens() )
+			continue;
+
+		const char* token = lp.gettoken_str(0);
+		if( token[0] == '<' ){
+			depth++;
+			if( skipDepth || depth == 1 ) continue; // project header has the save timestamp
+			if( depth == 2 && !IsFingerprintProjectChunk( token ) ){
+				skipDepth = depth;
+				continue;
+			}
+			if( depth == 2 && !strcmp( token, "<POOLEDENV" ) ){
+				poolDepth = depth;
+				poolId = -1;
+				poolHash = FNV64_IV;
+				continue;
+			}
+			if( !itemDepth && !strcmp( token, "<ITEM" ) ){
+				itemDepth = depth;
+				itemHash = FNV64_IV;
+				itemPos = itemLen = 0.0;
+				continue;
+			}
+		} else if( token[0] == '>' ){
+			if( skipDepth == depth ) skipDepth = 0;
+			else if( poolDepth == depth ){
+				pools[ poolId ] = poolHash;
+				poolDepth = 0;
+			} else if( itemDepth == depth ){
+				AddToOverlappingRegions( regions, itemPos, itemPos + itemLen, itemHash );
+				itemDepth = 0;
+			} else if( !skipDepth && !itemDepth && envPoints.size() ){
+				AddEnvelopePointsToRegions( regions, envPoints );
+			}
+			depth--;
+			continue;
+		}
+
+		if( skipDepth || depth < 1 || IsFingerprintIgnoredToken( token ) )
+			continue;
+
+		if( poolDepth ){
+			poolHash = FingerprintLine( poolHash, line );
+			if( depth == poolDepth && !strcmp( token, "ID" ) ) poolId = lp.gettoken_int(1);
+		} else if( itemDepth ){
+			itemHash = FingerprintLine( itemHash, line );
+			if( depth == itemDepth && !strcmp( token, "POSITION" ) ) itemPos = lp.gettoken_float(1);
+			else if( depth == itemDepth && !strcmp( token, "LENGTH" ) ) itemLen = lp.gettoken_float(1);
+			else if( !strcmp( token, "FILE" ) ){
+				// re-recorded/edited media files keep their name
+				time_t mtime = 0;
+				WDL_INT64 size = 0;
+				GetFileOrDirInfo( lp.gettoken_str(1), &mtime, &size );
+				itemHash = FNV64( itemHash, (const unsigned char*)&mtime, sizeof(mtime) );
+				itemHash = FNV64( itemHash, (const unsigned char*)&size, sizeof(size) );
+			}
+		} else if( !strcmp( token, "PT" ) && lp.getnumtokens() > 2 ){
+			envPoints.push_back( pair<double, WDL_UINT64>( lp.gettoken_float(1), FingerprintLine( FNV64_IV, line ) ) );
+		} else if( !strcmp( token, "POOLEDENVINST" ) && lp.getnumtokens() > 3 ){
+			PooledEnvInstance instance;
+			instance.poolId = lp.gettoken_int(1);
+			instance.start = lp.gettoken_float(2);
+			instance.end = instance.start + lp.gettoken_float(3);
+			instance.hash = FingerprintLine( FNV64_IV, line );
+			poolInstances.push_back( instance );
+		} else {
+			global = FingerprintLine( global, line );
+		}
+	}
+
+	for( unsigned int i = 0; i < poolInstances.size(); i++ ){
+		WDL_UINT64 h = poolInstances[i].hash;
+		map<int, WDL_UINT64>::iterator pool = pools.find( poolInstances[i].poolId );
+		if( pool != pools.end() )
+			h = FNV64( h, (const unsigned char*)&pool->second, sizeof(WDL_UINT64) );
+		AddToOverlappingRegions( regions, poolInstances[i].start, poolInstances[i].end, h );
+	}
+
+	for( unsigned int i = 0; i < regions.size(); i++ )
+		regions[i].fingerprint = FNV64( regions[i].fingerprint, (const unsigned char*)&global, sizeof(global) );
+}
+
+// In the render copy of the project: remove the regions that are not rendered and name the other
+// ones after their output file, so that names don't depend on the rendered regions
+void SetRenderedRegions( WDL_FastString *prjStr, vector<RenderRegion> &regions, int regionNumberPad ){
+	map<int, string> names;
+	for( unsigned int i = 0; i < regions.size(); i++ )
+		names[ regions[i].markerIndex ] = regions[i].getFileName( "", regionNumberPad );
+
+	WDL_FastString out;
+	char line[4096];
+	int pos = 0;
+	LineParser lp(false);
+	map<int, bool> startDone;
+
+	while( GetChunkLine( prjStr->Get(), line, 4096, &pos, false ) ){
+		if( !lp.parse( line ) && lp.getnumtokens() > 4 && !strcmp( lp.gettoken_str(0), "MARKER" ) && ( lp.gettoken_int(4) & 1 ) ){
+			const int idx = lp.gettoken_int(1);
+			map<int, string>::iterator name = names.find( idx );
+			if( name == names.end() )
+				continue;
+
+			if( !startDone[ idx ] ){
+				// region start line, the end line has the same index and an empty name
+				startDone[ idx ] = true;
+				WDL_FastString escaped;
+				for( int i = 0; i < lp.getnumtokens(); i++ ){
+					if( i ) out.Append( " " );
+					escaped.Set( "" );
+					makeEscapedConfigString( i == 3 ? name->second.c_str() : lp.gettoken_str(i), &escaped );
+					out.Append( escaped.Get() );
+				}
+				out.Append( "\n" );
+				continue;
+			}
+		}
+		out.Append( line );
+		out.Append( "\n" );
+	}
+	prjStr->Set( out.Get() );
+}
+
+#define AUTORENDER_TAG_THREADS 4
+
+struct TagJob {
+	string path;
+	RenderRegion region;
+	bool success;
+};
+
+struct TagPool {
+	vector<TagJob>* jobs;
+	SWS_Mutex mutex;
+	unsigned int nextJob;
+};
+
+static bool TagRenderedFile( const string &path, RenderRegion &renderRegion ){
+	TagLib::FileRef f( win32::widen(path).c_str() );
+
+	if( f.isNull() )
+		return false;
+
+	if( !g_tag_artist.empty() )
+	  f.tag()->setArtist( {g_tag_artist, TagLib::String::UTF8} );
+	if( !g_tag_album.empty() )
+	  f.tag()->setAlbum( {g_tag_album, TagLib::String::UTF8} );
+	if( !g_tag_genre.empty() )
+	  f.tag()->setGenre( {g_tag_genre, TagLib::String::UTF8} );
+	if( !g_tag_comment.empty() )
+	  f.tag()->setComment( {g_tag_comment, TagLib::String::UTF8} );
+	f.tag()->setTitle( {renderRegion.regionName, TagLib::String::UTF8} );
+
+	if( g_tag_year > 0 ) f.tag()->setYear( g_tag_year );
+
+	f.tag()->setTrack( renderRegion.regionNumber );
+	return f.save();
+}
+
+static unsigned WINAPI TagFilesThread( void* pPool ){
+	TagPool* pool = (TagPool*)pPool;
+	for(;;){
+		TagJob* job = NULL;
+		{
+			SWS_SectionLock lock( &pool->mutex );
+			if( pool->nextJob < pool->jobs->size() )
+				job = &(*pool->jobs)[ pool->nextJob++ ];
+		}
+		if( !job )
+			break;
+		job->success = TagRenderedFile( job->path, job->region );
+	}
+	return 0;
+}
+
+// each file is tagged by a single thread, TagLib objects are never shared
+void TagRenderedFiles( vector<TagJob> &jobs ){
+	TagPool pool;
+	pool.jobs = &jobs;
+	pool.nextJob = 0;
+
+	const int nThreads = (int)min( (size_t)AUTORENDER_TAG_THREADS, jobs.size() );
+	HANDLE threads[AUTORENDER_TAG_THREADS];
+	for( int i = 0; i < nThreads; i++ ){
+		threads[i] = (HANDLE)_beginthreadex( NULL, 0, TagFilesThread, &pool, 0, NULL );
+		if( !threads[i] )
+			TagFilesThread( &pool ); // couldn't start a thread, tag its share here
+	}
+	for( int i = 0; i < nThreads; i++ ){
+		if( threads[i] ){
+			WaitForSingleObject( threads[i], INFINITE );
+			CloseHandle( threads[i] );
+		}
+	}
+}
+
+// ct->user: 0 = render all regions, 1 = only render regions that changed since last render
+void AutorenderRegions(COMMAND_T* ct)
 {
+	const bool changedOnly = ct && ct->user == 1;
+
+	bool saveAllowed = false; // the project is only saved if the user agreed to
   if (IsProjectDirty && IsProjectDirty(NULL))
   {
     // keep this msg on a single line for the langpack generator
 		int r=MessageBox(GetMainHwnd(), __LOCALIZE("The current project is not saved.\r\nDo you want to save it?\r\n\r\nNote: if you have changed render settings, you need to run a dummy render and save the project first (last settings will not be taken into account otherwise).","sws_mbox"),
       __LOCALIZE("Autorender","sws_mbox"), MB_YESNOCANCEL);
     if (r==IDCANCEL) return;
-    if (r==IDYES) Main_OnCommand(40026,0);
+    if (r==IDYES) { Main_OnCommand(40026,0); saveAllowed = true; }
   }
 
 	g_doing_render = true;
@@ -620,6 +898,9 @@ void AutorenderRegions(COMMAND_T*)
 			}
 
 			renderRegion.regionNumber = ++region_index;
+			renderRegion.markerIndex = idx;
+			renderRegion.startPos = pos;
+			renderRegion.endPos = rgnend;
 			renderRegions.push_back( renderRegion );
 		}
 	}
@@ -635,6 +916,8 @@ void AutorenderRegions(COMMAND_T*)
 		renderRegion.sanitizedRegionName = prjNameStr;
 		SanitizeFilename( &renderRegion.sanitizedRegionName );
 		renderRegion.entireProject = true;
+		renderRegion.startPos = -1e300;
+		renderRegion.endPos = 1e300;
 		renderRegions.push_back( renderRegion );
 	}
 
@@ -649,13 +932,41 @@ void AutorenderRegions(COMMAND_T*)
 		}
 	}
 
+	ComputeRegionFingerprints( &prjStr, renderRegions );
+
+	//Only render the regions whose content changed since they were last rendered, or whose file is missing
+	vector<RenderRegion> changedRegions;
+	if( changedOnly ){
+		map<string, RenderRegion> existingFiles;
+		GetRenderedFiles( g_render_path, renderRegions, regionNumberPad, existingFiles );
+
+		set<string> rendered;
+		for( map<string, RenderRegion>::iterator file = existingFiles.begin(); file != existingFiles.end(); ++file )
+			rendered.insert( file->second.getFileName( "", regionNumberPad ) );
+
+		for( unsigned int i = 0; i < renderRegions.size(); i++ ){
+			string key = renderRegions[i].getFileName( "", regionNumberPad );
+			map<string, WDL_UINT64>::iterator fp = g_region_fingerprints.find( key );
+			if( fp == g_region_fingerprints.end() || fp->second != renderRegions[i].fingerprint || rendered.find( key ) == rendered.end() )
+				changedRegions.push_back( renderRegions[i] );
+		}
+
+		if( changedRegions.empty() ){
+			g_doing_render = false;
+			MessageBox( GetMainHwnd(), __LOCALIZE("All regions are up to date, nothing to render.","sws_mbox"), __LOCALIZE("Autorender","sws_mbox"), MB_OK );
+			return;
+		}
+	} else {
+		changedRegions = renderRegions;
+	}
+
 	//Build render queue
 	//a single project with fixed render parameters is added to the queue, which renders all regions
 	string outRenderProjectPath = outRenderProjectPrefix;
 	outRenderProjectPath += GetRenderQueueTimeString() + "_" + ARGetProjectName() + "_autorender.rpp";
 
 	if (renderRegions.size() == 1 && renderRegions[0].entireProject) {
-		string regionFilename = renderRegions[0].getFileName("", 2);
+		string regionFilename = renderRegions[0].getFileName("", regionNumberPad);
 		if (g_render_path.empty()){
 			SetProjectParameter(&prjStr, "RENDER_FILE", "\"" + regionFilename + "\"");
 		} else {
@@ -668,7 +979,9 @@ void AutorenderRegions(COMMAND_T*)
 			SetProjectParameter(&prjStr, "RENDER_FILE", "\"" + g_render_path + "\"");
 		}
 
-		SetProjectParameter(&prjStr, "RENDER_PATTERN", "\"$timelineorder $region\"", "RENDER_FILE");
+		// regions are named after their output file in the render copy (see SetRenderedRegions)
+		SetRenderedRegions(&prjStr, changedRegions, regionNumberPad);
+		SetProjectParameter(&prjStr, "RENDER_PATTERN", "\"$region\"", "RENDER_FILE");
 		SetProjectParameter(&prjStr, "RENDER_RANGE", "3 0 0 18 1000");
 	}
 
@@ -680,37 +993,59 @@ void AutorenderRegions(COMMAND_T*)
 	Main_OnCommand( 41207, 0 ); //Render all queued renders
 
 	map<string, RenderRegion> renderedFiles;
-	GetRenderedFiles(g_render_path, renderRegions, renderedFiles);
+	GetRenderedFiles(g_render_path, changedRegions, regionNumberPad, renderedFiles);
 
 	// Tag!
+	vector<TagJob> tagJobs;
 	for (std::map<string, RenderRegion>::iterator renderedFile = renderedFiles.begin(); renderedFile != renderedFiles.end(); ++renderedFile){
-		string renderedFilePath = renderedFile->first;
-		RenderRegion renderRegion = renderedFile->second;
-
-		TagLib::FileRef f( win32::widen(renderedFilePath).c_str() );
-
-		if( !f.isNull() ) {
-			if( !g_tag_artist.empty() )
-			  f.tag()->setArtist( {g_tag_artist, TagLib::String::UTF8} );
-			if( !g_tag_album.empty() )
-			  f.tag()->setAlbum( {g_tag_album, TagLib::String::UTF8} );
-			if( !g_tag_genre.empty() )
-			  f.tag()->setGenre( {g_tag_genre, TagLib::String::UTF8} );
-			if( !g_tag_comment.empty() )
-			  f.tag()->setComment( {g_tag_comment, TagLib::String::UTF8} );
-			f.tag()->setTitle( {renderRegion.regionName, TagLib::String::UTF8} );
-
-			if( g_tag_year > 0 ) f.tag()->setYear( g_tag_year );
-
-			f.tag()->setTrack( renderRegion.regionNumber );
-			f.save();
-		} else {
-			//throw error?
-		}
+		TagJob job;
+		job.path = renderedFile->first;
+		job.region = renderedFile->second;
+		job.success = false;
+		tagJobs.push_back( job );
+	}
+	TagRenderedFiles( tagJobs );
+
+	// Remember what has been rendered (stored in the project)
+	set<string> renderedKeys;
+	for( unsigned int i = 0; i < tagJobs.size(); i++ )
+		renderedKeys.insert( tagJobs[i].region.getFileName( "", regionNumberPad ) );
+
+	map<string, WDL_UINT64> fingerprints;
+	for( unsigned int i = 0; i < renderRegions.size(); i++ ){
+		string key = renderRegions[i].getFileName( "", regionNumberPad );
+		map<string, WDL_UINT64>::iterator fp = g_region_fingerprints.find( key );
+		if( renderedKeys.find( key ) != renderedKeys.end() )
+			fingerprints[ key ] = renderRegions[i].fingerprint;
+		else if( fp != g_region_fingerprints.end() && fp->second == renderRegions[i].fingerprint )
+			fingerprints[ key ] = fp->second;
+	}
+	g_doing_render = false;
+	if( fingerprints != g_region_fingerprints ){
+		// stored with the project on its next save (marks it dirty)
+		g_region_fingerprints = fingerprints;
+		Undo_OnStateChangeEx(__LOCALIZE("Autorender: Update region fingerprints","sws_undo"), UNDO_STATE_MISCCFG, -1);
+		if( saveAllowed )
+			Main_OnCommand( 40026, 0 ); //Save current project
 	}
 
+	// Summary
+	int tagged = 0;
+	string failed;
+	for( unsigned int i = 0; i < tagJobs.size(); i++ ){
+		if( tagJobs[i].success ) tagged++;
+		else failed += "\r\n" + tagJobs[i].path;
+	}
+
+	char summary[512];
+	snprintf( summary, sizeof(summary), __LOCALIZE_VERFMT("Rendered %d region(s), skipped %d unchanged region(s).\r\nTagged %d of %d rendered file(s).","sws_mbox"),
+		(int)changedRegions.size(), (int)(renderRegions.size() - changedRegions.size()), tagged, (int)tagJobs.size() );
+	string summaryStr = summary;
+	if( !failed.empty() )
+		summaryStr += "\r\n\r\n" + string( __LOCALIZE("Failed to tag:","sws_mbox") ) + failed;
+	MessageBox( GetMainHwnd(), summaryStr.c_str(), __LOCALIZE("Autorender","sws_mbox"), MB_OK );
+
 	OpenRenderPath( NULL );
-	g_doing_render = false;
 
 	//NukeDirFiles( queuedRendersDir, "rpp" ); //Maybe cleanup .rpp here too?
 }
@@ -881,6 +1216,8 @@ static bool ProcessExtensionLine(const char *line, ProjectStateContext *ctx, boo
 					g_tag_comment = lp.gettoken_str(1);
 				} else if ( !strcmp(lp.gettoken_str(0), "RENDER_PATH") ){
 					g_render_path = lp.gettoken_str(1);
+				} else if ( !strcmp(lp.gettoken_str(0), "FINGERPRINT") && lp.getnumtokens() > 2 ){
+					g_region_fingerprints[ lp.gettoken_str(2) ] = strtoull( lp.gettoken_str(1), NULL, 16 );
 				}
 			} else {
 				break;
@@ -914,7 +1251,7 @@ static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct pr
 	// then there will be a warning with every project file about unknown ext data
 	// If only the year is set, don't write anything either.
 	if (!g_tag_artist.empty() || !g_tag_album.empty() || !g_tag_genre.empty() ||
-		!g_tag_comment.empty() || !g_render_path.empty() )
+		!g_tag_comment.empty() || !g_render_path.empty() || !g_region_fingerprints.empty() )
 	{
 		ctx->AddLine("<AUTORENDER");
 
@@ -942,6 +1279,12 @@ static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct pr
 			writeAutorenderSettingString( ctx, "RENDER_PATH", g_render_path );
 		}
 
+		for( map<string, WDL_UINT64>::iterator fp = g_region_fingerprints.begin(); fp != g_region_fingerprints.end(); ++fp ){
+			char hex[32];
+			snprintf( hex, sizeof(hex), "FINGERPRINT %08X%08X", (unsigned int)(fp->second >> 32), (unsigned int)(fp->second & 0xFFFFFFFF) );
+			writeAutorenderSettingString( ctx, hex, fp->first );
+		}
+
 		ctx->AddLine(">");
 	}
 }
@@ -955,6 +1298,7 @@ static void BeginLoadProjectState(bool isUndo, struct project_config_extension_t
 	g_tag_year = GetCurrentYear();
 	g_tag_comment.clear();
 	g_render_path.clear();
+	g_region_fingerprints.clear();
 }
 
 static project_config_extension_t g_projectconfig = { ProcessExtensionLine, SaveExtensionConfig, BeginLoadProjectState, NULL };
@@ -962,6 +1306,7 @@ static project_config_extension_t g_projectconfig = { ProcessExtensionLine, Save
 //!WANT_LOCALIZE_1ST_STRING_BEGIN:sws_actions
 static COMMAND_T g_commandTable[] = {
 	{ { DEFACCEL, "SWS/Shane: Batch Render Regions" },	"AUTORENDER", AutorenderRegions, "Batch Render Regions" },
+	{ { DEFACCEL, "SWS/Shane: Batch Render Regions (changed regions only)" }, "AUTORENDER_CHANGED", AutorenderRegions, "Batch Render Changed Regions", 1, },
 	{ { DEFACCEL, "SWS/Shane: Autorender: Edit Project Metadata" }, "AUTORENDER_METADATA", ShowAutorenderMetadata, "Edit Project Metadata" },
 	{ { DEFACCEL, "SWS/Shane: Autorender: Open Render Path" }, "AUTORENDER_OPEN_RENDER_PATH", OpenRenderPath, "Open Render Path" },
 	{ { DEFACCEL, "SWS/Shane: Autorender: Show Instructions" }, "AUTORENDER_HELP", ShowAutorenderHelp, "Show Instructions" },
@@ -30,6 +30,10 @@
 
 RenderRegion::RenderRegion() {
 	entireProject = false;
+	markerIndex = -1;
+	startPos = 0.0;
+	endPos = 0.0;
+	fingerprint = 0;
 }
 
 string RenderRegion::zeroPadInt(int num, int digits ){
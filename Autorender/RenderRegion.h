@@ -34,6 +34,10 @@ class RenderRegion {
 		string getFileName( string, int );
 		string getPaddedRegionNumber( int );
 		bool entireProject;
+		int markerIndex;
+		double startPos;
+		double endPos;
+		WDL_UINT64 fingerprint;
 	private:
 		string zeroPadInt( int, int );
 };
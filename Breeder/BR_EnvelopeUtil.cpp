@@ -648,124 +648,57 @@ double BR_Envelope::ValueAtPosition (double position, bool fastMode /*= false*/)
 {
 	position -= m_takeEnvOffset;
 
-	const int id = FindPrevious(position, 0);
-	const bool faderMode = IsScaledToFader();
-	const double playRate = m_take ? GetMediaItemTakeInfo_Value(m_take, "D_PLAYRATE") : 1;
-
 	if (!m_pointsEdited && !fastMode)
 	{
 		if (m_sampleRate == -1)
 			m_sampleRate = ConfigVar<int>("projsrate").value_or(-1);
 
+		const double playRate = m_take ? GetMediaItemTakeInfo_Value(m_take, "D_PLAYRATE") : 1;
 		double value;
 		Envelope_Evaluate(m_envelope, position * playRate, m_sampleRate, 1, &value, NULL, NULL, NULL); // slower than our way with high point count (probably because we use binary search while Cockos uses linear) but more accurate
 		return ScaleFromEnvelopeMode(GetEnvelopeScalingMode(m_envelope), value);
 	}
 	else
 	{
-		// No previous point?
-		if (!this->ValidateId(id))
-		{
-			int nextId = this->FindFirstPoint();
-			if (this->ValidateId(nextId))
-				return m_points[nextId].value;
-			else
-				return this->LaneCenterValue();
-		}
+		return this->ValueAfterPoint(position, FindPrevious(position, 0), IsScaledToFader());
+	}
+}
 
-		// No next point?
-		int nextId = (m_sorted) ? (id + 1) : this->FindNext(m_points[id].position, 0);
-		if (!this->ValidateId(nextId))
-			return m_points[id].value;
-
-		// Position at the end of transition ?
-		if (m_points[nextId].position == position)
-			return m_points[this->LastPointAtPos(nextId)].value;
-
-		// Everything else
-		double t1 = m_points[id].position;
-		double t2 = m_points[nextId].position;
-		double v1 = m_points[id].value;
-		double v2 = m_points[nextId].value;
-		if (faderMode)
+void BR_Envelope::ValuesAtPositions (const double* positions, double* values, int count, bool fastMode /*= false*/)
+{
+	if (!m_pointsEdited && !fastMode)
+	{
+		if (m_sampleRate == -1)
+			m_sampleRate = ConfigVar<int>("projsrate").value_or(-1);
+
+		const double playRate = m_take ? GetMediaItemTakeInfo_Value(m_take, "D_PLAYRATE") : 1;
+		const int scalingMode = GetEnvelopeScalingMode(m_envelope);
+		for (int i = 0; i < count; ++i)
 		{
-			v1 = this->NormalizedDisplayValue(v1);
-			v2 = this->NormalizedDisplayValue(v2);
+			double value;
+			Envelope_Evaluate(m_envelope, (positions[i] - m_takeEnvOffset) * playRate, m_sampleRate, 1, &value, NULL, NULL, NULL);
+			values[i] = ScaleFromEnvelopeMode(scalingMode, value);
 		}
+	}
+	else
+	{
+		const bool faderMode = IsScaledToFader();
+		const int pointCount = (int)m_points.size();
 
-		double returnValue = 0;
-		switch (m_points[id].shape)
+		// with sorted points and positions, the point before current position only moves forward
+		int prevId = -1;
+		for (int i = 0; i < count; ++i)
 		{
-			case SQUARE:
-			{
-				returnValue = v1;
-			}
-			break;
-
-			case LINEAR:
-			{
-				double t = (position - t1) / (t2 - t1);
-				returnValue = (!m_tempoMap) ? (v1 + (v2 - v1) * t) : CalculateTempoAtPosition(v1, v2, t1, t2, position);
-			}
-			break;
-
-			case FAST_END:                                 // f(x) = x^3
-			{
-				double t = (position - t1) / (t2 - t1);
-				returnValue =  v1 + (v2 - v1) * pow(t, 3);
-			}
-			break;
-
-			case FAST_START:                               // f(x) = 1 - (1 - x)^3
-			{
-				double t = (position - t1) / (t2 - t1);
-				returnValue =  v1 + (v2 - v1) * (1 - pow(1-t, 3));
-			}
-			break;
-
-			case SLOW_START_END:                           // f(x) = x^2 * (3-2x)
-			{
-				double t = (position - t1) / (t2 - t1);
-				returnValue =  v1 + (v2 - v1) * (pow(t, 2) * (3 - 2*t));
-			}
-			break;
-
-			case BEZIER:
+			const double position = positions[i] - m_takeEnvOffset;
+			if (!m_sorted || (i > 0 && positions[i] < positions[i-1]))
+				prevId = FindPrevious(position, 0);
+			else
 			{
-				int id0 = (m_sorted) ? (id-1)     : (this->FindPrevious(t1, 0));
-				int id3 = (m_sorted) ? (nextId+1) : (this->FindNext(t2, 0));
-				double t0 = (!this->ValidateId(id0)) ? (t1) : (m_points[id0].position);
-				double v0 = (!this->ValidateId(id0)) ? (v1) : (m_points[id0].value);
-				double t3 = (!this->ValidateId(id3)) ? (t2) : (m_points[id3].position);
-				double v3 = (!this->ValidateId(id3)) ? (v2) : (m_points[id3].value);
-				if (faderMode)
-				{
-					v0 = this->NormalizedDisplayValue(v0);
-					v3 = this->NormalizedDisplayValue(v3);
-				}
-
-				double x1, x2, y1, y2, empty;
-				LICE_Bezier_FindCardinalCtlPts(0.25, t0, t1, t2, v0, v1, v2, &empty, &x1, &empty, &y1);
-				LICE_Bezier_FindCardinalCtlPts(0.25, t1, t2, t3, v1, v2, v3, &x2, &empty, &y2, &empty);
-
-				double tension = m_points[id].bezier;
-				x1 += tension * ((tension > 0) ? (t2-x1) : (x1-t1));
-				x2 += tension * ((tension > 0) ? (t2-x2) : (x2-t1));
-				y1 -= tension * ((tension > 0) ? (y1-v1) : (v2-y1));
-				y2 -= tension * ((tension > 0) ? (y2-v1) : (v2-y2));
-
-				x1 = SetToBounds(x1, t1, t2);
-				x2 = SetToBounds(x2, t1, t2);
-				y1 = SetToBounds(y1, this->MinValueAbs(), this->MaxValueAbs());
-				y2 = SetToBounds(y2, this->MinValueAbs(), this->MaxValueAbs());
-				returnValue = LICE_CBezier_GetY(t1, x1, x2, t2, v1, y1, y2, v2, position);
+				while (prevId + 1 < pointCount && m_points[prevId + 1].position < position)
+					++prevId;
 			}
-			break;
+			values[i] = this->ValueAfterPoint(position, prevId, faderMode);
 		}
-
-		if (faderMode)
-			returnValue = this->RealValue(returnValue);
-		return returnValue;
 	}
 }
 
@@ -1538,6 +1471,113 @@ int BR_Envelope::FindFirstPoint ()
 	}
 }
 
+double BR_Envelope::ValueAfterPoint (double position, int id, bool faderMode)
+{
+	// No previous point?
+	if (!this->ValidateId(id))
+	{
+		int nextId = this->FindFirstPoint();
+		if (this->ValidateId(nextId))
+			return m_points[nextId].value;
+		else
+			return this->LaneCenterValue();
+	}
+
+	// No next point?
+	int nextId = (m_sorted) ? (id + 1) : this->FindNext(m_points[id].position, 0);
+	if (!this->ValidateId(nextId))
+		return m_points[id].value;
+
+	// Position at the end of transition ?
+	if (m_points[nextId].position == position)
+		return m_points[this->LastPointAtPos(nextId)].value;
+
+	// Everything else
+	double t1 = m_points[id].position;
+	double t2 = m_points[nextId].position;
+	double v1 = m_points[id].value;
+	double v2 = m_points[nextId].value;
+	if (faderMode)
+	{
+		v1 = this->NormalizedDisplayValue(v1);
+		v2 = this->NormalizedDisplayValue(v2);
+	}
+
+	double returnValue = 0;
+	switch (m_points[id].shape)
+	{
+		case SQUARE:
+		{
+			returnValue = v1;
+		}
+		break;
+
+		case LINEAR:
+		{
+			double t = (position - t1) / (t2 - t1);
+			returnValue = (!m_tempoMap) ? (v1 + (v2 - v1) * t) : CalculateTempoAtPosition(v1, v2, t1, t2, position);
+		}
+		break;
+
+		case FAST_END:                                 // f(x) = x^3
+		{
+			double t = (position - t1) / (t2 - t1);
+			returnValue =  v1 + (v2 - v1) * pow(t, 3);
+		}
+		break;
+
+		case FAST_START:                               // f(x) = 1 - (1 - x)^3
+		{
+			double t = (position - t1) / (t2 - t1);
+			returnValue =  v1 + (v2 - v1) * (1 - pow(1-t, 3));
+		}
+		break;
+
+		case SLOW_START_END:                           // f(x) = x^2 * (3-2x)
+		{
+			double t = (position - t1) / (t2 - t1);
+			returnValue =  v1 + (v2 - v1) * (pow(t, 2) * (3 - 2*t));
+		}
+		break;
+
+		case BEZIER:
+		{
+			int id0 = (m_sorted) ? (id-1)     : (this->FindPrevious(t1, 0));
+			int id3 = (m_sorted) ? (nextId+1) : (this->FindNext(t2, 0));
+			double t0 = (!this->ValidateId(id0)) ? (t1) : (m_points[id0].position);
+			double v0 = (!this->ValidateId(id0)) ? (v1) : (m_points[id0].value);
+			double t3 = (!this->ValidateId(id3)) ? (t2) : (m_points[id3].position);
+			double v3 = (!this->ValidateId(id3)) ? (v2) : (m_points[id3].value);
+			if (faderMode)
+			{
+				v0 = this->NormalizedDisplayValue(v0);
+				v3 = this->NormalizedDisplayValue(v3);
+			}
+
+			double x1, x2, y1, y2, empty;
+			LICE_Bezier_FindCardinalCtlPts(0.25, t0, t1, t2, v0, v1, v2, &empty, &x1, &empty, &y1);
+			LICE_Bezier_FindCardinalCtlPts(0.25, t1, t2, t3, v1, v2, v3, &x2, &empty, &y2, &empty);
+
+			double tension = m_points[id].bezier;
+			x1 += tension * ((tension > 0) ? (t2-x1) : (x1-t1));
+			x2 += tension * ((tension > 0) ? (t2-x2) : (x2-t1));
+			y1 -= tension * ((tension > 0) ? (y1-v1) : (v2-y1));
+			y2 -= tension * ((tension > 0) ? (y2-v1) : (v2-y2));
+
+			x1 = SetToBounds(x1, t1, t2);
+			x2 = SetToBounds(x2, t1, t2);
+			y1 = SetToBounds(y1, this->MinValueAbs(), this->MaxValueAbs());
+			y2 = SetToBounds(y2, this->MinValueAbs(), this->MaxValueAbs());
+			returnValue = LICE_CBezier_GetY(t1, x1, x2, t2, v1, y1, y2, v2, position);
+		}
+		break;
+	}
+
+	if (faderMode)
+		returnValue = this->RealValue(returnValue);
+	return returnValue;
+}
+
 int BR_Envelope::LastPointAtPos (int id)
 {
 	/* no bounds checking - internal function so caller handles before calling */
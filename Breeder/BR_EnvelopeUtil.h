@@ -112,6 +112,7 @@ public:
 
 	/* Points properties */
 	double ValueAtPosition (double position, bool fastMode = false); // fastMode will not use native API which is more accurate in some cases (noticed it with bezier curves), but much slower with high point count (accuracy difference should be minimal but still important when dealing with things like mouse detection where every pixel counts!)
+	void ValuesAtPositions (const double* positions, double* values, int count, bool fastMode = false); // Same as ValueAtPosition() for many positions, much faster in fastMode when positions are sorted (points are then walked instead of searched for every position)
 	double NormalizedDisplayValue (double value);                    // Convert point value to 0.0 - 1.0 range as displayed in arrange
 	double RealValue (double normalizedDisplayValue);                // Convert normalized display value in range 0.0 - 1.0 to real envelope value
 	double SnapValue (double value);                                 // Snaps value to current settings (only relevant for take pitch envelope)
@@ -237,6 +238,7 @@ private:
 
 	int FindFirstPoint ();
 	int LastPointAtPos (int id);
+	double ValueAfterPoint (double position, int id, bool faderMode); // position has take envelope offset removed, id is the last point before it (see FindPrevious())
 	int FindNext (double position, double offset);     // used for internal stuff since position
 	int FindPrevious (double position, double offset); // offset of take envelopes has to be tracked
 	void Build (bool takeEnvelopesUseProjectTime);
@@ -33,6 +33,7 @@
 #include "../SnM/SnM_Dlg.h"
 #include "../SnM/SnM_Util.h"
 #include "../SnM/SnM.h"
+#include "../Utility/SampleArena.h"
 #include "../libebur128/ebur128.h"
 
 #include <WDL/localize/localize.h>
@@ -180,6 +181,7 @@ const int UPDATE_TIMER_FREQ  = 200;
 SNM_WindowManager<BR_AnalyzeLoudnessWnd>                              g_loudnessWndManager(LOUDNESS_WND);
 static SWSProjConfig<WDL_PtrList_DeleteOnDestroy<BR_LoudnessObject> > g_analyzedObjects; // no WDL_PtrList_DOD here (abort analysis)
 static HWND                                                           g_normalizeWnd = NULL;
+static SWSProjExtState                                                g_loudnessState("Loudness", false); // not undo-relevant
 
 /******************************************************************************
 * Loudness object                                                             *
@@ -201,6 +203,7 @@ m_killFlag            (false),
 m_integratedOnly      (false),
 m_doTruePeak          (true),
 m_truePeakAnalyzed    (false),
+m_analyzeFailed       (false),
 m_process             (NULL),
 m_doHighPrecisionMode (true),
 m_doDualMonoMode      (true)
@@ -224,6 +227,7 @@ m_killFlag            (false),
 m_integratedOnly      (false),
 m_doTruePeak          (true),
 m_truePeakAnalyzed    (false),
+m_analyzeFailed       (false),
 m_process             (NULL),
 m_doHighPrecisionMode (true),
 m_doDualMonoMode      (true)
@@ -248,6 +252,7 @@ m_killFlag            (false),
 m_integratedOnly      (false),
 m_doTruePeak          (true),
 m_truePeakAnalyzed    (false),
+m_analyzeFailed       (false),
 m_process             (NULL),
 m_doHighPrecisionMode (true),
 m_doDualMonoMode      (true)
@@ -281,6 +286,7 @@ bool BR_LoudnessObject::Analyze (bool integratedOnly, bool doTruePeak, bool doHi
 		{
 			this->SetRunning(true);
 			this->SetProgress(0);
+			this->SetAnalyzeFailed(false);
 			this->SetProcess((HANDLE)_beginthreadex(NULL, 0, this->AnalyzeData, (void*)this, 0, NULL));
 		}
 		return true;
@@ -322,6 +328,12 @@ double BR_LoudnessObject::GetProgress ()
 	return m_progress;
 }
 
+bool BR_LoudnessObject::AnalyzeFailed ()
+{
+	SWS_SectionLock lock(&m_mutex);
+	return m_analyzeFailed;
+}
+
 double BR_LoudnessObject::GetColumnVal (int column, int mode)
 {
 	SWS_SectionLock lock(&m_mutex);
@@ -1120,6 +1132,8 @@ unsigned WINAPI BR_LoudnessObject::AnalyzeData (void* loudnessObject)
 	bool momentaryFilled = true;
 	int processedSamples = 0;
 	int i = 0;
+	bool failed = false;
+	SWS_SampleArena arena; // one buffer for all blocks
 
 	while (currentTime < data.audioEnd && !_this->GetKillFlag())
 	{
@@ -1131,19 +1145,29 @@ unsigned WINAPI BR_LoudnessObject::AnalyzeData (void* loudnessObject)
 			sampleCount = static_cast<int>(data.samplerate * remainingTime);
 			bufSz = sampleCount * data.channels;
 			skipIntervals = true;
+			if (bufSz <= 0) // less than a sample left
+				break;
 		}
 
 		// Get new 200 ms (or 10 ms in high precision mode) of samples
 		// GetAudioAccessorSamples() stops writing to the buffer once it reaches the item's end, everything from that point to sampleCount is garbage
-		std::vector<double> samples(bufSz);
-		GetAudioAccessorSamples(data.audio, data.samplerate, data.channels, currentTime, sampleCount, &samples[0]);
+		SWS_SampleBuf buf(&arena, bufSz);
+		double* samples = buf.Get();
+		if (!samples) // out of memory, don't report a partial measurement
+		{
+			failed = true;
+			break;
+		}
+		memset(samples, 0, bufSz * sizeof(double));
+		GetAudioAccessorSamples(data.audio, data.samplerate, data.channels, currentTime, sampleCount, samples);
 
 		// Correct for volume and pan/volume envelopes
 		int currentChannel = 1;
 		double sampleTime = currentTime;
 
-		for (double &sample : samples)
+		for (int s = 0; s < bufSz; ++s)
 		{
+			double &sample = samples[s];
 			double adjust = 1;
 
 			// Volume envelopes
@@ -1173,7 +1197,7 @@ unsigned WINAPI BR_LoudnessObject::AnalyzeData (void* loudnessObject)
 				sampleTime = sampleTime + sampleTimeLen;
 		}
 
-		ebur128_add_frames_double(loudnessState, &samples[0], sampleCount);
+		ebur128_add_frames_double(loudnessState, samples, sampleCount);
 
 		if (!integratedOnly && !skipIntervals)
 		{
@@ -1225,7 +1249,7 @@ unsigned WINAPI BR_LoudnessObject::AnalyzeData (void* loudnessObject)
 	}
 
 	// Get integrated and loudness range
-	if (!_this->GetKillFlag())
+	if (!_this->GetKillFlag() && !failed)
 	{
 		ebur128_loudness_global(loudnessState, &integrated);
 		if (!integratedOnly)
@@ -1252,7 +1276,15 @@ unsigned WINAPI BR_LoudnessObject::AnalyzeData (void* loudnessObject)
 	ebur128_destroy(&loudnessState);
 
 	// Write analyze data
-	if (!_this->GetKillFlag())
+	if (failed)
+	{
+		_this->SetAnalyzeData(NEGATIVE_INF, 0, NEGATIVE_INF, -1, NEGATIVE_INF, NEGATIVE_INF, vector<double>(), vector<double>());
+		_this->SetAnalyzedStatus(false);
+		_this->SetAnalyzeFailed(true);
+		_this->SetProgress(0);
+		_this->SetRunning(false);
+	}
+	else if (!_this->GetKillFlag())
 	{
 		_this->SetAnalyzeData(integrated, range, truePeak, truePeakPos, shortTermMax, momentaryMax, shortTermValues, momentaryValues);
 		_this->SetProgress(1);
@@ -1459,6 +1491,12 @@ bool BR_LoudnessObject::GetTruePeakAnalyzeStatus ()
 	return m_truePeakAnalyzed;
 }
 
+void BR_LoudnessObject::SetAnalyzeFailed (bool failed)
+{
+	SWS_SectionLock lock(&m_mutex);
+	m_analyzeFailed = failed;
+}
+
 void BR_LoudnessObject::SetKillFlag (bool killFlag)
 {
 	SWS_SectionLock lock(&m_mutex);
@@ -1623,11 +1661,8 @@ static bool ProcessExtensionLine (const char *line, ProjectStateContext *ctx, bo
 	return false;
 }
 
-static void SaveExtensionConfig (ProjectStateContext *ctx, bool isUndo, project_config_extension_t *reg)
+static void SerializeLoudness (ProjectStateContext *ctx)
 {
-	if (isUndo)
-		return;
-
 	g_pref.SaveProjPref(ctx);
 
 	for (int i = 0; i < g_analyzedObjects.Get()->GetSize(); ++i)
@@ -1640,9 +1675,14 @@ static void SaveExtensionConfig (ProjectStateContext *ctx, bool isUndo, project_
 	}
 }
 
+static void SaveExtensionConfig (ProjectStateContext *ctx, bool isUndo, project_config_extension_t *reg)
+{
+	g_loudnessState.Save(ctx, isUndo, SerializeLoudness);
+}
+
 static void BeginLoadProjectState (bool isUndo, project_config_extension_t *reg)
 {
-	if (isUndo)
+	if (!g_loudnessState.BeginLoad(isUndo))
 		return;
 
 	g_analyzedObjects.Get()->Empty(true);
@@ -4451,7 +4491,7 @@ bool NFDoAnalyzeTakeLoudness_IntegratedOnly(MediaItem_Take* take, double* lufsIn
 			BR_NormalizeData analyzeData = { &objects, -23, true, false }; // quick mode, integrated only, targetLUFS isn't used here
 			NFAnalyzeItemsLoudnessAndShowProgress(&analyzeData);
 
-			if (analyzeData.normalized) { // here: checks if analysis is completed, returns false if e.g. user cancels analyse process
+			if (analyzeData.normalized && !objects.Get(0)->AnalyzeFailed()) { // here: checks if analysis is completed, returns false if e.g. user cancels analyse process
 				double returnLUFSintegrated;
 
 				objects.Get(0)->GetAnalyzeData(&returnLUFSintegrated, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
@@ -4488,7 +4528,7 @@ bool NFDoAnalyzeTakeLoudness(MediaItem_Take* take, bool analyzeTruePeak, double*
 			BR_NormalizeData analyzeData = { &objects, -23, false, false }; // full analyze mode
 			NFAnalyzeItemsLoudnessAndShowProgress(&analyzeData);
 
-			if (analyzeData.normalized) {
+			if (analyzeData.normalized && !objects.Get(0)->AnalyzeFailed()) {
 				double returnLUFSintegrated, returnRange, returnTruePeak, returnTruePeakPos, returnShortTermMax, returnMomentaryMax;
 
 				objects.Get(0)->GetAnalyzeData(&returnLUFSintegrated, &returnRange, &returnTruePeak, &returnTruePeakPos, &returnShortTermMax, &returnMomentaryMax, NULL, NULL);
@@ -4529,7 +4569,7 @@ bool NFDoAnalyzeTakeLoudness2(MediaItem_Take* take, bool analyzeTruePeak, double
 			BR_NormalizeData analyzeData = { &objects, -23, false, false }; // full analyze mode
 			NFAnalyzeItemsLoudnessAndShowProgress(&analyzeData);
 
-			if (analyzeData.normalized) {
+			if (analyzeData.normalized && !objects.Get(0)->AnalyzeFailed()) {
 				double returnLUFSintegrated, returnRange, returnTruePeak, returnTruePeakPos, returnShortTermMax, returnMomentaryMax, returnShortTermMaxPos, returnMomentaryMaxPos;
 
 				objects.Get(0)->GetAnalyzeData(&returnLUFSintegrated, &returnRange, &returnTruePeak, &returnTruePeakPos, &returnShortTermMax, &returnMomentaryMax, NULL, NULL);
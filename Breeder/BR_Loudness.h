@@ -44,6 +44,7 @@ public:
 	void AbortAnalyze ();
 	bool IsRunning ();
 	double GetProgress ();
+	bool AnalyzeFailed (); // last analysis couldn't get its sample buffer, results were reset
 
 	/* For populating list view in analyze loudness dialog */
 	double GetColumnVal (int column, int mode);                    // mode: 0->LUFS, 1->LU (LU will follow global format settings)
@@ -112,6 +113,7 @@ private:
 	bool GetIntegratedOnly ();
 	void SetTruePeakAnalyzed (bool analyzed);
 	bool GetTruePeakAnalyzeStatus ();
+	void SetAnalyzeFailed (bool failed);
 	void SetKillFlag (bool killFlag);
 	bool GetKillFlag ();
 	void SetProcess (HANDLE process);
@@ -134,7 +136,7 @@ private:
 	GUID m_guid;
 	double m_integrated, m_truePeak, m_truePeakPos, m_shortTermMax, m_momentaryMax, m_range;
 	double m_progress;
-	bool m_running, m_analyzed, m_killFlag, m_integratedOnly, m_doTruePeak, m_truePeakAnalyzed, m_doHighPrecisionMode, m_doDualMonoMode;
+	bool m_running, m_analyzed, m_killFlag, m_integratedOnly, m_doTruePeak, m_truePeakAnalyzed, m_analyzeFailed, m_doHighPrecisionMode, m_doDualMonoMode;
 	HANDLE m_process;
 	SWS_Mutex m_mutex;
 	vector<double> m_shortTermValues;
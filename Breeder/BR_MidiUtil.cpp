@@ -332,6 +332,11 @@ bool BR_MidiEditor::IsCCVisible (MediaItem_Take* take, int id)
 	return visible;
 }
 
+bool BR_MidiEditor::IsCCVisible (MediaItem_Take* take, int chanMsg, double position, int channel, int msg2, int msg3)
+{
+	return !m_filterEnabled || (take && this->CheckVisibility(take, chanMsg, position, 0, channel, msg2, msg3));
+}
+
 bool BR_MidiEditor::IsSysVisible (MediaItem_Take* take, int id)
 {
 	bool visible = false;
@@ -708,6 +713,272 @@ take (take)
 	sysEvents.reserve(sysCount);
 }
 
+/******************************************************************************
+* BR_MidiSnapshot                                                             *
+******************************************************************************/
+static const int MIDI_SNAPSHOT_CACHE_SIZE = 8;
+static WDL_PtrList_DeleteOnDestroy<BR_MidiSnapshot> g_midiSnapshots; // most recently used first
+
+const BR_MidiSnapshot* BR_MidiSnapshot::Get (MediaItem_Take* take)
+{
+	char hash[128] = "";
+	if (!take || !IsMidi(take) || !MIDI_GetHash(take, false, hash, sizeof(hash)))
+		return NULL;
+
+	BR_MidiSnapshot* snapshot = NULL;
+	for (int i = 0; i < g_midiSnapshots.GetSize(); ++i)
+	{
+		if (g_midiSnapshots.Get(i)->m_take == take)
+		{
+			snapshot = g_midiSnapshots.Get(i);
+			g_midiSnapshots.Delete(i, false);
+			break;
+		}
+	}
+
+	if (snapshot && strcmp(snapshot->m_hash.Get(), hash))
+	{
+		delete snapshot;
+		snapshot = NULL;
+	}
+
+	if (!snapshot)
+	{
+		snapshot = new BR_MidiSnapshot();
+		if (!snapshot->Build(take))
+		{
+			delete snapshot;
+			return NULL;
+		}
+		snapshot->m_hash.Set(hash);
+
+		while (g_midiSnapshots.GetSize() >= MIDI_SNAPSHOT_CACHE_SIZE)
+			g_midiSnapshots.Delete(g_midiSnapshots.GetSize() - 1, true);
+	}
+
+	g_midiSnapshots.Insert(0, snapshot);
+	return snapshot;
+}
+
+const vector<int>& BR_MidiSnapshot::GetLaneCCs (int lane) const
+{
+	static const vector<int> s_empty;
+	return (lane >= 0 && lane <= CC_CHANNEL_PRESSURE) ? m_lanes[lane] : s_empty;
+}
+
+set<int> BR_MidiSnapshot::GetUsedCCLanes (BR_MidiEditor* midiEditorFilterSettings, int detect14bit, bool selectedEventsOnly) const
+{
+	set<int> usedCC;
+	set<int> unpairedMSB;
+
+	for (size_t i = 0; i < m_ccs.pos.size(); ++i)
+	{
+		int chanMsg = m_ccs.chanMsg[i];
+		int msg2    = m_ccs.msg2[i];
+		if ((selectedEventsOnly && !(m_ccs.flags[i] & 1)) || (midiEditorFilterSettings && !midiEditorFilterSettings->IsCCVisible(m_take, chanMsg, m_ccs.pos[i], m_ccs.chan[i], msg2, m_ccs.msg3[i])))
+			continue;
+
+		if      (chanMsg == STATUS_PROGRAM)
+		{
+			usedCC.insert(CC_PROGRAM);
+			usedCC.insert(CC_BANK_SELECT);
+		}
+		else if (chanMsg == STATUS_CHANNEL_PRESSURE) usedCC.insert(CC_CHANNEL_PRESSURE);
+		else if (chanMsg == STATUS_PITCH)            usedCC.insert(CC_PITCH);
+		else if (chanMsg == STATUS_CC)
+		{
+			if (msg2 > 63 || detect14bit == 0)
+				usedCC.insert(msg2);
+			else
+			{
+				if (detect14bit == 1)
+					usedCC.insert(msg2);
+
+				// If MSB also check for LSB that makes up 14 bit event
+				if (msg2 <= 31)
+				{
+					if (this->Is14BitPaired((int)i, true))
+						usedCC.insert(msg2 + CC_14BIT_START);
+					else if (detect14bit == 2)
+					{
+						usedCC.insert(msg2);
+						unpairedMSB.insert(msg2);
+					}
+				}
+				// If LSB, just make sure it was paired
+				else if (detect14bit == 2 && !this->Is14BitPaired((int)i, false))
+				{
+					usedCC.insert(msg2);
+				}
+			}
+		}
+	}
+
+	if (detect14bit == 2)
+	{
+		for (set<int>::iterator it = unpairedMSB.begin(); it != unpairedMSB.end(); ++it)
+		{
+			if (usedCC.find(*it + CC_14BIT_START) != usedCC.end())
+			{
+				usedCC.erase(*it + CC_14BIT_START);
+				usedCC.insert(*it + 32);            // MSB is already there, LSB doesn't have to be so add it
+			}
+		}
+	}
+
+	for (size_t i = 0; i < m_notes.pos.size(); ++i)
+	{
+		if ((!midiEditorFilterSettings || midiEditorFilterSettings->IsChannelVisible(m_notes.chan[i])) && (!selectedEventsOnly || (m_notes.flags[i] & 1)))
+		{
+			usedCC.insert(-1);
+			break;
+		}
+	}
+
+	bool foundText = false, foundSys = false;
+	for (size_t i = 0; i < m_sys.pos.size() && !(foundText && foundSys); ++i)
+	{
+		if (selectedEventsOnly && !(m_sys.flags[i] & 1))
+			continue;
+
+		if (m_sys.type[i] == -1)
+		{
+			if (!foundSys)  usedCC.insert(CC_SYSEX);
+			foundSys = true;
+		}
+		else
+		{
+			if (!foundText) usedCC.insert(CC_TEXT_EVENTS);
+			foundText = true;
+		}
+	}
+
+	return usedCC;
+}
+
+BR_MidiSnapshot::BR_MidiSnapshot () :
+m_take (NULL)
+{
+}
+
+bool BR_MidiSnapshot::Build (MediaItem_Take* take)
+{
+	// MIDI_GetAllEvts() doesn't tell how big the buffer should be, so grow it until everything fits
+	WDL_TypedBuf<char> buf;
+	int size = 0;
+	for (int bufSize = 256*1024; ; bufSize *= 4)
+	{
+		if (bufSize > 512*1024*1024 || !buf.Resize(bufSize, false))
+			return false;
+
+		size = bufSize;
+		if (!MIDI_GetAllEvts(take, buf.Get(), &size))
+			return false;
+		if (size < bufSize)
+			break;
+	}
+
+	m_take = take;
+	vector< vector<int> > noteOn(16*128); // unmatched note-ons, per channel and pitch
+	double ppqPos = 0;
+	int pos = 0;
+
+	while (pos + 9 <= size)
+	{
+		int offset, msgLen;
+		memcpy(&offset, buf.Get() + pos, sizeof(int));
+		const unsigned char flags = (unsigned char)buf.Get()[pos + 4];
+		memcpy(&msgLen, buf.Get() + pos + 5, sizeof(int));
+		pos += 9;
+		if (msgLen < 0 || pos + msgLen > size)
+			break;
+
+		const unsigned char* msg = (const unsigned char*)buf.Get() + pos;
+		pos += msgLen;
+		ppqPos += offset;
+		if (!msgLen)
+			continue;
+
+		const int status  = msg[0] & 0xF0;
+		const int channel = msg[0] & 0x0F;
+		if (msg[0] == 0xF0)
+		{
+			m_sys.pos.push_back(ppqPos);
+			m_sys.type.push_back(-1);
+			m_sys.flags.push_back(flags);
+		}
+		else if (msg[0] == 0xFF)
+		{
+			// CC bezier tensions are stored as text events too, but they are not text events for the API
+			if (msgLen < 2 || (msgLen >= 6 && msg[1] == 0x0F && !memcmp(msg + 2, "CCBZ", 4)))
+				continue;
+			m_sys.pos.push_back(ppqPos);
+			m_sys.type.push_back(msg[1]);
+			m_sys.flags.push_back(flags);
+		}
+		else if (status == STATUS_NOTE_ON && msgLen >= 3 && msg[2])
+		{
+			noteOn[channel*128 + (msg[1] & 0x7F)].push_back((int)m_notes.pos.size());
+			m_notes.pos.push_back(ppqPos);
+			m_notes.end.push_back(-1);
+			m_notes.chan.push_back(channel);
+			m_notes.pitch.push_back(msg[1]);
+			m_notes.vel.push_back(msg[2]);
+			m_notes.flags.push_back(flags);
+		}
+		else if ((status == STATUS_NOTE_OFF || status == STATUS_NOTE_ON) && msgLen >= 3)
+		{
+			vector<int>& pending = noteOn[channel*128 + (msg[1] & 0x7F)];
+			if (pending.size())
+			{
+				m_notes.end[pending.front()] = ppqPos;
+				pending.erase(pending.begin());
+			}
+		}
+		else if (status >= STATUS_POLY_PRESSURE && status <= STATUS_PITCH && msgLen >= 2)
+		{
+			// last event is always "all notes off" marking the end of source, it's not a CC event for the API
+			if (pos >= size && status == STATUS_CC && msg[0] == STATUS_CC && msgLen >= 3 && msg[1] == 0x7B && msg[2] == 0)
+				break;
+
+			const int id = (int)m_ccs.pos.size();
+			m_ccs.pos.push_back(ppqPos);
+			m_ccs.chanMsg.push_back(status);
+			m_ccs.chan.push_back(channel);
+			m_ccs.msg2.push_back(msg[1]);
+			m_ccs.msg3.push_back(msgLen >= 3 ? msg[2] : 0);
+			m_ccs.flags.push_back(flags);
+
+			if      (status == STATUS_CC)               m_lanes[msg[1] & 0x7F].push_back(id);
+			else if (status == STATUS_PITCH)            m_lanes[CC_PITCH].push_back(id);
+			else if (status == STATUS_PROGRAM)          m_lanes[CC_PROGRAM].push_back(id);
+			else if (status == STATUS_CHANNEL_PRESSURE) m_lanes[CC_CHANNEL_PRESSURE].push_back(id);
+		}
+	}
+
+	// notes still playing at the end of source
+	for (size_t i = 0; i < m_notes.end.size(); ++i)
+	{
+		if (m_notes.end[i] < 0)
+			m_notes.end[i] = ppqPos;
+	}
+	return true;
+}
+
+bool BR_MidiSnapshot::Is14BitPaired (int id, bool msb) const
+{
+	const double pos = m_ccs.pos[id];
+	const int pairMsg2 = msb ? m_ccs.msg2[id] + 32 : m_ccs.msg2[id] - 32;
+	const int step = msb ? 1 : -1;
+
+	for (int i = id + step; i >= 0 && i < (int)m_ccs.pos.size() && m_ccs.pos[i] == pos; i += step)
+	{
+		if (m_ccs.chanMsg[i] == STATUS_CC && m_ccs.msg2[i] == pairMsg2 && m_ccs.chan[i] == m_ccs.chan[id])
+			return true;
+	}
+	return false;
+}
+
 /******************************************************************************
 * Mouse cursor                                                                *
 ******************************************************************************/
@@ -817,165 +1088,12 @@ vector<int> MuteUnselectedNotes (MediaItem_Take* take)
 
 set<int> GetUsedCCLanes (HWND midiEditor, int detect14bit, bool selectedEventsOnly)
 {
-	MediaItem_Take* take = MIDIEditor_GetTake(midiEditor);
 	set<int> usedCC;
-
-	int noteCount, ccCount, sysCount;
-	if (take && MIDI_CountEvts(take, &noteCount, &ccCount, &sysCount))
+	if (const BR_MidiSnapshot* midi = BR_MidiSnapshot::Get(MIDIEditor_GetTake(midiEditor)))
 	{
 		BR_MidiEditor editor(midiEditor);
-
-		set<int> unpairedMSB;
-		for (int id = 0; id < ccCount; ++id)
-		{
-			int chanMsg, chan, msg2;
-			bool selected;
-			if (!MIDI_GetCC(take, id, &selected, NULL, NULL, &chanMsg, &chan, &msg2, NULL) || !editor.IsCCVisible(take, id) || (selectedEventsOnly && !selected))
-				continue;
-
-			if      (chanMsg == STATUS_PROGRAM)
-			{
-				usedCC.insert(CC_PROGRAM);
-				usedCC.insert(CC_BANK_SELECT);
-			}
-			else if (chanMsg == STATUS_CHANNEL_PRESSURE) usedCC.insert(CC_CHANNEL_PRESSURE);
-			else if (chanMsg == STATUS_PITCH)            usedCC.insert(CC_PITCH);
-			else if (chanMsg == STATUS_CC)
-			{
-				if (msg2 > 63 || detect14bit == 0)
-					usedCC.insert(msg2);
-				else
-				{
-					if (detect14bit == 1)
-						usedCC.insert(msg2);
-
-					// If MSB also check for LSB that makes up 14 bit event
-					if (msg2 <= 31)
-					{
-						int tmpId = id;
-						if (MIDI_GetCC(take, tmpId + 1, NULL, NULL, NULL, NULL, NULL, NULL, NULL))
-						{
-							double pos;
-							MIDI_GetCC(take, id, NULL, NULL, &pos, NULL, NULL, NULL, NULL);
-
-							while (true)
-							{
-								double nextPos;
-								int nextChanMsg, nextChan, nextMsg2;
-								MIDI_GetCC(take, ++tmpId, NULL, NULL, &nextPos, &nextChanMsg, &nextChan, &nextMsg2, NULL);
-								if (tmpId >= ccCount)
-									break;
-								if (nextPos > pos)
-								{
-									if (detect14bit == 2)
-									{
-										usedCC.insert(msg2);
-										unpairedMSB.insert(msg2);
-									}
-									break;
-								}
-
-								if (nextChanMsg == STATUS_CC && msg2 == nextMsg2 - 32 && chan == nextChan)
-								{
-									usedCC.insert(msg2 + CC_14BIT_START);
-									break;
-								}
-							}
-						}
-						else
-						{
-							if (detect14bit == 2)
-							{
-								usedCC.insert(msg2);
-								unpairedMSB.insert(msg2);
-							}
-						}
-					}
-					// If LSB, just make sure it was paired
-					else if (detect14bit == 2)
-					{
-						int tmpId = id;
-						if (MIDI_GetCC(take, tmpId - 1, NULL, NULL, NULL, NULL, NULL, NULL, NULL))
-						{
-							double pos;
-							MIDI_GetCC(take, id, NULL, NULL, &pos, NULL, NULL, NULL, NULL);
-
-							while (true)
-							{
-								double prevPos;
-								int prevChanMsg, prevChan, prevMsg2;
-								MIDI_GetCC(take, --tmpId, NULL, NULL, &prevPos, &prevChanMsg, &prevChan, &prevMsg2, NULL);
-								if (prevPos < pos)
-								{
-									if (detect14bit == 2)
-										usedCC.insert(msg2);
-									break;
-								}
-
-								if (prevChanMsg == STATUS_CC && msg2 == prevMsg2 + 32 && chan == prevChan)
-									break;
-							}
-						}
-						else
-							usedCC.insert(msg2);
-					}
-				}
-			}
-		}
-
-		if (detect14bit == 2)
-		{
-			for (set<int>::iterator it = unpairedMSB.begin(); it != unpairedMSB.end(); ++it)
-			{
-				if (usedCC.find(*it + CC_14BIT_START) != usedCC.end())
-				{
-					usedCC.erase(*it + CC_14BIT_START);
-					usedCC.insert(*it + 32);            // MSB is already there, LSB doesn't have to be so add it
-				}
-			}
-		}
-
-		for (int i = 0; i < noteCount; ++i)
-		{
-			bool selected; int chan;
-			MIDI_GetNote(take, i, &selected, NULL, NULL, NULL, &chan, NULL, NULL);
-			if (editor.IsChannelVisible(chan) && (!selectedEventsOnly || selected))
-			{
-				usedCC.insert(-1);
-				break;
-			}
-		}
-
-		bool foundText = false, foundSys = false;
-		for (int i = 0; i < sysCount; ++i)
-		{
-			bool selected;
-			int type = 0;
-			MIDI_GetTextSysexEvt(take, i, &selected, NULL, NULL, &type, NULL, NULL);
-
-			if (type == -1)
-			{
-				if (!foundSys && (!selectedEventsOnly || selected))
-				{
-					usedCC.insert(CC_SYSEX);
-					foundSys = true;
-					if (foundText)
-						break;
-				}
-			}
-			else
-			{
-				if (!foundText && (!selectedEventsOnly || selected))
-				{
-					usedCC.insert(CC_TEXT_EVENTS);
-					foundText = true;
-					if (foundSys)
-						break;
-				}
-			}
-		}
+		usedCC = midi->GetUsedCCLanes(&editor, detect14bit, selectedEventsOnly);
 	}
-
 	return usedCC;
 }
 
@@ -135,6 +135,7 @@ public:
 	bool IsNoteVisible (MediaItem_Take* take, int id);
 	bool IsCCVisible (MediaItem_Take* take, int id);
 	bool IsSysVisible (MediaItem_Take* take, int id);
+	bool IsCCVisible (MediaItem_Take* take, int chanMsg, double position, int channel, int msg2, int msg3); // same as above, but for already decoded events
 	bool IsChannelVisible (int channel);
 
 	/* Misc */
@@ -211,6 +212,54 @@ private:
 	vector<BR_MidiItemTimePos::MidiTake> savedMidiTakes;
 };
 
+/******************************************************************************
+* Decoded snapshot of all MIDI events in a take (read-only)                   *
+* Events are decoded once from MIDI_GetAllEvts() and kept as struct of arrays *
+* with per-lane indexes. Snapshots are cached and rebuilt only when take's    *
+* MIDI hash changes. Event ids are the same as in MIDI_GetNote(), MIDI_GetCC()*
+* and MIDI_GetTextSysexEvt()                                                  *
+******************************************************************************/
+class BR_MidiSnapshot
+{
+public:
+	static const BR_MidiSnapshot* Get (MediaItem_Take* take); // returns NULL if take is not MIDI, don't keep returned pointer around
+
+	struct Notes
+	{
+		vector<double> pos, end;
+		vector<unsigned char> chan, pitch, vel, flags; // flags: &1=selected, &2=muted
+	};
+	struct CCs
+	{
+		vector<double> pos;
+		vector<unsigned char> chanMsg, chan, msg2, msg3, flags; // flags: &1=selected, &2=muted, &0xF0=shape
+	};
+	struct Sys
+	{
+		vector<double> pos;
+		vector<int> type;                                       // -1=sysex, otherwise text event type
+		vector<unsigned char> flags;
+	};
+
+	const Notes& GetNotes () const {return m_notes;}
+	const CCs& GetCCs () const     {return m_ccs;}
+	const Sys& GetSys () const     {return m_sys;}
+	const vector<int>& GetLaneCCs (int lane) const; // CC ids in lane (0-127=CC, CC_PITCH, CC_PROGRAM, CC_CHANNEL_PRESSURE), sorted by position
+	set<int> GetUsedCCLanes (BR_MidiEditor* midiEditorFilterSettings, int detect14bit, bool selectedEventsOnly) const; // see GetUsedCCLanes()
+
+private:
+	BR_MidiSnapshot ();
+	bool Build (MediaItem_Take* take);
+	bool Is14BitPaired (int id, bool msb) const;
+
+	MediaItem_Take* m_take;
+	WDL_FastString m_hash;
+	Notes m_notes;
+	CCs m_ccs;
+	Sys m_sys;
+	vector<int> m_lanes[CC_CHANNEL_PRESSURE + 1];
+};
+
 /******************************************************************************
 * Mouse cursor                                                                *
 ******************************************************************************/
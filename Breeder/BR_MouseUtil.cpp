@@ -61,35 +61,22 @@ static MediaTrack* GetTrackAreaFromY (int y, int* offset, int* spacerSize)
 	/* Check if Y is in some TCP track or it's envelopes, *
 	*  returned offset is always for returned track       */
 
-	MediaTrack* master = GetMasterTrack(NULL);
-	MediaTrack* track = NULL;
-
-	int trackEnd = 0;
-	int trackOffset = 0;
-	int trackSpacerSize = 0;
-	for (int i = 0; i <= GetNumTracks(); ++i)
+	if (y < 0)
 	{
-		MediaTrack* currentTrack = CSurf_TrackFromID(i, false);
-		int height = *(int*)GetSetMediaTrackInfo(currentTrack, "I_WNDH", NULL);
-
-		trackSpacerSize = GetTrackSpacerSize(currentTrack);
-		height += trackSpacerSize;
+		WritePtr(offset, 0);
+		WritePtr(spacerSize, 0);
+		return NULL;
+	}
 
-		if (currentTrack == master && TcpVis(master))
-			height += GetMasterTcpGap();
-		trackEnd += height;
+	// Track positions are relative to arrange view top, y is in arrange scroll coordinates
+	SCROLLINFO si = { sizeof(SCROLLINFO), SIF_POS };
+	CF_GetScrollInfo(GetArrangeWnd(), SB_VERT, &si);
 
-		if (y >= trackOffset && y < trackEnd)
-		{
-			track = currentTrack;
-			break;
-		}
-		trackOffset += height;
-		trackSpacerSize = 0;
-	}
+	int trackY = 0;
+	MediaTrack* track = GetTcpTrackFromY(y - si.nPos, &trackY, NULL); // gap below master belongs to master
 
-	WritePtr(offset, (track) ? (trackOffset) : (0));
-	WritePtr(spacerSize, trackSpacerSize);
+	WritePtr(offset, (track) ? (trackY + si.nPos) : (0));
+	WritePtr(spacerSize, (track) ? (GetTrackSpacerSize(track)) : (0));
 	return track;
 }
 
@@ -637,7 +624,10 @@ void BR_MouseInfo::GetContext (const POINT& p)
 					else if (mouseInfo.track)
 					{
 						mouseInfo.segment = "track";
-						mouseInfo.item = GetItemFromPoint(p.x, p.y, true, &mouseInfo.take);
+						// Skip REAPER's lookup (it goes through all items of the track) when the index says the pixel under mouse is empty
+						const double pixel = 1 / arrangeZoom;
+						if (MayHaveItemInRange(mouseInfo.track, mousePos - pixel, mousePos + pixel))
+							mouseInfo.item = GetItemFromPoint(p.x, p.y, true, &mouseInfo.take);
 
 						int trackEnvHit      = 0;
 						int takeEnvHit       = 0;
@@ -56,6 +56,7 @@ SWSProjConfig<WDL_PtrList_DOD<BR_MidiCCEvents> >       g_midiCCEvents;
 SWSProjConfig<WDL_PtrList_DOD<BR_ItemMuteState> >      g_itemMuteState;
 SWSProjConfig<WDL_PtrList_DOD<BR_TrackSoloMuteState> > g_trackSoloMuteState;
 SWSProjConfig<BR_MidiToggleCCLane>                     g_midiToggleHideCCLanes;
+static SWSProjExtState g_projState("BR saved states", false); // not undo-relevant
 
 /******************************************************************************
 * Project state init/exit                                                     *
@@ -121,11 +122,8 @@ static bool ProcessExtensionLine (const char *line, ProjectStateContext *ctx, bo
 	return false;
 }
 
-static void SaveExtensionConfig (ProjectStateContext *ctx, bool isUndo, project_config_extension_t *reg)
+static void SerializeProjState (ProjectStateContext *ctx)
 {
-	if (isUndo)
-		return;
-
 	// Envelope point selection
 	if (int count = g_envSel.Get()->GetSize())
 	{
@@ -173,9 +171,14 @@ static void SaveExtensionConfig (ProjectStateContext *ctx, bool isUndo, project_
 		g_midiToggleHideCCLanes.Get()->SaveState(ctx);
 }
 
+static void SaveExtensionConfig (ProjectStateContext *ctx, bool isUndo, project_config_extension_t *reg)
+{
+	g_projState.Save(ctx, isUndo, SerializeProjState);
+}
+
 static void BeginLoadProjectState (bool isUndo, project_config_extension_t *reg)
 {
-	if (isUndo)
+	if (!g_projState.BeginLoad(isUndo))
 		return;
 
 	// Envelope point selection
@@ -473,58 +476,54 @@ bool BR_MidiCCEvents::Save (BR_MidiEditor& midiEditor, int lane)
 		vector<BR_MidiCCEvents::Event> events;
 
 		m_sourcePpqStart = -1;
-		if ((lane >= 0 && lane <= 127))
+		const bool is14Bit = lane >= CC_14BIT_START && lane < CC_14BIT_START + 32; // lanes above are velocity off, notation...
+		const BR_MidiSnapshot* midi = BR_MidiSnapshot::Get(take);
+		if (midi && ((lane >= 0 && lane <= 127) || lane == CC_PITCH || lane == CC_PROGRAM || lane == CC_CHANNEL_PRESSURE || is14Bit))
 		{
-			int id = -1;
-
-			while ((id = MIDI_EnumSelCC(take, id)) != -1)
+			const BR_MidiSnapshot::CCs& ccs = midi->GetCCs();
+			int cc1 = (is14Bit) ? lane - CC_14BIT_START : lane;
+			int cc2 = cc1 + 32;
+			const vector<int>& ids = midi->GetLaneCCs(cc1);
+			for (size_t i = 0; i < ids.size(); ++i)
 			{
-				int cc, chanMsg;
-				if (MIDI_GetCC(take, id, NULL, NULL, NULL, &chanMsg, NULL, &cc, NULL) && midiEditor.IsCCVisible(take, id) && chanMsg == STATUS_CC && cc == lane)
+				int id = ids[i];
+				if (!(ccs.flags[id] & 1) || !midiEditor.IsCCVisible(take, ccs.chanMsg[id], ccs.pos[id], ccs.chan[id], ccs.msg2[id], ccs.msg3[id]))
+					continue;
+
+				BR_MidiCCEvents::Event event;
+				event.mute        = !!(ccs.flags[id] & 2);
+				event.positionPpq = ccs.pos[id];
+				event.channel     = ccs.chan[id];
+				if (lane == CC_PITCH)
 				{
-					BR_MidiCCEvents::Event event;
-					MIDI_GetCC(take, id, NULL, &event.mute, &event.positionPpq, NULL, &event.channel, NULL, &event.msg3);
-					if (MIDI_GetCCShape) // v6.0
-						MIDI_GetCCShape(take, id, &event.shape, &event.beztension);
-					events.push_back(event);
-					if (m_sourcePpqStart == -1)
-						m_sourcePpqStart = event.positionPpq;
+					event.msg2 = ccs.msg2[id];
+					event.msg3 = ccs.msg3[id];
 				}
-			}
-		}
-		else if (lane == CC_PITCH)
-		{
-			int id = -1;
-			while ((id = MIDI_EnumSelCC(take, id)) != -1)
-			{
-				int chanMsg;
-				if (MIDI_GetCC(take, id, NULL, NULL, NULL, &chanMsg, NULL, NULL, NULL) && midiEditor.IsCCVisible(take, id) &&chanMsg == STATUS_PITCH)
+				else if (lane == CC_PROGRAM || lane == CC_CHANNEL_PRESSURE)
 				{
-					BR_MidiCCEvents::Event event;
-					MIDI_GetCC(take, id, NULL, &event.mute, &event.positionPpq, NULL, &event.channel, &event.msg2, &event.msg3);
-					if (MIDI_GetCCShape) // v6.0
-						MIDI_GetCCShape(take, id, &event.shape, &event.beztension);
-					events.push_back(event);
-					if (m_sourcePpqStart == -1)
-						m_sourcePpqStart = event.positionPpq;
+					event.msg3 = ccs.msg2[id]; // messages are reversed
+					event.msg2 = ccs.msg3[id];
 				}
-			}
-		}
-		else if (lane == CC_PROGRAM || lane == CC_CHANNEL_PRESSURE)
-		{
-			int id = -1;
-			while ((id = MIDI_EnumSelCC(take, id)) != -1)
-			{
-				int chanMsg;
-				if (MIDI_GetCC(take, id, NULL, NULL, NULL, &chanMsg, NULL, NULL, NULL) && midiEditor.IsCCVisible(take, id) && chanMsg == ((lane == CC_PROGRAM) ? STATUS_PROGRAM : STATUS_CHANNEL_PRESSURE))
+				else
 				{
-					BR_MidiCCEvents::Event event;
-					MIDI_GetCC(take, id, NULL, &event.mute, &event.positionPpq, NULL, &event.channel, &event.msg3, &event.msg2); // messages are reversed
-					if (MIDI_GetCCShape) // v6.0
-						MIDI_GetCCShape(take, id, &event.shape, &event.beztension);
-					events.push_back(event);
-					if (m_sourcePpqStart == -1)
-						m_sourcePpqStart = event.positionPpq;
+					event.msg3 = ccs.msg3[id];
+				}
+				if (MIDI_GetCCShape) // v6.0
+					MIDI_GetCCShape(take, id, &event.shape, &event.beztension);
+				events.push_back(event);
+				if (m_sourcePpqStart == -1)
+					m_sourcePpqStart = event.positionPpq;
+
+				if (is14Bit)
+				{
+					for (int tmpId = id + 1; tmpId < (int)ccs.pos.size() && ccs.pos[tmpId] <= event.positionPpq; ++tmpId)
+					{
+						if ((ccs.flags[tmpId] & 1) && ccs.chanMsg[tmpId] == STATUS_CC && ccs.msg2[tmpId] == cc2 && ccs.chan[tmpId] == event.channel)
+						{
+							events.back().msg2 = ccs.msg3[tmpId];
+							break;
+						}
+					}
 				}
 			}
 		}
@@ -542,40 +541,6 @@ bool BR_MidiCCEvents::Save (BR_MidiEditor& midiEditor, int lane)
 				}
 			}
 		}
-		else if (lane >= CC_14BIT_START)
-		{
-			int id = -1;
-			int cc1 = lane - CC_14BIT_START;
-			int cc2 = cc1 + 32;
-			while ((id = MIDI_EnumSelCC(take, id)) != -1)
-			{
-				int cc, chanMsg;
-				if (MIDI_GetCC(take, id, NULL, NULL, NULL, &chanMsg, NULL, &cc, NULL) && midiEditor.IsCCVisible(take, id) && chanMsg == STATUS_CC && cc == cc1)
-				{
-					BR_MidiCCEvents::Event event;
-					MIDI_GetCC(take, id, NULL, &event.mute, &event.positionPpq, NULL, &event.channel, NULL, &event.msg3);
-					if (MIDI_GetCCShape) // v6.0
-						MIDI_GetCCShape(take, id, &event.shape, &event.beztension);
-					events.push_back(event);
-					if (m_sourcePpqStart == -1)
-						m_sourcePpqStart = event.positionPpq;
-
-					int tmpId = id;
-					while ((tmpId = MIDI_EnumSelCC(take, tmpId)) != -1)
-					{
-						double pos; int channel, value, chanMsg2;
-						MIDI_GetCC(take, tmpId, NULL, NULL, &pos, &chanMsg2, &channel, &cc, &value);
-						if (pos > event.positionPpq)
-							break;
-						if (chanMsg2 == STATUS_CC && cc == cc2 && channel == events.back().channel)
-						{
-							events.back().msg2 = value;
-							break;
-						}
-					}
-				}
-			}
-		}
 
 		if (events.size())
 		{
@@ -35,7 +35,9 @@
 #include "BR_Util.h"
 #include "../SnM/SnM.h"
 #include "../SnM/SnM_Chunk.h"
+#include "../SnM/SnM_Notes.h"
 #include "../SnM/SnM_Util.h"
+#include "../Utility/ReaScript_Utility.hpp"
 
 /******************************************************************************
 * Globals                                                                     *
@@ -43,6 +45,249 @@
 static BR_MouseInfo g_mouseInfo(BR_MouseInfo::MODE_ALL, false);
 WDL_PtrList_DOD<BR_Envelope> g_script_brenvs; // just to validate function parameters
 
+/******************************************************************************
+* Bulk property access                                                        *
+******************************************************************************/
+static void GetBulkObjects (ReaProject* proj, const char* objects, bool items, vector<void*>& out)
+{
+	vector<void*> all;
+	vector<bool> selected;
+	const int trackCount = CountTracks(proj);
+	for (int i = 0; i < trackCount; ++i)
+	{
+		MediaTrack* track = GetTrack(proj, i);
+		if (items)
+		{
+			const int itemCount = CountTrackMediaItems(track);
+			for (int j = 0; j < itemCount; ++j)
+			{
+				MediaItem* item = GetTrackMediaItem(track, j);
+				all.push_back(item);
+				selected.push_back(GetMediaItemInfo_Value(item, "B_UISEL") != 0);
+			}
+		}
+		else
+		{
+			all.push_back(track);
+			selected.push_back(GetMediaTrackInfo_Value(track, "I_SELECTED") != 0);
+		}
+	}
+
+	if (!objects || !*objects || !_stricmp(objects, "all"))
+	{
+		out.swap(all);
+	}
+	else if (!_stricmp(objects, "selected"))
+	{
+		for (size_t i = 0; i < all.size(); ++i)
+			if (selected[i])
+				out.push_back(all[i]);
+	}
+	else
+	{
+		const char* p = objects;
+		while (*p)
+		{
+			char* end;
+			long id = strtol(p, &end, 10);
+			if (end == p)
+			{
+				++p; // separator
+				continue;
+			}
+			p = end;
+
+			if (id >= 0 && id < (long)all.size())
+				out.push_back(all[id]);
+			else if (id == -1 && !items)
+				out.push_back(GetMasterTrack(proj));
+		}
+	}
+}
+
+static void GetBulkKeys (const char* keys, vector<string>& out)
+{
+	if (!keys)
+		return;
+
+	string key;
+	for (const char* p = keys;; ++p)
+	{
+		if (*p == ',' || !*p)
+		{
+			size_t first = key.find_first_not_of(" \t");
+			size_t last  = key.find_last_not_of(" \t");
+			if (first != string::npos)
+				out.push_back(key.substr(first, last - first + 1));
+			key.clear();
+			if (!*p)
+				break;
+		}
+		else
+			key += *p;
+	}
+}
+
+static void AppendBulkValue (WDL_FastString& out, const char* value)
+{
+	for (const char* p = value; p && *p; ++p)
+	{
+		switch (*p)
+		{
+			case '\\': out.Append("\\\\"); break;
+			case '\t': out.Append("\\t");  break;
+			case '\n': out.Append("\\n");  break;
+			case '\r': out.Append("\\r");  break;
+			default:   out.Append(p, 1);   break;
+		}
+	}
+}
+
+// Splits packed values (see BR_GetMediaItemsInfo) into lines of unescaped fields
+static void ParseBulkValues (const char* values, vector<vector<string> >& out)
+{
+	if (!values || !*values)
+		return;
+
+	out.resize(1);
+	out.back().resize(1);
+	for (const char* p = values; *p; ++p)
+	{
+		if (*p == '\n')
+		{
+			out.push_back(vector<string>(1));
+		}
+		else if (*p == '\t')
+		{
+			out.back().push_back(string());
+		}
+		else if (*p == '\\' && p[1])
+		{
+			++p;
+			out.back().back() += (*p == 't') ? '\t' : (*p == 'n') ? '\n' : (*p == 'r') ? '\r' : *p;
+		}
+		else if (*p != '\r')
+		{
+			out.back().back() += *p;
+		}
+	}
+	if (out.size() > 1 && out.back().size() == 1 && out.back().front().empty()) // trailing new line
+		out.pop_back();
+}
+
+static bool IsBulkStringKey (const char* key)
+{
+	return !strncmp(key, "P_", 2) || !strcmp(key, "GUID") || !strcmp(key, "SWS_NOTES");
+}
+
+// P_ attributes that are objects (parent track, project, envelopes), not strings: neither read nor written
+static bool IsBulkObjectKey (const char* key)
+{
+	return !strcmp(key, "P_TRACK") || !strcmp(key, "P_PARTRACK") || !strcmp(key, "P_PROJECT") || !strncmp(key, "P_ENV:", 6);
+}
+
+// String attributes are read through the pointer GetSetMedia*Info returns (as for P_NAME), GetSetMedia*Info_String
+// takes no buffer size and values of keys like P_NOTES or P_EXT:xyz can be of any length
+static const char* GetBulkString (void* object, bool items, const char* key, char* guidBuf)
+{
+	if (!strcmp(key, "GUID"))
+	{
+		const GUID* g = items ? (const GUID*)GetSetMediaItemInfo((MediaItem*)object, "GUID", NULL) : GetTrackGUID((MediaTrack*)object);
+		if (!g)
+			return NULL;
+		guidToString(g, guidBuf);
+		return guidBuf;
+	}
+	if (!strcmp(key, "SWS_NOTES"))
+		return items ? NULL : NF_GetSWSTrackNotes((MediaTrack*)object);
+	if (IsBulkObjectKey(key))
+		return NULL;
+	return items ? (const char*)GetSetMediaItemInfo((MediaItem*)object, key, NULL) : (const char*)GetSetMediaTrackInfo((MediaTrack*)object, key, NULL);
+}
+
+static int GetBulkInfo (ReaProject* proj, const char* objects, bool items, const char* keys, char* valuesOut, int valuesOut_sz)
+{
+	if (valuesOut && valuesOut_sz > 0)
+		*valuesOut = '\0';
+
+	vector<void*> objectList;
+	vector<string> keyList;
+	GetBulkObjects(proj, objects, items, objectList);
+	GetBulkKeys(keys, keyList);
+
+	WDL_FastString str;
+	char guidBuf[64];
+	for (size_t i = 0; i < objectList.size(); ++i)
+	{
+		if (i) str.Append("\n");
+		for (size_t j = 0; j < keyList.size(); ++j)
+		{
+			if (j) str.Append("\t");
+
+			const char* key = keyList[j].c_str();
+			if (IsBulkStringKey(key))
+			{
+				if (const char* value = GetBulkString(objectList[i], items, key, guidBuf))
+					AppendBulkValue(str, value);
+			}
+			else
+			{
+				double value = items ? GetMediaItemInfo_Value((MediaItem*)objectList[i], key) : GetMediaTrackInfo_Value((MediaTrack*)objectList[i], key);
+				str.AppendFormatted(32, "%.14g", value);
+			}
+		}
+	}
+
+	if (valuesOut && valuesOut_sz > 0)
+		CopyToBuffer(str.Get(), valuesOut, valuesOut_sz);
+	return (int)objectList.size();
+}
+
+static int SetBulkInfo (ReaProject* proj, const char* objects, bool items, const char* keys, const char* values)
+{
+	vector<void*> objectList;
+	vector<string> keyList;
+	vector<vector<string> > valueList;
+	GetBulkObjects(proj, objects, items, objectList);
+	GetBulkKeys(keys, keyList);
+	ParseBulkValues(values, valueList);
+	if (objectList.empty() || keyList.empty() || valueList.empty())
+		return 0;
+
+	PreventUIRefresh(1);
+	int count = 0;
+	for (size_t i = 0; i < objectList.size(); ++i)
+	{
+		if (valueList.size() != 1 && i >= valueList.size())
+			break;
+		const vector<string>& line = (valueList.size() == 1) ? valueList.front() : valueList[i]; // single line is applied to all objects
+
+		for (size_t j = 0; j < keyList.size() && j < line.size(); ++j)
+		{
+			const char* key = keyList[j].c_str();
+			if (IsBulkStringKey(key))
+			{
+				if (!strcmp(key, "GUID") || IsBulkObjectKey(key))
+					continue;
+
+				char* value = const_cast<char*>(line[j].c_str());
+				if (items)                       GetSetMediaItemInfo_String((MediaItem*)objectList[i], key, value, true);
+				else if (!strcmp(key, "SWS_NOTES")) NF_SetSWSTrackNotes((MediaTrack*)objectList[i], value);
+				else                             GetSetMediaTrackInfo_String((MediaTrack*)objectList[i], key, value, true);
+			}
+			else
+			{
+				double value = atof(line[j].c_str());
+				if (items) SetMediaItemInfo_Value((MediaItem*)objectList[i], key, value);
+				else       SetMediaTrackInfo_Value((MediaTrack*)objectList[i], key, value);
+			}
+		}
+		++count;
+	}
+	PreventUIRefresh(-1);
+	return count;
+}
+
 /******************************************************************************
 * ReaScript export                                                            *
 ******************************************************************************/
@@ -237,6 +482,43 @@ double BR_EnvValueAtPos (BR_Envelope* envelope, double position)
 	return 0;
 }
 
+int BR_EnvValuesAtPos (BR_Envelope* envelope, const char* positions, bool fastMode, char* valuesOut, int valuesOut_sz)
+{
+	if (valuesOut && valuesOut_sz > 0)
+		*valuesOut = '\0';
+	if (!envelope || g_script_brenvs.Find(envelope) < 0 || !positions)
+		return 0;
+
+	vector<double> position;
+	const char* p = positions;
+	while (*p)
+	{
+		char* end;
+		double value = strtod(p, &end);
+		if (end == p)
+			++p; // separator
+		else
+		{
+			position.push_back(value);
+			p = end;
+		}
+	}
+	if (position.empty())
+		return 0;
+
+	vector<double> values(position.size());
+	envelope->ValuesAtPositions(&position[0], &values[0], (int)position.size(), fastMode);
+
+	if (valuesOut && valuesOut_sz > 0)
+	{
+		WDL_FastString str;
+		for (size_t i = 0; i < values.size(); ++i)
+			str.AppendFormatted(32, i ? ",%.12g" : "%.12g", values[i]);
+		CopyToBuffer(str.Get(), valuesOut, valuesOut_sz);
+	}
+	return (int)values.size();
+}
+
 void BR_GetArrangeView (ReaProject* proj, double* startPositionOut, double* endPositionOut)
 {
 	double start, end;
@@ -301,6 +583,11 @@ bool BR_GetMediaItemImageResource (MediaItem* item, char* imageOut, int imageOut
 	return resourceFound;
 }
 
+int BR_GetMediaItemsInfo (ReaProject* proj, const char* items, const char* keys, char* valuesOut, int valuesOut_sz)
+{
+	return GetBulkInfo(proj, items, true, keys, valuesOut, valuesOut_sz);
+}
+
 void BR_GetMediaItemTakeGUID (MediaItem_Take* take, char* guidStringOut, int guidStringOut_sz)
 {
 	if (take && guidStringOut && guidStringOut_sz > 0)
@@ -386,6 +673,11 @@ MediaTrack* BR_GetMediaTrackSendInfo_Track (MediaTrack* track, int category, int
 		return NULL;
 }
 
+int BR_GetMediaTracksInfo (ReaProject* proj, const char* tracks, const char* keys, char* valuesOut, int valuesOut_sz)
+{
+	return GetBulkInfo(proj, tracks, false, keys, valuesOut, valuesOut_sz);
+}
+
 double BR_GetMidiSourceLenPPQ (MediaItem_Take* take)
 {
 	double length = -1;
@@ -434,6 +726,25 @@ bool BR_GetMidiTakeTempoInfo (MediaItem_Take* take, bool* ignoreProjTempoOut, do
 	return GetMidiTakeTempoInfo (take, ignoreProjTempoOut, bpmOut, numOut, denOut);
 }
 
+int BR_GetMidiTakeUsedCCLanes (MediaItem_Take* take, bool selectedEventsOnly, char* lanesOut, int lanesOut_sz)
+{
+	if (lanesOut && lanesOut_sz > 0)
+		lanesOut[0] = '\0';
+
+	const BR_MidiSnapshot* midi = BR_MidiSnapshot::Get(take);
+	if (!midi)
+		return 0;
+
+	set<int> usedCC = midi->GetUsedCCLanes(NULL, 2, selectedEventsOnly);
+	WDL_FastString lanes;
+	for (set<int>::iterator it = usedCC.begin(); it != usedCC.end(); ++it)
+		lanes.AppendFormatted(32, lanes.GetLength() ? ",%d" : "%d", MapVelLaneToReaScriptCC(*it));
+
+	if (lanesOut && lanesOut_sz > 0)
+		snprintf(lanesOut, lanesOut_sz, "%s", lanes.Get());
+	return (int)usedCC.size();
+}
+
 void BR_GetMouseCursorContext (char* windowOut, int windowOut_sz, char* segmentOut, int segmentOut_sz, char* detailsOut, int detailsOut_sz)
 {
 	g_mouseInfo.Update();
@@ -810,6 +1121,11 @@ void BR_SetMediaItemImageResource (MediaItem* item, const char* imageIn, int ima
 	}
 }
 
+int BR_SetMediaItemsInfo (ReaProject* proj, const char* items, const char* keys, const char* values)
+{
+	return SetBulkInfo(proj, items, true, keys, values);
+}
+
 bool BR_SetMediaSourceProperties (MediaItem_Take* take, bool section, double start, double length, double fade, bool reverse)
 {
 	return SetMediaSourceProperties(take, section, start, length, fade, reverse);
@@ -843,6 +1159,11 @@ bool BR_SetMediaTrackLayouts (MediaTrack* track, const char* mcpLayoutNameIn, co
 	return changedLayouts;
 }
 
+int BR_SetMediaTracksInfo (ReaProject* proj, const char* tracks, const char* keys, const char* values)
+{
+	return SetBulkInfo(proj, tracks, false, keys, values);
+}
+
 bool BR_SetMidiTakeTempoInfo (MediaItem_Take* take, bool ignoreProjTempo, double bpm, int num, int den)
 {
 	bool succes = false;
@@ -47,12 +47,14 @@ bool            BR_EnvSetPoint (BR_Envelope* envelope, int id, double position,
 void            BR_EnvSetProperties (BR_Envelope* envelope, bool active, bool visible, bool armed, bool inLane, int laneHeight, int defaultShape, bool faderScaling, int* AIoptions);
 void            BR_EnvSortPoints (BR_Envelope* envelope);
 double          BR_EnvValueAtPos (BR_Envelope* envelope, double position);
+int             BR_EnvValuesAtPos (BR_Envelope* envelope, const char* positions, bool fastMode, char* valuesOut, int valuesOut_sz);
 void            BR_GetArrangeView (ReaProject* proj, double* startPositionOut, double* endPositionOut);
 double          BR_GetClosestGridDivision (double position);
 void            BR_GetCurrentTheme (char* themePathOut, int themePathOut_sz, char* themeNameOut, int themeNameOut_sz);
 MediaItem*      BR_GetMediaItemByGUID (ReaProject* proj, const char* guidStringIn);
 void            BR_GetMediaItemGUID (MediaItem* item, char* guidStringOut, int guidStringOut_sz);
 bool            BR_GetMediaItemImageResource (MediaItem* item, char* imageOut, int imageOut_sz, int* imageFlagsOut);
+int             BR_GetMediaItemsInfo (ReaProject* proj, const char* items, const char* keys, char* valuesOut, int valuesOut_sz);
 void            BR_GetMediaItemTakeGUID (MediaItem_Take* take, char* guidStringOut, int guidStringOut_sz);
 bool            BR_GetMediaSourceProperties (MediaItem_Take* take, bool* sectionOut, double* startOut, double* lengthOut, double* fadeOut, bool* reverseOut);
 MediaTrack*     BR_GetMediaTrackByGUID (ReaProject* proj, const char* guidStringIn);
@@ -61,9 +63,11 @@ void            BR_GetMediaTrackGUID (MediaTrack* track, char* guidStringOut, in
 void            BR_GetMediaTrackLayouts (MediaTrack* track, char* mcpLayoutNameOut, int mcpLayoutNameOut_sz, char* tcpLayoutNameOut, int tcpLayoutNameOut_sz);
 TrackEnvelope*  BR_GetMediaTrackSendInfo_Envelope (MediaTrack* track, int category, int sendidx, int envelopeType);
 MediaTrack*     BR_GetMediaTrackSendInfo_Track (MediaTrack* track, int category, int sendidx, int trackType);
+int             BR_GetMediaTracksInfo (ReaProject* proj, const char* tracks, const char* keys, char* valuesOut, int valuesOut_sz);
 double          BR_GetMidiSourceLenPPQ (MediaItem_Take* take);
 bool            BR_GetMidiTakePoolGUID (MediaItem_Take* take, char* guidStringOut, int guidStringOut_sz);
 bool            BR_GetMidiTakeTempoInfo (MediaItem_Take* take, bool* ignoreProjTempoOut, double* bpmOut, int* numOut, int* denOut);
+int             BR_GetMidiTakeUsedCCLanes (MediaItem_Take* take, bool selectedEventsOnly, char* lanesOut, int lanesOut_sz);
 void            BR_GetMouseCursorContext (char* windowOut, int windowOut_sz, char* segmentOut, int segmentOut_sz, char* detailsOut, int detailsOut_sz);
 TrackEnvelope*  BR_GetMouseCursorContext_Envelope (bool* takeEnvelopeOut);
 TrackEnvelope*  BR_GetMouseCursorContext_EnvelopeEx (bool* takeEnvelopeOut, int* aiIdOut, int* pointIdOut);
@@ -86,8 +90,10 @@ double          BR_PositionAtMouseCursor (bool checkRuler);
 void            BR_SetArrangeView (ReaProject* proj, double startPosition, double endPosition);
 bool            BR_SetItemEdges (MediaItem* item, double startTime, double endTime);
 void            BR_SetMediaItemImageResource (MediaItem* item, const char* imageIn, int imageFlags);
+int             BR_SetMediaItemsInfo (ReaProject* proj, const char* items, const char* keys, const char* values);
 bool            BR_SetMediaSourceProperties (MediaItem_Take* take, bool section, double start, double length, double fade, bool reverse);
 bool            BR_SetMediaTrackLayouts (MediaTrack* track, const char* mcpLayoutNameIn, const char* tcpLayoutNameIn);
+int             BR_SetMediaTracksInfo (ReaProject* proj, const char* tracks, const char* keys, const char* values);
 bool            BR_SetMidiTakeTempoInfo (MediaItem_Take* take, bool ignoreProjTempo, double bpm, int num, int den);
 bool            BR_SetTakeSourceFromFile (MediaItem_Take* take, const char* filenameIn, bool inProjectData);
 bool            BR_SetTakeSourceFromFile2 (MediaItem_Take* take, const char* filenameIn, bool inProjectData, bool keepSourceProperties);
@@ -36,6 +36,7 @@
 #include "BR_MouseUtil.h"
 #include "BR_TempoDlg.h"
 #include "BR_Util.h"
+#include "../Fingers/TimeMap.h"
 #include "../SnM/SnM_Util.h"
 
 #include <WDL/localize/localize.h>
@@ -1187,6 +1188,7 @@ void DeleteTempoPreserveItems (COMMAND_T* ct)
 	const int timeBase = ConfigVar<int>("tempoenvtimelock").value_or(0);
 	if (timeBase != 0)
 	{
+		const RprTempoMap& timeMap = RprTempoMap::get();
 		double offset = 0;
 		for (int i = 0; i < tempoMap.CountConseq(); ++i)
 		{
@@ -1202,8 +1204,8 @@ void DeleteTempoPreserveItems (COMMAND_T* ct)
 				t0 -= offset; // last unselected point before next selection - readjust position to original (earlier iterations moved it)
 
 				int startMeasure, endMeasure, num, den;
-				double startBeats = TimeMap2_timeToBeats(NULL, t0, &startMeasure, &num, NULL, &den);
-				double endBeats   = TimeMap2_timeToBeats(NULL, t1, &endMeasure, NULL, NULL, NULL);
+				double startBeats = timeMap.timeToBeats(t0, &startMeasure, &num, &den);
+				double endBeats   = timeMap.timeToBeats(t1, &endMeasure, NULL, NULL);
 				double beatCount = endBeats - startBeats + num * (endMeasure - startMeasure);
 
 				if (s0 == SQUARE)
@@ -1386,6 +1388,7 @@ void TempoShapeLinear (COMMAND_T* ct)
 	int skipped = 0;
 	int count = tempoMap.CountPoints()-1;
 	vector<double> stretchMarkers;
+	const RprTempoMap& timeMap = RprTempoMap::get(); // tempo map only gets committed at the end
 	for (int i = 0; i < tempoMap.CountSelected(); ++i)
 	{
 		int id = tempoMap.GetSelected(i);
@@ -1422,9 +1425,9 @@ void TempoShapeLinear (COMMAND_T* ct)
 					{
 						stretchMarkers.push_back(t0);
 
-						double t0_QN = TimeMap_timeToQN_abs(NULL, t0);
-						double t1_QN = TimeMap_timeToQN_abs(NULL, t1);
-						stretchMarkers.push_back(TimeMap_QNToTime_abs(NULL, (t0_QN + t1_QN) / 2));
+						double t0_QN = timeMap.timeToQNAbs(t0);
+						double t1_QN = timeMap.timeToQNAbs(t1);
+						stretchMarkers.push_back(timeMap.qnAbsToTime((t0_QN + t1_QN) / 2));
 
 						stretchMarkers.push_back(t1);
 					}
@@ -1444,14 +1447,14 @@ void TempoShapeLinear (COMMAND_T* ct)
 				{
 					stretchMarkers.push_back(t0);
 
-					double t0_QN = TimeMap_timeToQN_abs(NULL, t0);
-					double t1_QN = TimeMap_timeToQN_abs(NULL, t1);
+					double t0_QN = timeMap.timeToQNAbs(t0);
+					double t1_QN = timeMap.timeToQNAbs(t1);
 					double lenHalfQ = (t1_QN - t0_QN) / 2;
 
 					if (tempoMap.CreatePoint(tempoMap.CountPoints(), position1, bpm1, LINEAR, 0, false))
-						stretchMarkers.push_back(TimeMap_QNToTime_abs(NULL, lenHalfQ * (1 - splitRatio) + t0_QN));
+						stretchMarkers.push_back(timeMap.qnAbsToTime(lenHalfQ * (1 - splitRatio) + t0_QN));
 					if (tempoMap.CreatePoint(tempoMap.CountPoints(), position2, bpm2, LINEAR, 0, false))
-						stretchMarkers.push_back(TimeMap_QNToTime_abs(NULL, lenHalfQ * (splitRatio) + t0_QN + lenHalfQ));
+						stretchMarkers.push_back(timeMap.qnAbsToTime(lenHalfQ * (splitRatio) + t0_QN + lenHalfQ));
 
 					stretchMarkers.push_back(t1);
 				}
@@ -1496,6 +1499,7 @@ void TempoShapeSquare (COMMAND_T* ct)
 	int skipped = 0;
 	int count = tempoMap.CountPoints()-1;
 	vector<double> stretchMarkers;
+	const RprTempoMap& timeMap = RprTempoMap::get(); // tempo map only gets committed at the end
 	for (int i = 0; i < tempoMap.CountSelected(); ++i)
 	{
 		int id = tempoMap.GetSelected(i);
@@ -1549,9 +1553,9 @@ void TempoShapeSquare (COMMAND_T* ct)
 					{
 						stretchMarkers.push_back(t0);
 
-						double t0_QN = TimeMap_timeToQN_abs(NULL, t0);
-						double t1_QN = TimeMap_timeToQN_abs(NULL, t1);
-						stretchMarkers.push_back(TimeMap_QNToTime_abs(NULL, (t0_QN + t1_QN) / 2));
+						double t0_QN = timeMap.timeToQNAbs(t0);
+						double t1_QN = timeMap.timeToQNAbs(t1);
+						stretchMarkers.push_back(timeMap.qnAbsToTime((t0_QN + t1_QN) / 2));
 
 						stretchMarkers.push_back(t1);
 					}
@@ -1570,14 +1574,14 @@ void TempoShapeSquare (COMMAND_T* ct)
 				{
 					stretchMarkers.push_back(t0);
 
-					double t0_QN = TimeMap_timeToQN_abs(NULL, t0);
-					double t1_QN = TimeMap_timeToQN_abs(NULL, t1);
+					double t0_QN = timeMap.timeToQNAbs(t0);
+					double t1_QN = timeMap.timeToQNAbs(t1);
 					double lenHalfQ = (t1_QN - t0_QN) / 2;
 
 					if (tempoMap.CreatePoint(tempoMap.CountPoints(), position1, bpm1, LINEAR, 0, false))
-						stretchMarkers.push_back(TimeMap_QNToTime_abs(NULL, lenHalfQ * (1 - splitRatio) + t0_QN));
+						stretchMarkers.push_back(timeMap.qnAbsToTime(lenHalfQ * (1 - splitRatio) + t0_QN));
 					if (tempoMap.CreatePoint(tempoMap.CountPoints(), position2, bpm2, LINEAR, 0, false))
-						stretchMarkers.push_back(TimeMap_QNToTime_abs(NULL, lenHalfQ * (splitRatio)+t0_QN + lenHalfQ));
+						stretchMarkers.push_back(timeMap.qnAbsToTime(lenHalfQ * (splitRatio)+t0_QN + lenHalfQ));
 
 					stretchMarkers.push_back(t1);
 				}
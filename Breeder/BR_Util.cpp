@@ -669,9 +669,173 @@ bool TcpVis (MediaTrack* track)
 		return false;
 }
 
+MediaTrack* GetTcpTrackFromY (int y, int* trackY /*=NULL*/, int* trackH /*=NULL*/)
+{
+	/* Visible tracks are laid out top to bottom, so binary search the first *
+	*  one (master included) whose area ends below y. Hidden tracks take the  *
+	*  result of the next visible track which keeps the search monotonic     */
+	const int count = GetNumTracks() + 1; // 0 is master
+	int lo = 0, hi = count;
+	while (lo < hi)
+	{
+		const int mid = (lo + hi) / 2;
+		int id = mid;
+		MediaTrack* track = NULL;
+		while (id < hi && !TcpVis(track = CSurf_TrackFromID(id, false)))
+			++id;
+
+		if (id < hi && (int)GetMediaTrackInfo_Value(track, "I_TCPY") + (int)GetMediaTrackInfo_Value(track, "I_WNDH") <= y)
+			lo = id + 1;
+		else
+			hi = mid;
+	}
+
+	MediaTrack* track = NULL;
+	while (lo < count && !TcpVis(track = CSurf_TrackFromID(lo, false)))
+		++lo;
+	if (lo >= count)
+		track = NULL;
+
+	if (track)
+	{
+		const int spacer = GetTrackSpacerSize(track);
+		int top = (int)GetMediaTrackInfo_Value(track, "I_TCPY") - spacer;
+		int height = (int)GetMediaTrackInfo_Value(track, "I_WNDH") + spacer;
+
+		// Gap below master belongs to master
+		MediaTrack* master = GetMasterTrack(NULL);
+		if (track != master && y < top && TcpVis(master))
+		{
+			const int masterTop = (int)GetMediaTrackInfo_Value(master, "I_TCPY") - GetTrackSpacerSize(master);
+			height = top - masterTop;
+			top = masterTop;
+			track = master;
+		}
+		WritePtr(trackY, top);
+		WritePtr(trackH, height);
+	}
+	else
+	{
+		WritePtr(trackY, 0);
+		WritePtr(trackH, 0);
+	}
+	return track;
+}
+
 /******************************************************************************
 * Items and takes                                                             *
 ******************************************************************************/
+/* Items of a track indexed by start with prefix maximum of their ends (a   *
+*  lighter stand-in for an interval tree). Each track is rebuilt on its own *
+*  first query after project state or its item count changes. Moves during  *
+*  mouse edits don't touch the state change count so the index isn't used  *
+*  while a mouse button is down, and hits are verified against live values */
+struct BR_TrackItemIndex
+{
+	int stateCount;
+	vector<pair<double,int> > starts; // sorted, item id
+	vector<double> maxEnds;           // maximum end of starts[0..i]
+	BR_TrackItemIndex () : stateCount(-1) {}
+};
+
+static map<MediaTrack*,BR_TrackItemIndex> g_itemIndex;
+
+static bool IsMouseEditing ()
+{
+	return (GetAsyncKeyState(VK_LBUTTON) & 0x8000) || (GetAsyncKeyState(VK_RBUTTON) & 0x8000) || (GetAsyncKeyState(VK_MBUTTON) & 0x8000);
+}
+
+static BR_TrackItemIndex* GetTrackItemIndex (MediaTrack* track, bool rebuild)
+{
+	if (IsMouseEditing())
+		return NULL;
+
+	// Deleted tracks are only dropped here, their entries are never read since a new track at the same address is rebuilt
+	if ((int)g_itemIndex.size() > 2 * (CountTracks(NULL) + 1))
+		g_itemIndex.clear();
+
+	const int stateCount = GetProjectStateChangeCount(NULL);
+	const int itemCount = CountTrackMediaItems(track);
+	BR_TrackItemIndex& index = g_itemIndex[track];
+	if (rebuild || index.stateCount != stateCount || (int)index.starts.size() != itemCount)
+	{
+		index.stateCount = stateCount;
+		index.starts.resize(itemCount);
+		index.maxEnds.resize(itemCount);
+		vector<double> ends(itemCount);
+		for (int i = 0; i < itemCount; ++i)
+		{
+			MediaItem* item = GetTrackMediaItem(track, i);
+			const double start = GetMediaItemInfo_Value(item, "D_POSITION");
+			index.starts[i] = make_pair(start, i);
+			ends[i] = start + GetMediaItemInfo_Value(item, "D_LENGTH");
+		}
+		sort(index.starts.begin(), index.starts.end());
+		for (int i = 0; i < itemCount; ++i)
+			index.maxEnds[i] = (i > 0) ? max(index.maxEnds[i-1], ends[index.starts[i].second]) : ends[index.starts[i].second];
+	}
+	return &index;
+}
+
+// Returns first item id (in track order) containing position, -2 if the index turns out stale
+static int FindItemInIndex (MediaTrack* track, const BR_TrackItemIndex& index, double position)
+{
+	int i = (int)(upper_bound(index.starts.begin(), index.starts.end(), make_pair(position, INT_MAX)) - index.starts.begin()) - 1;
+	int firstId = -1;
+	for (; i >= 0 && index.maxEnds[i] >= position; --i)
+	{
+		const int id = index.starts[i].second;
+		if (firstId != -1 && id > firstId)
+			continue;
+
+		MediaItem* item = GetTrackMediaItem(track, id);
+		const double start = GetMediaItemInfo_Value(item, "D_POSITION");
+		if (start != index.starts[i].first)
+			return -2;
+		if (position >= start && position <= start + GetMediaItemInfo_Value(item, "D_LENGTH"))
+			firstId = id;
+	}
+	return firstId;
+}
+
+MediaItem* GetItemAtPosition (MediaTrack* track, double position)
+{
+	if (!track)
+		return NULL;
+
+	if (BR_TrackItemIndex* index = GetTrackItemIndex(track, false))
+	{
+		int id = FindItemInIndex(track, *index, position);
+		if (id == -2)
+			id = FindItemInIndex(track, *GetTrackItemIndex(track, true), position);
+		if (id != -2)
+			return (id >= 0) ? GetTrackMediaItem(track, id) : NULL;
+	}
+
+	const int count = CountTrackMediaItems(track);
+	for (int i = 0; i < count; ++i)
+	{
+		MediaItem* item = GetTrackMediaItem(track, i);
+		const double start = GetMediaItemInfo_Value(item, "D_POSITION");
+		if (position >= start && position <= start + GetMediaItemInfo_Value(item, "D_LENGTH"))
+			return item;
+	}
+	return NULL;
+}
+
+bool MayHaveItemInRange (MediaTrack* track, double start, double end)
+{
+	if (!track)
+		return false;
+
+	const BR_TrackItemIndex* index = GetTrackItemIndex(track, false);
+	if (!index)
+		return true;
+
+	const int i = (int)(upper_bound(index->starts.begin(), index->starts.end(), make_pair(end, INT_MAX)) - index->starts.begin()) - 1;
+	return i >= 0 && index->maxEnds[i] >= start;
+}
+
 vector<MediaItem*> GetSelItems (MediaTrack* track)
 {
 	vector<MediaItem*> items;
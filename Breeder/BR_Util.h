@@ -123,10 +123,13 @@ PCM_source* DuplicateSource (PCM_source* source); // if the option "Toggle poole
 int GetEffectiveCompactLevel (MediaTrack* track);           // displayed compact level is determined by the highest compact level of any successive parent
 int GetTrackFreezeCount (MediaTrack* track);
 bool TcpVis (MediaTrack* track);
+MediaTrack* GetTcpTrackFromY (int y, int* trackY = NULL, int* trackH = NULL); // y is relative to arrange view top (like I_TCPY), returns first track whose area (spacer and envelopes included) ends below y, gap below master belongs to master
 
 /******************************************************************************
 * Items and takes                                                             *
 ******************************************************************************/
+MediaItem* GetItemAtPosition (MediaTrack* track, double position);           // first item in track containing position, looked up in a per-track index
+bool MayHaveItemInRange (MediaTrack* track, double start, double end);     // false only if no item of track overlaps start-end, true while mouse editing (index not usable)
 vector<MediaItem*> GetSelItems (MediaTrack* track);
 double ProjectTimeToItemTime (MediaItem* item, double projTime);
 double ItemTimeToProjectTime (MediaItem* item, double itemTime);
@@ -43,6 +43,16 @@
 
 ReaConsoleWnd* g_pConsoleWnd = NULL;
 static WDL_TypedBuf<int> g_selTracks;
+
+// Track lookup index, so that parsing/processing commands doesn't go through
+// every track with the API (invalidated on track list and track name changes)
+static struct
+{
+	bool valid;
+	std::vector<MediaTrack*> tracks;                 // [track number - 1]
+	std::vector<std::string> names;                  // lower case, same order
+	std::vector<std::pair<std::string, int> > sorted; // non-empty names, sorted for prefix matches
+} g_trackIndex = { false };
 static char g_cLastKey = 0;
 static DWORD g_dwLastKeyMsg = 0;
 #define CONSOLE_WINDOWPOS_KEY "ReaConsoleWindowPos"
@@ -109,6 +119,52 @@ static console_COMMAND_T g_commands[NUM_COMMANDS] =
 };
 //!WANT_LOCALIZE_STRINGS_END
 
+static std::string ToLowerName(const char* name)
+{
+	std::string lower(name ? name : "");
+	for (size_t i = 0; i < lower.size(); i++)
+		lower[i] = (char)tolower((unsigned char)lower[i]);
+	return lower;
+}
+
+static void UpdateTrackIndex()
+{
+	const int numTracks = GetNumTracks();
+	if (g_trackIndex.valid && (int)g_trackIndex.tracks.size() == numTracks)
+		return;
+
+	g_trackIndex.tracks.resize(numTracks);
+	g_trackIndex.names.resize(numTracks);
+	g_trackIndex.sorted.clear();
+	for (int i = 0; i < numTracks; i++)
+	{
+		MediaTrack* tr = CSurf_TrackFromID(i+1, false);
+		g_trackIndex.tracks[i] = tr;
+		g_trackIndex.names[i] = ToLowerName((const char*)GetSetMediaTrackInfo(tr, "P_NAME", NULL));
+		if (!g_trackIndex.names[i].empty())
+			g_trackIndex.sorted.push_back(std::make_pair(g_trackIndex.names[i], i));
+	}
+	std::sort(g_trackIndex.sorted.begin(), g_trackIndex.sorted.end());
+	g_trackIndex.valid = true;
+}
+
+// First entry of g_trackIndex.sorted whose name starts with (lower case) prefix, entries
+// starting with prefix follow (see IsPrefixMatch)
+static std::vector<std::pair<std::string, int> >::const_iterator FindPrefix(const std::string& prefix)
+{
+	return std::lower_bound(g_trackIndex.sorted.begin(), g_trackIndex.sorted.end(), std::make_pair(prefix, -1));
+}
+
+static bool IsPrefixMatch(std::vector<std::pair<std::string, int> >::const_iterator it, const std::string& prefix)
+{
+	return it != g_trackIndex.sorted.end() && !it->first.compare(0, prefix.size(), prefix);
+}
+
+void ConsoleTrackListChange()
+{
+	g_trackIndex.valid = false;
+}
+
 // Split into various categories, independent of actually having a correct and/or finished command string
 // Basically just a fancy tokenizer
 CONSOLE_COMMAND ParseConsoleCommand(char* strCommand, char** trackid, char** args)
@@ -199,6 +255,9 @@ void ParseTrackId(char* strId, bool bReset)
 	if (!strId || !GetNumTracks())
 		return;
 
+	UpdateTrackIndex();
+	const int numTracks = (int)g_trackIndex.tracks.size();
+
 	if (bReset)
 	{
 		g_selTracks.Resize(GetNumTracks(), false);
@@ -244,17 +303,17 @@ void ParseTrackId(char* strId, bool bReset)
 
 	// If the string is "all" or exactly "*", select all tracks.
 	if (_stricmp(strId, __LOCALIZE("all","sws_DLG_100")) == 0 || strcmp(strId, "*") == 0)
-		for (track = 0; track < GetNumTracks(); track++)
+		for (track = 0; track < numTracks; track++)
 			g_selTracks.Get()[track] = 1;
 
 	// If the string is empty, use the tracks' selected flags
 	else if (strId[0] == 0)
-		for (track = 0; track < GetNumTracks(); track++)
+		for (track = 0; track < numTracks; track++)
 		{
 			// If tracks were selected before (because of a comma separated list) don't change it here.
 			if (g_selTracks.Get()[track])
 				break;
-			int iSel = *((int*)GetSetMediaTrackInfo(CSurf_TrackFromID(track+1, false), "I_SELECTED", NULL));
+			int iSel = *((int*)GetSetMediaTrackInfo(g_trackIndex.tracks[track], "I_SELECTED", NULL));
 			g_selTracks.Get()[track] = iSel;
 		}
 
@@ -273,8 +332,8 @@ void ParseTrackId(char* strId, bool bReset)
 		int end = atol(p+1);
 		if (start < 1)
 			start = 1;
-		if (end > GetNumTracks())
-			end = GetNumTracks();
+		if (end > numTracks)
+			end = numTracks;
 		for (track = start-1; track < end; track++)
 			g_selTracks.Get()[track] = 1;
 	}
@@ -282,62 +341,65 @@ void ParseTrackId(char* strId, bool bReset)
 	// If a wildcard is in the string, use loose matches
 	else if ((p = strchr(strId, '*')) != NULL)
 	{
-		char* strMatch = NULL;
-		for (track = 0; track < GetNumTracks(); track++)
+		const std::string id = ToLowerName(strId);
+		const size_t len = id.size();
+
+		// Trailing wildcard only: prefix match on the sorted names
+		if ((size_t)(p-strId) == len - 1)
+		{
+			const std::string prefix = id.substr(0, len - 1);
+			for (std::vector<std::pair<std::string, int> >::const_iterator it = FindPrefix(prefix); IsPrefixMatch(it, prefix); ++it)
+				g_selTracks.Get()[it->second] = 1;
+		}
+		else
 		{
-			cName = (const char*)GetSetMediaTrackInfo(CSurf_TrackFromID(track+1, false), "P_NAME", NULL);
-			if (cName && cName[0])
+			for (track = 0; track < numTracks; track++)
 			{
-				if (p == strId && _strnicmp(strId+1, cName+1+strlen(cName)-strlen(strId), strlen(strId)-1) == 0)
-					g_selTracks.Get()[track] = 1;
-				else if (p-strId == strlen(strId) - 1 && _strnicmp(strId, cName, strlen(strId)-1) == 0)
+				const std::string& name = g_trackIndex.names[track];
+				if (name.empty())
+					continue;
+				if (p == strId && name.size() >= len - 1 && !name.compare(name.size() - (len - 1), len - 1, id, 1, len - 1))
 					g_selTracks.Get()[track] = 1;
 				// This "should" be the double wildcard case, but check anyway
-				else if (strId[0] == '*' && strlen(strId) > 2 && strId[strlen(strId)-1] == '*')
-				{
-					if (!strMatch)
-					{
-						strMatch = new char[strlen(strId)-1];
-						lstrcpyn(strMatch, strId+1, (int)strlen(strId)-1);
-					}
-					if (stristr(cName, strMatch))
-						g_selTracks.Get()[track] = 1;
-				}
+				else if (id[0] == '*' && len > 2 && id[len-1] == '*' && name.find(id.substr(1, len - 2)) != std::string::npos)
+					g_selTracks.Get()[track] = 1;
 			}
 		}
-		delete [] strMatch;
 	}
 	// Check for exact numeric
-	else if ((track = atol(strId)) > 0 && track <= GetNumTracks())
+	else if ((track = atol(strId)) > 0 && track <= numTracks)
 		g_selTracks.Get()[track-1] = 1;
 
 	// Check for exact name matches, with "auto compelete"
 	//   e.g. if there's no exact match, but only one track that starts with the string, select that one
 	else
 	{
+		const std::string id = ToLowerName(strId);
+		const int iNumber = atol(strId);
 		int iCloseMatch = 0;
 		int iExactMatch = 0;
-		int iMatchedTrack;
-		for (track = 0; track < GetNumTracks(); track++)
+		int iMatchedTrack = -1;
+
+		// Exact number match
+		if (iNumber > 0 && iNumber <= numTracks)
+		{
+			iExactMatch++;
+			g_selTracks.Get()[iNumber-1] = 1;
+		}
+
+		for (std::vector<std::pair<std::string, int> >::const_iterator it = FindPrefix(id); IsPrefixMatch(it, id); ++it)
 		{
-			cName = (const char*)GetSetMediaTrackInfo(CSurf_TrackFromID(track+1, false), "P_NAME", NULL);
 			// Exact name match
-			if (cName[0] && _stricmp(strId, cName) == 0)
-			{
-				iExactMatch++;
-				g_selTracks.Get()[track] = 1;
-			}
-			// Exact number match
-			else if (atol(strId) == track+1)
+			if (it->first.size() == id.size())
 			{
 				iExactMatch++;
-				g_selTracks.Get()[track] = 1;
+				g_selTracks.Get()[it->second] = 1;
 			}
 			// Check for close match
-			else if (cName[0] && _strnicmp(strId, cName, strlen(strId)) == 0)
+			else if (it->second != iNumber-1)
 			{
 				iCloseMatch++;
-				iMatchedTrack = track;
+				iMatchedTrack = it->second;
 			}
 		}
 
@@ -350,9 +412,9 @@ void ParseTrackId(char* strId, bool bReset)
 		int iParentDepth;
 		bool bSelected = false;
 		MediaTrack* gfd = NULL;
-		for (int i = 0; i < GetNumTracks(); i++)
+		for (int i = 0; i < numTracks; i++)
 		{
-			MediaTrack* tr = CSurf_TrackFromID(i+1, false);
+			MediaTrack* tr = g_trackIndex.tracks[i];
 			int iType;
 			int iFolder = GetFolderDepth(tr, &iType, &gfd);
 
@@ -372,7 +434,7 @@ void ParseTrackId(char* strId, bool bReset)
 
 	if (bInvert)
 	{
-		for (int i = 0; i < GetNumTracks(); i++)
+		for (int i = 0; i < numTracks; i++)
 			g_selTracks.Get()[i] = g_selTracks.Get()[i] ? 0 : 1;
 	}
 }
@@ -430,9 +492,19 @@ void ProcessCommand(CONSOLE_COMMAND command, const char* args)
 		return;
 	}
 
-	for (int track = 0; track < GetNumTracks(); track++)
+	// Resolve targets once, commands that work only on the selected tracks skip the others
+	UpdateTrackIndex();
+	const bool bExclusive = command == SOLO_EXCLUSIVE || command == MUTE_EXCLUSIVE || command == ARM_EXCLUSIVE ||
+	                        command == PHASE_EXCLUSIVE || command == SELECT_EXCLUSIVE || command == FX_EXCLUSIVE;
+	const int numTracks = min((int)g_trackIndex.tracks.size(), g_selTracks.GetSize());
+
+	PreventUIRefresh(1);
+	for (int track = 0; track < numTracks; track++)
 	{
-		MediaTrack* pMt = CSurf_TrackFromID(track+1, false);
+		if (!bExclusive && !g_selTracks.Get()[track])
+			continue;
+
+		MediaTrack* pMt = g_trackIndex.tracks[track];
 		// Do the class of commands that works only on the selected track
 		if (g_selTracks.Get()[track])
 		{
@@ -645,6 +717,10 @@ void ProcessCommand(CONSOLE_COMMAND command, const char* args)
 			break;
 		}
 	}
+	PreventUIRefresh(-1);
+
+	if (command == NAME_SET || command == NAME_PREFIX || command == NAME_SUFFIX)
+		ConsoleTrackListChange();
 }
 
 // Provide a human readable string of what's up:
@@ -669,9 +745,11 @@ const char* StatusString(CONSOLE_COMMAND command, const char* args)
 
 	if (!(g_commands[command].iNumArgs & NOTRACK_ARG))
 	{
+		UpdateTrackIndex();
+		const int numTracks = min((int)g_trackIndex.tracks.size(), g_selTracks.GetSize());
 		int previous_n = n;
 		bool all = true;
-		for (int i = 0; i < GetNumTracks(); i++)
+		for (int i = 0; i < numTracks; i++)
 			if (!g_selTracks.Get()[i])
 			{
 				all = false;
@@ -683,10 +761,10 @@ const char* StatusString(CONSOLE_COMMAND command, const char* args)
 		}
 		else
 		{
-			for (int i = 0; i < GetNumTracks(); i++)
+			for (int i = 0; i < numTracks; i++)
 				if (g_selTracks.Get()[i])
 				{
-					const char* cName = (const char*)GetSetMediaTrackInfo(CSurf_TrackFromID(i+1, false), "P_NAME", NULL);
+					const char* cName = (const char*)GetSetMediaTrackInfo(g_trackIndex.tracks[i], "P_NAME", NULL);
 					if (strlen(cName) + n + 20 >= 512)
 						// Really grunge string overflow check.  Can't see the status string past two lines anyway.
 						return status;
@@ -89,6 +89,7 @@ int ConsoleInit();
 void ConsoleExit();
 CONSOLE_COMMAND ParseConsoleCommand(char *strCommand, char **trackid, char **args);
 void RunConsoleCommand(const char* cmd);
+void ConsoleTrackListChange();
 bool LoadConsoleCmds(WDL_PtrList<WDL_FastString>* _outCmds);
 
 class ReaConsoleWnd : public SWS_DockWnd
@@ -181,7 +181,7 @@ static bool convertToInProjectMidi(RprItemCtrPtr &ctr)
     return true;
 }
 
-static void applyGrooveToMidiTake(RprMidiTake &midiTake, double beatDivider, double positionStrength, double velocityStrength,
+static void applyGrooveToMidiTake(const RprTempoMap &tempoMap, RprMidiTake &midiTake, double beatDivider, double positionStrength, double velocityStrength,
                                   std::vector<GrooveItem> &grooveBeats, bool selectedOnly)
 {
     RprItem rprItem = *midiTake.getParent();
@@ -189,17 +189,17 @@ static void applyGrooveToMidiTake(RprMidiTake &midiTake, double beatDivider, dou
         RprMidiNote *note = midiTake.getNoteAt(i);
         if(selectedOnly && !note->isSelected())
             continue;
-        double noteBeat = TimeToBeat(note->getPosition());
+        double noteBeat = TimeToBeat(tempoMap, note->getPosition());
         GrooveItem grooveItem;
-        if(!GetGrooveBeatPosition(noteBeat, BeatsInMeasure(BeatToMeasure(noteBeat)) / beatDivider, positionStrength, &grooveBeats, grooveItem))
+        if(!GetGrooveBeatPosition(noteBeat, BeatsInMeasure(tempoMap, BeatToMeasure(tempoMap, noteBeat)) / beatDivider, positionStrength, &grooveBeats, grooveItem))
             continue;
 
                 /* fudge factor for issue 348 */
                 static const double epsilon = 0.0000000001;
-        double itemFirstBeat = TimeToBeat(rprItem.getPosition()) - epsilon;
-        double itemLastBeat = TimeToBeat(rprItem.getPosition() + rprItem.getLength());
+        double itemFirstBeat = TimeToBeat(tempoMap, rprItem.getPosition()) - epsilon;
+        double itemLastBeat = TimeToBeat(tempoMap, rprItem.getPosition() + rprItem.getLength());
         if(grooveItem.position >= itemFirstBeat && grooveItem.position < itemLastBeat) {
-            note->setPosition(BeatToTime(grooveItem.position));
+            note->setPosition(BeatToTime(tempoMap, grooveItem.position));
             if(grooveItem.amplitude >= 0.0) {
                 int newVelocity = (int)(grooveItem.amplitude * 127.5);
                 int difference = newVelocity - note->getVelocity();
@@ -233,12 +233,12 @@ static double getRightEdgeOfMidiTake(RprMidiTakePtr &take)
     return rightEdge;
 }
 
-static void createGrooveVector(double leftEdge, double rightEdge, std::vector<GrooveItem> &inputGrooveBeats, int nBeatsInGroove, std::vector<GrooveItem> &outputGrooveBeats)
+static void createGrooveVector(const RprTempoMap &tempoMap, double leftEdge, double rightEdge, std::vector<GrooveItem> &inputGrooveBeats, int nBeatsInGroove, std::vector<GrooveItem> &outputGrooveBeats)
 {
     /* create vector of positions which is longer then the total length of the items */
-    int beatCount = (int)ceil(TimeToBeat(rightEdge) - TimeToBeat(leftEdge));
-    int firstMeasure = TimeToMeasure(leftEdge);
-    double beatsTillFirstMeasure = BeatsTillMeasure(firstMeasure);
+    int beatCount = (int)ceil(TimeToBeat(tempoMap, rightEdge) - TimeToBeat(tempoMap, leftEdge));
+    int firstMeasure = TimeToMeasure(tempoMap, leftEdge);
+    double beatsTillFirstMeasure = BeatsTillMeasure(tempoMap, firstMeasure);
 
     for(int i = -nBeatsInGroove; i < beatCount + nBeatsInGroove; i += nBeatsInGroove) {
         for(std::vector<GrooveItem>::iterator j = inputGrooveBeats.begin(); j != inputGrooveBeats.end(); j++) {
@@ -259,14 +259,14 @@ bool treatAsMidiTake(RprMidiTake &midiTake)
     return false;
 }
 
-void applyGrooveToItem(RprItem &rprItem, double beatDivider, double strength, std::vector<GrooveItem> &grooveBeats)
+void applyGrooveToItem(const RprTempoMap &tempoMap, RprItem &rprItem, double beatDivider, double strength, std::vector<GrooveItem> &grooveBeats)
 {
-    double beatPosition = TimeToBeat(rprItem.getPosition() + rprItem.getSnapOffset());
+    double beatPosition = TimeToBeat(tempoMap, rprItem.getPosition() + rprItem.getSnapOffset());
     GrooveItem grooveItem;
-    if(!GetGrooveBeatPosition(beatPosition, BeatsInMeasure(BeatToMeasure(beatPosition)) / beatDivider, strength, &grooveBeats, grooveItem))
+    if(!GetGrooveBeatPosition(beatPosition, BeatsInMeasure(tempoMap, BeatToMeasure(tempoMap, beatPosition)) / beatDivider, strength, &grooveBeats, grooveItem))
         return;
 
-    double timePosition = BeatToTime(grooveItem.position) - rprItem.getSnapOffset();
+    double timePosition = BeatToTime(tempoMap, grooveItem.position) - rprItem.getSnapOffset();
     /* Change amplitude for items?? Maybe in the future...*/
     /* How does velocity map to item volumes and vice versa... */
     if(timePosition >= 0.0f)
@@ -283,13 +283,14 @@ void GrooveTemplateHandler::ApplyGrooveToMidiEditor(int beatDivider, double posS
     if(me->grooveInBeats.size() == 0)
         return;
 
+    const RprTempoMap &tempoMap = RprTempoMap::get();
     std::vector<GrooveItem> grooveBeats;
-    createGrooveVector(takePtr->getNoteAt(0)->getPosition(),
+    createGrooveVector(tempoMap, takePtr->getNoteAt(0)->getPosition(),
         getRightEdgeOfMidiTake(takePtr),
         me->grooveInBeats,
         me->nBeatsInGroove,
         grooveBeats);
-    applyGrooveToMidiTake(*takePtr.get(), (double)beatDivider, posStrength, velStrength, grooveBeats, true);
+    applyGrooveToMidiTake(tempoMap, *takePtr.get(), (double)beatDivider, posStrength, velStrength, grooveBeats, true);
 }
 
 
@@ -310,9 +311,10 @@ void GrooveTemplateHandler::ApplyGroove(int beatDivider, double posStrength, dou
         return;
 
     ctr->sort();
+    const RprTempoMap &tempoMap = RprTempoMap::get();
     std::vector<GrooveItem> grooveBeats;
 
-    createGrooveVector(ctr->first().getPosition() + ctr->first().getSnapOffset(),
+    createGrooveVector(tempoMap, ctr->first().getPosition() + ctr->first().getSnapOffset(),
         getRightEdgeOfContainer(ctr),
         me->grooveInBeats,
         me->nBeatsInGroove,
@@ -322,15 +324,15 @@ void GrooveTemplateHandler::ApplyGroove(int beatDivider, double posStrength, dou
     for(int i = 0; i < ctr->size(); i++) {
         RprItem rprItem = ctr->getAt(i);
         if(!rprItem.getActiveTake().isMIDI()) {
-            applyGrooveToItem(rprItem, (double)beatDivider, posStrength, grooveBeats);
+            applyGrooveToItem(tempoMap, rprItem, (double)beatDivider, posStrength, grooveBeats);
             continue;
         }
 
         RprMidiTake midiTake(rprItem.getActiveTake());
         if(treatAsMidiTake(midiTake))
-            applyGrooveToMidiTake(midiTake, (double)beatDivider, posStrength, velStrength, grooveBeats, false);
+            applyGrooveToMidiTake(tempoMap, midiTake, (double)beatDivider, posStrength, velStrength, grooveBeats, false);
         else
-            applyGrooveToItem(rprItem, (double)beatDivider, posStrength, grooveBeats);
+            applyGrooveToItem(tempoMap, rprItem, (double)beatDivider, posStrength, grooveBeats);
 
     }
     UpdateTimeline();
@@ -364,7 +366,7 @@ std::string GrooveTemplateHandler::GetGrooveMarkerString(int index)
     return "";
 }
 
-static int GetMidiBeatPositions(RprMidiTake &midiTake, const RprItem &parent, std::vector<GrooveItem> &vPositions, bool selectedOnly)
+static int GetMidiBeatPositions(const RprTempoMap &tempoMap, RprMidiTake &midiTake, const RprItem &parent, std::vector<GrooveItem> &vPositions, bool selectedOnly)
 {
     double takeLength = parent.getPosition() + parent.getLength();
     for(int i = 0; i < midiTake.countNotes(); i++) {
@@ -376,7 +378,7 @@ static int GetMidiBeatPositions(RprMidiTake &midiTake, const RprItem &parent, st
         if (notePosition < takeLength) {
             GrooveItem grooveItem;
             grooveItem.amplitude = noteAmplitude;
-            grooveItem.position = TimeToBeat(notePosition);
+            grooveItem.position = TimeToBeat(tempoMap, notePosition);
             vPositions.push_back(grooveItem);
         }
     }
@@ -393,7 +395,7 @@ static bool isGrooveItemUnique(const GrooveItem &lhs, const GrooveItem &rhs)
     return lhs.position == rhs.position;
 }
 
-static void finalizeGroove(int &beatsInGroove, std::vector<GrooveItem> &grooveInBeats)
+static void finalizeGroove(const RprTempoMap &tempoMap, int &beatsInGroove, std::vector<GrooveItem> &grooveInBeats)
 {
     if (grooveInBeats.size() == 0)
     {
@@ -412,8 +414,8 @@ static void finalizeGroove(int &beatsInGroove, std::vector<GrooveItem> &grooveIn
      * first position to the start of the measure.
      * Use 1/960 as the default midi ticks per qn is 960 so the resolution is appropriate. */
     double fudge = 1.0 / 960.0;
-    double beatsTillStartOfGrooveMeasure = BeatsTillMeasure(BeatToMeasure(i->position));
-    double beatsTillStartOfGrooveMeasureWithFudge = BeatsTillMeasure(BeatToMeasure(i->position + fudge));
+    double beatsTillStartOfGrooveMeasure = BeatsTillMeasure(tempoMap, BeatToMeasure(tempoMap, i->position));
+    double beatsTillStartOfGrooveMeasureWithFudge = BeatsTillMeasure(tempoMap, BeatToMeasure(tempoMap, i->position + fudge));
     if ((int)beatsTillStartOfGrooveMeasure != (int)beatsTillStartOfGrooveMeasureWithFudge)
     {
         i->position = beatsTillStartOfGrooveMeasureWithFudge;
@@ -421,7 +423,7 @@ static void finalizeGroove(int &beatsInGroove, std::vector<GrooveItem> &grooveIn
     }
 
     i = grooveInBeats.end() - 1;
-    double beatsTillOneAfterEndOfGrooveMeasure = BeatsTillMeasure(BeatToMeasure(i->position) + 1);
+    double beatsTillOneAfterEndOfGrooveMeasure = BeatsTillMeasure(tempoMap, BeatToMeasure(tempoMap, i->position) + 1);
 
     double dBeatsInGroove = beatsTillOneAfterEndOfGrooveMeasure - beatsTillStartOfGrooveMeasure;
 
@@ -459,15 +461,16 @@ void GrooveTemplateHandler::GetGrooveFromMidiEditor()
     GrooveTemplateHandler *me = GrooveTemplateHandler::Instance();
     GrooveTemplateHandler::ClearGroove();
 
-    GetMidiBeatPositions(*takePtr.get(), *takePtr->getParent(), me->grooveInBeats, true);
-    finalizeGroove(me->nBeatsInGroove, me->grooveInBeats);
+    const RprTempoMap &tempoMap = RprTempoMap::get();
+    GetMidiBeatPositions(tempoMap, *takePtr.get(), *takePtr->getParent(), me->grooveInBeats, true);
+    finalizeGroove(tempoMap, me->nBeatsInGroove, me->grooveInBeats);
 }
 
-GrooveItem createGrooveItemFromItem(const RprItem &rprItem)
+GrooveItem createGrooveItemFromItem(const RprTempoMap &tempoMap, const RprItem &rprItem)
 {
     GrooveItem grooveItem;
     grooveItem.amplitude = -1.0;
-    grooveItem.position = TimeToBeat(rprItem.getPosition() + rprItem.getSnapOffset());
+    grooveItem.position = TimeToBeat(tempoMap, rprItem.getPosition() + rprItem.getSnapOffset());
     return grooveItem;
 }
 
@@ -483,20 +486,21 @@ void GrooveTemplateHandler::GetGrooveFromItems()
     }
     GrooveTemplateHandler::ClearGroove();
 
+    const RprTempoMap &tempoMap = RprTempoMap::get();
     for(int i = 0; i < ctr->size(); i++) {
         RprItem rprItem = ctr->getAt(i);
         if (rprItem.getActiveTake().isMIDI()) {
             RprMidiTake midiTake(rprItem.getActiveTake(),true);
             /* add item position if no notes in midi item */
-            if(GetMidiBeatPositions(midiTake, rprItem, me->grooveInBeats, false) == 0) {
-                me->grooveInBeats.push_back(createGrooveItemFromItem(rprItem));
+            if(GetMidiBeatPositions(tempoMap, midiTake, rprItem, me->grooveInBeats, false) == 0) {
+                me->grooveInBeats.push_back(createGrooveItemFromItem(tempoMap, rprItem));
             }
         }
         else {
-            me->grooveInBeats.push_back(createGrooveItemFromItem(rprItem));
+            me->grooveInBeats.push_back(createGrooveItemFromItem(tempoMap, rprItem));
         }
     }
-    finalizeGroove(me->nBeatsInGroove, me->grooveInBeats);
+    finalizeGroove(tempoMap, me->nBeatsInGroove, me->grooveInBeats);
 
 }
 
@@ -615,16 +619,17 @@ void GrooveTemplateHandler::MarkGroove(int multiple)
         return;
     }
 
+    const RprTempoMap &tempoMap = RprTempoMap::get();
     double dOffset = 0.0;
     if(me->grooveMarkerStart == CURRENTBAR)
     {
         double pos = GetCursorPosition();
-        dOffset = MeasureToTime(TimeToMeasure(pos));
+        dOffset = MeasureToTime(tempoMap, TimeToMeasure(tempoMap, pos));
     }
     else /* current position */
     {
         double pos = GetCursorPosition();
-        dOffset = TimeToBeat(pos);
+        dOffset = TimeToBeat(tempoMap, pos);
         /* remove position of first beat so the first beat starts at the edit cursor */
         dOffset -= me->grooveInBeats.begin()->position;
     }
@@ -636,7 +641,7 @@ void GrooveTemplateHandler::MarkGroove(int multiple)
         {
             std::stringstream oss;
             double beat = dOffset + it->position;
-            double pos = BeatToTime(beat);
+            double pos = BeatToTime(tempoMap, beat);
             oss << "GRV_" << num;
             GrooveMarker mark;
             mark.index = num + 100;
@@ -132,8 +132,9 @@ void CmdExpandItemsToBar::doCommand(int flag)
     if(m_nBars == 0)
         return;
 
+    const RprTempoMap &tempoMap = RprTempoMap::get();
     double startPos = ctr->first().getPosition();
-    double expandPoint = BeatToTime(TimeToBeat(startPos) + BeatsInMeasure(TimeToMeasure(startPos)) * m_nBars);
+    double expandPoint = BeatToTime(tempoMap, TimeToBeat(tempoMap, startPos) + BeatsInMeasure(tempoMap, TimeToMeasure(tempoMap, startPos)) * m_nBars);
 
     for(int i = 0; i < 5; i++)
     {
@@ -208,14 +208,14 @@ static void GetEmulationSettings(int flag, void *data)
     }
 }
 
-double getQuantizedPosition(double pos, double gridSize)
+double getQuantizedPosition(const RprTempoMap &tempoMap, double pos, double gridSize)
 {
-    double beat = TimeToBeat(pos);
+    double beat = TimeToBeat(tempoMap, pos);
     double posMod = fmod(beat, gridSize);
     if(gridSize / 2 > posMod) {
-        return BeatToTime(beat - posMod);
+        return BeatToTime(tempoMap, beat - posMod);
     } else {
-        return BeatToTime(beat + gridSize - posMod);
+        return BeatToTime(tempoMap, beat + gridSize - posMod);
     }
 }
 
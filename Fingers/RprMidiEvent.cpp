@@ -3,17 +3,32 @@
 #include "RprMidiEvent.h"
 #include "RprNode.h"
 
-#include "StringUtil.h"
-
 #include <memory>
 #include <WDL/localize/localize.h>
 
-static std::string toHex(unsigned char hex);
-
 RprMidiEvent::RprMidiEvent()
-    : mSelected(false), mMuted(false), mDelta(0), mOffset(0), mQuantizeOffset(0)
+    : mMessageSize(3), mSourceOffset(0), mSourceLength(0), mSourceDelta(0), mQuantizeOffset(0), mDelta(0), mOffset(0),
+      mMuted(false), mSelected(false), mModified(true)
+{
+    memset(mMidiMessage, 0, sizeof(mMidiMessage));
+}
+
+void RprMidiEvent::setSourceLine(size_t offset, size_t len)
 {
-    mMidiMessage.resize(3);
+    mSourceOffset = offset;
+    mSourceLength = len;
+    mSourceDelta = mDelta;
+    mModified = false;
+}
+
+void RprMidiEvent::setModified()
+{
+    mModified = true;
+}
+
+bool RprMidiEvent::isModified() const
+{
+    return mModified || mDelta != mSourceDelta;
 }
 
 bool RprMidiEvent::isSelected() const
@@ -23,6 +38,8 @@ bool RprMidiEvent::isSelected() const
 
 void RprMidiEvent::setSelected(bool selected)
 {
+    if(selected != mSelected)
+        setModified();
     mSelected = selected;
 }
 
@@ -33,6 +50,8 @@ bool RprMidiEvent::isMuted() const
 
 void RprMidiEvent::setMuted(bool muted)
 {
+    if(muted != mMuted)
+        setModified();
     mMuted = muted;
 }
 
@@ -89,20 +108,13 @@ RprMidiEvent::MessageType RprExtendedMidiEvent::getMessageType() const
         return RprMidiEvent::Sysex;
 }
 
-RprNode *RprExtendedMidiEvent::toReaper()
+RprNode *RprExtendedMidiEvent::toReaper(const std::string &)
 {
-    std::stringstream oss;
-    if(isSelected())
-        oss << "x";
-    else
-        oss << "X";
-
-    if(isMuted())
-        oss << "m";
-    oss << " ";
-    oss << getDelta() << " 0";
-    std::auto_ptr<RprNode> node(new RprParentNode(oss.str().c_str()));
-    for(std::list<std::string>::const_iterator i = mExtendedData.begin();
+    char line[64];
+    snprintf(line, sizeof(line), "%s%s %d 0", isSelected() ? "x" : "X",
+        isMuted() ? "m" : "", getDelta());
+    std::auto_ptr<RprNode> node(new RprParentNode(line));
+    for(std::vector<std::string>::const_iterator i = mExtendedData.begin();
         i != mExtendedData.end(); ++i)
     {
         std::auto_ptr<RprNode> childNode(new RprPropertyNode(*i));
@@ -111,16 +123,6 @@ RprNode *RprExtendedMidiEvent::toReaper()
     return node.release();
 }
 
-void RprMidiEvent::setMidiMessage(const std::vector<unsigned char> message)
-{
-    mMidiMessage = message;
-}
-
-const std::vector<unsigned char>& RprMidiEvent::getMidiMessage()
-{
-    return mMidiMessage;
-}
-
 bool RprMidiEvent::isAttachableTo(const RprMidiEvent *targetEvent) const
 {
     // Notations Events are Text Events occuring right after a Note On.
@@ -150,6 +152,8 @@ unsigned char RprMidiEvent::getValue1() const
 
 void RprMidiEvent::setValue1(unsigned char value)
 {
+    if(value != mMidiMessage[1])
+        setModified();
     mMidiMessage[1] = value;
 }
 
@@ -203,8 +207,10 @@ void RprMidiEvent::setMessageType(RprMidiEvent::MessageType messageType)
         default:
             break;
     }
-    mMidiMessage[0] &= 0x0F;
-    mMidiMessage[0] |= (messageNibble << 4);
+    unsigned char status = (mMidiMessage[0] & 0x0F) | (messageNibble << 4);
+    if(status != mMidiMessage[0])
+        setModified();
+    mMidiMessage[0] = status;
 }
 
 unsigned char RprMidiEvent::getValue2() const
@@ -214,6 +220,8 @@ unsigned char RprMidiEvent::getValue2() const
 
 void RprMidiEvent::setValue2(unsigned char value)
 {
+    if(value != mMidiMessage[2])
+        setModified();
     mMidiMessage[2] = value;
 }
 
@@ -224,6 +232,8 @@ int RprMidiEvent::getUnquantizedOffset() const
 
 void RprMidiEvent::setUnquantizedOffset(int offset)
 {
+    if(offset != mQuantizeOffset)
+        setModified();
     mQuantizeOffset = offset;
 }
 
@@ -234,41 +244,43 @@ unsigned char RprMidiEvent::getChannel() const
 
 void RprMidiEvent::setChannel(unsigned char channel)
 {
-    mMidiMessage[0] &= 0xF0;
-    mMidiMessage[0] |= channel;
+    unsigned char status = (mMidiMessage[0] & 0xF0) | channel;
+    if(status != mMidiMessage[0])
+        setModified();
+    mMidiMessage[0] = status;
 }
 
-RprNode *RprMidiEvent::toReaper()
+RprNode *RprMidiEvent::toReaper(const std::string &sourceLines)
 {
-    std::stringstream oss;
-    if(isSelected())
-        oss << "e";
-    else
-        oss << "E";
-
-    if(isMuted())
-        oss << "m";
-    oss << " ";
-    oss << getDelta();
-    for(std::vector<unsigned char>::iterator i = mMidiMessage.begin(); i != mMidiMessage.end(); i++)
-        oss << " " << toHex(*i);
-
-    if(getMessageType() == NoteOn || getMessageType() == NoteOff) {
-        if(mQuantizeOffset != 0) {
-            oss << " " << mQuantizeOffset;
+    std::string line;
+    if(!isModified()) {
+        line.assign(sourceLines, mSourceOffset, mSourceLength);
+    } else {
+        char buf[64];
+        int len = snprintf(buf, sizeof(buf), "%s%s %d", isSelected() ? "e" : "E",
+            isMuted() ? "m" : "", getDelta());
+        for(int i = 0; i < mMessageSize; i++)
+            len += snprintf(buf + len, sizeof(buf) - len, " %02x", mMidiMessage[i]);
+
+        if(getMessageType() == NoteOn || getMessageType() == NoteOff) {
+            if(mQuantizeOffset != 0) {
+                len += snprintf(buf + len, sizeof(buf) - len, " %d", mQuantizeOffset);
+            }
         }
+        line.assign(buf, len);
     }
 
-    for(const std::string &propertyLine : mPropertyLines)
-        oss << '\n' << propertyLine;
+    for(const std::string &propertyLine : mPropertyLines) {
+        line += '\n';
+        line += propertyLine;
+    }
 
-    std::auto_ptr<RprNode> node(new RprPropertyNode(oss.str()));
-    return node.release();
+    return new RprPropertyNode(std::move(line));
 }
 
-static bool isExtended(const char* inStr)
+static bool isExtended(const char* inStr, size_t len)
 {
-    if(inStr[0] == 0)
+    if(len == 0)
         throw RprMidiEvent::RprMidiException(__LOCALIZE("Error parsing MIDI data","sws_mbox"));
     if(inStr[0] == 'x')
         return true;
@@ -277,9 +289,9 @@ static bool isExtended(const char* inStr)
     return false;
 }
 
-static bool isSelected(const char* inStr)
+static bool isSelected(const char* inStr, size_t len)
 {
-    if(inStr[0] == 0)
+    if(len == 0)
         throw RprMidiEvent::RprMidiException(__LOCALIZE("Error parsing MIDI data","sws_mbox"));
     if(inStr[0] == 'E')
         return false;
@@ -293,9 +305,9 @@ static bool isSelected(const char* inStr)
     throw RprMidiEvent::RprMidiException(__LOCALIZE("Error parsing MIDI data","sws_mbox"));
 }
 
-static bool isMuted(const char* inStr)
+static bool isMuted(const char* inStr, size_t len)
 {
-    if(inStr[0] == 0 || inStr[1] == 0)
+    if(len < 2)
         return false;
     if(inStr[1] == 'm')
         return true;
@@ -303,24 +315,9 @@ static bool isMuted(const char* inStr)
     throw RprMidiEvent::RprMidiException(__LOCALIZE("Error parsing MIDI data","sws_mbox"));
 }
 
-static unsigned char fromHex(const std::string &inStr)
+static bool isNote(const unsigned char *midiMessage, int size)
 {
-    unsigned int v;
-    std::istringstream iss(inStr);
-    iss >> std::setbase(16) >> v;
-    return (unsigned char)v;
-}
-
-static std::string toHex(unsigned char hex)
-{
-    std::ostringstream oss;
-    oss << std::setbase(16) << std::setw(2) << std::setfill('0') << (int)hex;
-    return oss.str();
-}
-
-static bool isNote(std::vector<unsigned char> &midiMessage)
-{
-    if(midiMessage.empty())
+    if(size == 0)
         return false;
     if(getMessageType(midiMessage[0]) == RprMidiEvent::NoteOn)
         return true;
@@ -329,18 +326,36 @@ static bool isNote(std::vector<unsigned char> &midiMessage)
     return false;
 }
 
-RprMidiEventCreator::RprMidiEventCreator(RprNode *node)
+/* Returns the next space separated token of an event line, *end is set to
+ * the character following it */
+static const char *nextToken(const char *inStr, const char **end)
+{
+    while(*inStr == ' ') ++inStr;
+    const char *tokenEnd = inStr;
+    while(*tokenEnd && *tokenEnd != ' ') ++tokenEnd;
+    *end = tokenEnd;
+    return inStr;
+}
+
+RprMidiEventCreator::RprMidiEventCreator(RprNode *node, std::string &sourceLines)
 {
-    StringVector tokens(node->getValue());
+    const std::string &value = node->getValue();
+    const char *end;
+    const char *flags = nextToken(value.c_str(), &end);
+    const size_t flagsLen = end - flags;
+
+    if(!flagsLen)
+        throw RprMidiEvent::RprMidiException(__LOCALIZE("Error parsing MIDI data","sws_mbox"));
 
-    if(tokens.empty())
+    const char *token = nextToken(end, &end);
+    if(token == end)
         throw RprMidiEvent::RprMidiException(__LOCALIZE("Error parsing MIDI data","sws_mbox"));
 
-    int delta = (int)strtoul(tokens.at(1), 0, 10);
-    bool selected = isSelected(tokens.at(0));
-    bool muted = isMuted(tokens.at(0));
+    int delta = (int)strtoul(token, 0, 10);
+    bool selected = isSelected(flags, flagsLen);
+    bool muted = isMuted(flags, flagsLen);
 
-    if(isExtended(tokens.at(0)))
+    if(isExtended(flags, flagsLen))
     {
         mXEvent.reset(new RprExtendedMidiEvent());
         mXEvent->setDelta(delta);
@@ -358,17 +373,20 @@ RprMidiEventCreator::RprMidiEventCreator(RprNode *node)
     mEvent->setSelected(selected);
     mEvent->setMuted(muted);
     mEvent->setDelta(delta);
-    std::vector<unsigned char> midiMessage;
-    for(unsigned int i = 2; i < tokens.size(); i++) {
-
-        if(i == 5 && isNote(midiMessage)) {
-            mEvent->setUnquantizedOffset(::atoi(tokens.at(i)));
-        } else {
-            midiMessage.push_back(fromHex(tokens.at(i)));
+    RprMidiEvent *event = mEvent.get();
+    int size = 0;
+    for(int i = 2; *(token = nextToken(end, &end)); i++) {
+
+        if(i == 5 && isNote(event->mMidiMessage, size)) {
+            event->mQuantizeOffset = ::atoi(token);
+        } else if(size < (int)sizeof(event->mMidiMessage)) {
+            event->mMidiMessage[size++] = (unsigned char)strtoul(token, 0, 16);
         }
 
     }
-    mEvent->setMidiMessage(midiMessage);
+    event->mMessageSize = size;
+    event->setSourceLine(sourceLines.size(), value.size());
+    sourceLines += value;
 }
 
 RprMidiEvent *RprMidiEventCreator::collectEvent()
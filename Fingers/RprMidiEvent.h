@@ -38,15 +38,13 @@ public:
     int getUnquantizedOffset() const;
     void setUnquantizedOffset(int offset);
 
-    void setMidiMessage(const std::vector<unsigned char> message);
-    const std::vector<unsigned char>& getMidiMessage();
-
     bool isAttachableTo(const RprMidiEvent *) const;
     void addAttachedEvent(RprMidiEvent *);
 
     void addPropertyNode(const RprNode *);
 
-    virtual RprNode *toReaper();
+    /* sourceLines: buffer the event was read from, see setSourceLine() */
+    virtual RprNode *toReaper(const std::string &sourceLines);
 
     virtual ~RprMidiEvent() {}
 
@@ -59,16 +57,31 @@ public:
         std::string mMessage;
     };
 
+protected:
+    friend class RprMidiEventCreator;
+    void setSourceLine(size_t offset, size_t len);
+    bool isModified() const;
+
 private:
-    std::vector<unsigned char> mMidiMessage;
-    std::list<RprMidiEvent *> mAttachedEvents;
-    std::list<std::string> mPropertyLines;
+    void setModified();
+
+    // Short messages are stored inline so parsing a take doesn't allocate
+    // per event. The line the event was read from is written back as-is
+    // while the event is unmodified: it is kept in a buffer shared by all
+    // events of the take (mSourceOffset/mSourceLength point into it).
+    unsigned char mMidiMessage[3];
+    int mMessageSize;
+    std::vector<RprMidiEvent *> mAttachedEvents;
+    std::vector<std::string> mPropertyLines;
+    size_t mSourceOffset, mSourceLength;
+    int mSourceDelta;
 
     int mQuantizeOffset;
     int mDelta;
     int mOffset;
     bool mMuted;
     bool mSelected;
+    bool mModified;
 };
 
 class RprExtendedMidiEvent : public RprMidiEvent
@@ -80,16 +93,18 @@ public:
 
     virtual MessageType getMessageType() const;
 
-    virtual RprNode *toReaper();
+    virtual RprNode *toReaper(const std::string &sourceLines);
 
 private:
-    std::list<std::string> mExtendedData;
+    std::vector<std::string> mExtendedData;
 };
 
 class RprMidiEventCreator
 {
 public:
-    RprMidiEventCreator(RprNode *node);
+    /* The line of node is appended to sourceLines, the buffer later
+     * passed to RprMidiEvent::toReaper() */
+    RprMidiEventCreator(RprNode *node, std::string &sourceLines);
     /* Collect midi Event. Once you have collected it you
      * take ownership of it. */
     RprMidiEvent *collectEvent();
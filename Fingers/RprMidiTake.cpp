@@ -31,6 +31,7 @@ RprMidiTake* FNG_AllocMidiTake(MediaItem_Take* take)
 void FNG_FreeMidiTake(RprMidiTake* midiTake)
 {
     int idx=g_script_miditakes.Find(midiTake);
+    RprTempoMap::get(); // the script may have changed the tempo map since FNG_AllocMidiTake, revalidate before the changes are committed
     if (idx>=0) g_script_miditakes.Delete(idx, true);
 }
 
@@ -194,6 +195,7 @@ public:
     static RprMidiContext *createMidiContext(double playRate, double startOffset, int ticksPerQN)
     {
         RprMidiContext *context = new RprMidiContext;
+        context->mTempoMap = &RprTempoMap::get();
         context->mPlayRate = playRate;
         context->mStartOffset = startOffset;
         context->mTicksPerQN = ticksPerQN;
@@ -219,12 +221,19 @@ public:
         return mTicksPerQN;
     }
 
+    /* validated when the take is read, see FNG_FreeMidiTake() */
+    const RprTempoMap &getTempoMap() const
+    {
+        return *mTempoMap;
+    }
+
 private:
 
     RprMidiContext()
     {
     }
 
+    const RprTempoMap *mTempoMap;
     int mTicksPerQN;
     double mStartOffset;
     double mPlayRate;
@@ -258,17 +267,19 @@ RprMidiNote::RprMidiNote(RprMidiEvent *noteOn, RprMidiEvent *noteOff, RprMidiCon
 
 static double getPositionMidiOffset(const RprMidiContext *context, int offset)
 {
-    double offsetQN = TimeToQN(context->getStartOffset());
+    const RprTempoMap &tempoMap = context->getTempoMap();
+    double offsetQN = TimeToQN(tempoMap, context->getStartOffset());
     double midiNoteQN = (double)offset / (double)context->getTicksPerQN();
     midiNoteQN /= context->getPlayRate();
     offsetQN += midiNoteQN;
-    return QNtoTime(offsetQN);
+    return QNtoTime(tempoMap, offsetQN);
 }
 
 static int getMidiOffsetPosition(const RprMidiContext *context, double position)
 {
-    double posQN = TimeToQN(position);
-    double startQN = TimeToQN(context->getStartOffset());
+    const RprTempoMap &tempoMap = context->getTempoMap();
+    double posQN = TimeToQN(tempoMap, position);
+    double startQN = TimeToQN(tempoMap, context->getStartOffset());
     double itemQN = posQN - startQN;
     itemQN *= context->getPlayRate();
     return (int)(itemQN * (double)context->getTicksPerQN() + 0.5);
@@ -348,8 +359,9 @@ double RprMidiNote::getLength() const
 void RprMidiNote::setLength(double length)
 {
     double pos = getPosition();
-    double rightEdgeOffset = TimeToQN(pos + length);
-    double leftEdgeOffset = TimeToQN(pos);
+    const RprTempoMap &tempoMap = mContext->getTempoMap();
+    double rightEdgeOffset = TimeToQN(tempoMap, pos + length);
+    double leftEdgeOffset = TimeToQN(tempoMap, pos);
     setItemLength( (int)((rightEdgeOffset - leftEdgeOffset) *
         (double)mContext->getTicksPerQN() + 0.5));
 }
@@ -538,31 +550,37 @@ static int clearMidiEventsFromMidiNode(RprNode *parent)
     }
 
     const int offset = i;
-    while(true)
+    for(; i < parent->childCount(); ++i)
     {
         const std::string &value = parent->getChild(i)->getValue();
         if(!isMidiEvent(value) && !isEventProperty(value))
             break;
-
-        parent->removeChild(i);
     }
+    parent->removeChildren(offset, i - offset);
 
     return offset;
 }
 
 static void midiEventsToMidiNode(std::vector< RprMidiEvent *> &midiEvents, RprNode *midiNode, 
-                                 int offset)
+                                 int offset, const std::string &sourceLines)
 {
-    int index = offset;
+    std::vector<RprNode *> eventNodes;
+    eventNodes.reserve(midiEvents.size());
     for(std::vector<RprMidiEvent *>::iterator i = midiEvents.begin(); i != midiEvents.end(); i++)
     {
         RprMidiEvent *current = *i;
-        midiNode->addChild(current->toReaper(), index++);
+        eventNodes.push_back(current->toReaper(sourceLines));
     }
+    midiNode->addChildren(eventNodes, offset);
 }
 
-static void getMidiEvents(RprNode *midiNode, RprMidiEvents &midiEvents)
+static void getMidiEvents(RprNode *midiNode, RprMidiEvents &midiEvents, std::string &sourceLines)
 {
+    size_t sourceSize = 0;
+    for(int i = 1; i < midiNode->childCount(); i++)
+        sourceSize += midiNode->getChild(i)->getValue().size();
+    sourceLines.reserve(sourceSize);
+
     int offset = 0;
     for(int i = 1; i < midiNode->childCount(); i++)
     {
@@ -579,7 +597,7 @@ static void getMidiEvents(RprNode *midiNode, RprMidiEvents &midiEvents)
         else if(!isMidiEvent(value))
             continue;
 
-        RprMidiEventCreator creator(subNode);
+        RprMidiEventCreator creator(subNode, sourceLines);
         RprMidiEvent *midiEvent = creator.collectEvent();
         offset += midiEvent->getDelta();
         midiEvent->setOffset(offset);
@@ -636,8 +654,8 @@ static bool getMidiNotes(RprMidiEvents &midiEvents,
                          std::vector<RprMidiNote *> &midiNotes,
                          RprMidiContext *context)
 {
-    RprMidiEvents noteOns;
-    RprMidiEvents noteOffs;
+    std::vector<RprMidiEvent *> noteOns;
+    std::vector<RprMidiEvent *> noteOffs;
     RprMidiEvents other;
 
     /* categorize notes into note-ons and note-offs */
@@ -661,45 +679,72 @@ static bool getMidiNotes(RprMidiEvents &midiEvents,
     }
     midiEvents.clear();
 
+    /* bucket note-offs by channel and pitch so matching a note-on only
+     * looks at note-offs that can match it, in take order */
+    std::vector<int> bucketStart(16 * 128 + 1, 0);
+    for(std::vector<RprMidiEvent *>::const_iterator j = noteOffs.begin(); j != noteOffs.end(); ++j)
+    {
+        ++bucketStart[((*j)->getChannel() & 0x0F) * 128 + ((*j)->getValue1() & 0x7F) + 1];
+    }
+    for(int b = 1; b < (int)bucketStart.size(); ++b)
+    {
+        bucketStart[b] += bucketStart[b - 1];
+    }
+
+    std::vector<int> buckets(noteOffs.size());
+    std::vector<int> bucketHead(bucketStart.begin(), bucketStart.end() - 1);
+    std::vector<int> bucketFill(bucketHead);
+    for(int j = 0; j < (int)noteOffs.size(); ++j)
+    {
+        buckets[bucketFill[(noteOffs[j]->getChannel() & 0x0F) * 128 + (noteOffs[j]->getValue1() & 0x7F)]++] = j;
+    }
+    std::vector<bool> matched(noteOffs.size(), false);
+
     /* match note-ons and note-offs, removing zero length notes */
-    RprMidiEventsIter i = noteOns.begin();
-    while(i != noteOns.end())
+    for(std::vector<RprMidiEvent *>::const_iterator i = noteOns.begin(); i != noteOns.end(); ++i)
     {
-        RprMidiEventsIter j = noteOffs.begin();
-        while(j != noteOffs.end() && !noteEventsMatch(*i, *j))
+        RprMidiEvent *noteOn = *i;
+        const int bucket = (noteOn->getChannel() & 0x0F) * 128 + (noteOn->getValue1() & 0x7F);
+
+        // already matched note-offs at the front of the bucket are skipped for good
+        int &head = bucketHead[bucket];
+        while(head < bucketStart[bucket + 1] && matched[buckets[head]])
+        {
+            ++head;
+        }
+
+        int j = head;
+        while(j < bucketStart[bucket + 1] &&
+              (matched[buckets[j]] || !noteEventsMatch(noteOn, noteOffs[buckets[j]])))
         {
             ++j;
         }
         /* no match so add noteOn to other events */
-        if(j == noteOffs.end())
+        if(j == bucketStart[bucket + 1])
         {
-            other.push_back(*i);
-            ++i;
+            other.push_back(noteOn);
             continue;
         }
 
-        RprMidiEvent *noteOn = *i;
-        RprMidiEvent *noteOff = *j;
+        matched[buckets[j]] = true;
+        RprMidiEvent *noteOff = noteOffs[buckets[j]];
         /* delete zero length notes */
         if(noteOn->getOffset() == noteOff->getOffset())
         {
             delete noteOn;
             delete noteOff;
-            noteOns.erase(i++);
-            noteOffs.erase(j);
             continue;
         }
 
         RprMidiNote *newNote = new RprMidiNote(noteOn, noteOff, context);
         midiNotes.push_back(newNote);
-        noteOffs.erase(j);
-        ++i;
     }
 
     /* put non-note events back onto midiEvents list */
-    for(RprMidiEventsCIter j = noteOffs.begin(); j != noteOffs.end(); j++)
+    for(int j = 0; j < (int)noteOffs.size(); j++)
     {
-        midiEvents.push_back(*j);
+        if(!matched[j])
+            midiEvents.push_back(noteOffs[j]);
     }
 
     for(RprMidiEventsCIter j = other.begin(); j != other.end(); j++)
@@ -853,7 +898,7 @@ RprMidiTake::RprMidiTake(const RprTake &take, bool readOnly)
         RprNode *sourceNode = RprMidiTemplate::getMidiSourceNode();
 
         RprTempMidiEvents tempMidiEvents;
-        getMidiEvents(sourceNode, tempMidiEvents.get());
+        getMidiEvents(sourceNode, tempMidiEvents.get(), mSourceLines);
         mContext = RprMidiContext::createMidiContext(take.getPlayRate(),
             getParent()->getPosition() - (take.getStartOffset() / take.getPlayRate()),
             getQNValue(sourceNode));
@@ -981,10 +1026,11 @@ RprMidiTake::~RprMidiTake()
             mTake.getStartOffset() / mContext->getPlayRate();
 
         // convert to Quarter notes and subtract first event offset
-        double newTakeQNStartPosition = TimeToQN(takeStartPosition) + ((double)firstEventOffset /
+        const RprTempoMap &tempoMap = mContext->getTempoMap();
+        double newTakeQNStartPosition = TimeToQN(tempoMap, takeStartPosition) + ((double)firstEventOffset /
             mContext->getTicksPerQN()) / mContext->getPlayRate();
         //convert back to seconds / playrate
-        mNewTakeOffset = takeStartPosition - QNtoTime(newTakeQNStartPosition) +
+        mNewTakeOffset = takeStartPosition - QNtoTime(tempoMap, newTakeQNStartPosition) +
             mTake.getStartOffset() / mContext->getPlayRate();
         //convert to seconds
         mNewTakeOffset *= mContext->getPlayRate();
@@ -1004,7 +1050,7 @@ RprMidiTake::~RprMidiTake()
     }
 
     midiEventsToMidiNode(midiEvents, RprMidiTemplate::getMidiSourceNode(),
-        mMidiEventsOffset);
+        mMidiEventsOffset, mSourceLines);
 
     cleanup();
 }
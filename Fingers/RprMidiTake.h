@@ -121,6 +121,7 @@ private:
     std::vector<RprMidiEvent *> mOtherEvents;
     RprMidiContext *mContext;
     int mMidiEventsOffset;
+    std::string mSourceLines; // lines of the parsed events, see RprMidiEvent::toReaper()
 };
 
 #endif
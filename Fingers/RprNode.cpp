@@ -3,11 +3,11 @@
 
 #include "RprNode.h"
 
-void RprPropertyNode::toReaper(std::ostringstream &oss, int indent)
+void RprPropertyNode::toReaper(std::string &out, int indent)
 {
-    std::string strIndent(indent, ' ');
-    oss << strIndent.c_str() << getValue().c_str();
-    oss << std::endl;
+    out.append(indent, ' ');
+    out.append(getValue());
+    out.push_back('\n');
 }
 
 const std::string& RprNode::getValue() const
@@ -15,9 +15,9 @@ const std::string& RprNode::getValue() const
     return mValue;
 }
 
-void RprNode::setValue(const std::string& value)
+void RprNode::setValue(std::string value)
 {
-    mValue = value;
+    mValue = std::move(value);
 }
 
 RprNode *RprNode::getParent()
@@ -72,6 +72,13 @@ void RprParentNode::addChild(RprNode *node, int index)
     mChildren.insert(mChildren.begin() + index, node);
 }
 
+void RprParentNode::addChildren(const std::vector<RprNode *> &nodes, int index)
+{
+    for(RprNode *node : nodes)
+        node->setParent(this);
+    mChildren.insert(mChildren.begin() + index, nodes.begin(), nodes.end());
+}
+
 int RprParentNode::childCount() const
 {
     return (int)mChildren.size();
@@ -84,33 +91,58 @@ void RprParentNode::removeChild(int index)
     delete child;
 }
 
-static std::string getTrimmedLine(std::istringstream &iss)
+void RprParentNode::removeChildren(int index, int count)
 {
-    while(iss.peek() == '\x20') iss.get();
+    if(count <= 0)
+        return;
 
-    std::string line;
-    std::getline(iss, line);
-    return line;
+    std::vector<RprNode *>::iterator first = mChildren.begin() + index;
+    std::vector<RprNode *>::iterator last = first + count;
+    for(std::vector<RprNode *>::iterator i = first; i != last; ++i)
+        delete *i;
+    mChildren.erase(first, last);
 }
 
-void RprParentNode::toReaper(std::ostringstream &oss, int indent)
+/* Returns the next line with leading spaces skipped and without the trailing
+ * newline, advancing *pos past it. Works on the chunk in place. */
+static bool getTrimmedLine(const char **pos, const char **line, size_t *len)
 {
-    std::string strIndent(indent, ' ');
-    oss << strIndent.c_str() << "<";
-    oss << getValue().c_str() << std::endl;
+    const char *p = *pos;
+    if(!*p)
+        return false;
+
+    while(*p == '\x20') ++p;
+
+    const char *end = strchr(p, '\n');
+    if(!end)
+        end = p + strlen(p);
+
+    *line = p;
+    *len = end - p;
+    *pos = *end ? end + 1 : end;
+    return true;
+}
+
+void RprParentNode::toReaper(std::string &out, int indent)
+{
+    out.append(indent, ' ');
+    out.push_back('<');
+    out.append(getValue());
+    out.push_back('\n');
     for(std::vector<RprNode *>::iterator i = mChildren.begin();
         i != mChildren.end();
         i++) {
-            (*i)->toReaper(oss, 0);
+            (*i)->toReaper(out, 0);
     }
-    oss << strIndent.c_str() << ">" << std::endl;
+    out.append(indent, ' ');
+    out.append(">\n");
 }
 
 std::string RprNode::toReaper()
 {
-    std::ostringstream oss;
-    toReaper(oss, 0);
-    return oss.str();
+    std::string out;
+    toReaper(out, 0);
+    return out;
 }
 
 static RprNode *addNewChildNode(RprNode *node, const std::string &value)
@@ -120,14 +152,9 @@ static RprNode *addNewChildNode(RprNode *node, const std::string &value)
     return newNode;
 }
 
-static void addNewPropertyNode(RprNode *node, const std::string &property)
-{
-    node->addChild(new RprPropertyNode(property));
-}
-
-RprPropertyNode::RprPropertyNode(const std::string &value)
+RprPropertyNode::RprPropertyNode(std::string value)
 {
-    setValue(value);
+    setValue(std::move(value));
 }
 
 RprNode *RprParentNode::createItemStateTree(const char *itemState)
@@ -139,24 +166,24 @@ RprNode *RprParentNode::createItemStateTree(const char *itemState)
     if(strncmp(itemState, "<ITEM", 5))
         return NULL;
 
-    std::istringstream iss(itemState);
-    std::string line = getTrimmedLine(iss);
-    std::auto_ptr<RprParentNode> parentNode(new RprParentNode(line.substr(1).c_str()));
+    const char *pos = itemState, *line;
+    size_t len;
+    getTrimmedLine(&pos, &line, &len);
+    std::auto_ptr<RprParentNode> parentNode(new RprParentNode(std::string(line + 1, len - 1).c_str()));
 
     RprNode *currentNode = parentNode.get();
 
-    while(!iss.eof()) {
+    while(getTrimmedLine(&pos, &line, &len)) {
 
-        line = getTrimmedLine(iss);
-        if(line.empty())
+        if(!len)
             continue;
 
         if(line[0] == '<')
-            currentNode = addNewChildNode(currentNode, line.substr(1));
+            currentNode = addNewChildNode(currentNode, std::string(line + 1, len - 1));
         else if(line[0] == '>')
             currentNode = currentNode->getParent();
         else
-            addNewPropertyNode(currentNode, line);
+            currentNode->addChild(new RprPropertyNode(std::string(line, len)));
     }
 
     return parentNode.release();
@@ -9,16 +9,18 @@ public:
     void setParent(RprNode *parent);
 
     std::string toReaper();
-    virtual void toReaper(std::ostringstream &oss, int indent) = 0;
+    virtual void toReaper(std::string &out, int indent) = 0;
 
     virtual int childCount() const = 0;
     virtual RprNode *getChild(int index) const = 0;
     virtual RprNode *findChildByToken(const std::string &) const = 0;
     virtual void addChild(RprNode *node) = 0;
     virtual void addChild(RprNode *node, int index) {}
+    virtual void addChildren(const std::vector<RprNode *> &nodes, int index) {}
     virtual void removeChild(int index) = 0;
+    virtual void removeChildren(int index, int count) {}
 
-    void setValue(const std::string &value);
+    void setValue(std::string value);
     const std::string &getValue() const;
 
 private:
@@ -28,7 +30,7 @@ private:
 
 class RprPropertyNode : public RprNode {
 public:
-    RprPropertyNode(const std::string &value);
+    RprPropertyNode(std::string value);
     ~RprPropertyNode() {}
 
     int childCount() const override { return 0; }
@@ -38,7 +40,7 @@ public:
     void removeChild(int index) override {}
 
 private:
-    void toReaper(std::ostringstream &oss, int indent) override;
+    void toReaper(std::string &out, int indent) override;
 };
 
 class RprParentNode : public RprNode {
@@ -54,11 +56,15 @@ public:
     RprNode *findChildByToken(const std::string &) const override;
     void addChild(RprNode *node) override;
     void addChild(RprNode *node, int index) override;
+    // Range versions of addChild/removeChild, a take with n events would
+    // otherwise shift the child list n times
+    void addChildren(const std::vector<RprNode *> &nodes, int index) override;
     void removeChild(int index) override;
+    void removeChildren(int index, int count) override;
 
 private:
     RprParentNode& operator=(const RprNode&);
-    void toReaper(std::ostringstream &oss, int indent) override;
+    void toReaper(std::string &out, int indent) override;
 
     std::vector<RprNode *> mChildren;
 };
@@ -1,64 +1,331 @@
 #include "stdafx.h"
 
 #include "TimeMap.h"
+#include "../SnM/SnM_Util.h"
 
-double TimeToBeat(double time)
+/* Measure boundaries computed from QN are off by rounding errors, don't
+ * let 3.9999999 beats end up in the previous measure */
+#define MEASURE_EPSILON 0.000000001
+#define PARTIAL_MEASURE_EPSILON 0.000001
+
+double TimeToBeat(const RprTempoMap &tempoMap, double time)
 {
-    return TimeMap2_timeToBeats(0, time, NULL, NULL, NULL, NULL);
+    return tempoMap.timeToFullBeats(time);
 }
 
-double BeatToTime(double beat)
+double BeatToTime(const RprTempoMap &tempoMap, double beat)
 {
-    return TimeMap2_beatsToTime(0, beat, NULL);
+    return tempoMap.fullBeatsToTime(beat);
 }
 
-int TimeToMeasure(double time)
+int TimeToMeasure(const RprTempoMap &tempoMap, double time)
 {
     int measure = 0;
-    TimeMap2_timeToBeats(0, time, &measure, NULL, NULL, NULL);
+    tempoMap.timeToBeats(time, &measure, NULL, NULL);
     return measure;
 }
 
-int BeatToMeasure(double beat)
+int BeatToMeasure(const RprTempoMap &tempoMap, double beat)
 {
-    double time = BeatToTime(beat);
-    return TimeToMeasure(time);
+    double time = BeatToTime(tempoMap, beat);
+    return TimeToMeasure(tempoMap, time);
 }
 
-double MeasureToTime(int measure)
+double MeasureToTime(const RprTempoMap &tempoMap, int measure)
 {
-    return TimeMap2_beatsToTime(0, 0.0f, &measure);
+    return tempoMap.measureToTime(measure);
 }
 
-int BeatsInMeasure(int measure)
+int BeatsInMeasure(const RprTempoMap &tempoMap, int measure)
 {
-    double time = MeasureToTime(measure);
+    double time = tempoMap.measureToTime(measure);
     int measureLength = 0;
-    TimeMap2_timeToBeats(0, time, &measure, &measureLength, NULL, NULL);
+    tempoMap.timeToBeats(time, &measure, &measureLength, NULL);
     return measureLength;
 }
 
-double BeatsTillMeasure(int measure)
+double BeatsTillMeasure(const RprTempoMap &tempoMap, int measure)
+{
+    double time = tempoMap.measureToTime(measure);
+    return tempoMap.timeToFullBeats(time);
+}
+
+double BPMAtTime(const RprTempoMap &tempoMap, double time)
+{
+    return tempoMap.dividedBpmAtTime(time);
+}
+
+double QNtoTime(const RprTempoMap &tempoMap, double qn)
+{
+    return tempoMap.qnToTime(qn);
+}
+double TimeToQN(const RprTempoMap &tempoMap, double t)
+{
+    return tempoMap.timeToQN(t);
+}
+
+double BPMatTime(const RprTempoMap &tempoMap, double t)
+{
+    return tempoMap.dividedBpmAtTime(t);
+}
+
+static RprTempoMap *gTempoMap = NULL;
+
+const RprTempoMap &RprTempoMap::get()
+{
+    if(gTempoMap == NULL)
+        gTempoMap = new RprTempoMap();
+
+    if(gTempoMap->isStale(EnumProjects(-1, NULL, 0)))
+        gTempoMap->build();
+    return *gTempoMap;
+}
+
+bool RprTempoMap::isStale(ReaProject *project) const
+{
+    if(project != mProject ||
+       GetProjectStateChangeCount(project) != mStateCount ||
+       CountTempoTimeSigMarkers(project) != mMarkerCount)
+        return true;
+
+    int measure = 0;
+    TimeMap2_timeToBeats(project, mProbeTime, &measure, NULL, NULL, NULL);
+    return measure != mProbeMeasure ||
+        TimeMap_timeToQN_abs(project, mProbeTime) != mProbeQN;
+}
+
+RprTempoMap::RprTempoMap()
+: mRegular(true), mProject(NULL), mStateCount(-1), mMarkerCount(-1),
+  mProbeTime(0.0), mProbeQN(0.0), mProbeMeasure(0), mHash(0)
+{}
+
+namespace {
+struct TempoMarker {
+    double time;
+    double bpm;
+    int num;
+    int denom;
+    bool linear;
+};
+}
+
+void RprTempoMap::build()
+{
+    ReaProject *project = EnumProjects(-1, NULL, 0);
+    mProject = project;
+    mStateCount = GetProjectStateChangeCount(project);
+    mMarkerCount = CountTempoTimeSigMarkers(project);
+
+    int startNum = 4, startDenom = 4;
+    double startBpm = 120.0;
+    TimeMap_GetTimeSigAtTime(project, 0.0, &startNum, &startDenom, &startBpm);
+
+    std::vector<TempoMarker> markers(mMarkerCount);
+    WDL_UINT64 hash = FNV64(FNV64_IV, (const unsigned char *)&startNum, sizeof(int));
+    hash = FNV64(hash, (const unsigned char *)&startDenom, sizeof(int));
+    hash = FNV64(hash, (const unsigned char *)&startBpm, sizeof(double));
+    for(int i = 0; i < mMarkerCount; ++i) {
+        TempoMarker &marker = markers[i];
+        marker.time = marker.bpm = 0.0;
+        marker.num = marker.denom = 0;
+        marker.linear = false;
+        GetTempoTimeSigMarker(project, i, &marker.time, NULL, NULL, &marker.bpm,
+            &marker.num, &marker.denom, &marker.linear);
+
+        hash = FNV64(hash, (const unsigned char *)&marker.time, sizeof(double));
+        hash = FNV64(hash, (const unsigned char *)&marker.bpm, sizeof(double));
+        hash = FNV64(hash, (const unsigned char *)&marker.num, sizeof(int));
+        hash = FNV64(hash, (const unsigned char *)&marker.denom, sizeof(int));
+        hash = FNV64(hash, (const unsigned char *)&marker.linear, sizeof(bool));
+    }
+
+    /* any marker edit moves QN or the measure count past the last marker */
+    mProbeTime = (markers.empty() ? 0.0 : markers.back().time) + 1.0;
+    mProbeQN = TimeMap_timeToQN_abs(project, mProbeTime);
+    mProbeMeasure = 0;
+    TimeMap2_timeToBeats(project, mProbeTime, &mProbeMeasure, NULL, NULL, NULL);
+
+    if(hash == mHash && !mTempo.empty())
+        return;
+    mHash = hash;
+
+    mTempo.clear();
+    mTempo.reserve(mMarkerCount + 1);
+    if(markers.empty() || markers.front().time > 0.0) {
+        /* tempo before the first marker is constant, take it from REAPER
+         * so QN at the first marker matches exactly */
+        TempoSegment segment = { 0.0, 0.0, startBpm, 0.0 };
+        if(!markers.empty())
+            segment.bpm = 60.0 * TimeMap_timeToQN_abs(project, markers.front().time) / markers.front().time;
+        mTempo.push_back(segment);
+    }
+
+    for(size_t i = 0; i < markers.size(); ++i) {
+        TempoSegment segment = { markers[i].time, 0.0, markers[i].bpm, 0.0 };
+        if(!mTempo.empty()) {
+            const TempoSegment &prev = mTempo.back();
+            double length = segment.time - prev.time;
+            segment.qn = prev.qn + (prev.bpm + prev.slope * length / 2.0) * length / 60.0;
+        }
+        if(markers[i].linear && i + 1 < markers.size() && markers[i + 1].time > markers[i].time)
+            segment.slope = (markers[i + 1].bpm - markers[i].bpm) / (markers[i + 1].time - markers[i].time);
+        mTempo.push_back(segment);
+    }
+
+    mRegular = true;
+    mTimeSigs.clear();
+    TimeSigSegment start = { 0.0, 0, startNum, startDenom };
+    mTimeSigs.push_back(start);
+    for(size_t i = 0; i < markers.size(); ++i) {
+        if(markers[i].denom == 0)
+            continue;
+
+        const TimeSigSegment &prev = mTimeSigs.back();
+        double qn = timeToQNAbs(markers[i].time);
+        double measures = (qn - prev.qn) * prev.denom / (4.0 * prev.num);
+        double wholeMeasures = floor(measures + 0.5);
+        if(fabs(measures - wholeMeasures) > PARTIAL_MEASURE_EPSILON)
+            mRegular = false;
+
+        TimeSigSegment segment = { qn, prev.measure + (int)wholeMeasures, markers[i].num, markers[i].denom };
+        mTimeSigs.push_back(segment);
+    }
+}
+
+const RprTempoMap::TempoSegment &RprTempoMap::tempoSegmentAtTime(double time) const
+{
+    size_t lo = 0, hi = mTempo.size();
+    while(hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if(mTempo[mid].time <= time)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return mTempo[lo];
+}
+
+const RprTempoMap::TempoSegment &RprTempoMap::tempoSegmentAtQN(double qn) const
+{
+    size_t lo = 0, hi = mTempo.size();
+    while(hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if(mTempo[mid].qn <= qn)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return mTempo[lo];
+}
+
+const RprTempoMap::TimeSigSegment &RprTempoMap::timeSigSegmentAtQN(double qn) const
+{
+    size_t lo = 0, hi = mTimeSigs.size();
+    while(hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if(mTimeSigs[mid].qn <= qn)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return mTimeSigs[lo];
+}
+
+double RprTempoMap::timeToQNAbs(double time) const
+{
+    const TempoSegment &segment = tempoSegmentAtTime(time);
+    double offset = time - segment.time;
+    if(offset <= 0.0)
+        return segment.qn + segment.bpm * offset / 60.0;
+    return segment.qn + (segment.bpm + segment.slope * offset / 2.0) * offset / 60.0;
+}
+
+double RprTempoMap::qnAbsToTime(double qn) const
+{
+    const TempoSegment &segment = tempoSegmentAtQN(qn);
+    double c = 60.0 * (qn - segment.qn);
+    if(c <= 0.0 || segment.slope == 0.0)
+        return segment.time + c / segment.bpm;
+
+    /* solve slope/2 * t^2 + bpm * t - c = 0, in the form that stays
+     * stable when slope is tiny */
+    double d = segment.bpm * segment.bpm + 2.0 * segment.slope * c;
+    return segment.time + 2.0 * c / (segment.bpm + sqrt(d > 0.0 ? d : 0.0));
+}
+
+double RprTempoMap::timeToQN(double time) const
+{
+    if(!mRegular)
+        return TimeMap2_timeToQN(mProject, time);
+    return timeToQNAbs(time);
+}
+
+double RprTempoMap::qnToTime(double qn) const
+{
+    if(!mRegular)
+        return TimeMap2_QNToTime(mProject, qn);
+    return qnAbsToTime(qn);
+}
+
+double RprTempoMap::timeToBeats(double time, int *measure, int *measureLength, int *denominator) const
 {
-    double time = MeasureToTime(measure);
-    return TimeMap2_timeToBeats(0, time, NULL, NULL, NULL, NULL);
+    if(!mRegular)
+        return TimeMap2_timeToBeats(mProject, time, measure, measureLength, NULL, denominator);
+
+    double qn = timeToQNAbs(time);
+    const TimeSigSegment &segment = timeSigSegmentAtQN(qn);
+    double measureQN = 4.0 * segment.num / segment.denom;
+    double measures = floor((qn - segment.qn) / measureQN + MEASURE_EPSILON);
+    double beats = (qn - segment.qn - measures * measureQN) * segment.denom / 4.0;
+
+    if(measure)
+        *measure = segment.measure + (int)measures;
+    if(measureLength)
+        *measureLength = segment.num;
+    if(denominator)
+        *denominator = segment.denom;
+    return beats > 0.0 ? beats : 0.0;
 }
 
-double BPMAtTime(double time)
+double RprTempoMap::timeToFullBeats(double time) const
 {
-    return TimeMap2_GetDividedBpmAtTime(0, time);
+    /* full beat counts depend on how REAPER sums beats of different
+     * lengths, only do it ourselves with a single time signature */
+    if(!mRegular || mTimeSigs.size() > 1)
+        return TimeMap2_timeToBeats(mProject, time, NULL, NULL, NULL, NULL);
+
+    return timeToQNAbs(time) * mTimeSigs.front().denom / 4.0;
 }
 
-double QNtoTime(double qn)
+double RprTempoMap::fullBeatsToTime(double beats) const
 {
-    return TimeMap2_QNToTime(0, qn);
+    if(!mRegular || mTimeSigs.size() > 1)
+        return TimeMap2_beatsToTime(mProject, beats, NULL);
+
+    return qnAbsToTime(beats * 4.0 / mTimeSigs.front().denom);
 }
-double TimeToQN(double t)
+
+double RprTempoMap::measureToTime(int measure) const
+{
+    if(!mRegular)
+        return TimeMap2_beatsToTime(mProject, 0.0, &measure);
+
+    size_t i = mTimeSigs.size() - 1;
+    while(i > 0 && mTimeSigs[i].measure > measure)
+        --i;
+    const TimeSigSegment &segment = mTimeSigs[i];
+    return qnAbsToTime(segment.qn + (measure - segment.measure) * 4.0 * segment.num / segment.denom);
+}
+
+double RprTempoMap::bpmAtTime(double time) const
 {
-    return TimeMap2_timeToQN(0, t);
+    const TempoSegment &segment = tempoSegmentAtTime(time);
+    double offset = time - segment.time;
+    return offset > 0.0 ? segment.bpm + segment.slope * offset : segment.bpm;
 }
 
-double BPMatTime(double t)
+double RprTempoMap::dividedBpmAtTime(double time) const
 {
-    return TimeMap2_GetDividedBpmAtTime(0, t);
+    const TimeSigSegment &segment = timeSigSegmentAtQN(timeToQNAbs(time));
+    return bpmAtTime(time) * segment.denom / 4.0;
 }
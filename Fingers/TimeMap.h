@@ -1,16 +1,88 @@
 #ifndef _TIME_MAP_H_
 #define _TIME_MAP_H_
 
-double TimeToBeat(double time);
-double BeatToTime(double beat);
-int TimeToMeasure(double time);
-int BeatToMeasure(double beat);
-double MeasureToTime(int measure);
-int BeatsInMeasure(int measure);
-double BeatsTillMeasure(int measure);
-double BPMAtTime(double time);
-double QNtoTime(double qn);
-double TimeToQN(double t);
-double BPMatTime(double t);
+class RprTempoMap;
+
+/* Conversions over a tempo map obtained once per action, see RprTempoMap::get() */
+double TimeToBeat(const RprTempoMap &tempoMap, double time);
+double BeatToTime(const RprTempoMap &tempoMap, double beat);
+int TimeToMeasure(const RprTempoMap &tempoMap, double time);
+int BeatToMeasure(const RprTempoMap &tempoMap, double beat);
+double MeasureToTime(const RprTempoMap &tempoMap, int measure);
+int BeatsInMeasure(const RprTempoMap &tempoMap, int measure);
+double BeatsTillMeasure(const RprTempoMap &tempoMap, int measure);
+double BPMAtTime(const RprTempoMap &tempoMap, double time);
+double QNtoTime(const RprTempoMap &tempoMap, double qn);
+double TimeToQN(const RprTempoMap &tempoMap, double t);
+double BPMatTime(const RprTempoMap &tempoMap, double t);
+
+/* Piecewise copy of the current project's tempo map. Conversions are
+ * binary searched over the tempo markers and linear tempo ramps are
+ * integrated analytically, so they don't go through the REAPER API on
+ * every call. Anything the copy can't represent exactly (partial
+ * measures, full beat counts across time signature changes) falls back
+ * to the REAPER API.
+ */
+class RprTempoMap {
+public:
+    /* Tempo map of the current project, re-read when the project state
+     * changes and rebuilt only when the tempo markers actually differ.
+     * Edits that don't change the project state count (API calls before
+     * the undo point) are caught by comparing the marker count and REAPER's
+     * QN/measure just after the last marker, which depend on every marker.
+     * Validating costs a few API calls: call it once per action (or API
+     * call) and hold the reference for the conversions.
+     */
+    static const RprTempoMap &get();
+
+    double timeToQNAbs(double time) const;
+    double qnAbsToTime(double qn) const;
+    double timeToQN(double time) const;
+    double qnToTime(double qn) const;
+
+    /* Same as TimeMap2_timeToBeats with measures set: beats since measure start */
+    double timeToBeats(double time, int *measure, int *measureLength, int *denominator) const;
+    double timeToFullBeats(double time) const;
+    double fullBeatsToTime(double beats) const;
+    double measureToTime(int measure) const;
+
+    double bpmAtTime(double time) const;
+    double dividedBpmAtTime(double time) const;
+
+private:
+    struct TempoSegment {
+        double time;
+        double qn;
+        double bpm;
+        double slope; /* bpm per second, 0 unless linear */
+    };
+
+    struct TimeSigSegment {
+        double qn;
+        int measure;
+        int num;
+        int denom;
+    };
+
+    RprTempoMap();
+    void build();
+    bool isStale(ReaProject *project) const;
+
+    const TempoSegment &tempoSegmentAtTime(double time) const;
+    const TempoSegment &tempoSegmentAtQN(double qn) const;
+    const TimeSigSegment &timeSigSegmentAtQN(double qn) const;
+
+    std::vector<TempoSegment> mTempo;
+    std::vector<TimeSigSegment> mTimeSigs;
+    bool mRegular;
+
+    ReaProject *mProject;
+    int mStateCount;
+    int mMarkerCount;
+    double mProbeTime;
+    double mProbeQN;
+    int mProbeMeasure;
+    WDL_UINT64 mHash;
+};
 
 #endif /*_TIME_MAP_H_*/
@@ -0,0 +1,110 @@
+/******************************************************************************
+/ ArenaScenarios.cpp
+/
+/ Copyright (c) 2026 SWS
+/
+/
+/ Permission is hereby granted, free of charge, to any person obtaining a copy
+/ of this software and associated documentation files (the "Software"), to deal
+/ in the Software without restriction, including without limitation the rights to
+/ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/ of the Software, and to permit persons to whom the Software is furnished to
+/ do so, subject to the following conditions:
+/
+/ The above copyright notice and this permission notice shall be included in all
+/ copies or substantial portions of the Software.
+/
+/ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+/ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+/ OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+/ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+/ HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+/ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+/ OTHER DEALINGS IN THE SOFTWARE.
+/
+******************************************************************************/
+
+#include "stdafx.h"
+#include "Harness.h"
+#include "../Utility/SampleArena.h"
+
+namespace {
+
+// one block of an analysis loop: fill and read the buffer like
+// GetAudioAccessorSamples() and the analysis would
+double TouchBlock(ReaSample* buf, int count)
+{
+	double sum = 0.0;
+	for (int i = 0; i < count; i += 16)
+		sum += buf[i] = (double)i;
+	return sum;
+}
+
+} // namespace
+
+// SWS_SampleArena as the analysis loops use it: after the first block (or
+// item) a warm arena must not allocate anymore
+HARNESS_TEST(sample_arena_steady_state)
+{
+	const int nbBlocks = ctx.Size(20000, 500), nch = 2;
+	double sum = 0.0;
+
+	// loudness (BR_LoudnessObject::AnalyzeData): 200 ms blocks at 48 kHz
+	SWS_SampleArena loudness;
+	for (int i = 0; i < nbBlocks; i++)
+	{
+		SWS_SampleBuf buf(&loudness, 9600 * nch);
+		HARNESS_CHECK(r, buf.Get() && !((INT_PTR)buf.Get() & 63));
+		if (!buf.Get())
+			return;
+		sum += TouchBlock(buf.Get(), 9600 * nch);
+	}
+	HARNESS_CHECK(r, loudness.GetAllocCount() == 1);
+	HARNESS_CHECK(r, loudness.GetRequestCount() == nbBlocks);
+
+	// item analysis and transient detection: one worker arena for every item,
+	// two buffers per item (samples + previous window, samples + mono mix)
+	SWS_SampleArena worker;
+	int warmAllocs = 0;
+	for (int item = 0; item < nbBlocks / 10; item++)
+	{
+		const int length = 4097 + (item * 37) % 4095; // same size classes for all items
+		{
+			SWS_SampleBuf samples(&worker, length * nch), prev(&worker, length * nch);
+			HARNESS_CHECK(r, samples.Get() && prev.Get() && samples.Get() != prev.Get());
+			if (samples.Get() && prev.Get())
+				sum += TouchBlock(samples.Get(), length * nch) + TouchBlock(prev.Get(), length * nch);
+		}
+		{
+			SWS_SampleBuf samples(&worker, length * nch), mono(&worker, length);
+			if (samples.Get() && mono.Get())
+				sum += TouchBlock(samples.Get(), length * nch) + TouchBlock(mono.Get(), length);
+		}
+		if (!item)
+			warmAllocs = worker.GetAllocCount();
+	}
+	HARNESS_CHECK(r, warmAllocs == 3 && worker.GetAllocCount() == warmAllocs);
+
+	// empty requests (no previous window) are neither served nor counted
+	const int nbRequests = worker.GetRequestCount();
+	HARNESS_CHECK(r, !worker.Get(0) && worker.GetRequestCount() == nbRequests);
+
+	// per block cost vs. the std::vector per block it replaced
+	HarnessTimer t;
+	for (int i = 0; i < nbBlocks; i++)
+	{
+		SWS_SampleBuf buf(&loudness, 9600 * nch);
+		sum += TouchBlock(buf.Get(), 9600 * nch);
+	}
+	r.Metric("arena_block_us", t.Ms() * 1000.0 / nbBlocks);
+
+	t.Reset();
+	for (int i = 0; i < nbBlocks; i++)
+	{
+		std::vector<double> buf(9600 * nch);
+		sum += TouchBlock(&buf[0], 9600 * nch);
+	}
+	r.Metric("vector_block_us", t.Ms() * 1000.0 / nbBlocks);
+	HARNESS_CHECK(r, loudness.GetAllocCount() == 1 && sum > 0.0);
+}
@@ -0,0 +1,219 @@
+/******************************************************************************
+/ ChunkScenarios.cpp
+/
+/ Copyright (c) 2026 SWS
+/
+/
+/ Permission is hereby granted, free of charge, to any person obtaining a copy
+/ of this software and associated documentation files (the "Software"), to deal
+/ in the Software without restriction, including without limitation the rights to
+/ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/ of the Software, and to permit persons to whom the Software is furnished to
+/ do so, subject to the following conditions:
+/
+/ The above copyright notice and this permission notice shall be included in all
+/ copies or substantial portions of the Software.
+/
+/ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+/ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+/ OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+/ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+/ HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+/ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+/ OTHER DEALINGS IN THE SOFTWARE.
+/
+******************************************************************************/
+
+#include "stdafx.h"
+#include "Harness.h"
+#include "ReaperStub.h"
+#include "../SnM/SnM.h"
+#include "../SnM/SnM_ChunkParserPatcher.h"
+#include "../SnM/SnM_Util.h"
+
+namespace {
+
+// items of 2 seconds with an in-project MIDI take of nbNotes 8th notes
+void AddMidiItems(StubTrack* tr, int nbItems, int nbNotes)
+{
+	std::vector<StubMidiEvent> events;
+	for (int n = 0; n < nbNotes; n++)
+		Stub_AddNote(&events, n * 480.0, n * 480.0 + 240.0, 0, 60 + n % 12, 100, 0, 0);
+	Stub_SortEvents(&events);
+	for (int i = 0; i < nbItems; i++)
+		Stub_AddMidiTake(Stub_AddItem(tr, i * 2.0, 2.0), events, 3840.0);
+}
+
+// an FX chain file as REAPER writes them on Windows: indented, "\r\n", base64
+// plugin states. Returns the size LoadChunk() should get once trimmed
+int WriteFxChain(const char* fn, int minBytes)
+{
+	FILE* f = fopen(fn, "wb");
+	if (!f)
+		return -1;
+
+	char b64[129];
+	for (int i = 0; i < 128; i++)
+		b64[i] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[(i * 7) % 64];
+	b64[128] = '\0';
+
+	int written = 0, trimmed = 0;
+	for (int fx = 0; written < minBytes; fx++)
+	{
+		WDL_FastString block;
+		block.AppendFormatted(128, "BYPASS 0 0 0\r\n<VST \"VST: ReaEQ (Cockos)\" reaeq.dll 0 \"\" %d\r\n", 1919247729 + fx);
+		trimmed += block.GetLength() - 2;
+		for (int i = 0; i < 64; i++)
+		{
+			block.AppendFormatted(256, "  %s\r\n", b64);
+			trimmed += 129;
+		}
+		const char* tail = ">\r\nFLOATPOS 0 0 0 0\r\nWAK 0 0\r\n";
+		block.Append(tail);
+		trimmed += (int)strlen(tail) - 3;
+		if (fwrite(block.Get(), 1, block.GetLength(), f) != (size_t)block.GetLength())
+		{
+			fclose(f);
+			return -1;
+		}
+		written += block.GetLength();
+	}
+	return fclose(f) ? -1 : trimmed;
+}
+
+// LoadChunk() before the bulk read: fgets line by line
+void LoadChunkByLine(const char* fn, WDL_FastString* chunkOut)
+{
+	chunkOut->Set("");
+	if (FILE* f = fopen(fn, "r"))
+	{
+		char line[SNM_MAX_CHUNK_LINE_LENGTH]="";
+		while(fgets(line, sizeof(line), f) && *line)
+		{
+			char* p = line;
+			while(*p && (*p == ' ' || *p == '\t')) p++;
+			if (*p && *p!='\n' && *p!='\r')
+				if (const char* eol = FindFirstRN(p)) {
+					chunkOut->Append(p, (int)(eol-p));
+					chunkOut->Append("\n");
+				}
+		}
+		fclose(f);
+	}
+}
+
+} // namespace
+
+// what SWS reads is what it writes back
+HARNESS_TEST(stub_chunk_roundtrip)
+{
+	StubProject* proj = Stub_GetProject();
+	StubTrack* src = Stub_AddTrack(proj, "Source");
+	StubTrack* tr = Stub_AddTrack(proj, "Track \"1\"");
+	AddMidiItems(tr, 3, 8);
+	Stub_AddSend(src, tr)->vol = 0.5;
+	StubEnvelope* env = Stub_AddEnvelope(tr, "VOLENV2");
+	const StubEnvelope::Point pt = { 1.0, 0.5, 0, 0.0, false };
+	env->m_points.push_back(pt);
+
+	char* chunk = GetSetObjectState(Stub_Rpr(tr), NULL);
+	HARNESS_CHECK(r, chunk && !strncmp(chunk, "<TRACK", 6));
+	const std::string before = chunk ? chunk : "";
+	FreeHeapPtr(chunk);
+
+	HARNESS_CHECK(r, !GetSetObjectState(Stub_Rpr(tr), before.c_str()));
+	chunk = GetSetObjectState(Stub_Rpr(tr), NULL);
+	HARNESS_CHECK(r, chunk && before == chunk);
+	FreeHeapPtr(chunk);
+
+	HARNESS_CHECK(r, tr->m_name == "Track \"1\"");
+	HARNESS_CHECK(r, tr->m_items.size() == 3 && tr->m_items[2]->m_takes.size() == 1);
+	HARNESS_CHECK(r, tr->m_items[2]->m_takes[0]->m_events.size() == 16);
+	HARNESS_CHECK(r, tr->m_envelopes.size() == 1 && tr->m_envelopes[0]->m_points.size() == 1);
+	HARNESS_CHECK(r, GetTrackNumSends(Stub_Rpr(tr), -1) == 1 && GetTrackSendInfo_Value(Stub_Rpr(src), 0, 0, "D_VOL") == 0.5);
+}
+
+// SNM_ChunkParserPatcher on a large project: count, patch and commit the items
+// of every track, as the S&M item/take actions do
+HARNESS_BENCH(chunk_parse_patch)
+{
+	const int nbTracks = ctx.Size(100, 4), nbItems = ctx.Size(500, 20);
+	StubProject* proj = Stub_GetProject();
+	for (int i = 0; i < nbTracks; i++)
+		AddMidiItems(Stub_AddTrack(proj), nbItems, 32);
+
+	double getMs = 0.0, parseMs = 0.0, patchMs = 0.0, commitMs = 0.0, bytes = 0.0;
+	int nbFound = 0, nbUpdates = 0;
+	for (int i = 0; i < nbTracks; i++)
+	{
+		SNM_ChunkParserPatcher p(CSurf_TrackFromID(i + 1, false), false);
+
+		HarnessTimer t;
+		bytes += p.GetChunk()->GetLength();
+		getMs += t.Ms();
+
+		t.Reset();
+		nbFound += p.Parse(SNM_COUNT_KEYWORD, 2, "ITEM", "POSITION");
+		parseMs += t.Ms();
+
+		t.Reset();
+		nbUpdates += p.ParsePatch(SNM_SET_CHUNK_CHAR, 2, "ITEM", "MUTE", -1, 1, (void*)"1");
+		patchMs += t.Ms();
+
+		t.Reset();
+		HARNESS_CHECK(r, p.Commit());
+		commitMs += t.Ms();
+	}
+
+	HARNESS_CHECK(r, nbFound == nbTracks * nbItems);
+	HARNESS_CHECK(r, nbUpdates == nbTracks * nbItems);
+	int nbMuted = 0;
+	for (int i = 0; i < nbTracks; i++)
+		for (size_t j = 0; j < proj->m_tracks[i]->m_items.size(); j++)
+			nbMuted += proj->m_tracks[i]->m_items[j]->m_mute ? 1 : 0;
+	HARNESS_CHECK(r, nbMuted == nbTracks * nbItems);
+
+	r.Metric("chunk_mb", bytes / (1024.0 * 1024.0));
+	r.Metric("get_ms", getMs);
+	r.Metric("parse_ms", parseMs);
+	r.Metric("patch_ms", patchMs);
+	r.Metric("commit_ms", commitMs);
+	r.Metric("parse_mb_s", parseMs > 0.0 ? bytes / (1024.0 * 1024.0) / (parseMs / 1000.0) : 0.0);
+}
+
+// LoadChunk()/SaveChunk() on a 50 MB FX chain file of the resource path
+HARNESS_BENCH(chunk_file_load_save)
+{
+	char fn[SNM_MAX_PATH], savedFn[SNM_MAX_PATH];
+	snprintf(fn, sizeof(fn), "%s/big.RfxChain", ctx.GetResourcePath());
+	snprintf(savedFn, sizeof(savedFn), "%s/saved.RfxChain", ctx.GetResourcePath());
+	const int expected = WriteFxChain(fn, ctx.Size(50, 1) * 1024 * 1024);
+	HARNESS_CHECK(r, expected > 0);
+
+	WDL_FastString chunk, saved, byLine;
+	HarnessTimer t;
+	HARNESS_CHECK(r, LoadChunk(fn, &chunk));
+	const double loadMs = t.Ms();
+	HARNESS_CHECK(r, chunk.GetLength() == expected && !strchr(chunk.Get(), '\r'));
+
+	t.Reset();
+	HARNESS_CHECK(r, SaveChunk(savedFn, &chunk, true));
+	const double saveMs = t.Ms();
+
+	HARNESS_CHECK(r, LoadChunk(savedFn, &saved));
+	HARNESS_CHECK(r, !strcmp(saved.Get(), chunk.Get()));
+
+	t.Reset();
+	LoadChunkByLine(fn, &byLine);
+	const double byLineMs = t.Ms();
+	HARNESS_CHECK(r, !strcmp(byLine.Get(), chunk.Get()));
+
+	const double mb = chunk.GetLength() / (1024.0 * 1024.0);
+	r.Metric("chunk_mb", mb);
+	r.Metric("load_ms", loadMs);
+	r.Metric("save_ms", saveMs);
+	r.Metric("load_mb_s", loadMs > 0.0 ? mb / (loadMs / 1000.0) : 0.0);
+	r.Metric("save_mb_s", saveMs > 0.0 ? mb / (saveMs / 1000.0) : 0.0);
+	r.Metric("by_line_load_ms", byLineMs);
+}
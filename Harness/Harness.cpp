@@ -0,0 +1,254 @@
+/******************************************************************************
+/ Harness.cpp
+/
+/ Copyright (c) 2026 SWS
+/
+/
+/ Permission is hereby granted, free of charge, to any person obtaining a copy
+/ of this software and associated documentation files (the "Software"), to deal
+/ in the Software without restriction, including without limitation the rights to
+/ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/ of the Software, and to permit persons to whom the Software is furnished to
+/ do so, subject to the following conditions:
+/
+/ The above copyright notice and this permission notice shall be included in all
+/ copies or substantial portions of the Software.
+/
+/ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+/ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+/ OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+/ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+/ HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+/ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+/ OTHER DEALINGS IN THE SOFTWARE.
+/
+******************************************************************************/
+
+#include "stdafx.h"
+#include "Harness.h"
+#include "ReaperStub.h"
+#include "../SnM/SnM.h"
+
+#include <chrono>
+#include <stdarg.h>
+#include <ftw.h>
+#include <sys/stat.h>
+
+void HarnessResult::Metric(const char* name, double value)
+{
+	MetricValue m = { name, value };
+	m_metrics.push_back(m);
+}
+
+void HarnessResult::Fail(const char* fmt, ...)
+{
+	if (!m_error.empty())
+		return;
+	char buf[1024];
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(buf, sizeof(buf), fmt, args);
+	va_end(args);
+	m_error = *buf ? buf : "failed";
+}
+
+void HarnessTimer::Reset()
+{
+	m_start = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double HarnessTimer::Ms() const
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count() - m_start;
+}
+
+std::vector<HarnessScenario>& HarnessScenarios()
+{
+	static std::vector<HarnessScenario> s_scenarios;
+	return s_scenarios;
+}
+
+namespace {
+
+struct ScenarioRun
+{
+	const HarnessScenario* scenario;
+	HarnessResult result;
+	double ms;
+};
+
+void AppendJsonString(std::string* json, const char* s)
+{
+	*json += '"';
+	for (; *s; s++)
+	{
+		const unsigned char c = (unsigned char)*s;
+		if (c == '"' || c == '\\') { *json += '\\'; *json += (char)c; }
+		else if (c < 0x20)
+		{
+			char buf[8];
+			snprintf(buf, sizeof(buf), "\\u%04x", c);
+			*json += buf;
+		}
+		else
+			*json += (char)c;
+	}
+	*json += '"';
+}
+
+bool WriteJson(const char* fn, const std::vector<ScenarioRun>& runs, bool quick)
+{
+	std::string json = quick ? "{\"quick\":true,\"scenarios\":[" : "{\"quick\":false,\"scenarios\":[";
+	for (size_t i = 0; i < runs.size(); i++)
+	{
+		const ScenarioRun& run = runs[i];
+		char buf[64];
+		json += i ? ",\n{\"name\":" : "\n{\"name\":";
+		AppendJsonString(&json, run.scenario->name);
+		json += run.scenario->kind == HARNESS_KIND_BENCH ? ",\"kind\":\"bench\"" : ",\"kind\":\"test\"";
+		json += run.result.Ok() ? ",\"ok\":true,\"error\":" : ",\"ok\":false,\"error\":";
+		AppendJsonString(&json, run.result.GetError().c_str());
+		snprintf(buf, sizeof(buf), ",\"ms\":%.3f,\"metrics\":{", run.ms);
+		json += buf;
+		const std::vector<HarnessResult::MetricValue>& metrics = run.result.GetMetrics();
+		for (size_t j = 0; j < metrics.size(); j++)
+		{
+			if (j) json += ',';
+			AppendJsonString(&json, metrics[j].name.c_str());
+			snprintf(buf, sizeof(buf), ":%.6g", metrics[j].value);
+			json += buf;
+		}
+		json += "}}";
+	}
+	json += "\n]}\n";
+
+	FILE* f = fopen(fn, "w");
+	if (!f)
+		return false;
+	const bool ok = fwrite(json.c_str(), 1, json.size(), f) == json.size();
+	return !fclose(f) && ok;
+}
+
+int RemoveFile(const char* path, const struct stat*, int, struct FTW*)
+{
+	return remove(path);
+}
+
+void Usage(const char* exe)
+{
+	fprintf(stderr,
+		"usage: %s [--list] [--quick] [--tests|--benches] [--json <file>] [scenario...]\n"
+		"  --list     list the scenarios and exit\n"
+		"  --quick    smaller synthetic projects (ctest)\n"
+		"  --tests    run the tests only\n"
+		"  --benches  run the benchmarks only\n"
+		"  --json     write the results and metrics to <file>\n", exe);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	bool quick = false, list = false, tests = true, benches = true;
+	const char* jsonFn = NULL;
+	std::vector<std::string> names;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--list")) list = true;
+		else if (!strcmp(argv[i], "--quick")) quick = true;
+		else if (!strcmp(argv[i], "--tests")) benches = false;
+		else if (!strcmp(argv[i], "--benches")) tests = false;
+		else if (!strcmp(argv[i], "--json") && i + 1 < argc) jsonFn = argv[++i];
+		else if (argv[i][0] == '-') { Usage(argv[0]); return 2; }
+		else names.push_back(argv[i]);
+	}
+
+	// registration order depends on the link order: sort for repeatable runs
+	std::vector<HarnessScenario> scenarios = HarnessScenarios();
+	std::sort(scenarios.begin(), scenarios.end(),
+		[](const HarnessScenario& a, const HarnessScenario& b) { return strcmp(a.name, b.name) < 0; });
+
+	std::vector<const HarnessScenario*> selected;
+	for (size_t i = 0; i < scenarios.size(); i++)
+	{
+		const HarnessScenario& s = scenarios[i];
+		if (names.empty() ? (s.kind == HARNESS_KIND_TEST ? tests : benches) : std::find(names.begin(), names.end(), s.name) != names.end())
+			selected.push_back(&s);
+	}
+	for (size_t i = 0; i < names.size(); i++)
+		if (std::find_if(selected.begin(), selected.end(), [&](const HarnessScenario* s) { return names[i] == s->name; }) == selected.end())
+		{
+			fprintf(stderr, "unknown scenario: %s\n", names[i].c_str());
+			return 2;
+		}
+
+	if (list)
+	{
+		for (size_t i = 0; i < selected.size(); i++)
+			printf("%s\t%s\n", selected[i]->kind == HARNESS_KIND_BENCH ? "bench" : "test", selected[i]->name);
+		return 0;
+	}
+
+	char tmpDir[] = "/tmp/sws_harness.XXXXXX";
+	if (!mkdtemp(tmpDir))
+	{
+		perror("mkdtemp");
+		return 2;
+	}
+
+	Stub_Install();
+
+	std::vector<ScenarioRun> runs(selected.size());
+	int failed = 0;
+	for (size_t i = 0; i < selected.size(); i++)
+	{
+		ScenarioRun& run = runs[i];
+		run.scenario = selected[i];
+
+		// each scenario gets an empty project and resource path
+		HarnessContext ctx;
+		ctx.m_quick = quick;
+		ctx.m_resourcePath = std::string(tmpDir) + "/" + run.scenario->name;
+		mkdir(ctx.m_resourcePath.c_str(), 0700);
+		Stub_Reset(ctx.GetResourcePath());
+		g_SNM_IniFn.SetFormatted(SNM_MAX_PATH, SNM_FORMATED_INI_FILE, GetResourcePath());
+
+		HarnessTimer t;
+		try
+		{
+			run.scenario->func(ctx, run.result);
+		}
+		catch (const std::exception& e)
+		{
+			run.result.Fail("exception: %s", e.what());
+		}
+		catch (...)
+		{
+			run.result.Fail("unknown exception");
+		}
+		run.ms = t.Ms();
+		Stub_FlushIniFiles();
+
+		if (!run.result.Ok())
+			failed++;
+		printf("%s %s (%.1f ms)%s%s\n", run.result.Ok() ? "PASS" : "FAIL", run.scenario->name, run.ms,
+			run.result.Ok() ? "" : ": ", run.result.GetError().c_str());
+		const std::vector<HarnessResult::MetricValue>& metrics = run.result.GetMetrics();
+		for (size_t j = 0; j < metrics.size(); j++)
+			printf("  %s = %g\n", metrics[j].name.c_str(), metrics[j].value);
+		fflush(stdout);
+	}
+
+	Stub_Reset(tmpDir);
+	nftw(tmpDir, RemoveFile, 16, FTW_DEPTH | FTW_PHYS);
+
+	if (jsonFn && !WriteJson(jsonFn, runs, quick))
+	{
+		fprintf(stderr, "can't write %s\n", jsonFn);
+		return 2;
+	}
+
+	printf("%d/%d scenarios passed\n", (int)selected.size() - failed, (int)selected.size());
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+/******************************************************************************
+/ Harness.h
+/
+/ Copyright (c) 2026 SWS
+/
+/
+/ Permission is hereby granted, free of charge, to any person obtaining a copy
+/ of this software and associated documentation files (the "Software"), to deal
+/ in the Software without restriction, including without limitation the rights to
+/ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/ of the Software, and to permit persons to whom the Software is furnished to
+/ do so, subject to the following conditions:
+/
+/ The above copyright notice and this permission notice shall be included in all
+/ copies or substantial portions of the Software.
+/
+/ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+/ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+/ OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+/ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+/ HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+/ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+/ OTHER DEALINGS IN THE SOFTWARE.
+/
+******************************************************************************/
+
+#pragma once
+
+// Headless test and benchmark harness: runs SWS code against the stub REAPER
+// API of ReaperStub.h, without REAPER (Linux only, BUILD_SWS_HARNESS=ON).
+//
+// A scenario is a test (pass/fail checks) or a benchmark (timings, plus checks
+// that the timed code did its job). Each one starts with an empty stub project
+// and reports named metrics, written to the --json file.
+//
+// HARNESS_TEST(chunk_roundtrip)
+// {
+//     const int n = ctx.Size(100000, 1000); // full size, --quick size
+//     HarnessTimer t;
+//     ...
+//     r.Metric("parse_ms", t.Ms());
+//     HARNESS_CHECK(r, count == n);
+// }
+
+#include <string>
+#include <vector>
+
+class HarnessContext
+{
+public:
+	HarnessContext() : m_quick(false) {}
+
+	// --quick (ctest): smaller synthetic projects, same code paths
+	bool IsQuick() const { return m_quick; }
+	int Size(int full, int quick) const { return m_quick ? quick : full; }
+	const char* GetResourcePath() const { return m_resourcePath.c_str(); }
+
+	bool m_quick;
+	std::string m_resourcePath;
+};
+
+class HarnessResult
+{
+public:
+	struct MetricValue
+	{
+		std::string name;
+		double value;
+	};
+
+	void Metric(const char* name, double value);
+	// keeps the first failure, a scenario carries on after a failed check
+	void Fail(const char* fmt, ...)
+#ifdef __GNUC__
+		__attribute__((format(printf, 2, 3)))
+#endif
+	;
+	bool Ok() const { return m_error.empty(); }
+	const std::string& GetError() const { return m_error; }
+	const std::vector<MetricValue>& GetMetrics() const { return m_metrics; }
+
+private:
+	std::string m_error;
+	std::vector<MetricValue> m_metrics;
+};
+
+class HarnessTimer
+{
+public:
+	HarnessTimer() { Reset(); }
+	void Reset();
+	double Ms() const;
+
+private:
+	double m_start;
+};
+
+enum HarnessKind { HARNESS_KIND_TEST, HARNESS_KIND_BENCH };
+
+typedef void (*HarnessFunc)(const HarnessContext& ctx, HarnessResult& r);
+
+struct HarnessScenario
+{
+	const char* name;
+	HarnessKind kind;
+	HarnessFunc func;
+};
+
+std::vector<HarnessScenario>& HarnessScenarios();
+
+struct HarnessRegistrar
+{
+	HarnessRegistrar(const char* name, HarnessKind kind, HarnessFunc func)
+	{
+		HarnessScenario s = { name, kind, func };
+		HarnessScenarios().push_back(s);
+	}
+};
+
+#define HARNESS_SCENARIO(kind, name) \
+	static void Harness_##name(const HarnessContext& ctx, HarnessResult& r); \
+	static HarnessRegistrar s_harness_##name(#name, kind, Harness_##name); \
+	static void Harness_##name(const HarnessContext& ctx, HarnessResult& r)
+
+#define HARNESS_TEST(name)  HARNESS_SCENARIO(HARNESS_KIND_TEST, name)
+#define HARNESS_BENCH(name) HARNESS_SCENARIO(HARNESS_KIND_BENCH, name)
+
+#define HARNESS_CHECK(r, cond) \
+	do { if (!(cond)) (r).Fail("%s:%d: check failed: %s", __FILE__, __LINE__, #cond); } while (0)
@@ -0,0 +1,108 @@
+/******************************************************************************
+/ ItemIndexScenarios.cpp
+/
+/ Copyright (c) 2026 SWS
+/
+/
+/ Permission is hereby granted, free of charge, to any person obtaining a copy
+/ of this software and associated documentation files (the "Software"), to deal
+/ in the Software without restriction, including without limitation the rights to
+/ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/ of the Software, and to permit persons to whom the Software is furnished to
+/ do so, subject to the following conditions:
+/
+/ The above copyright notice and this permission notice shall be included in all
+/ copies or substantial portions of the Software.
+/
+/ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+/ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+/ OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+/ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+/ HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+/ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+/ OTHER DEALINGS IN THE SOFTWARE.
+/
+******************************************************************************/
+
+#include "stdafx.h"
+#include "Harness.h"
+#include "ReaperStub.h"
+#include "../Breeder/BR_Util.h"
+
+namespace {
+
+// what GetItemAtPosition did before the index
+MediaItem* ScanItemAtPosition(MediaTrack* track, double position)
+{
+	const int count = CountTrackMediaItems(track);
+	for (int i = 0; i < count; ++i)
+	{
+		MediaItem* item = GetTrackMediaItem(track, i);
+		const double start = GetMediaItemInfo_Value(item, "D_POSITION");
+		if (position >= start && position <= start + GetMediaItemInfo_Value(item, "D_LENGTH"))
+			return item;
+	}
+	return NULL;
+}
+
+} // namespace
+
+// GetItemAtPosition (mouse context, ItemAtPoint) on a 50k item project: one
+// second items with half second gaps so a quarter of the queries hit nothing
+HARNESS_BENCH(item_at_position)
+{
+	const int nbTracks = ctx.Size(10, 2), nbItems = ctx.Size(5000, 200), nbQueries = ctx.Size(200000, 2000);
+	StubProject* proj = Stub_GetProject();
+	for (int i = 0; i < nbTracks; i++)
+	{
+		StubTrack* tr = Stub_AddTrack(proj);
+		for (int j = 0; j < nbItems; j++)
+			Stub_AddItem(tr, j * 1.5, 1.0);
+	}
+
+	// same pseudo random queries for both lookups
+	std::vector<std::pair<MediaTrack*,double> > queries(nbQueries);
+	unsigned int seed = 1;
+	for (int i = 0; i < nbQueries; i++)
+	{
+		seed = seed * 1664525 + 1013904223;
+		queries[i] = std::make_pair(CSurf_TrackFromID(1 + (seed >> 8) % nbTracks, false), (seed >> 4) % (nbItems * 1500) / 1000.0);
+	}
+
+	HarnessTimer t;
+	for (int i = 0; i < nbTracks; i++)
+		GetItemAtPosition(CSurf_TrackFromID(i + 1, false), 0.0);
+	r.Metric("build_ms", t.Ms());
+
+	std::vector<MediaItem*> found(nbQueries);
+	t.Reset();
+	for (int i = 0; i < nbQueries; i++)
+		found[i] = GetItemAtPosition(queries[i].first, queries[i].second);
+	r.Metric("index_us", t.Ms() * 1000.0 / nbQueries);
+
+	int nbMismatches = 0, nbHits = 0;
+	t.Reset();
+	for (int i = 0; i < nbQueries; i++)
+	{
+		MediaItem* item = ScanItemAtPosition(queries[i].first, queries[i].second);
+		nbMismatches += item != found[i] ? 1 : 0;
+		nbHits += item ? 1 : 0;
+	}
+	r.Metric("scan_us", t.Ms() * 1000.0 / nbQueries);
+	HARNESS_CHECK(r, nbMismatches == 0);
+	HARNESS_CHECK(r, nbHits > 0 && nbHits < nbQueries);
+
+	// a move through the API invalidates the index...
+	MediaTrack* tr = CSurf_TrackFromID(1, false);
+	MediaItem* last = GetTrackMediaItem(tr, nbItems - 1);
+	SetMediaItemInfo_Value(last, "D_POSITION", nbItems * 1.5 + 10.0);
+	HARNESS_CHECK(r, GetItemAtPosition(tr, nbItems * 1.5 + 10.5) == last);
+
+	// ...a move it didn't see (mouse edits) is caught by the live check on
+	// the next query that reaches the item, which rebuilds the track
+	StubItem* first = proj->m_tracks[0]->m_items[0].get();
+	first->m_position = 0.25;
+	HARNESS_CHECK(r, !GetItemAtPosition(tr, 0.1));
+	HARNESS_CHECK(r, GetItemAtPosition(tr, 1.1) == Stub_Rpr(first));
+}
@@ -0,0 +1,147 @@
+/******************************************************************************
+/ MidiScenarios.cpp
+/
+/ Copyright (c) 2026 SWS
+/
+/
+/ Permission is hereby granted, free of charge, to any person obtaining a copy
+/ of this software and associated documentation files (the "Software"), to deal
+/ in the Software without restriction, including without limitation the rights to
+/ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/ of the Software, and to permit persons to whom the Software is furnished to
+/ do so, subject to the following conditions:
+/
+/ The above copyright notice and this permission notice shall be included in all
+/ copies or substantial portions of the Software.
+/
+/ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+/ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+/ OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+/ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+/ HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+/ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+/ OTHER DEALINGS IN THE SOFTWARE.
+/
+******************************************************************************/
+
+#include "stdafx.h"
+#include "Harness.h"
+#include "ReaperStub.h"
+#include "../Breeder/BR_MidiUtil.h"
+#include "../Breeder/BR_ProjState.h"
+#include "../Fingers/RprMidiTake.h"
+
+namespace {
+
+// inline editor state BR_MidiEditor reads from the take source: lanes, view,
+// event filter off, draw channel 1
+void SetEditorLanes(StubTake* take, const std::vector<int>& lanes)
+{
+	for (size_t i = 0; i < lanes.size(); i++)
+	{
+		char line[64];
+		snprintf(line, sizeof(line), "VELLANE %d 50 0", lanes[i]);
+		take->m_sourceLines.push_back(line);
+	}
+	take->m_sourceLines.push_back("CFGEDITVIEW 0 0.125 64 12 0 -1 0 0 0 0.5");
+	take->m_sourceLines.push_back("EVTFILTER 0 -1 -1 -1 -1 0 0 0 0 -1 -1 -1 -1 0 -1 0 -1 -1");
+	take->m_sourceLines.push_back("CFGEDIT 1 1 0 1 0 0 1 1 1 1 1 0.125 0 0 1024 768 0 0 0 0 0.0 0 0 0 0 0 1 64");
+}
+
+} // namespace
+
+// the velocity off lane (167) is above the 14-bit CC lanes: saving it must
+// take the notes, not the CC #33 events a 14-bit CC #1 lane would get
+HARNESS_TEST(midi_cc_events_velocity_off_lane)
+{
+	std::vector<StubMidiEvent> events;
+	for (int i = 0; i < 4; i++)
+		Stub_AddNote(&events, i * 960.0, i * 960.0 + 480.0, 0, 60 + i, 90 + i, 10 + i, 1);
+	for (int i = 0; i < 6; i++)
+		Stub_AddCC(&events, i * 480.0, STATUS_CC, 0, 33, 50, 1);
+	Stub_SortEvents(&events);
+
+	StubItem* item = Stub_AddItem(Stub_AddTrack(Stub_GetProject()), 0.0, 8.0);
+	StubTake* tk = Stub_AddMidiTake(item, events, 16 * 960.0);
+	std::vector<int> lanes;
+	lanes.push_back(CC_VELOCITY_OFF);
+	lanes.push_back(7);
+	SetEditorLanes(tk, lanes);
+	MediaItem_Take* take = Stub_Rpr(tk);
+
+	BR_MidiEditor editor(take);
+	HARNESS_CHECK(r, editor.IsValid());
+
+	BR_MidiCCEvents saved(0, CC_VELOCITY_OFF);
+	HARNESS_CHECK(r, saved.Save(editor, CC_VELOCITY_OFF));
+	HARNESS_CHECK(r, saved.CountSavedEvents() == 4);
+
+	// REAPER can't insert on the velocity off lane: restoring there is a no-op...
+	HARNESS_CHECK(r, !saved.Restore(editor, CC_VELOCITY_OFF, false, 0.0, false, false));
+	int nbNotes, nbCCs;
+	MIDI_CountEvts(take, &nbNotes, &nbCCs, NULL);
+	HARNESS_CHECK(r, nbNotes == 4 && nbCCs == 6);
+
+	// ...a CC lane gets the saved velocities
+	HARNESS_CHECK(r, saved.Restore(editor, 7, false, 0.0, false, false));
+	MIDI_CountEvts(take, &nbNotes, &nbCCs, NULL);
+	HARNESS_CHECK(r, nbNotes == 4 && nbCCs == 10);
+	int nbRestored = 0;
+	for (int i = 0; i < nbCCs; i++)
+	{
+		double pos;
+		int chanMsg, msg2, msg3;
+		if (MIDI_GetCC(take, i, NULL, NULL, &pos, &chanMsg, NULL, &msg2, &msg3) && chanMsg == STATUS_CC && msg2 == 7)
+		{
+			HARNESS_CHECK(r, pos == nbRestored * 960.0 && msg3 == 90 + nbRestored);
+			nbRestored++;
+		}
+	}
+	HARNESS_CHECK(r, nbRestored == 4);
+}
+
+// RprMidiTake (the FNG_* MIDI take API) on a 100k event take: parse the
+// source, edit a quarter of the notes and commit them back to the item
+HARNESS_BENCH(fingers_midi_take)
+{
+	const int nbNotes = ctx.Size(50000, 500);
+	std::vector<StubMidiEvent> events;
+	for (int i = 0; i < nbNotes; i++)
+		Stub_AddNote(&events, i * 240.0, i * 240.0 + 120.0, 0, 36 + i % 48, 100, 0, 0);
+	Stub_SortEvents(&events);
+	StubItem* item = Stub_AddItem(Stub_AddTrack(Stub_GetProject()), 0.0, nbNotes / 8.0);
+	StubTake* tk = Stub_AddMidiTake(item, events, nbNotes * 240.0);
+
+	HarnessTimer t;
+	RprMidiTake* midiTake = FNG_AllocMidiTake(Stub_Rpr(tk));
+	const double allocMs = t.Ms();
+	HARNESS_CHECK(r, midiTake && FNG_CountMidiNotes(midiTake) == nbNotes);
+
+	t.Reset();
+	for (int i = 0; i < nbNotes; i += 4)
+		FNG_SetMidiNoteIntProperty(FNG_GetMidiNote(midiTake, i), "VELOCITY", 50);
+	const double editMs = t.Ms();
+
+	t.Reset();
+	FNG_FreeMidiTake(midiTake);
+	const double commitMs = t.Ms();
+
+	int nbNoteOns = 0, nbEdited = 0;
+	for (size_t i = 0; i < tk->m_events.size(); i++)
+	{
+		const std::string& msg = tk->m_events[i].msg;
+		if (msg.size() == 3 && ((unsigned char)msg[0] & 0xF0) == 0x90 && msg[2])
+		{
+			nbNoteOns++;
+			nbEdited += msg[2] == 50 ? 1 : 0;
+		}
+	}
+	HARNESS_CHECK(r, nbNoteOns == nbNotes);
+	HARNESS_CHECK(r, nbEdited == (nbNotes + 3) / 4);
+
+	r.Metric("events", nbNotes * 2.0);
+	r.Metric("alloc_ms", allocMs);
+	r.Metric("edit_ms", editMs);
+	r.Metric("commit_ms", commitMs);
+}
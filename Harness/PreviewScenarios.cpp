@@ -0,0 +1,159 @@
+/******************************************************************************
+/ PreviewScenarios.cpp
+/
+/ Copyright (c) 2026 SWS
+/
+/
+/ Permission is hereby granted, free of charge, to any person obtaining a copy
+/ of this software and associated documentation files (the "Software"), to deal
+/ in the Software without restriction, including without limitation the rights to
+/ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/ of the Software, and to permit persons to whom the Software is furnished to
+/ do so, subject to the following conditions:
+/
+/ The above copyright notice and this permission notice shall be included in all
+/ copies or substantial portions of the Software.
+/
+/ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+/ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+/ OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+/ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+/ HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+/ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+/ OTHER DEALINGS IN THE SOFTWARE.
+/
+******************************************************************************/
+
+#include "stdafx.h"
+#include "Harness.h"
+#include "ReaperStub.h"
+#include "../cfillion/pitchshiftsource.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+// an hour of stereo DC at 1.0
+class DCSource : public PCM_source
+{
+public:
+	PCM_source* Duplicate() override { return new DCSource; }
+	bool IsAvailable() override { return true; }
+	const char* GetType() override { return "WAVE"; }
+	const char* GetFileName() override { return ""; }
+	bool SetFileName(const char*) override { return false; }
+	int GetNumChannels() override { return 2; }
+	double GetSampleRate() override { return 48000.0; }
+	double GetLength() override { return 3600.0; }
+	int PropertiesWindow(HWND) override { return -1; }
+	void GetSamples(PCM_source_transfer_t* block) override
+	{
+		std::fill(block->samples, block->samples + block->length * block->nch, 1.0);
+		block->samples_out = block->length;
+	}
+	void GetPeakInfo(PCM_source_peaktransfer_t* block) override { block->peaks_out = 0; }
+	void SaveState(ProjectStateContext*) override {}
+	int LoadState(const char*, ProjectStateContext*) override { return -1; }
+	void Peaks_Clear(bool) override {}
+	int PeaksBuild_Begin() override { return 0; }
+	int PeaksBuild_Run() override { return 0; }
+	void PeaksBuild_Finish() override {}
+};
+
+} // namespace
+
+// CF_Preview's lock-free parameter path: the main thread sweeps every
+// parameter and reads peaks/position while the audio thread renders. Volume
+// is kept within [0, 2] so no sample of the DC source may exceed 2.0
+HARNESS_TEST(preview_parameter_stress)
+{
+	const int nbBlocks = ctx.Size(200000, 5000), blockLen = 64, nch = 2;
+	DCSource dc;
+	std::unique_ptr<PitchShiftSource> src(PitchShiftSource::create(&dc));
+	HARNESS_CHECK(r, !strcmp(src->GetType(), "SWS_PITCHSHIFT_AUDIO"));
+
+	std::atomic<bool> done(false);
+	std::atomic<int> nbBadSamples(0);
+	double maxBlockUs = 0.0, totalMs = 0.0;
+	std::thread audio([&] {
+		std::vector<ReaSample> buf(blockLen * nch);
+		PCM_source_transfer_t tx = {};
+		tx.samplerate = 48000.0;
+		tx.nch = nch;
+		tx.length = blockLen;
+		tx.samples = &buf[0];
+		for (int i = 0; i < nbBlocks; i++)
+		{
+			tx.time_s = (double)i * blockLen / tx.samplerate;
+			tx.samples_out = 0;
+			HarnessTimer t;
+			src->GetSamples(&tx);
+			const double ms = t.Ms();
+			totalMs += ms;
+			maxBlockUs = std::max(maxBlockUs, ms * 1000.0);
+			for (int j = 0; j < tx.samples_out * nch; j++)
+				if (!(fabs(buf[j]) <= 2.0 + 1e-9))
+					nbBadSamples++;
+		}
+		done = true;
+	});
+
+	int nbUpdates = 0, nbBackwards = 0;
+	double lastPos = 0.0, maxPeak = 0.0;
+	unsigned int seed = 1;
+	while (!done)
+	{
+		seed = seed * 1664525 + 1013904223;
+		const double x = (seed >> 8) / double(1 << 24); // [0, 1)
+		src->setVolume(2.0 * x);
+		src->setPan(2.0 * x - 1.0);
+		src->setPlayRate(0.5 + 1.5 * x);
+		src->setPitch(24.0 * x - 12.0);
+		src->setPreservePitch((seed >> 4) & 1);
+		src->setMode((seed >> 5) & 1 ? -1 : 0);
+		src->setFadeInLen(0.01 * x);
+		nbUpdates++;
+
+		const double pos = src->getPosition();
+		nbBackwards += pos < lastPos ? 1 : 0;
+		lastPos = pos;
+		double peak;
+		for (int c = 0; c < nch; c++)
+			if (src->readPeak(c, &peak))
+				maxPeak = std::max(maxPeak, peak);
+	}
+	audio.join();
+
+	HARNESS_CHECK(r, nbBadSamples == 0);
+	HARNESS_CHECK(r, nbBackwards == 0);
+	HARNESS_CHECK(r, maxPeak <= 2.0 + 1e-9);
+	HARNESS_CHECK(r, fabs(src->getPosition() - (double)nbBlocks * blockLen / 48000.0) < 1e-6);
+
+	// once the sweep stops the last values apply: ramped over one block, then steady
+	src->setPlayRate(1.0);
+	src->setPitch(0.0);
+	src->setVolume(0.5);
+	src->setPan(0.0);
+	std::vector<ReaSample> buf(blockLen * nch);
+	PCM_source_transfer_t tx = {};
+	tx.samplerate = 48000.0;
+	tx.nch = nch;
+	tx.length = blockLen;
+	tx.samples = &buf[0];
+	for (int i = 0; i < 2; i++)
+	{
+		tx.time_s = (double)(nbBlocks + i) * blockLen / tx.samplerate;
+		tx.samples_out = 0;
+		src->GetSamples(&tx);
+	}
+	HARNESS_CHECK(r, tx.samples_out == blockLen);
+	for (int j = 0; j < blockLen * nch; j++)
+		HARNESS_CHECK(r, fabs(buf[j] - 0.5) < 1e-9);
+
+	r.Metric("blocks", nbBlocks);
+	r.Metric("updates", nbUpdates);
+	r.Metric("block_us", totalMs * 1000.0 / nbBlocks);
+	r.Metric("max_block_us", maxBlockUs);
+}
@@ -0,0 +1,104 @@
+/******************************************************************************
+/ ProjConfigScenarios.cpp
+/
+/ Copyright (c) 2026 SWS
+/
+/
+/ Permission is hereby granted, free of charge, to any person obtaining a copy
+/ of this software and associated documentation files (the "Software"), to deal
+/ in the Software without restriction, including without limitation the rights to
+/ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/ of the Software, and to permit persons to whom the Software is furnished to
+/ do so, subject to the following conditions:
+/
+/ The above copyright notice and this permission notice shall be included in all
+/ copies or substantial portions of the Software.
+/
+/ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+/ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+/ OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+/ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+/ HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+/ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+/ OTHER DEALINGS IN THE SOFTWARE.
+/
+******************************************************************************/
+
+#include "stdafx.h"
+#include "Harness.h"
+#include "ReaperStub.h"
+
+namespace {
+
+// the lookup SWSProjConfig did before the keyed array: a linear Find
+struct LinearProjConfig
+{
+	WDL_PtrList<void> m_projects;
+	WDL_PtrList<int> m_data;
+	~LinearProjConfig() { m_data.Empty(true); }
+	int* Get(ReaProject* pProj)
+	{
+		int i = m_projects.Find(pProj);
+		if (i >= 0)
+			return m_data.Get(i);
+		m_projects.Add(pProj);
+		return m_data.Add(new int(0));
+	}
+};
+
+// ns per Get() of the current project
+double TimeGet(SWSProjConfig<int>* cfg, int nbCalls, unsigned int* sum)
+{
+	HarnessTimer t;
+	for (int i = 0; i < nbCalls; i++)
+		*sum += ++*cfg->Get();
+	return t.Ms() * 1e6 / nbCalls;
+}
+
+} // namespace
+
+// SWSProjConfig::Get() with 1 and 64 open projects. The project switch case
+// misses the last-hit cache on every call, the linear case is the old lookup
+HARNESS_BENCH(proj_config_get)
+{
+	const int nbCalls = ctx.Size(10000000, 100000);
+	SWSProjConfig<int> cfg;
+	unsigned int sum = 0;
+
+	r.Metric("get_ns_1", TimeGet(&cfg, nbCalls, &sum));
+	HARNESS_CHECK(r, cfg.GetNumProj() == 1);
+
+	std::vector<ReaProject*> projs(1, Stub_Rpr(Stub_GetProject()));
+	for (int i = 1; i < 64; i++)
+	{
+		char path[64];
+		snprintf(path, sizeof(path), "/tmp/proj%d.RPP", i);
+		StubProject* proj = Stub_AddProject(path);
+		Stub_SelectProject(proj);
+		projs.push_back(Stub_Rpr(proj));
+		*cfg.Get() = i;
+	}
+	HARNESS_CHECK(r, cfg.GetNumProj() == 64);
+	for (int i = 1; i < 64; i++)
+		HARNESS_CHECK(r, *cfg.Get(projs[i]) == i);
+
+	r.Metric("get_ns_64", TimeGet(&cfg, nbCalls, &sum));
+
+	HarnessTimer t;
+	for (int i = 0; i < nbCalls; i++)
+		sum += *cfg.Get(projs[i & 63]);
+	r.Metric("get_ns_64_switch", t.Ms() * 1e6 / nbCalls);
+
+	LinearProjConfig linear;
+	for (int i = 0; i < 64; i++)
+		*linear.Get(projs[i]) = i;
+	t.Reset();
+	for (int i = 0; i < nbCalls; i++)
+		sum += *linear.Get(projs[i & 63]);
+	r.Metric("linear_ns_64_switch", t.Ms() * 1e6 / nbCalls);
+
+	cfg.Remove(projs[63]);
+	HARNESS_CHECK(r, cfg.GetNumProj() == 63 && *cfg.Get(projs[62]) == 62);
+	HARNESS_CHECK(r, sum != 0); // keeps the loops
+}
@@ -0,0 +1,2592 @@
+/******************************************************************************
+/ ReaperStub.cpp
+/
+/ Copyright (c) 2026 SWS
+/
+/
+/ Permission is hereby granted, free of charge, to any person obtaining a copy
+/ of this software and associated documentation files (the "Software"), to deal
+/ in the Software without restriction, including without limitation the rights to
+/ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/ of the Software, and to permit persons to whom the Software is furnished to
+/ do so, subject to the following conditions:
+/
+/ The above copyright notice and this permission notice shall be included in all
+/ copies or substantial portions of the Software.
+/
+/ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+/ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+/ OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+/ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+/ HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+/ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+/ OTHER DEALINGS IN THE SOFTWARE.
+/
+******************************************************************************/
+
+#include "stdafx.h"
+#include "ReaperStub.h"
+#include "WDL/projectcontext.h"
+
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+
+extern "C" int SWELL_dllMain(HINSTANCE hInst, DWORD callMode, LPVOID getFunc);
+
+namespace {
+
+std::vector<std::unique_ptr<StubProject> > s_projects;
+StubProject* s_curProject = NULL;
+std::string s_resourcePath, s_iniFile;
+unsigned int s_guidCounter = 0;
+int s_getStateCalls = 0, s_setStateCalls = 0;
+int s_commandIds = 40000;
+
+struct ConfigVarValue
+{
+	int size;
+	union { int i; double d; } value;
+};
+std::map<std::string, ConfigVarValue> s_configVars; // map nodes don't move: addresses stay valid
+
+template<class T> T* Obj(void* p, StubObject::Kind kind)
+{
+	StubObject* o = reinterpret_cast<StubObject*>(p);
+	return o && o->m_kind == kind ? static_cast<T*>(o) : NULL;
+}
+
+StubProject* Proj(ReaProject* proj)
+{
+	return proj ? Obj<StubProject>(proj, StubObject::PROJECT) : s_curProject;
+}
+
+StubTrack* Tr(MediaTrack* tr)             { return Obj<StubTrack>(tr, StubObject::TRACK); }
+StubItem* It(MediaItem* item)             { return Obj<StubItem>(item, StubObject::ITEM); }
+StubTake* Tk(MediaItem_Take* take)        { return Obj<StubTake>(take, StubObject::TAKE); }
+StubEnvelope* Env(TrackEnvelope* env)     { return Obj<StubEnvelope>(env, StubObject::ENVELOPE); }
+
+void Touch(StubProject* proj)
+{
+	if (proj)
+		proj->m_stateChangeCount++;
+}
+
+StubProject* ProjOf(StubTrack* tr)  { return tr ? tr->m_project : NULL; }
+StubProject* ProjOf(StubItem* item) { return item ? ProjOf(item->m_track) : NULL; }
+StubProject* ProjOf(StubTake* take) { return take ? ProjOf(take->m_item) : NULL; }
+
+void NewGuid(GUID* g)
+{
+	memset(g, 0, sizeof(GUID));
+	g->Data1 = ++s_guidCounter; // repeatable runs
+	g->Data2 = 0x5357;
+	g->Data3 = 0x4854;
+}
+
+// items stay sorted by position on their track, as in REAPER
+void SortItems(StubTrack* tr)
+{
+	std::stable_sort(tr->m_items.begin(), tr->m_items.end(),
+		[](const std::unique_ptr<StubItem>& a, const std::unique_ptr<StubItem>& b) { return a->m_position < b->m_position; });
+}
+
+bool StartsWith(const std::string& s, const char* prefix)
+{
+	return !s.compare(0, strlen(prefix), prefix);
+}
+
+std::string Quoted(const char* s)
+{
+	WDL_FastString str;
+	makeEscapedConfigString(s, &str);
+	return str.Get();
+}
+
+double QNPerSecond(const StubProject* proj)
+{
+	return proj->m_bpm / 60.0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// PCM sources and pitch shifter
+///////////////////////////////////////////////////////////////////////////////
+
+// in-project MIDI source: the events live in the StubTake
+class StubMidiSource : public PCM_source
+{
+public:
+	PCM_source* Duplicate() override { return new StubMidiSource; }
+	bool IsAvailable() override { return true; }
+	const char* GetType() override { return "MIDI"; }
+	const char* GetFileName() override { return ""; }
+	bool SetFileName(const char*) override { return false; }
+	int GetNumChannels() override { return 1; }
+	double GetSampleRate() override { return 0.0; }
+	double GetLength() override { return 0.0; }
+	int PropertiesWindow(HWND) override { return -1; }
+	void GetSamples(PCM_source_transfer_t* block) override { block->samples_out = 0; }
+	void GetPeakInfo(PCM_source_peaktransfer_t* block) override { block->peaks_out = 0; }
+	void SaveState(ProjectStateContext*) override {}
+	int LoadState(const char*, ProjectStateContext*) override { return -1; }
+	void Peaks_Clear(bool) override {}
+	int PeaksBuild_Begin() override { return 0; }
+	int PeaksBuild_Run() override { return 0; }
+	void PeaksBuild_Finish() override {}
+};
+
+// time-stretches with linear interpolation, pitch and formants are ignored
+class StubPitchShift : public IReaperPitchShift
+{
+public:
+	StubPitchShift() : m_nch(1), m_tempo(1.0), m_readPos(0.0) {}
+
+	void set_srate(double) override {}
+	void set_nch(int nch) override { m_nch = nch > 0 ? nch : 1; Reset(); }
+	void set_shift(double) override {}
+	void set_formant_shift(double) override {}
+	void set_tempo(double tempo) override { m_tempo = tempo > 0.0 ? tempo : 1.0; }
+	void Reset() override { m_input.clear(); m_readPos = 0.0; }
+	ReaSample* GetBuffer(int size) override { m_buf.resize((size_t)(size > 0 ? size : 1) * m_nch); return &m_buf[0]; }
+	void BufferDone(int filled) override { m_input.insert(m_input.end(), m_buf.begin(), m_buf.begin() + (size_t)filled * m_nch); }
+	void FlushSamples() override {}
+	bool IsReset() override { return m_input.empty(); }
+	void SetQualityParameter(int) override {}
+
+	int GetSamples(int requested, ReaSample* buffer) override
+	{
+		const int frames = (int)(m_input.size() / m_nch);
+		int done = 0;
+		while (done < requested && (int)m_readPos + 1 < frames)
+		{
+			const int i = (int)m_readPos;
+			const double frac = m_readPos - i;
+			for (int ch = 0; ch < m_nch; ch++)
+				buffer[done * m_nch + ch] = m_input[i * m_nch + ch] * (1.0 - frac) + m_input[(i + 1) * m_nch + ch] * frac;
+			m_readPos += m_tempo;
+			done++;
+		}
+		const int consumed = (int)m_readPos < frames ? (int)m_readPos : frames;
+		m_input.erase(m_input.begin(), m_input.begin() + (size_t)consumed * m_nch);
+		m_readPos -= consumed;
+		return done;
+	}
+
+private:
+	int m_nch;
+	double m_tempo, m_readPos;
+	std::vector<ReaSample> m_buf, m_input;
+};
+
+} // namespace
+
+StubTake::~StubTake()
+{
+	delete m_source;
+}
+
+bool StubTake::IsMidi() const
+{
+	return m_source && !strcmp(m_source->GetType(), "MIDI");
+}
+
+const std::vector<StubTake::Note>& StubTake::GetNotes()
+{
+	BuildMidiIndex();
+	return m_notes;
+}
+
+const std::vector<int>& StubTake::GetCCs()
+{
+	BuildMidiIndex();
+	return m_ccs;
+}
+
+void StubTake::BuildMidiIndex()
+{
+	if (m_midiIndexValid)
+		return;
+	m_midiIndexValid = true;
+	m_notes.clear();
+	m_ccs.clear();
+
+	std::vector<std::vector<int> > pending(16 * 128); // note-ons waiting for their note-off
+	for (int i = 0; i < (int)m_events.size(); i++)
+	{
+		const std::string& msg = m_events[i].msg;
+		if (msg.size() < 2)
+			continue;
+		const int status = (unsigned char)msg[0] & 0xF0, chan = (unsigned char)msg[0] & 0x0F, pitch = msg[1] & 0x7F;
+		if (status == 0x90 && msg.size() >= 3 && msg[2])
+		{
+			Note n = { i, -1 };
+			pending[chan * 128 + pitch].push_back((int)m_notes.size());
+			m_notes.push_back(n);
+		}
+		else if ((status == 0x80 || status == 0x90) && msg.size() >= 3)
+		{
+			std::vector<int>& p = pending[chan * 128 + pitch];
+			if (p.size())
+			{
+				m_notes[p.front()].off = i;
+				p.erase(p.begin());
+			}
+		}
+		else if (status >= 0xA0 && status <= 0xE0)
+			m_ccs.push_back(i);
+	}
+}
+
+int StubProject::GetTrackIndex(const StubTrack* tr) const
+{
+	for (int i = 0; i < (int)m_tracks.size(); i++)
+		if (m_tracks[i].get() == tr)
+			return i;
+	return -1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RPP chunks
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+void GuidStr(const GUID* g, char* buf); // see Api_guidToString()
+
+void SplitLines(const char* str, std::vector<std::string>* lines)
+{
+	while (*str)
+	{
+		while (*str == ' ' || *str == '\t') str++; // left trim, as SWS expects
+		const char* eol = str;
+		while (*eol && *eol != '\n' && *eol != '\r') eol++;
+		if (eol > str)
+			lines->push_back(std::string(str, eol - str));
+		str = eol;
+		while (*str == '\n' || *str == '\r') str++;
+	}
+}
+
+// index of the ">" closing the sub-chunk opened at lines[start]
+size_t SubChunkEnd(const std::vector<std::string>& lines, size_t start)
+{
+	int depth = 0;
+	for (size_t i = start; i < lines.size(); i++)
+	{
+		if (lines[i][0] == '<')
+			depth++;
+		else if (lines[i][0] == '>' && !--depth)
+			return i;
+	}
+	return lines.size();
+}
+
+void AppendSourceChunk(StubTake* take, WDL_FastString* chunk)
+{
+	if (!take->m_source)
+		return;
+	if (!take->IsMidi())
+	{
+		chunk->AppendFormatted(256, "<SOURCE %s\n", take->m_source->GetType());
+		if (const char* fn = take->m_source->GetFileName())
+			chunk->AppendFormatted(4096, "FILE %s\n", Quoted(fn).c_str());
+		chunk->Append(">\n");
+		return;
+	}
+
+	chunk->Append("<SOURCE MIDI\n");
+	chunk->AppendFormatted(64, "HASDATA 1 %d QN\n", take->m_ppq);
+	double last = 0.0;
+	for (size_t i = 0; i < take->m_events.size(); i++)
+	{
+		const StubMidiEvent& e = take->m_events[i];
+		const char* type = (e.flags & 3) == 3 ? "em" : (e.flags & 2) ? "Em" : (e.flags & 1) ? "e" : "E";
+		chunk->AppendFormatted(32, "%s %.0f", type, floor(e.ppq + 0.5) - floor(last + 0.5));
+		for (size_t j = 0; j < e.msg.size(); j++)
+			chunk->AppendFormatted(8, " %02x", (unsigned char)e.msg[j]);
+		chunk->Append("\n");
+		last = e.ppq;
+	}
+	// end of source: all notes off
+	chunk->AppendFormatted(64, "E %.0f b0 7b 00\n", floor(take->m_lengthPPQ + 0.5) - floor(last + 0.5));
+	for (size_t i = 0; i < take->m_sourceLines.size(); i++)
+	{
+		chunk->Append(take->m_sourceLines[i].c_str());
+		chunk->Append("\n");
+	}
+	chunk->Append(">\n");
+}
+
+void ParseSourceChunk(StubTake* take, const std::vector<std::string>& lines, size_t start, size_t end)
+{
+	if (!take->IsMidi())
+		return; // audio sources are not parsed back
+
+	take->m_events.clear();
+	take->m_sourceLines.clear();
+	take->MidiChanged();
+
+	LineParser lp(false);
+	double ppq = 0.0;
+	for (size_t i = start + 1; i < end; i++)
+	{
+		const std::string& line = lines[i];
+		if (line[0] == '<') // sysex/text events are not modeled, but their delta counts
+		{
+			const size_t subEnd = SubChunkEnd(lines, i);
+			if (!lp.parse(line.c_str()) && !strcmp(lp.gettoken_str(0), "<X"))
+				ppq += lp.gettoken_float(1);
+			else
+				for (size_t j = i; j <= subEnd && j < end; j++)
+					take->m_sourceLines.push_back(lines[j]);
+			i = subEnd;
+			continue;
+		}
+		if (lp.parse(line.c_str()))
+			continue;
+
+		const char* key = lp.gettoken_str(0);
+		if (!strcmp(key, "HASDATA"))
+			take->m_ppq = lp.gettoken_int(2);
+		else if ((key[0] == 'E' || key[0] == 'e') && (!key[1] || (key[1] == 'm' && !key[2])))
+		{
+			ppq += lp.gettoken_float(1);
+			StubMidiEvent e;
+			e.ppq = ppq;
+			e.flags = (key[0] == 'e' ? 1 : 0) | (key[1] == 'm' ? 2 : 0);
+			for (int t = 2; t < lp.getnumtokens(); t++)
+				e.msg += (char)strtol(lp.gettoken_str(t), NULL, 16);
+			take->m_events.push_back(e);
+		}
+		else
+			take->m_sourceLines.push_back(line);
+	}
+
+	// last event is the end of source marker
+	if (take->m_events.size() && take->m_events.back().msg == std::string("\xb0\x7b\x00", 3))
+	{
+		take->m_lengthPPQ = take->m_events.back().ppq;
+		take->m_events.pop_back();
+	}
+	else
+		take->m_lengthPPQ = ppq;
+}
+
+void AppendItemChunk(StubItem* item, WDL_FastString* chunk)
+{
+	char guid[64];
+	GuidStr(&item->m_guid, guid);
+	chunk->Append("<ITEM\n");
+	chunk->AppendFormatted(64, "POSITION %.14f\n", item->m_position);
+	chunk->Append("SNAPOFFS 0\n");
+	chunk->AppendFormatted(64, "LENGTH %.14f\n", item->m_length);
+	chunk->Append("LOOP 0\nALLTAKES 0\nFADEIN 1 0 0 1 0 0 0\nFADEOUT 1 0 0 1 0 0 0\n");
+	chunk->AppendFormatted(32, "MUTE %d 0\n", item->m_mute ? 1 : 0);
+	chunk->AppendFormatted(32, "SEL %d\n", item->m_selected ? 1 : 0);
+	chunk->AppendFormatted(128, "IGUID %s\n", guid);
+	for (size_t i = 0; i < item->m_takes.size(); i++)
+	{
+		StubTake* take = item->m_takes[i].get();
+		if (i)
+			chunk->Append((int)i == item->m_activeTake ? "TAKE SEL\n" : "TAKE\n");
+		GuidStr(&take->m_guid, guid);
+		chunk->AppendFormatted(4096, "NAME %s\n", Quoted(take->m_name.c_str()).c_str());
+		chunk->Append("VOLPAN 1 0 1 -1\n");
+		chunk->AppendFormatted(64, "SOFFS %.14f\n", take->m_startOffset);
+		chunk->AppendFormatted(64, "PLAYRATE %.14f 1 0 -1 0 0.0025\n", take->m_playRate);
+		chunk->Append("CHANMODE 0\n");
+		chunk->AppendFormatted(128, "GUID %s\n", guid);
+		AppendSourceChunk(take, chunk);
+	}
+	chunk->Append(">\n");
+}
+
+StubTake* NewTake(StubItem* item)
+{
+	StubTake* take = new StubTake;
+	take->m_item = item;
+	NewGuid(&take->m_guid);
+	item->m_takes.push_back(std::unique_ptr<StubTake>(take));
+	return take;
+}
+
+// takes are matched by index: handles given to SWS stay valid
+void ParseItemChunk(StubItem* item, const std::vector<std::string>& lines, size_t start, size_t end)
+{
+	LineParser lp(false);
+	int takeIdx = -1, activeTake = 0;
+	for (size_t i = start + 1; i < end; i++)
+	{
+		const std::string& line = lines[i];
+		if (line[0] == '<')
+		{
+			const size_t subEnd = SubChunkEnd(lines, i);
+			if (StartsWith(line, "<SOURCE"))
+			{
+				if (takeIdx < 0) takeIdx = 0;
+				StubTake* take = takeIdx < (int)item->m_takes.size() ? item->m_takes[takeIdx].get() : NewTake(item);
+				if (!take->m_source && StartsWith(line, "<SOURCE MIDI"))
+					take->m_source = new StubMidiSource;
+				ParseSourceChunk(take, lines, i, subEnd);
+			}
+			i = subEnd; // other sub-chunks (take FX...) are not modeled
+			continue;
+		}
+		if (lp.parse(line.c_str()))
+			continue;
+
+		const char* key = lp.gettoken_str(0);
+		if      (!strcmp(key, "POSITION")) item->m_position = lp.gettoken_float(1);
+		else if (!strcmp(key, "LENGTH"))   item->m_length = lp.gettoken_float(1);
+		else if (!strcmp(key, "MUTE"))     item->m_mute = lp.gettoken_int(1) != 0;
+		else if (!strcmp(key, "SEL"))      item->m_selected = lp.gettoken_int(1) != 0;
+		else if (!strcmp(key, "TAKE"))
+		{
+			takeIdx = takeIdx < 0 ? 1 : takeIdx + 1;
+			if (!strcmp(lp.gettoken_str(1), "SEL"))
+				activeTake = takeIdx;
+		}
+		else if (!strcmp(key, "NAME") || !strcmp(key, "SOFFS") || !strcmp(key, "PLAYRATE") || !strcmp(key, "GUID"))
+		{
+			if (takeIdx < 0) takeIdx = 0;
+			StubTake* take = takeIdx < (int)item->m_takes.size() ? item->m_takes[takeIdx].get() : NewTake(item);
+			if      (!strcmp(key, "NAME"))     take->m_name = lp.gettoken_str(1);
+			else if (!strcmp(key, "SOFFS"))    take->m_startOffset = lp.gettoken_float(1);
+			else if (!strcmp(key, "PLAYRATE")) take->m_playRate = lp.gettoken_float(1);
+			// GUID: ids are kept, SWS strips them before setting chunks
+		}
+	}
+
+	const size_t nbTakes = takeIdx + 1;
+	if (item->m_takes.size() > nbTakes)
+		item->m_takes.resize(nbTakes);
+	item->m_activeTake = activeTake < (int)nbTakes ? activeTake : 0;
+}
+
+bool IsEnvelopeChunk(const std::string& line)
+{
+	const size_t end = line.find(' ');
+	const std::string key = line.substr(1, end == std::string::npos ? std::string::npos : end - 1);
+	return key == "PARMENV" || (key.size() > 3 && !key.compare(key.size() - 3, 3, "ENV")) ||
+		(key.size() > 4 && !key.compare(key.size() - 4, 4, "ENV2"));
+}
+
+void AppendEnvelopeChunk(StubEnvelope* env, WDL_FastString* chunk)
+{
+	chunk->AppendFormatted(256, "<%s\n", env->m_name.c_str());
+	chunk->AppendFormatted(32, "ACT %d -1\n", env->m_active ? 1 : 0);
+	chunk->AppendFormatted(32, "VIS %d 1 1\n", env->m_visible ? 1 : 0);
+	chunk->Append("LANEHEIGHT 0 0\nARM 0\nDEFSHAPE 0 -1 -1\n");
+	for (size_t i = 0; i < env->m_points.size(); i++)
+	{
+		const StubEnvelope::Point& pt = env->m_points[i];
+		chunk->AppendFormatted(128, "PT %.12f %.10f %d 0 %d 0 %.8f\n", pt.time, pt.value, pt.shape, pt.selected ? 1 : 0, pt.tension);
+	}
+	chunk->Append(">\n");
+}
+
+void ParseEnvelopeChunk(StubEnvelope* env, const std::vector<std::string>& lines, size_t start, size_t end)
+{
+	LineParser lp(false);
+	env->m_points.clear();
+	for (size_t i = start + 1; i < end; i++)
+	{
+		if (lines[i][0] == '<')
+		{
+			i = SubChunkEnd(lines, i);
+			continue;
+		}
+		if (lp.parse(lines[i].c_str()))
+			continue;
+		const char* key = lp.gettoken_str(0);
+		if (!strcmp(key, "ACT"))
+			env->m_active = lp.gettoken_int(1) != 0;
+		else if (!strcmp(key, "VIS"))
+			env->m_visible = lp.gettoken_int(1) != 0;
+		else if (!strcmp(key, "PT"))
+		{
+			StubEnvelope::Point pt = { lp.gettoken_float(1), lp.gettoken_float(2), lp.gettoken_int(3), lp.gettoken_float(7), (lp.gettoken_int(5) & 1) != 0 };
+			env->m_points.push_back(pt);
+		}
+	}
+}
+
+// lines built from the model, not kept in StubTrack::m_chunkLines
+bool IsModeledTrackLine(const char* key)
+{
+	static const char* const s_keys[] = { "NAME", "PEAKCOL", "MUTESOLO", "SEL", "NCHAN", "TRACKID", "AUXRECV", "MIDIOUT", "MAINSEND" };
+	for (size_t i = 0; i < sizeof(s_keys) / sizeof(s_keys[0]); i++)
+		if (!strcmp(key, s_keys[i]))
+			return true;
+	return false;
+}
+
+void AppendTrackChunk(StubTrack* tr, WDL_FastString* chunk)
+{
+	StubProject* proj = tr->m_project;
+	char guid[64];
+	GuidStr(&tr->m_guid, guid);
+	chunk->AppendFormatted(128, "<TRACK %s\n", guid);
+	chunk->AppendFormatted(4096, "NAME %s\n", Quoted(tr->m_name.c_str()).c_str());
+	chunk->Append("PEAKCOL 16576\n");
+	chunk->AppendFormatted(32, "MUTESOLO %d 0 0\n", tr->m_mute ? 1 : 0);
+	chunk->AppendFormatted(32, "SEL %d\n", tr->m_selected);
+	chunk->Append("NCHAN 2\n");
+	for (size_t i = 0; i < tr->m_chunkLines.size(); i++)
+	{
+		chunk->Append(tr->m_chunkLines[i].c_str());
+		chunk->Append("\n");
+	}
+	chunk->AppendFormatted(128, "TRACKID %s\n", guid);
+	for (size_t i = 0; i < proj->m_sends.size(); i++)
+	{
+		const StubSend* s = proj->m_sends[i].get();
+		if (s->dest == tr)
+			chunk->AppendFormatted(256, "AUXRECV %d %d %.14f %.14f %d %d %d %d %d %.14f:U %d %d ''\n",
+				proj->GetTrackIndex(s->src), s->mode, s->vol, s->pan, s->mute ? 1 : 0, s->mono ? 1 : 0, s->phase ? 1 : 0,
+				s->srcChan, s->dstChan, s->panLaw, s->midiFlags, s->autoMode);
+	}
+	chunk->Append("MIDIOUT -1\nMAINSEND 1 0\n");
+	for (size_t i = 0; i < tr->m_envelopes.size(); i++)
+		AppendEnvelopeChunk(tr->m_envelopes[i].get(), chunk);
+	for (size_t i = 0; i < tr->m_items.size(); i++)
+		AppendItemChunk(tr->m_items[i].get(), chunk);
+	chunk->Append(">\n");
+}
+
+void ParseTrackChunk(StubTrack* tr, const std::vector<std::string>& lines)
+{
+	StubProject* proj = tr->m_project;
+	LineParser lp(false);
+
+	// receives are rebuilt from the AUXRECV lines
+	for (size_t i = proj->m_sends.size(); i-- > 0;)
+		if (proj->m_sends[i]->dest == tr)
+			proj->m_sends.erase(proj->m_sends.begin() + i);
+
+	tr->m_chunkLines.clear();
+	size_t nbItems = 0;
+	const size_t end = lines.size() && lines[0][0] == '<' ? SubChunkEnd(lines, 0) : lines.size();
+	for (size_t i = lines.size() && lines[0][0] == '<' ? 1 : 0; i < end; i++)
+	{
+		const std::string& line = lines[i];
+		if (line[0] == '<')
+		{
+			const size_t subEnd = SubChunkEnd(lines, i);
+			if (StartsWith(line, "<ITEM"))
+			{
+				StubItem* item;
+				if (nbItems < tr->m_items.size())
+					item = tr->m_items[nbItems].get();
+				else
+				{
+					item = new StubItem;
+					item->m_track = tr;
+					NewGuid(&item->m_guid);
+					tr->m_items.push_back(std::unique_ptr<StubItem>(item));
+				}
+				ParseItemChunk(item, lines, i, subEnd);
+				nbItems++;
+			}
+			else if (IsEnvelopeChunk(line))
+			{
+				const std::string name = line.substr(1, line.find(' ') == std::string::npos ? std::string::npos : line.find(' ') - 1);
+				StubEnvelope* env = NULL;
+				for (size_t j = 0; !env && j < tr->m_envelopes.size(); j++)
+					if (tr->m_envelopes[j]->m_name == name)
+						env = tr->m_envelopes[j].get();
+				if (!env)
+					env = Stub_AddEnvelope(tr, name.c_str());
+				ParseEnvelopeChunk(env, lines, i, subEnd);
+			}
+			else
+				for (size_t j = i; j <= subEnd && j < end; j++)
+					tr->m_chunkLines.push_back(lines[j]);
+			i = subEnd;
+			continue;
+		}
+		if (lp.parse(line.c_str()))
+			continue;
+
+		const char* key = lp.gettoken_str(0);
+		if      (!strcmp(key, "NAME"))     tr->m_name = lp.gettoken_str(1);
+		else if (!strcmp(key, "MUTESOLO")) tr->m_mute = lp.gettoken_int(1) != 0;
+		else if (!strcmp(key, "SEL"))      tr->m_selected = lp.gettoken_int(1);
+		else if (!strcmp(key, "AUXRECV"))
+		{
+			const int srcIdx = lp.gettoken_int(1);
+			if (srcIdx >= 0 && srcIdx < (int)proj->m_tracks.size())
+			{
+				StubSend* s = Stub_AddSend(proj->m_tracks[srcIdx].get(), tr);
+				s->mode = lp.gettoken_int(2);
+				s->vol = lp.gettoken_float(3);
+				s->pan = lp.gettoken_float(4);
+				s->mute = lp.gettoken_int(5) != 0;
+				s->mono = lp.gettoken_int(6) != 0;
+				s->phase = lp.gettoken_int(7) != 0;
+				s->srcChan = lp.gettoken_int(8);
+				s->dstChan = lp.gettoken_int(9);
+				s->panLaw = atof(lp.gettoken_str(10)); // "-1:U"
+				s->midiFlags = lp.gettoken_int(11);
+				s->autoMode = lp.gettoken_int(12);
+			}
+		}
+		else if (!IsModeledTrackLine(key))
+			tr->m_chunkLines.push_back(line);
+	}
+
+	if (tr->m_items.size() > nbItems)
+		tr->m_items.resize(nbItems);
+	SortItems(tr);
+}
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// REAPER API
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// GUIDs
+
+void GuidStr(const GUID* g, char* buf)
+{
+	snprintf(buf, 64, "{%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X}",
+		g->Data1, g->Data2, g->Data3, g->Data4[0], g->Data4[1],
+		g->Data4[2], g->Data4[3], g->Data4[4], g->Data4[5], g->Data4[6], g->Data4[7]);
+}
+
+void Api_guidToString(const GUID* g, char* destNeed64)
+{
+	if (g && destNeed64)
+		GuidStr(g, destNeed64);
+}
+
+void Api_stringToGuid(const char* str, GUID* g)
+{
+	unsigned int d[11];
+	if (!str || !g || sscanf(str, "{%8x-%4x-%4x-%2x%2x-%2x%2x%2x%2x%2x%2x}",
+		&d[0], &d[1], &d[2], &d[3], &d[4], &d[5], &d[6], &d[7], &d[8], &d[9], &d[10]) != 11)
+	{
+		if (g) memset(g, 0, sizeof(GUID));
+		return;
+	}
+	g->Data1 = d[0];
+	g->Data2 = (unsigned short)d[1];
+	g->Data3 = (unsigned short)d[2];
+	for (int i = 0; i < 8; i++)
+		g->Data4[i] = (unsigned char)d[3 + i];
+}
+
+void Api_genGuid(GUID* g)
+{
+	if (g)
+		NewGuid(g);
+}
+
+// Projects
+
+ReaProject* Api_EnumProjects(int idx, char* projfnOutOptional, int projfnOutOptional_sz)
+{
+	StubProject* proj = NULL;
+	if (idx < 0 || idx == 0x40000000)
+		proj = s_curProject;
+	else if (idx < (int)s_projects.size())
+		proj = s_projects[idx].get();
+	if (proj && projfnOutOptional && projfnOutOptional_sz > 0)
+		lstrcpyn_safe(projfnOutOptional, proj->m_path.c_str(), projfnOutOptional_sz);
+	return proj ? Stub_Rpr(proj) : NULL;
+}
+
+ReaProject* Api_GetCurrentProjectInLoadSave()                  { return NULL; }
+int Api_GetProjectStateChangeCount(ReaProject* proj)          { StubProject* p = Proj(proj); return p ? p->m_stateChangeCount : 0; }
+void Api_MarkProjectDirty(ReaProject* proj)                   { if (StubProject* p = Proj(proj)) { p->m_dirty = true; Touch(p); } }
+void Api_Undo_OnStateChange(const char*)                      { Touch(s_curProject); }
+void Api_Undo_OnStateChange2(ReaProject* proj, const char*)   { Touch(Proj(proj)); }
+void Api_Undo_OnStateChangeEx(const char*, int, int)          { Touch(s_curProject); }
+void Api_Undo_OnStateChangeEx2(ReaProject* proj, const char*, int, int) { Touch(Proj(proj)); }
+void Api_Undo_BeginBlock()                                    {}
+void Api_Undo_BeginBlock2(ReaProject*)                        {}
+void Api_Undo_EndBlock(const char*, int)                      { Touch(s_curProject); }
+void Api_Undo_EndBlock2(ReaProject* proj, const char*, int)   { Touch(Proj(proj)); }
+void Api_PreventUIRefresh(int)                                {}
+int Api_GetPlayState()                                        { return 0; }
+int Api_GetPlayStateEx(ReaProject*)                           { return 0; }
+void Api_UpdateArrange()                                      {}
+void Api_UpdateTimeline()                                     {}
+void Api_UpdateItemInProject(MediaItem*)                      {}
+double Api_GetCursorPosition()                                { return 0.0; }
+double Api_GetCursorPositionEx(ReaProject*)                   { return 0.0; }
+double Api_GetHZoomLevel()                                    { return 100.0; }
+
+// Tracks
+
+int Api_CountTracks(ReaProject* proj)
+{
+	StubProject* p = Proj(proj);
+	return p ? (int)p->m_tracks.size() : 0;
+}
+
+MediaTrack* Api_GetTrack(ReaProject* proj, int trackidx)
+{
+	StubProject* p = Proj(proj);
+	return p && trackidx >= 0 && trackidx < (int)p->m_tracks.size() ? Stub_Rpr(p->m_tracks[trackidx].get()) : NULL;
+}
+
+MediaTrack* Api_GetMasterTrack(ReaProject* proj)
+{
+	StubProject* p = Proj(proj);
+	return p ? Stub_Rpr(&p->m_master) : NULL;
+}
+
+int Api_CSurf_TrackToID(MediaTrack* track, bool)
+{
+	StubTrack* tr = Tr(track);
+	if (!tr) return -1;
+	if (tr == &tr->m_project->m_master) return 0;
+	const int idx = tr->m_project->GetTrackIndex(tr);
+	return idx >= 0 ? idx + 1 : -1;
+}
+
+MediaTrack* Api_CSurf_TrackFromID(int idx, bool)
+{
+	return idx ? Api_GetTrack(NULL, idx - 1) : Api_GetMasterTrack(NULL);
+}
+
+int Api_CountSelectedTracks(ReaProject* proj)
+{
+	int count = 0;
+	if (StubProject* p = Proj(proj))
+		for (size_t i = 0; i < p->m_tracks.size(); i++)
+			if (p->m_tracks[i]->m_selected)
+				count++;
+	return count;
+}
+
+MediaTrack* Api_GetSelectedTrack(ReaProject* proj, int seltrackidx)
+{
+	if (StubProject* p = Proj(proj))
+		for (size_t i = 0; i < p->m_tracks.size(); i++)
+			if (p->m_tracks[i]->m_selected && !seltrackidx--)
+				return Stub_Rpr(p->m_tracks[i].get());
+	return NULL;
+}
+
+GUID* Api_GetTrackGUID(MediaTrack* track)
+{
+	StubTrack* tr = Tr(track);
+	return tr ? &tr->m_guid : NULL;
+}
+
+void Api_InsertTrackAtIndex(int idx, bool)
+{
+	Stub_AddTrack(s_curProject);
+	std::vector<std::unique_ptr<StubTrack> >& tracks = s_curProject->m_tracks;
+	if (idx >= 0 && idx < (int)tracks.size() - 1)
+		std::rotate(tracks.begin() + idx, tracks.end() - 1, tracks.end());
+}
+
+void Api_DeleteTrack(MediaTrack* track)
+{
+	StubTrack* tr = Tr(track);
+	if (!tr || tr == &tr->m_project->m_master)
+		return;
+	StubProject* p = tr->m_project;
+	for (size_t i = p->m_sends.size(); i-- > 0;)
+		if (p->m_sends[i]->src == tr || p->m_sends[i]->dest == tr)
+			p->m_sends.erase(p->m_sends.begin() + i);
+	const int idx = p->GetTrackIndex(tr);
+	if (idx >= 0)
+		p->m_tracks.erase(p->m_tracks.begin() + idx);
+	Touch(p);
+}
+
+double Api_GetMediaTrackInfo_Value(MediaTrack* track, const char* parmname)
+{
+	StubTrack* tr = Tr(track);
+	if (!tr || !parmname) return 0.0;
+	if (!strcmp(parmname, "IP_TRACKNUMBER"))
+		return tr == &tr->m_project->m_master ? -1.0 : tr->m_project->GetTrackIndex(tr) + 1.0;
+	if (!strcmp(parmname, "B_MUTE"))     return tr->m_mute ? 1.0 : 0.0;
+	if (!strcmp(parmname, "I_SELECTED")) return tr->m_selected;
+	std::map<std::string, double>::const_iterator it = tr->m_values.find(parmname);
+	if (it != tr->m_values.end())
+		return it->second;
+	return !strcmp(parmname, "D_VOL") ? 1.0 : 0.0;
+}
+
+bool Api_SetMediaTrackInfo_Value(MediaTrack* track, const char* parmname, double newvalue)
+{
+	StubTrack* tr = Tr(track);
+	if (!tr || !parmname || !strcmp(parmname, "IP_TRACKNUMBER")) return false;
+	if      (!strcmp(parmname, "B_MUTE"))     tr->m_mute = newvalue != 0.0;
+	else if (!strcmp(parmname, "I_SELECTED")) tr->m_selected = (int)newvalue;
+	else tr->m_values[parmname] = newvalue;
+	Touch(tr->m_project);
+	return true;
+}
+
+void* Api_GetSetMediaTrackInfo(MediaTrack* track, const char* parmname, void* setNewValue)
+{
+	StubTrack* tr = Tr(track);
+	if (!tr || !parmname) return NULL;
+	if (setNewValue)
+		Touch(tr->m_project);
+	if (!strcmp(parmname, "P_NAME"))
+	{
+		if (setNewValue) tr->m_name = (const char*)setNewValue;
+		return (void*)tr->m_name.c_str();
+	}
+	if (!strcmp(parmname, "GUID"))
+	{
+		if (setNewValue) tr->m_guid = *(GUID*)setNewValue;
+		return &tr->m_guid;
+	}
+	if (!strcmp(parmname, "B_MUTE"))
+	{
+		if (setNewValue) tr->m_mute = *(bool*)setNewValue;
+		return &tr->m_mute;
+	}
+	if (!strcmp(parmname, "I_SELECTED"))
+	{
+		if (setNewValue) tr->m_selected = *(int*)setNewValue;
+		return &tr->m_selected;
+	}
+	if (!strcmp(parmname, "P_PROJECT"))
+		return Stub_Rpr(tr->m_project);
+	if (!strcmp(parmname, "IP_TRACKNUMBER"))
+		return (void*)(INT_PTR)Api_GetMediaTrackInfo_Value(track, parmname);
+	if (parmname[0] == 'D' && parmname[1] == '_')
+	{
+		if (tr->m_values.find(parmname) == tr->m_values.end())
+			tr->m_values[parmname] = Api_GetMediaTrackInfo_Value(track, parmname);
+		double* v = &tr->m_values[parmname];
+		if (setNewValue) *v = *(double*)setNewValue;
+		return v;
+	}
+	return NULL;
+}
+
+// Items
+
+int Api_CountTrackMediaItems(MediaTrack* track)
+{
+	StubTrack* tr = Tr(track);
+	return tr ? (int)tr->m_items.size() : 0;
+}
+
+MediaItem* Api_GetTrackMediaItem(MediaTrack* track, int itemidx)
+{
+	StubTrack* tr = Tr(track);
+	return tr && itemidx >= 0 && itemidx < (int)tr->m_items.size() ? Stub_Rpr(tr->m_items[itemidx].get()) : NULL;
+}
+
+// project-wide item enumeration, track by track as REAPER
+template<class F> StubItem* FindItem(StubProject* p, int idx, F match)
+{
+	if (p)
+		for (size_t i = 0; i < p->m_tracks.size(); i++)
+			for (size_t j = 0; j < p->m_tracks[i]->m_items.size(); j++)
+				if (match(p->m_tracks[i]->m_items[j].get()) && !idx--)
+					return p->m_tracks[i]->m_items[j].get();
+	return NULL;
+}
+
+int Api_CountMediaItems(ReaProject* proj)
+{
+	int count = 0;
+	if (StubProject* p = Proj(proj))
+		for (size_t i = 0; i < p->m_tracks.size(); i++)
+			count += (int)p->m_tracks[i]->m_items.size();
+	return count;
+}
+
+MediaItem* Api_GetMediaItem(ReaProject* proj, int itemidx)
+{
+	StubItem* item = FindItem(Proj(proj), itemidx, [](StubItem*) { return true; });
+	return item ? Stub_Rpr(item) : NULL;
+}
+
+int Api_CountSelectedMediaItems(ReaProject* proj)
+{
+	int count = 0;
+	if (StubProject* p = Proj(proj))
+		for (size_t i = 0; i < p->m_tracks.size(); i++)
+			for (size_t j = 0; j < p->m_tracks[i]->m_items.size(); j++)
+				if (p->m_tracks[i]->m_items[j]->m_selected)
+					count++;
+	return count;
+}
+
+MediaItem* Api_GetSelectedMediaItem(ReaProject* proj, int selitem)
+{
+	StubItem* item = FindItem(Proj(proj), selitem, [](StubItem* it) { return it->m_selected; });
+	return item ? Stub_Rpr(item) : NULL;
+}
+
+MediaTrack* Api_GetMediaItem_Track(MediaItem* item)
+{
+	StubItem* it = It(item);
+	return it ? Stub_Rpr(it->m_track) : NULL;
+}
+
+MediaItem* Api_AddMediaItemToTrack(MediaTrack* track)
+{
+	StubTrack* tr = Tr(track);
+	return tr ? Stub_Rpr(Stub_AddItem(tr, 0.0, 0.0)) : NULL;
+}
+
+bool Api_DeleteTrackMediaItem(MediaTrack* track, MediaItem* item)
+{
+	StubTrack* tr = Tr(track);
+	StubItem* it = It(item);
+	if (!tr || !it || it->m_track != tr)
+		return false;
+	for (size_t i = 0; i < tr->m_items.size(); i++)
+		if (tr->m_items[i].get() == it)
+		{
+			tr->m_items.erase(tr->m_items.begin() + i);
+			Touch(tr->m_project);
+			return true;
+		}
+	return false;
+}
+
+bool Api_MoveMediaItemToTrack(MediaItem* item, MediaTrack* desttr)
+{
+	StubItem* it = It(item);
+	StubTrack* dest = Tr(desttr);
+	if (!it || !dest || dest == &dest->m_project->m_master)
+		return false;
+	StubTrack* src = it->m_track;
+	for (size_t i = 0; i < src->m_items.size(); i++)
+		if (src->m_items[i].get() == it)
+		{
+			dest->m_items.push_back(std::move(src->m_items[i]));
+			src->m_items.erase(src->m_items.begin() + i);
+			it->m_track = dest;
+			SortItems(dest);
+			Touch(dest->m_project);
+			return true;
+		}
+	return false;
+}
+
+double Api_GetMediaItemInfo_Value(MediaItem* item, const char* parmname)
+{
+	StubItem* it = It(item);
+	if (!it || !parmname) return 0.0;
+	if (!strcmp(parmname, "D_POSITION")) return it->m_position;
+	if (!strcmp(parmname, "D_LENGTH"))   return it->m_length;
+	if (!strcmp(parmname, "B_MUTE"))     return it->m_mute ? 1.0 : 0.0;
+	if (!strcmp(parmname, "B_UISEL"))    return it->m_selected ? 1.0 : 0.0;
+	if (!strcmp(parmname, "I_CURTAKE"))  return it->m_activeTake;
+	if (!strcmp(parmname, "IP_ITEMNUMBER"))
+		for (size_t i = 0; i < it->m_track->m_items.size(); i++)
+			if (it->m_track->m_items[i].get() == it)
+				return (double)i;
+	return 0.0;
+}
+
+bool Api_SetMediaItemInfo_Value(MediaItem* item, const char* parmname, double newvalue)
+{
+	StubItem* it = It(item);
+	if (!it || !parmname) return false;
+	if      (!strcmp(parmname, "D_POSITION")) { it->m_position = newvalue; SortItems(it->m_track); }
+	else if (!strcmp(parmname, "D_LENGTH"))   it->m_length = newvalue;
+	else if (!strcmp(parmname, "B_MUTE"))     it->m_mute = newvalue != 0.0;
+	else if (!strcmp(parmname, "B_UISEL"))    it->m_selected = newvalue != 0.0;
+	else if (!strcmp(parmname, "I_CURTAKE"))  it->m_activeTake = (int)newvalue;
+	else return false;
+	Touch(ProjOf(it));
+	return true;
+}
+
+void* Api_GetSetMediaItemInfo(MediaItem* item, const char* parmname, void* setNewValue)
+{
+	StubItem* it = It(item);
+	if (!it || !parmname) return NULL;
+	if (setNewValue)
+		Touch(ProjOf(it));
+	if (!strcmp(parmname, "P_TRACK"))
+		return Stub_Rpr(it->m_track);
+	if (!strcmp(parmname, "D_POSITION"))
+	{
+		if (setNewValue) { it->m_position = *(double*)setNewValue; SortItems(it->m_track); }
+		return &it->m_position;
+	}
+	if (!strcmp(parmname, "D_LENGTH"))
+	{
+		if (setNewValue) it->m_length = *(double*)setNewValue;
+		return &it->m_length;
+	}
+	if (!strcmp(parmname, "B_MUTE"))
+	{
+		if (setNewValue) it->m_mute = *(bool*)setNewValue;
+		return &it->m_mute;
+	}
+	if (!strcmp(parmname, "B_UISEL"))
+	{
+		if (setNewValue) it->m_selected = *(bool*)setNewValue;
+		return &it->m_selected;
+	}
+	if (!strcmp(parmname, "I_CURTAKE"))
+	{
+		if (setNewValue) it->m_activeTake = *(int*)setNewValue;
+		return &it->m_activeTake;
+	}
+	if (!strcmp(parmname, "GUID"))
+	{
+		if (setNewValue) it->m_guid = *(GUID*)setNewValue;
+		return &it->m_guid;
+	}
+	return NULL;
+}
+
+// Takes
+
+int Api_CountTakes(MediaItem* item)
+{
+	StubItem* it = It(item);
+	return it ? (int)it->m_takes.size() : 0;
+}
+
+MediaItem_Take* Api_GetTake(MediaItem* item, int takeidx)
+{
+	StubItem* it = It(item);
+	return it && takeidx >= 0 && takeidx < (int)it->m_takes.size() ? Stub_Rpr(it->m_takes[takeidx].get()) : NULL;
+}
+
+MediaItem_Take* Api_GetActiveTake(MediaItem* item)
+{
+	StubItem* it = It(item);
+	return it ? Api_GetTake(item, it->m_activeTake) : NULL;
+}
+
+MediaItem_Take* Api_AddTakeToMediaItem(MediaItem* item)
+{
+	StubItem* it = It(item);
+	if (!it) return NULL;
+	Touch(ProjOf(it));
+	return Stub_Rpr(NewTake(it));
+}
+
+MediaItem* Api_GetMediaItemTake_Item(MediaItem_Take* take)
+{
+	StubTake* tk = Tk(take);
+	return tk ? Stub_Rpr(tk->m_item) : NULL;
+}
+
+MediaTrack* Api_GetMediaItemTake_Track(MediaItem_Take* take)
+{
+	StubTake* tk = Tk(take);
+	return tk ? Stub_Rpr(tk->m_item->m_track) : NULL;
+}
+
+PCM_source* Api_GetMediaItemTake_Source(MediaItem_Take* take)
+{
+	StubTake* tk = Tk(take);
+	return tk ? tk->m_source : NULL;
+}
+
+const char* Api_GetTakeName(MediaItem_Take* take)
+{
+	StubTake* tk = Tk(take);
+	return tk ? tk->m_name.c_str() : NULL;
+}
+
+bool Api_TakeIsMIDI(MediaItem_Take* take)
+{
+	StubTake* tk = Tk(take);
+	return tk && tk->IsMidi();
+}
+
+int TakeIndex(StubTake* tk)
+{
+	for (size_t i = 0; i < tk->m_item->m_takes.size(); i++)
+		if (tk->m_item->m_takes[i].get() == tk)
+			return (int)i;
+	return -1;
+}
+
+double Api_GetMediaItemTakeInfo_Value(MediaItem_Take* take, const char* parmname)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || !parmname) return 0.0;
+	if (!strcmp(parmname, "D_STARTOFFS"))   return tk->m_startOffset;
+	if (!strcmp(parmname, "D_PLAYRATE"))    return tk->m_playRate;
+	if (!strcmp(parmname, "IP_TAKENUMBER")) return TakeIndex(tk);
+	if (!strcmp(parmname, "D_VOL"))         return 1.0;
+	return 0.0;
+}
+
+bool Api_SetMediaItemTakeInfo_Value(MediaItem_Take* take, const char* parmname, double newvalue)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || !parmname) return false;
+	if      (!strcmp(parmname, "D_STARTOFFS")) tk->m_startOffset = newvalue;
+	else if (!strcmp(parmname, "D_PLAYRATE"))  tk->m_playRate = newvalue;
+	else return false;
+	Touch(ProjOf(tk));
+	return true;
+}
+
+void* Api_GetSetMediaItemTakeInfo(MediaItem_Take* take, const char* parmname, void* setNewValue)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || !parmname) return NULL;
+	if (setNewValue)
+		Touch(ProjOf(tk));
+	if (!strcmp(parmname, "P_NAME"))
+	{
+		if (setNewValue) tk->m_name = (const char*)setNewValue;
+		return (void*)tk->m_name.c_str();
+	}
+	if (!strcmp(parmname, "GUID"))
+	{
+		if (setNewValue) tk->m_guid = *(GUID*)setNewValue;
+		return &tk->m_guid;
+	}
+	if (!strcmp(parmname, "P_SOURCE"))
+	{
+		if (setNewValue && setNewValue != tk->m_source)
+		{
+			delete tk->m_source;
+			tk->m_source = (PCM_source*)setNewValue;
+			tk->m_events.clear();
+			tk->MidiChanged();
+		}
+		return tk->m_source;
+	}
+	if (!strcmp(parmname, "P_ITEM"))  return Stub_Rpr(tk->m_item);
+	if (!strcmp(parmname, "P_TRACK")) return Stub_Rpr(tk->m_item->m_track);
+	if (!strcmp(parmname, "D_STARTOFFS"))
+	{
+		if (setNewValue) tk->m_startOffset = *(double*)setNewValue;
+		return &tk->m_startOffset;
+	}
+	if (!strcmp(parmname, "D_PLAYRATE"))
+	{
+		if (setNewValue) tk->m_playRate = *(double*)setNewValue;
+		return &tk->m_playRate;
+	}
+	if (!strcmp(parmname, "IP_TAKENUMBER"))
+		return (void*)(INT_PTR)TakeIndex(tk);
+	return NULL;
+}
+
+// MIDI
+
+double TakeStartQN(StubTake* tk)
+{
+	const StubProject* p = ProjOf(tk);
+	return (tk->m_item->m_position - tk->m_startOffset) * QNPerSecond(p);
+}
+
+double Api_MIDI_GetPPQPosFromProjQN(MediaItem_Take* take, double projqn)
+{
+	StubTake* tk = Tk(take);
+	return tk ? (projqn - TakeStartQN(tk)) * tk->m_ppq : 0.0;
+}
+
+double Api_MIDI_GetProjQNFromPPQPos(MediaItem_Take* take, double ppqpos)
+{
+	StubTake* tk = Tk(take);
+	return tk ? TakeStartQN(tk) + ppqpos / tk->m_ppq : 0.0;
+}
+
+double Api_MIDI_GetPPQPosFromProjTime(MediaItem_Take* take, double projtime)
+{
+	StubTake* tk = Tk(take);
+	return tk ? Api_MIDI_GetPPQPosFromProjQN(take, projtime * QNPerSecond(ProjOf(tk))) : 0.0;
+}
+
+double Api_MIDI_GetProjTimeFromPPQPos(MediaItem_Take* take, double ppqpos)
+{
+	StubTake* tk = Tk(take);
+	return tk ? Api_MIDI_GetProjQNFromPPQPos(take, ppqpos) / QNPerSecond(ProjOf(tk)) : 0.0;
+}
+
+void MidiChanged(StubTake* tk, bool sort)
+{
+	if (sort)
+		Stub_SortEvents(&tk->m_events);
+	tk->MidiChanged();
+	Touch(ProjOf(tk));
+}
+
+int Api_MIDI_CountEvts(MediaItem_Take* take, int* notecntOut, int* ccevtcntOut, int* textsyxevtcntOut)
+{
+	StubTake* tk = Tk(take);
+	int notes = 0, ccs = 0, sys = 0;
+	if (tk && tk->IsMidi())
+	{
+		notes = (int)tk->GetNotes().size();
+		ccs = (int)tk->GetCCs().size();
+		for (size_t i = 0; i < tk->m_events.size(); i++)
+			if (tk->m_events[i].msg.size() && (unsigned char)tk->m_events[i].msg[0] >= 0xF0)
+				sys++;
+	}
+	if (notecntOut) *notecntOut = notes;
+	if (ccevtcntOut) *ccevtcntOut = ccs;
+	if (textsyxevtcntOut) *textsyxevtcntOut = sys;
+	return notes + ccs + sys;
+}
+
+bool Api_MIDI_GetNote(MediaItem_Take* take, int noteidx, bool* selectedOut, bool* mutedOut, double* startppqposOut, double* endppqposOut, int* chanOut, int* pitchOut, int* velOut)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || noteidx < 0 || noteidx >= (int)tk->GetNotes().size())
+		return false;
+	const StubTake::Note& n = tk->GetNotes()[noteidx];
+	const StubMidiEvent& on = tk->m_events[n.on];
+	if (selectedOut)    *selectedOut = (on.flags & 1) != 0;
+	if (mutedOut)       *mutedOut = (on.flags & 2) != 0;
+	if (startppqposOut) *startppqposOut = on.ppq;
+	if (endppqposOut)   *endppqposOut = n.off >= 0 ? tk->m_events[n.off].ppq : tk->m_lengthPPQ;
+	if (chanOut)        *chanOut = on.msg[0] & 0x0F;
+	if (pitchOut)       *pitchOut = on.msg[1] & 0x7F;
+	if (velOut)         *velOut = on.msg[2] & 0x7F;
+	return true;
+}
+
+bool Api_MIDI_SetNote(MediaItem_Take* take, int noteidx, const bool* selectedInOptional, const bool* mutedInOptional, const double* startppqposInOptional, const double* endppqposInOptional, const int* chanInOptional, const int* pitchInOptional, const int* velInOptional, const bool* noSortInOptional)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || noteidx < 0 || noteidx >= (int)tk->GetNotes().size())
+		return false;
+	const StubTake::Note n = tk->GetNotes()[noteidx];
+	StubMidiEvent* evts[2] = { &tk->m_events[n.on], n.off >= 0 ? &tk->m_events[n.off] : NULL };
+	for (int i = 0; i < 2; i++)
+	{
+		StubMidiEvent* e = evts[i];
+		if (!e) continue;
+		if (selectedInOptional) e->flags = (e->flags & ~1) | (*selectedInOptional ? 1 : 0);
+		if (mutedInOptional)    e->flags = (e->flags & ~2) | (*mutedInOptional ? 2 : 0);
+		if (chanInOptional)     e->msg[0] = (char)((e->msg[0] & 0xF0) | (*chanInOptional & 0x0F));
+		if (pitchInOptional)    e->msg[1] = (char)(*pitchInOptional & 0x7F);
+	}
+	if (startppqposInOptional) evts[0]->ppq = *startppqposInOptional;
+	if (endppqposInOptional && evts[1]) evts[1]->ppq = *endppqposInOptional;
+	if (velInOptional) evts[0]->msg[2] = (char)(*velInOptional & 0x7F);
+	MidiChanged(tk, !noSortInOptional || !*noSortInOptional);
+	return true;
+}
+
+bool Api_MIDI_InsertNote(MediaItem_Take* take, bool selected, bool muted, double startppqpos, double endppqpos, int chan, int pitch, int vel, const bool* noSortInOptional)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || !tk->IsMidi())
+		return false;
+	const int flags = (selected ? 1 : 0) | (muted ? 2 : 0);
+	Stub_AddNote(&tk->m_events, startppqpos, endppqpos, chan, pitch, vel, 0, flags);
+	MidiChanged(tk, !noSortInOptional || !*noSortInOptional);
+	return true;
+}
+
+bool Api_MIDI_DeleteNote(MediaItem_Take* take, int noteidx)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || noteidx < 0 || noteidx >= (int)tk->GetNotes().size())
+		return false;
+	const StubTake::Note n = tk->GetNotes()[noteidx];
+	if (n.off > n.on) tk->m_events.erase(tk->m_events.begin() + n.off);
+	tk->m_events.erase(tk->m_events.begin() + n.on);
+	if (n.off >= 0 && n.off < n.on) tk->m_events.erase(tk->m_events.begin() + n.off);
+	MidiChanged(tk, false);
+	return true;
+}
+
+bool Api_MIDI_GetCC(MediaItem_Take* take, int ccidx, bool* selectedOut, bool* mutedOut, double* ppqposOut, int* chanmsgOut, int* chanOut, int* msg2Out, int* msg3Out)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || ccidx < 0 || ccidx >= (int)tk->GetCCs().size())
+		return false;
+	const StubMidiEvent& e = tk->m_events[tk->GetCCs()[ccidx]];
+	if (selectedOut) *selectedOut = (e.flags & 1) != 0;
+	if (mutedOut)    *mutedOut = (e.flags & 2) != 0;
+	if (ppqposOut)   *ppqposOut = e.ppq;
+	if (chanmsgOut)  *chanmsgOut = (unsigned char)e.msg[0] & 0xF0;
+	if (chanOut)     *chanOut = e.msg[0] & 0x0F;
+	if (msg2Out)     *msg2Out = e.msg[1] & 0x7F;
+	if (msg3Out)     *msg3Out = e.msg.size() > 2 ? e.msg[2] & 0x7F : 0;
+	return true;
+}
+
+bool Api_MIDI_SetCC(MediaItem_Take* take, int ccidx, const bool* selectedInOptional, const bool* mutedInOptional, const double* ppqposInOptional, const int* chanmsgInOptional, const int* chanInOptional, const int* msg2InOptional, const int* msg3InOptional, const bool* noSortInOptional)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || ccidx < 0 || ccidx >= (int)tk->GetCCs().size())
+		return false;
+	StubMidiEvent& e = tk->m_events[tk->GetCCs()[ccidx]];
+	if (selectedInOptional) e.flags = (e.flags & ~1) | (*selectedInOptional ? 1 : 0);
+	if (mutedInOptional)    e.flags = (e.flags & ~2) | (*mutedInOptional ? 2 : 0);
+	if (ppqposInOptional)   e.ppq = *ppqposInOptional;
+	if (chanmsgInOptional)  e.msg[0] = (char)((*chanmsgInOptional & 0xF0) | (e.msg[0] & 0x0F));
+	if (chanInOptional)     e.msg[0] = (char)((e.msg[0] & 0xF0) | (*chanInOptional & 0x0F));
+	if (msg2InOptional)     e.msg[1] = (char)(*msg2InOptional & 0x7F);
+	if (msg3InOptional && e.msg.size() > 2) e.msg[2] = (char)(*msg3InOptional & 0x7F);
+	MidiChanged(tk, !noSortInOptional || !*noSortInOptional);
+	return true;
+}
+
+bool Api_MIDI_InsertCC(MediaItem_Take* take, bool selected, bool muted, double ppqpos, int chanmsg, int chan, int msg2, int msg3)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || !tk->IsMidi())
+		return false;
+	Stub_AddCC(&tk->m_events, ppqpos, chanmsg, chan, msg2, msg3, (selected ? 1 : 0) | (muted ? 2 : 0));
+	MidiChanged(tk, true);
+	return true;
+}
+
+bool Api_MIDI_DeleteCC(MediaItem_Take* take, int ccidx)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || ccidx < 0 || ccidx >= (int)tk->GetCCs().size())
+		return false;
+	tk->m_events.erase(tk->m_events.begin() + tk->GetCCs()[ccidx]);
+	MidiChanged(tk, false);
+	return true;
+}
+
+void Api_MIDI_Sort(MediaItem_Take* take)
+{
+	if (StubTake* tk = Tk(take))
+		MidiChanged(tk, true);
+}
+
+void Api_MIDI_DisableSort(MediaItem_Take*)
+{
+	// MIDI_Insert*() etc. sort unless told otherwise, MIDI_Sort() is always fine
+}
+
+int Api_MIDI_EnumSelNotes(MediaItem_Take* take, int noteidx)
+{
+	StubTake* tk = Tk(take);
+	if (!tk) return -1;
+	const std::vector<StubTake::Note>& notes = tk->GetNotes();
+	for (int i = noteidx < 0 ? 0 : noteidx + 1; i < (int)notes.size(); i++)
+		if (tk->m_events[notes[i].on].flags & 1)
+			return i;
+	return -1;
+}
+
+int Api_MIDI_EnumSelCC(MediaItem_Take* take, int ccidx)
+{
+	StubTake* tk = Tk(take);
+	if (!tk) return -1;
+	const std::vector<int>& ccs = tk->GetCCs();
+	for (int i = ccidx < 0 ? 0 : ccidx + 1; i < (int)ccs.size(); i++)
+		if (tk->m_events[ccs[i]].flags & 1)
+			return i;
+	return -1;
+}
+
+// packed events: int offset, char flags, int msglen, msg; ends with an all notes off
+bool Api_MIDI_GetAllEvts(MediaItem_Take* take, char* bufNeedBig, int* bufNeedBig_sz)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || !tk->IsMidi() || !bufNeedBig_sz)
+		return false;
+	const int bufSize = *bufNeedBig_sz;
+	int pos = 0;
+	double last = 0.0;
+	for (size_t i = 0; i <= tk->m_events.size(); i++)
+	{
+		const bool end = i == tk->m_events.size();
+		const std::string msg = end ? std::string("\xb0\x7b\x00", 3) : tk->m_events[i].msg;
+		const double ppq = end ? tk->m_lengthPPQ : tk->m_events[i].ppq;
+		const int len = (int)msg.size();
+		if (pos + 9 + len > bufSize)
+			break;
+		const int offset = (int)(floor(ppq + 0.5) - floor(last + 0.5));
+		memcpy(bufNeedBig + pos, &offset, sizeof(int));
+		bufNeedBig[pos + 4] = end ? 0 : (char)tk->m_events[i].flags;
+		memcpy(bufNeedBig + pos + 5, &len, sizeof(int));
+		memcpy(bufNeedBig + pos + 9, msg.data(), len);
+		pos += 9 + len;
+		last = ppq;
+	}
+	*bufNeedBig_sz = pos;
+	return true;
+}
+
+bool Api_MIDI_SetAllEvts(MediaItem_Take* take, const char* buf, int buf_sz)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || !tk->IsMidi() || !buf)
+		return false;
+	tk->m_events.clear();
+	double ppq = 0.0;
+	int pos = 0;
+	while (pos + 9 <= buf_sz)
+	{
+		int offset, len;
+		memcpy(&offset, buf + pos, sizeof(int));
+		memcpy(&len, buf + pos + 5, sizeof(int));
+		if (len < 0 || pos + 9 + len > buf_sz)
+			return false;
+		StubMidiEvent e;
+		ppq += offset;
+		e.ppq = ppq;
+		e.flags = (unsigned char)buf[pos + 4];
+		e.msg.assign(buf + pos + 9, len);
+		tk->m_events.push_back(e);
+		pos += 9 + len;
+	}
+	tk->m_lengthPPQ = ppq;
+	if (tk->m_events.size() && tk->m_events.back().msg == std::string("\xb0\x7b\x00", 3))
+		tk->m_events.pop_back();
+	MidiChanged(tk, false);
+	return true;
+}
+
+bool Api_MIDI_GetHash(MediaItem_Take* take, bool notesonly, char* hashOut, int hashOut_sz)
+{
+	StubTake* tk = Tk(take);
+	if (!tk || !tk->IsMidi() || !hashOut || hashOut_sz < 17)
+		return false;
+	WDL_UINT64 h = 14695981039346656037ULL; // FNV-1a
+	for (size_t i = 0; i < tk->m_events.size(); i++)
+	{
+		const StubMidiEvent& e = tk->m_events[i];
+		const int status = e.msg.size() ? (unsigned char)e.msg[0] & 0xF0 : 0;
+		if (notesonly && status != 0x80 && status != 0x90)
+			continue;
+		char buf[32];
+		const int n = snprintf(buf, sizeof(buf), "%.0f:%d:", e.ppq, e.flags);
+		for (int j = 0; j < n; j++)               { h ^= (unsigned char)buf[j]; h *= 1099511628211ULL; }
+		for (size_t j = 0; j < e.msg.size(); j++) { h ^= (unsigned char)e.msg[j]; h *= 1099511628211ULL; }
+	}
+	snprintf(hashOut, hashOut_sz, "%016llx", (unsigned long long)h);
+	return true;
+}
+
+HWND Api_MIDIEditor_GetActive()                  { return NULL; }
+MediaItem_Take* Api_MIDIEditor_GetTake(HWND)     { return NULL; }
+int Api_MIDIEditor_GetMode(HWND)                 { return -1; }
+
+// Tempo: constant per project
+
+double Api_TimeMap2_timeToQN(ReaProject* proj, double tpos)  { return tpos * QNPerSecond(Proj(proj)); }
+double Api_TimeMap2_QNToTime(ReaProject* proj, double qn)    { return qn / QNPerSecond(Proj(proj)); }
+double Api_TimeMap_timeToQN(double tpos)                      { return Api_TimeMap2_timeToQN(NULL, tpos); }
+double Api_TimeMap_QNToTime(double qn)                        { return Api_TimeMap2_QNToTime(NULL, qn); }
+double Api_TimeMap_timeToQN_abs(ReaProject* proj, double tpos) { return Api_TimeMap2_timeToQN(proj, tpos); }
+double Api_TimeMap_QNToTime_abs(ReaProject* proj, double qn)   { return Api_TimeMap2_QNToTime(proj, qn); }
+double Api_TimeMap2_GetDividedBpmAtTime(ReaProject* proj, double) { return Proj(proj)->m_bpm; }
+double Api_TimeMap_GetDividedBpmAtTime(double)                { return s_curProject->m_bpm; }
+double Api_Master_GetTempo()                                  { return s_curProject->m_bpm; }
+int Api_CountTempoTimeSigMarkers(ReaProject*)                 { return 0; }
+
+bool Api_GetTempoTimeSigMarker(ReaProject*, int, double*, int*, double*, double*, int*, int*, bool*)
+{
+	return false;
+}
+
+void Api_TimeMap_GetTimeSigAtTime(ReaProject* proj, double, int* timesig_numOut, int* timesig_denomOut, double* tempoOut)
+{
+	const StubProject* p = Proj(proj);
+	if (timesig_numOut)   *timesig_numOut = p->m_timeSigNum;
+	if (timesig_denomOut) *timesig_denomOut = p->m_timeSigDenom;
+	if (tempoOut)         *tempoOut = p->m_bpm;
+}
+
+double Api_TimeMap2_timeToBeats(ReaProject* proj, double tpos, int* measuresOutOptional, int* cmlOutOptional, double* fullbeatsOutOptional, int* cdenomOutOptional)
+{
+	const StubProject* p = Proj(proj);
+	const double beats = tpos * QNPerSecond(p) * p->m_timeSigDenom / 4.0;
+	const int measures = (int)floor(beats / p->m_timeSigNum);
+	if (measuresOutOptional)  *measuresOutOptional = measures;
+	if (cmlOutOptional)       *cmlOutOptional = p->m_timeSigNum;
+	if (fullbeatsOutOptional) *fullbeatsOutOptional = beats;
+	if (cdenomOutOptional)    *cdenomOutOptional = p->m_timeSigDenom;
+	return beats - measures * p->m_timeSigNum;
+}
+
+double Api_TimeMap2_beatsToTime(ReaProject* proj, double tpos, const int* measuresInOptional)
+{
+	const StubProject* p = Proj(proj);
+	const double beats = tpos + (measuresInOptional ? *measuresInOptional * p->m_timeSigNum : 0);
+	return beats * 4.0 / p->m_timeSigDenom / QNPerSecond(p);
+}
+
+// Sends: category <0 receives, 0 sends, >0 hardware outputs (none)
+
+StubSend* FindSend(StubTrack* tr, int category, int sendidx)
+{
+	if (!tr || category > 0)
+		return NULL;
+	std::vector<std::unique_ptr<StubSend> >& sends = tr->m_project->m_sends;
+	for (size_t i = 0; i < sends.size(); i++)
+		if ((category < 0 ? sends[i]->dest : sends[i]->src) == tr && !sendidx--)
+			return sends[i].get();
+	return NULL;
+}
+
+int Api_GetTrackNumSends(MediaTrack* track, int category)
+{
+	StubTrack* tr = Tr(track);
+	int count = 0;
+	if (tr && category <= 0)
+		for (size_t i = 0; i < tr->m_project->m_sends.size(); i++)
+			if ((category < 0 ? tr->m_project->m_sends[i]->dest : tr->m_project->m_sends[i]->src) == tr)
+				count++;
+	return count;
+}
+
+int Api_CreateTrackSend(MediaTrack* tr, MediaTrack* desttrIn)
+{
+	StubTrack* src = Tr(tr);
+	StubTrack* dest = Tr(desttrIn);
+	if (!src || !dest)
+		return -1; // no hardware outputs
+	StubSend* s = Stub_AddSend(src, dest);
+	s->vol = s_configVars["defsendvol"].value.d;
+	Touch(src->m_project);
+	return Api_GetTrackNumSends(tr, 0) - 1;
+}
+
+bool Api_RemoveTrackSend(MediaTrack* track, int category, int sendidx)
+{
+	StubTrack* tr = Tr(track);
+	StubSend* s = FindSend(tr, category, sendidx);
+	if (!s)
+		return false;
+	std::vector<std::unique_ptr<StubSend> >& sends = tr->m_project->m_sends;
+	for (size_t i = 0; i < sends.size(); i++)
+		if (sends[i].get() == s)
+		{
+			sends.erase(sends.begin() + i);
+			break;
+		}
+	Touch(tr->m_project);
+	return true;
+}
+
+void* Api_GetSetTrackSendInfo(MediaTrack* track, int category, int sendidx, const char* parmname, void* setNewValue)
+{
+	StubSend* s = FindSend(Tr(track), category, sendidx);
+	if (!s || !parmname)
+		return NULL;
+	if (setNewValue)
+		Touch(s->src->m_project);
+	if (!strcmp(parmname, "P_SRCTRACK"))  return Stub_Rpr(s->src);
+	if (!strcmp(parmname, "P_DESTTRACK")) return Stub_Rpr(s->dest);
+#define STUB_SEND_PARM(name, field, type) \
+	if (!strcmp(parmname, name)) { if (setNewValue) s->field = *(type*)setNewValue; return &s->field; }
+	STUB_SEND_PARM("B_MUTE", mute, bool)
+	STUB_SEND_PARM("B_PHASE", phase, bool)
+	STUB_SEND_PARM("B_MONO", mono, bool)
+	STUB_SEND_PARM("D_VOL", vol, double)
+	STUB_SEND_PARM("D_PAN", pan, double)
+	STUB_SEND_PARM("D_PANLAW", panLaw, double)
+	STUB_SEND_PARM("I_SENDMODE", mode, int)
+	STUB_SEND_PARM("I_AUTOMODE", autoMode, int)
+	STUB_SEND_PARM("I_SRCCHAN", srcChan, int)
+	STUB_SEND_PARM("I_DSTCHAN", dstChan, int)
+	STUB_SEND_PARM("I_MIDIFLAGS", midiFlags, int)
+#undef STUB_SEND_PARM
+	return NULL;
+}
+
+double Api_GetTrackSendInfo_Value(MediaTrack* tr, int category, int sendidx, const char* parmname)
+{
+	void* p = Api_GetSetTrackSendInfo(tr, category, sendidx, parmname, NULL);
+	if (!p) return 0.0;
+	if (parmname[0] == 'P') return (double)(INT_PTR)p;
+	if (parmname[0] == 'B') return *(bool*)p ? 1.0 : 0.0;
+	if (parmname[0] == 'D') return *(double*)p;
+	return *(int*)p;
+}
+
+bool Api_SetTrackSendInfo_Value(MediaTrack* tr, int category, int sendidx, const char* parmname, double newvalue)
+{
+	if (!parmname || parmname[0] == 'P')
+		return false;
+	bool b = newvalue != 0.0;
+	int i = (int)newvalue;
+	void* value = parmname[0] == 'B' ? (void*)&b : parmname[0] == 'D' ? (void*)&newvalue : (void*)&i;
+	return Api_GetSetTrackSendInfo(tr, category, sendidx, parmname, value) != NULL;
+}
+
+// Envelopes
+
+int Api_CountTrackEnvelopes(MediaTrack* track)
+{
+	StubTrack* tr = Tr(track);
+	return tr ? (int)tr->m_envelopes.size() : 0;
+}
+
+TrackEnvelope* Api_GetTrackEnvelope(MediaTrack* track, int envidx)
+{
+	StubTrack* tr = Tr(track);
+	return tr && envidx >= 0 && envidx < (int)tr->m_envelopes.size() ? Stub_Rpr(tr->m_envelopes[envidx].get()) : NULL;
+}
+
+int Api_CountEnvelopePoints(TrackEnvelope* envelope)
+{
+	StubEnvelope* env = Env(envelope);
+	return env ? (int)env->m_points.size() : 0;
+}
+
+bool Api_GetEnvelopePoint(TrackEnvelope* envelope, int ptidx, double* timeOut, double* valueOut, int* shapeOut, double* tensionOut, bool* selectedOut)
+{
+	StubEnvelope* env = Env(envelope);
+	if (!env || ptidx < 0 || ptidx >= (int)env->m_points.size())
+		return false;
+	const StubEnvelope::Point& pt = env->m_points[ptidx];
+	if (timeOut)     *timeOut = pt.time;
+	if (valueOut)    *valueOut = pt.value;
+	if (shapeOut)    *shapeOut = pt.shape;
+	if (tensionOut)  *tensionOut = pt.tension;
+	if (selectedOut) *selectedOut = pt.selected;
+	return true;
+}
+
+void SortPoints(StubEnvelope* env)
+{
+	std::stable_sort(env->m_points.begin(), env->m_points.end(),
+		[](const StubEnvelope::Point& a, const StubEnvelope::Point& b) { return a.time < b.time; });
+}
+
+bool Api_SetEnvelopePoint(TrackEnvelope* envelope, int ptidx, double* timeInOptional, double* valueInOptional, int* shapeInOptional, double* tensionInOptional, bool* selectedInOptional, bool* noSortInOptional)
+{
+	StubEnvelope* env = Env(envelope);
+	if (!env || ptidx < 0 || ptidx >= (int)env->m_points.size())
+		return false;
+	StubEnvelope::Point& pt = env->m_points[ptidx];
+	if (timeInOptional)     pt.time = *timeInOptional;
+	if (valueInOptional)    pt.value = *valueInOptional;
+	if (shapeInOptional)    pt.shape = *shapeInOptional;
+	if (tensionInOptional)  pt.tension = *tensionInOptional;
+	if (selectedInOptional) pt.selected = *selectedInOptional;
+	if (!noSortInOptional || !*noSortInOptional)
+		SortPoints(env);
+	Touch(ProjOf(env->m_track));
+	return true;
+}
+
+bool Api_InsertEnvelopePoint(TrackEnvelope* envelope, double time, double value, int shape, double tension, bool selected, bool* noSortInOptional)
+{
+	StubEnvelope* env = Env(envelope);
+	if (!env)
+		return false;
+	StubEnvelope::Point pt = { time, value, shape, tension, selected };
+	env->m_points.push_back(pt);
+	if (!noSortInOptional || !*noSortInOptional)
+		SortPoints(env);
+	Touch(ProjOf(env->m_track));
+	return true;
+}
+
+bool Api_DeleteEnvelopePointRange(TrackEnvelope* envelope, double time_start, double time_end)
+{
+	StubEnvelope* env = Env(envelope);
+	if (!env)
+		return false;
+	for (size_t i = env->m_points.size(); i-- > 0;)
+		if (env->m_points[i].time >= time_start && env->m_points[i].time < time_end)
+			env->m_points.erase(env->m_points.begin() + i);
+	Touch(ProjOf(env->m_track));
+	return true;
+}
+
+bool Api_Envelope_SortPoints(TrackEnvelope* envelope)
+{
+	StubEnvelope* env = Env(envelope);
+	if (env)
+		SortPoints(env);
+	return env != NULL;
+}
+
+int Api_GetEnvelopeScalingMode(TrackEnvelope*)
+{
+	return 0;
+}
+
+// linear between points, square points hold their value
+int Api_Envelope_Evaluate(TrackEnvelope* envelope, double time, double, int, double* valueOut, double* dVdSOut, double* ddVdSOut, double* dddVdSOut)
+{
+	StubEnvelope* env = Env(envelope);
+	double value = 0.0;
+	if (env && env->m_points.size())
+	{
+		const std::vector<StubEnvelope::Point>& pts = env->m_points;
+		size_t i = 0;
+		while (i < pts.size() && pts[i].time <= time)
+			i++;
+		if (!i)
+			value = pts[0].value;
+		else if (i == pts.size() || pts[i - 1].shape == 1 || pts[i].time <= pts[i - 1].time)
+			value = pts[i - 1].value;
+		else
+			value = pts[i - 1].value + (pts[i].value - pts[i - 1].value) * (time - pts[i - 1].time) / (pts[i].time - pts[i - 1].time);
+	}
+	if (valueOut)  *valueOut = value;
+	if (dVdSOut)   *dVdSOut = 0.0;
+	if (ddVdSOut)  *ddVdSOut = 0.0;
+	if (dddVdSOut) *dddVdSOut = 0.0;
+	return 0;
+}
+
+// Markers and regions
+
+int Api_AddProjectMarker2(ReaProject* proj, bool isrgn, double pos, double rgnend, const char* name, int wantidx, int color)
+{
+	StubProject* p = Proj(proj);
+	if (!p) return -1;
+	int number = wantidx;
+	if (number < 0 || [&]() { for (size_t i = 0; i < p->m_markers.size(); i++) if (p->m_markers[i].region == isrgn && p->m_markers[i].number == number) return true; return false; }())
+	{
+		number = 1;
+		for (size_t i = 0; i < p->m_markers.size(); i++)
+			if (p->m_markers[i].region == isrgn && p->m_markers[i].number >= number)
+				number = p->m_markers[i].number + 1;
+	}
+	StubMarker m = { isrgn, pos, isrgn ? rgnend : pos, name ? name : "", number, color };
+	p->m_markers.push_back(m);
+	std::stable_sort(p->m_markers.begin(), p->m_markers.end(), [](const StubMarker& a, const StubMarker& b) { return a.pos < b.pos; });
+	Touch(p);
+	return number;
+}
+
+int Api_AddProjectMarker(ReaProject* proj, bool isrgn, double pos, double rgnend, const char* name, int wantidx)
+{
+	return Api_AddProjectMarker2(proj, isrgn, pos, rgnend, name, wantidx, 0);
+}
+
+int Api_CountProjectMarkers(ReaProject* proj, int* num_markersOut, int* num_regionsOut)
+{
+	StubProject* p = Proj(proj);
+	int markers = 0, regions = 0;
+	if (p)
+		for (size_t i = 0; i < p->m_markers.size(); i++)
+			(p->m_markers[i].region ? regions : markers)++;
+	if (num_markersOut) *num_markersOut = markers;
+	if (num_regionsOut) *num_regionsOut = regions;
+	return markers + regions;
+}
+
+int Api_EnumProjectMarkers3(ReaProject* proj, int idx, bool* isrgnOut, double* posOut, double* rgnendOut, const char** nameOut, int* markrgnindexnumberOut, int* colorOut)
+{
+	StubProject* p = Proj(proj);
+	if (!p || idx < 0 || idx >= (int)p->m_markers.size())
+		return 0;
+	const StubMarker& m = p->m_markers[idx];
+	if (isrgnOut)              *isrgnOut = m.region;
+	if (posOut)                *posOut = m.pos;
+	if (rgnendOut)             *rgnendOut = m.end;
+	if (nameOut)               *nameOut = m.name.c_str();
+	if (markrgnindexnumberOut) *markrgnindexnumberOut = m.number;
+	if (colorOut)              *colorOut = m.color;
+	return idx + 1;
+}
+
+int Api_EnumProjectMarkers2(ReaProject* proj, int idx, bool* isrgnOut, double* posOut, double* rgnendOut, const char** nameOut, int* markrgnindexnumberOut)
+{
+	return Api_EnumProjectMarkers3(proj, idx, isrgnOut, posOut, rgnendOut, nameOut, markrgnindexnumberOut, NULL);
+}
+
+int Api_EnumProjectMarkers(int idx, bool* isrgnOut, double* posOut, double* rgnendOut, const char** nameOut, int* markrgnindexnumberOut)
+{
+	return Api_EnumProjectMarkers3(NULL, idx, isrgnOut, posOut, rgnendOut, nameOut, markrgnindexnumberOut, NULL);
+}
+
+bool Api_DeleteProjectMarker(ReaProject* proj, int markrgnindexnumber, bool isrgn)
+{
+	StubProject* p = Proj(proj);
+	if (p)
+		for (size_t i = 0; i < p->m_markers.size(); i++)
+			if (p->m_markers[i].region == isrgn && p->m_markers[i].number == markrgnindexnumber)
+			{
+				p->m_markers.erase(p->m_markers.begin() + i);
+				Touch(p);
+				return true;
+			}
+	return false;
+}
+
+// Chunks
+
+char* Api_GetSetObjectState(void* obj, const char* str)
+{
+	StubObject* o = reinterpret_cast<StubObject*>(obj);
+	if (!o)
+		return NULL;
+
+	if (!str)
+	{
+		s_getStateCalls++;
+		WDL_FastString chunk;
+		switch (o->m_kind)
+		{
+			case StubObject::TRACK:    AppendTrackChunk(static_cast<StubTrack*>(o), &chunk); break;
+			case StubObject::ITEM:     AppendItemChunk(static_cast<StubItem*>(o), &chunk); break;
+			case StubObject::ENVELOPE: AppendEnvelopeChunk(static_cast<StubEnvelope*>(o), &chunk); break;
+			default: return NULL;
+		}
+		char* ret = (char*)malloc(chunk.GetLength() + 1); // see Api_FreeHeapPtr()
+		if (ret)
+			memcpy(ret, chunk.Get(), chunk.GetLength() + 1);
+		return ret;
+	}
+
+	s_setStateCalls++;
+	std::vector<std::string> lines;
+	SplitLines(str, &lines);
+	switch (o->m_kind)
+	{
+		case StubObject::TRACK:
+			ParseTrackChunk(static_cast<StubTrack*>(o), lines);
+			Touch(static_cast<StubTrack*>(o)->m_project);
+			break;
+		case StubObject::ITEM:
+		{
+			StubItem* item = static_cast<StubItem*>(o);
+			if (lines.size())
+				ParseItemChunk(item, lines, 0, SubChunkEnd(lines, 0));
+			SortItems(item->m_track);
+			Touch(ProjOf(item));
+			break;
+		}
+		case StubObject::ENVELOPE:
+			if (lines.size())
+				ParseEnvelopeChunk(static_cast<StubEnvelope*>(o), lines, 0, SubChunkEnd(lines, 0));
+			Touch(ProjOf(static_cast<StubEnvelope*>(o)->m_track));
+			break;
+		default:
+			return (char*)""; // error
+	}
+	return NULL;
+}
+
+void Api_FreeHeapPtr(void* ptr)
+{
+	free(ptr);
+}
+
+// Paths, config, registrations
+
+const char* Api_GetResourcePath() { return s_resourcePath.c_str(); }
+const char* Api_GetExePath()      { return s_resourcePath.c_str(); }
+const char* Api_get_ini_file()    { return s_iniFile.c_str(); }
+const char* Api_GetAppVersion()   { return "7.0/linux-x86_64"; }
+
+double Api_time_precise()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Api_ShowConsoleMsg(const char* msg)
+{
+	if (msg)
+		fputs(msg, stderr);
+}
+
+int Api_plugin_register(const char* name, void*)
+{
+	return name && !strcmp(name, "command_id") ? ++s_commandIds : 1;
+}
+
+void* Api_get_config_var(const char* name, int* szOut)
+{
+	std::map<std::string, ConfigVarValue>::iterator it = name ? s_configVars.find(name) : s_configVars.end();
+	if (it == s_configVars.end())
+		return NULL;
+	if (szOut)
+		*szOut = it->second.size;
+	return &it->second.value;
+}
+
+int Api_projectconfig_var_getoffs(const char*, int* szOut)
+{
+	if (szOut)
+		*szOut = 0;
+	return 0; // no project config var: ConfigVar falls back to get_config_var()
+}
+
+void* Api_projectconfig_var_addr(ReaProject*, int)
+{
+	return NULL;
+}
+
+void Api_screenset_registerNew(char*, screensetNewCallbackFunc, void*) {}
+void Api_screenset_unregister(char*) {}
+
+IReaperPitchShift* Api_ReaperGetPitchShiftAPI(int version)
+{
+	return version == REAPER_PITCHSHIFT_API_VER ? new StubPitchShift : NULL;
+}
+
+PCM_source* Api_PCM_Source_CreateFromType(const char* sourcetype)
+{
+	return sourcetype && !strcmp(sourcetype, "MIDI") ? new StubMidiSource : NULL;
+}
+
+void Api_PCM_Source_Destroy(PCM_source* src)
+{
+	delete src;
+}
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// SWELL ini files
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// sections and keys keep their order, lookups are case insensitive
+struct IniSection
+{
+	std::string m_name;
+	std::vector<std::pair<std::string, std::string> > m_keys;
+	std::unordered_map<std::string, size_t> m_index; // lower case key -> m_keys index
+
+	void Reindex()
+	{
+		m_index.clear();
+		for (size_t i = 0; i < m_keys.size(); i++)
+			m_index[Lower(m_keys[i].first)] = i;
+	}
+
+	static std::string Lower(const char* s)
+	{
+		std::string l(s);
+		for (size_t i = 0; i < l.size(); i++)
+			l[i] = (char)tolower((unsigned char)l[i]);
+		return l;
+	}
+
+	static std::string Lower(const std::string& s) { return Lower(s.c_str()); }
+};
+
+struct IniFile
+{
+	IniFile() : m_dirty(false) {}
+	std::vector<std::unique_ptr<IniSection> > m_sections;
+	bool m_dirty;
+};
+
+std::map<std::string, IniFile> s_iniFiles;
+
+IniFile* GetIniFile(const char* fn)
+{
+	if (!fn || !*fn)
+		return NULL;
+
+	std::map<std::string, IniFile>::iterator it = s_iniFiles.find(fn);
+	if (it != s_iniFiles.end())
+		return &it->second;
+
+	IniFile* ini = &s_iniFiles[fn];
+	if (FILE* f = fopen(fn, "r"))
+	{
+		IniSection* sec = NULL;
+		char line[8192];
+		while (fgets(line, sizeof(line), f))
+		{
+			size_t len = strlen(line);
+			while (len && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = '\0';
+			if (line[0] == '[' && len > 1 && line[len - 1] == ']')
+			{
+				sec = new IniSection;
+				sec->m_name.assign(line + 1, len - 2);
+				ini->m_sections.push_back(std::unique_ptr<IniSection>(sec));
+			}
+			else if (const char* eq = sec ? strchr(line, '=') : NULL)
+				sec->m_keys.push_back(std::make_pair(std::string(line, eq - line), std::string(eq + 1)));
+		}
+		fclose(f);
+		for (size_t i = 0; i < ini->m_sections.size(); i++)
+			ini->m_sections[i]->Reindex();
+	}
+	return ini;
+}
+
+IniSection* FindSection(IniFile* ini, const char* name, bool create)
+{
+	if (!ini || !name)
+		return NULL;
+	for (size_t i = 0; i < ini->m_sections.size(); i++)
+		if (!strcasecmp(ini->m_sections[i]->m_name.c_str(), name))
+			return ini->m_sections[i].get();
+	if (!create)
+		return NULL;
+	IniSection* sec = new IniSection;
+	sec->m_name = name;
+	ini->m_sections.push_back(std::unique_ptr<IniSection>(sec));
+	return sec;
+}
+
+const std::string* FindKey(IniSection* sec, const char* key)
+{
+	if (!sec || !key)
+		return NULL;
+	std::unordered_map<std::string, size_t>::const_iterator it = sec->m_index.find(IniSection::Lower(key));
+	return it != sec->m_index.end() ? &sec->m_keys[it->second].second : NULL;
+}
+
+// copies a double null terminated list, returns the length without the last null
+DWORD CopyList(const std::vector<std::string>& strs, char* ret, int retsize)
+{
+	if (!ret || retsize < 2)
+		return 0;
+	int pos = 0;
+	for (size_t i = 0; i < strs.size() && pos + (int)strs[i].size() + 2 <= retsize; i++)
+	{
+		memcpy(ret + pos, strs[i].c_str(), strs[i].size() + 1);
+		pos += (int)strs[i].size() + 1;
+	}
+	ret[pos] = '\0';
+	return pos;
+}
+
+DWORD SwellStub_GetPrivateProfileString(const char* appname, const char* keyname, const char* def, char* ret, int retsize, const char* fn)
+{
+	IniFile* ini = GetIniFile(fn);
+	std::vector<std::string> names;
+	if (!appname)
+	{
+		for (size_t i = 0; ini && i < ini->m_sections.size(); i++)
+			names.push_back(ini->m_sections[i]->m_name);
+		return CopyList(names, ret, retsize);
+	}
+	IniSection* sec = FindSection(ini, appname, false);
+	if (!keyname)
+	{
+		for (size_t i = 0; sec && i < sec->m_keys.size(); i++)
+			names.push_back(sec->m_keys[i].first);
+		return CopyList(names, ret, retsize);
+	}
+
+	if (!ret || retsize < 1)
+		return 0;
+	const std::string* val = FindKey(sec, keyname);
+	std::string str = val ? *val : def ? def : "";
+	if (val && str.size() >= 2 && str[0] == '"' && str[str.size() - 1] == '"')
+		str = str.substr(1, str.size() - 2);
+	lstrcpyn_safe(ret, str.c_str(), retsize);
+	return (DWORD)strlen(ret);
+}
+
+int SwellStub_GetPrivateProfileInt(const char* appname, const char* keyname, int def, const char* fn)
+{
+	const std::string* val = FindKey(FindSection(GetIniFile(fn), appname, false), keyname);
+	return val && val->size() ? atoi(val->c_str()) : def;
+}
+
+BOOL SwellStub_WritePrivateProfileString(const char* appname, const char* keyname, const char* val, const char* fn)
+{
+	IniFile* ini = GetIniFile(fn);
+	if (!ini || !appname)
+		return FALSE;
+	ini->m_dirty = true;
+
+	if (!keyname) // deletes the section
+	{
+		for (size_t i = 0; i < ini->m_sections.size(); i++)
+			if (!strcasecmp(ini->m_sections[i]->m_name.c_str(), appname))
+			{
+				ini->m_sections.erase(ini->m_sections.begin() + i);
+				break;
+			}
+		return TRUE;
+	}
+
+	IniSection* sec = FindSection(ini, appname, val != NULL);
+	if (!sec)
+		return TRUE;
+	std::unordered_map<std::string, size_t>::iterator it = sec->m_index.find(IniSection::Lower(keyname));
+	if (!val) // deletes the key
+	{
+		if (it != sec->m_index.end())
+		{
+			sec->m_keys.erase(sec->m_keys.begin() + it->second);
+			sec->Reindex();
+		}
+	}
+	else if (it != sec->m_index.end())
+		sec->m_keys[it->second].second = val;
+	else
+	{
+		sec->m_index[IniSection::Lower(keyname)] = sec->m_keys.size();
+		sec->m_keys.push_back(std::make_pair(std::string(keyname), std::string(val)));
+	}
+	return TRUE;
+}
+
+DWORD SwellStub_GetPrivateProfileSection(const char* appname, char* strout, DWORD strout_len, const char* fn)
+{
+	IniSection* sec = FindSection(GetIniFile(fn), appname, false);
+	std::vector<std::string> lines;
+	for (size_t i = 0; sec && i < sec->m_keys.size(); i++)
+		lines.push_back(sec->m_keys[i].first + "=" + sec->m_keys[i].second);
+	return CopyList(lines, strout, (int)strout_len);
+}
+
+BOOL SwellStub_WritePrivateProfileSection(const char* appname, const char* strings, const char* fn)
+{
+	IniFile* ini = GetIniFile(fn);
+	IniSection* sec = FindSection(ini, appname, true);
+	if (!sec || !strings)
+		return FALSE;
+	ini->m_dirty = true;
+	sec->m_keys.clear();
+	for (const char* s = strings; *s; s += strlen(s) + 1)
+		if (const char* eq = strchr(s, '='))
+			sec->m_keys.push_back(std::make_pair(std::string(s, eq - s), std::string(eq + 1)));
+	sec->Reindex();
+	return TRUE;
+}
+
+// hex bytes followed by a checksum byte, as SWELL does
+BOOL SwellStub_WritePrivateProfileStruct(const char* appname, const char* keyname, const void* buf, int bufsz, const char* fn)
+{
+	if (!buf || bufsz < 0)
+		return SwellStub_WritePrivateProfileString(appname, keyname, NULL, fn);
+	std::string hex;
+	unsigned char sum = 0;
+	char tmp[8];
+	for (int i = 0; i < bufsz; i++)
+	{
+		const unsigned char c = ((const unsigned char*)buf)[i];
+		snprintf(tmp, sizeof(tmp), "%02X", c);
+		hex += tmp;
+		sum += c;
+	}
+	snprintf(tmp, sizeof(tmp), "%02X", sum);
+	hex += tmp;
+	return SwellStub_WritePrivateProfileString(appname, keyname, hex.c_str(), fn);
+}
+
+BOOL SwellStub_GetPrivateProfileStruct(const char* appname, const char* keyname, void* buf, int bufsz, const char* fn)
+{
+	const std::string* hex = FindKey(FindSection(GetIniFile(fn), appname, false), keyname);
+	if (!buf || bufsz < 0 || !hex || (int)hex->size() != (bufsz + 1) * 2)
+		return FALSE;
+	std::vector<unsigned char> bytes(bufsz + 1);
+	unsigned char sum = 0;
+	for (int i = 0; i <= bufsz; i++)
+	{
+		char tmp[3] = { (*hex)[i * 2], (*hex)[i * 2 + 1], '\0' };
+		char* end;
+		bytes[i] = (unsigned char)strtol(tmp, &end, 16);
+		if (*end)
+			return FALSE;
+		if (i < bufsz)
+			sum += bytes[i];
+	}
+	if (sum != bytes[bufsz])
+		return FALSE;
+	memcpy(buf, &bytes[0], bufsz);
+	return TRUE;
+}
+
+void FlushIniFile(const std::string& fn, IniFile* ini)
+{
+	if (!ini->m_dirty)
+		return;
+	if (FILE* f = fopen(fn.c_str(), "w"))
+	{
+		for (size_t i = 0; i < ini->m_sections.size(); i++)
+		{
+			const IniSection* sec = ini->m_sections[i].get();
+			fprintf(f, "[%s]\n", sec->m_name.c_str());
+			for (size_t j = 0; j < sec->m_keys.size(); j++)
+				fprintf(f, "%s=%s\n", sec->m_keys[j].first.c_str(), sec->m_keys[j].second.c_str());
+			fputs("\n", f);
+		}
+		fclose(f);
+		ini->m_dirty = false;
+	}
+}
+
+int SwellStub_MessageBox(HWND, const char* text, const char* caption, unsigned int type)
+{
+	fprintf(stderr, "MessageBox: %s: %s\n", caption ? caption : "", text ? text : "");
+	const unsigned int buttons = type & 0xF;
+	return buttons == MB_YESNO || buttons == MB_YESNOCANCEL ? IDNO : IDOK;
+}
+
+WORD SwellStub_GetAsyncKeyState(int)
+{
+	return 0; // no modifier key down
+}
+
+DWORD SwellStub_GetTickCount()
+{
+	return (DWORD)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SwellStub_Sleep(int ms)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void* SwellGetFunc(const char* name)
+{
+	static const struct { const char* name; void* func; } s_funcs[] =
+	{
+#define SWELL_STUB_FUNC(x) { #x, (void*)&SwellStub_##x },
+		SWELL_STUB_FUNC(GetPrivateProfileString)
+		SWELL_STUB_FUNC(GetPrivateProfileInt)
+		SWELL_STUB_FUNC(WritePrivateProfileString)
+		SWELL_STUB_FUNC(GetPrivateProfileSection)
+		SWELL_STUB_FUNC(WritePrivateProfileSection)
+		SWELL_STUB_FUNC(GetPrivateProfileStruct)
+		SWELL_STUB_FUNC(WritePrivateProfileStruct)
+		SWELL_STUB_FUNC(MessageBox)
+		SWELL_STUB_FUNC(GetAsyncKeyState)
+		SWELL_STUB_FUNC(GetTickCount)
+		SWELL_STUB_FUNC(Sleep)
+#undef SWELL_STUB_FUNC
+	};
+	for (size_t i = 0; i < sizeof(s_funcs) / sizeof(s_funcs[0]); i++)
+		if (!strcmp(s_funcs[i].name, name))
+			return s_funcs[i].func;
+	return NULL;
+}
+
+void SetDefaultConfigVars()
+{
+	s_configVars.clear();
+	Stub_SetConfigVar("vstfullstate", 0);
+	Stub_SetConfigVar("defsendflag", 0);
+	Stub_SetConfigVar("defsendvol", 1.0);
+}
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Harness side
+///////////////////////////////////////////////////////////////////////////////
+
+void Stub_Install()
+{
+#define STUB_API(x) x = Api_##x;
+	STUB_API(AddMediaItemToTrack)
+	STUB_API(AddProjectMarker)
+	STUB_API(AddProjectMarker2)
+	STUB_API(AddTakeToMediaItem)
+	STUB_API(CountEnvelopePoints)
+	STUB_API(CountMediaItems)
+	STUB_API(CountProjectMarkers)
+	STUB_API(CountSelectedMediaItems)
+	STUB_API(CountSelectedTracks)
+	STUB_API(CountTakes)
+	STUB_API(CountTempoTimeSigMarkers)
+	STUB_API(CountTrackEnvelopes)
+	STUB_API(CountTrackMediaItems)
+	STUB_API(CountTracks)
+	STUB_API(CreateTrackSend)
+	STUB_API(CSurf_TrackFromID)
+	STUB_API(CSurf_TrackToID)
+	STUB_API(DeleteEnvelopePointRange)
+	STUB_API(DeleteProjectMarker)
+	STUB_API(DeleteTrack)
+	STUB_API(DeleteTrackMediaItem)
+	STUB_API(EnumProjectMarkers)
+	STUB_API(EnumProjectMarkers2)
+	STUB_API(EnumProjectMarkers3)
+	STUB_API(EnumProjects)
+	STUB_API(Envelope_Evaluate)
+	STUB_API(Envelope_SortPoints)
+	STUB_API(FreeHeapPtr)
+	STUB_API(genGuid)
+	STUB_API(get_config_var)
+	STUB_API(get_ini_file)
+	STUB_API(GetActiveTake)
+	STUB_API(GetAppVersion)
+	STUB_API(GetCurrentProjectInLoadSave)
+	STUB_API(GetCursorPosition)
+	STUB_API(GetCursorPositionEx)
+	STUB_API(GetEnvelopePoint)
+	STUB_API(GetEnvelopeScalingMode)
+	STUB_API(GetExePath)
+	STUB_API(GetHZoomLevel)
+	STUB_API(GetMasterTrack)
+	STUB_API(GetMediaItem)
+	STUB_API(GetMediaItem_Track)
+	STUB_API(GetMediaItemInfo_Value)
+	STUB_API(GetMediaItemTake_Item)
+	STUB_API(GetMediaItemTake_Source)
+	STUB_API(GetMediaItemTake_Track)
+	STUB_API(GetMediaItemTakeInfo_Value)
+	STUB_API(GetMediaTrackInfo_Value)
+	STUB_API(GetPlayState)
+	STUB_API(GetPlayStateEx)
+	STUB_API(GetProjectStateChangeCount)
+	STUB_API(GetResourcePath)
+	STUB_API(GetSelectedMediaItem)
+	STUB_API(GetSelectedTrack)
+	STUB_API(GetSetMediaItemInfo)
+	STUB_API(GetSetMediaItemTakeInfo)
+	STUB_API(GetSetMediaTrackInfo)
+	STUB_API(GetSetObjectState)
+	STUB_API(GetSetTrackSendInfo)
+	STUB_API(GetTake)
+	STUB_API(GetTakeName)
+	STUB_API(GetTempoTimeSigMarker)
+	STUB_API(GetTrack)
+	STUB_API(GetTrackEnvelope)
+	STUB_API(GetTrackGUID)
+	STUB_API(GetTrackMediaItem)
+	STUB_API(GetTrackNumSends)
+	STUB_API(GetTrackSendInfo_Value)
+	STUB_API(guidToString)
+	STUB_API(InsertEnvelopePoint)
+	STUB_API(InsertTrackAtIndex)
+	STUB_API(MarkProjectDirty)
+	STUB_API(Master_GetTempo)
+	STUB_API(MIDI_CountEvts)
+	STUB_API(MIDI_DeleteCC)
+	STUB_API(MIDI_DeleteNote)
+	STUB_API(MIDI_DisableSort)
+	STUB_API(MIDI_EnumSelCC)
+	STUB_API(MIDI_EnumSelNotes)
+	STUB_API(MIDI_GetAllEvts)
+	STUB_API(MIDI_GetCC)
+	STUB_API(MIDI_GetHash)
+	STUB_API(MIDI_GetNote)
+	STUB_API(MIDI_GetPPQPosFromProjQN)
+	STUB_API(MIDI_GetPPQPosFromProjTime)
+	STUB_API(MIDI_GetProjQNFromPPQPos)
+	STUB_API(MIDI_GetProjTimeFromPPQPos)
+	STUB_API(MIDI_InsertCC)
+	STUB_API(MIDI_InsertNote)
+	STUB_API(MIDI_SetAllEvts)
+	STUB_API(MIDI_SetCC)
+	STUB_API(MIDI_SetNote)
+	STUB_API(MIDI_Sort)
+	STUB_API(MIDIEditor_GetActive)
+	STUB_API(MIDIEditor_GetMode)
+	STUB_API(MIDIEditor_GetTake)
+	STUB_API(MoveMediaItemToTrack)
+	STUB_API(PCM_Source_CreateFromType)
+	STUB_API(PCM_Source_Destroy)
+	STUB_API(plugin_register)
+	STUB_API(PreventUIRefresh)
+	STUB_API(projectconfig_var_addr)
+	STUB_API(projectconfig_var_getoffs)
+	STUB_API(ReaperGetPitchShiftAPI)
+	STUB_API(RemoveTrackSend)
+	STUB_API(screenset_registerNew)
+	STUB_API(screenset_unregister)
+	STUB_API(SetEnvelopePoint)
+	STUB_API(SetMediaItemInfo_Value)
+	STUB_API(SetMediaItemTakeInfo_Value)
+	STUB_API(SetMediaTrackInfo_Value)
+	STUB_API(SetTrackSendInfo_Value)
+	STUB_API(ShowConsoleMsg)
+	STUB_API(stringToGuid)
+	STUB_API(TakeIsMIDI)
+	STUB_API(time_precise)
+	STUB_API(TimeMap_GetDividedBpmAtTime)
+	STUB_API(TimeMap_GetTimeSigAtTime)
+	STUB_API(TimeMap_QNToTime)
+	STUB_API(TimeMap_QNToTime_abs)
+	STUB_API(TimeMap_timeToQN)
+	STUB_API(TimeMap_timeToQN_abs)
+	STUB_API(TimeMap2_beatsToTime)
+	STUB_API(TimeMap2_GetDividedBpmAtTime)
+	STUB_API(TimeMap2_QNToTime)
+	STUB_API(TimeMap2_timeToBeats)
+	STUB_API(TimeMap2_timeToQN)
+	STUB_API(Undo_BeginBlock)
+	STUB_API(Undo_BeginBlock2)
+	STUB_API(Undo_EndBlock)
+	STUB_API(Undo_EndBlock2)
+	STUB_API(Undo_OnStateChange)
+	STUB_API(Undo_OnStateChange2)
+	STUB_API(Undo_OnStateChangeEx)
+	STUB_API(Undo_OnStateChangeEx2)
+	STUB_API(UpdateArrange)
+	STUB_API(UpdateItemInProject)
+	STUB_API(UpdateTimeline)
+#undef STUB_API
+
+	// SWELL reports the functions it doesn't get: we only provide a few of them
+	fflush(stdout);
+	const int out = dup(STDOUT_FILENO), null = open("/dev/null", O_WRONLY);
+	if (null >= 0) { dup2(null, STDOUT_FILENO); close(null); }
+	SWELL_dllMain(NULL, DLL_PROCESS_ATTACH, (LPVOID)&SwellGetFunc);
+	fflush(stdout);
+	if (out >= 0) { dup2(out, STDOUT_FILENO); close(out); }
+}
+
+void Stub_Reset(const char* resourcePath)
+{
+	Stub_FlushIniFiles();
+	s_iniFiles.clear();
+	s_resourcePath = resourcePath;
+	s_iniFile = s_resourcePath + "/reaper.ini";
+
+	s_projects.clear();
+	s_curProject = Stub_AddProject("");
+	s_guidCounter = 0;
+	s_getStateCalls = s_setStateCalls = 0;
+	SetDefaultConfigVars();
+}
+
+void Stub_FlushIniFiles()
+{
+	for (std::map<std::string, IniFile>::iterator it = s_iniFiles.begin(); it != s_iniFiles.end(); ++it)
+		FlushIniFile(it->first, &it->second);
+}
+
+StubProject* Stub_GetProject()
+{
+	return s_curProject;
+}
+
+StubProject* Stub_AddProject(const char* path)
+{
+	StubProject* proj = new StubProject;
+	proj->m_path = path ? path : "";
+	NewGuid(&proj->m_master.m_guid);
+	s_projects.push_back(std::unique_ptr<StubProject>(proj));
+	return proj;
+}
+
+void Stub_SelectProject(StubProject* proj)
+{
+	s_curProject = proj;
+}
+
+StubTrack* Stub_AddTrack(StubProject* proj, const char* name)
+{
+	StubTrack* tr = new StubTrack;
+	tr->m_project = proj;
+	tr->m_name = name ? name : "";
+	NewGuid(&tr->m_guid);
+	proj->m_tracks.push_back(std::unique_ptr<StubTrack>(tr));
+	Touch(proj);
+	return tr;
+}
+
+StubItem* Stub_AddItem(StubTrack* tr, double position, double length)
+{
+	StubItem* item = new StubItem;
+	item->m_track = tr;
+	item->m_position = position;
+	item->m_length = length;
+	NewGuid(&item->m_guid);
+	tr->m_items.push_back(std::unique_ptr<StubItem>(item));
+	SortItems(tr);
+	Touch(tr->m_project);
+	return item;
+}
+
+StubTake* Stub_AddMidiTake(StubItem* item, const std::vector<StubMidiEvent>& events, double lengthPPQ)
+{
+	StubTake* take = NewTake(item);
+	take->m_source = new StubMidiSource;
+	take->m_events = events;
+	take->m_lengthPPQ = lengthPPQ;
+	Touch(ProjOf(item));
+	return take;
+}
+
+StubTake* Stub_AddAudioTake(StubItem* item, PCM_source* src)
+{
+	StubTake* take = NewTake(item);
+	take->m_source = src;
+	Touch(ProjOf(item));
+	return take;
+}
+
+StubEnvelope* Stub_AddEnvelope(StubTrack* tr, const char* name)
+{
+	StubEnvelope* env = new StubEnvelope;
+	env->m_track = tr;
+	env->m_name = name;
+	tr->m_envelopes.push_back(std::unique_ptr<StubEnvelope>(env));
+	Touch(tr->m_project);
+	return env;
+}
+
+StubSend* Stub_AddSend(StubTrack* src, StubTrack* dest)
+{
+	StubSend* s = new StubSend;
+	s->src = src;
+	s->dest = dest;
+	s->mode = 0;
+	s->vol = 1.0;
+	s->pan = 0.0;
+	s->mute = s->mono = s->phase = false;
+	s->srcChan = s->dstChan = 0;
+	s->panLaw = -1.0;
+	s->midiFlags = 0;
+	s->autoMode = -1;
+	src->m_project->m_sends.push_back(std::unique_ptr<StubSend>(s));
+	return s;
+}
+
+void Stub_AddNote(std::vector<StubMidiEvent>* events, double start, double end, int chan, int pitch, int vel, int offVel, int flags)
+{
+	StubMidiEvent on = { start, flags, std::string() }, off = { end, flags, std::string() };
+	on.msg += (char)(0x90 | (chan & 0x0F));
+	on.msg += (char)(pitch & 0x7F);
+	on.msg += (char)(vel & 0x7F);
+	off.msg += (char)(0x80 | (chan & 0x0F));
+	off.msg += (char)(pitch & 0x7F);
+	off.msg += (char)(offVel & 0x7F);
+	events->push_back(on);
+	events->push_back(off);
+}
+
+void Stub_AddCC(std::vector<StubMidiEvent>* events, double ppq, int chanMsg, int chan, int msg2, int msg3, int flags)
+{
+	StubMidiEvent e = { ppq, flags, std::string() };
+	e.msg += (char)((chanMsg & 0xF0) | (chan & 0x0F));
+	e.msg += (char)(msg2 & 0x7F);
+	if ((chanMsg & 0xF0) != 0xC0 && (chanMsg & 0xF0) != 0xD0)
+		e.msg += (char)(msg3 & 0x7F);
+	events->push_back(e);
+}
+
+// note-offs first at equal positions, as in REAPER
+void Stub_SortEvents(std::vector<StubMidiEvent>* events)
+{
+	std::stable_sort(events->begin(), events->end(), [](const StubMidiEvent& a, const StubMidiEvent& b)
+	{
+		if (a.ppq != b.ppq)
+			return a.ppq < b.ppq;
+		const auto isOff = [](const StubMidiEvent& e) {
+			const int status = e.msg.size() >= 3 ? (unsigned char)e.msg[0] & 0xF0 : 0;
+			return status == 0x80 || (status == 0x90 && !e.msg[2]);
+		};
+		return isOff(a) && !isOff(b);
+	});
+}
+
+void Stub_SetConfigVar(const char* name, int value)
+{
+	ConfigVarValue& v = s_configVars[name];
+	v.size = sizeof(int);
+	v.value.i = value;
+}
+
+void Stub_SetConfigVar(const char* name, double value)
+{
+	ConfigVarValue& v = s_configVars[name];
+	v.size = sizeof(double);
+	v.value.d = value;
+}
+
+int Stub_GetObjectStateCalls(bool sets)
+{
+	return sets ? s_setStateCalls : s_getStateCalls;
+}
@@ -0,0 +1,219 @@
+/******************************************************************************
+/ ReaperStub.h
+/
+/ Copyright (c) 2026 SWS
+/
+/
+/ Permission is hereby granted, free of charge, to any person obtaining a copy
+/ of this software and associated documentation files (the "Software"), to deal
+/ in the Software without restriction, including without limitation the rights to
+/ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/ of the Software, and to permit persons to whom the Software is furnished to
+/ do so, subject to the following conditions:
+/
+/ The above copyright notice and this permission notice shall be included in all
+/ copies or substantial portions of the Software.
+/
+/ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+/ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+/ OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+/ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+/ HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+/ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+/ OTHER DEALINGS IN THE SOFTWARE.
+/
+******************************************************************************/
+
+#pragma once
+
+// Stub of the REAPER API for the harness: an in-memory project model behind
+// the reaper_plugin_functions.h pointers (tracks, items, takes, MIDI, envelopes,
+// markers, sends, tempo, config vars) and the SWELL ini file functions.
+//
+// GetSetObjectState() builds RPP chunks from the model and parses the core
+// properties back (names, positions, mute/selection, AUXRECV receives, take
+// sources, envelope points); the other lines of a track chunk are kept as is.
+// Tempo is constant per project, there is no audio engine nor UI: GUI API
+// pointers are left NULL, calling them crashes the harness on purpose.
+//
+// Handles given to SWS are the model objects themselves, e.g. a StubTrack* is
+// the MediaTrack*.
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct StubProject;
+struct StubTrack;
+struct StubItem;
+struct StubTake;
+
+struct StubObject
+{
+	enum Kind { PROJECT, TRACK, ITEM, TAKE, ENVELOPE };
+	explicit StubObject(Kind kind) : m_kind(kind) {}
+	virtual ~StubObject() {}
+	const Kind m_kind;
+};
+
+struct StubMidiEvent
+{
+	double ppq;
+	int flags;       // &1: selected, &2: muted
+	std::string msg; // raw bytes
+};
+
+struct StubTake : StubObject
+{
+	StubTake() : StubObject(TAKE), m_item(NULL), m_startOffset(0.0), m_playRate(1.0), m_source(NULL),
+		m_ppq(960), m_lengthPPQ(0.0), m_midiIndexValid(false) {}
+	~StubTake();
+
+	StubItem* m_item;
+	GUID m_guid;
+	std::string m_name;
+	double m_startOffset, m_playRate;
+
+	// audio takes: any PCM_source (owned). MIDI takes: a StubMidiSource, the
+	// events below and the other lines of the SOURCE chunk (HASDATA excluded)
+	PCM_source* m_source;
+	int m_ppq;
+	double m_lengthPPQ;
+	std::vector<StubMidiEvent> m_events; // sorted by ppq
+	std::vector<std::string> m_sourceLines;
+
+	bool IsMidi() const;
+	void MidiChanged() { m_midiIndexValid = false; }
+
+	// note/CC indexes in m_events as seen by the MIDI_ API, rebuilt after changes
+	struct Note { int on, off; };
+	const std::vector<Note>& GetNotes();
+	const std::vector<int>& GetCCs();
+
+private:
+	void BuildMidiIndex();
+	bool m_midiIndexValid;
+	std::vector<Note> m_notes;
+	std::vector<int> m_ccs;
+};
+
+struct StubItem : StubObject
+{
+	StubItem() : StubObject(ITEM), m_track(NULL), m_position(0.0), m_length(1.0),
+		m_mute(false), m_selected(false), m_activeTake(0) {}
+
+	StubTrack* m_track;
+	GUID m_guid;
+	double m_position, m_length;
+	bool m_mute, m_selected;
+	int m_activeTake;
+	std::vector<std::unique_ptr<StubTake> > m_takes;
+};
+
+struct StubEnvelope : StubObject
+{
+	struct Point
+	{
+		double time, value;
+		int shape;
+		double tension;
+		bool selected;
+	};
+
+	StubEnvelope() : StubObject(ENVELOPE), m_track(NULL), m_active(true), m_visible(true) {}
+
+	StubTrack* m_track;
+	std::string m_name; // chunk keyword, e.g. VOLENV2
+	bool m_active, m_visible;
+	std::vector<Point> m_points;
+};
+
+// one send: in the source track's sends and the destination track's receives
+struct StubSend
+{
+	StubTrack* src;
+	StubTrack* dest;
+	int mode;
+	double vol, pan;
+	bool mute, mono, phase;
+	int srcChan, dstChan;
+	double panLaw;
+	int midiFlags, autoMode;
+};
+
+struct StubTrack : StubObject
+{
+	StubTrack() : StubObject(TRACK), m_project(NULL), m_mute(false), m_selected(0) {}
+
+	StubProject* m_project;
+	GUID m_guid;
+	std::string m_name;
+	bool m_mute;
+	int m_selected; // I_SELECTED
+	std::vector<std::unique_ptr<StubItem> > m_items;
+	std::vector<std::unique_ptr<StubEnvelope> > m_envelopes;
+	std::vector<std::string> m_chunkLines; // track chunk lines the stub doesn't model
+	std::map<std::string, double> m_values; // other Get/SetMediaTrackInfo_Value() parameters
+};
+
+struct StubMarker
+{
+	bool region;
+	double pos, end;
+	std::string name;
+	int number, color;
+};
+
+struct StubProject : StubObject
+{
+	StubProject() : StubObject(PROJECT), m_bpm(120.0), m_timeSigNum(4), m_timeSigDenom(4),
+		m_stateChangeCount(1), m_dirty(false) { m_master.m_project = this; }
+
+	std::string m_path;
+	StubTrack m_master;
+	std::vector<std::unique_ptr<StubTrack> > m_tracks;
+	std::vector<std::unique_ptr<StubSend> > m_sends;
+	std::vector<StubMarker> m_markers;
+	double m_bpm;
+	int m_timeSigNum, m_timeSigDenom;
+	int m_stateChangeCount;
+	bool m_dirty;
+
+	int GetTrackIndex(const StubTrack* tr) const; // -1: master or not found
+};
+
+// Harness side
+void Stub_Install();                         // assigns the API pointers, once
+void Stub_Reset(const char* resourcePath);   // closes all projects, opens an empty one
+void Stub_FlushIniFiles();                   // writes the modified ini files
+
+StubProject* Stub_GetProject();              // current project
+StubProject* Stub_AddProject(const char* path);
+void Stub_SelectProject(StubProject* proj);
+
+StubTrack* Stub_AddTrack(StubProject* proj, const char* name = "");
+StubItem* Stub_AddItem(StubTrack* tr, double position, double length);
+StubTake* Stub_AddMidiTake(StubItem* item, const std::vector<StubMidiEvent>& events, double lengthPPQ);
+StubTake* Stub_AddAudioTake(StubItem* item, PCM_source* src); // takes ownership
+StubEnvelope* Stub_AddEnvelope(StubTrack* tr, const char* name);
+StubSend* Stub_AddSend(StubTrack* src, StubTrack* dest);
+
+// note on/off pair, for synthetic MIDI takes
+void Stub_AddNote(std::vector<StubMidiEvent>* events, double start, double end, int chan, int pitch, int vel, int offVel, int flags);
+void Stub_AddCC(std::vector<StubMidiEvent>* events, double ppq, int chanMsg, int chan, int msg2, int msg3, int flags);
+void Stub_SortEvents(std::vector<StubMidiEvent>* events);
+
+// REAPER config vars, see get_config_var()
+void Stub_SetConfigVar(const char* name, int value);
+void Stub_SetConfigVar(const char* name, double value);
+
+// number of GetSetObjectState() calls, gets and sets
+int Stub_GetObjectStateCalls(bool sets);
+
+inline MediaTrack* Stub_Rpr(StubTrack* tr)          { return reinterpret_cast<MediaTrack*>(static_cast<StubObject*>(tr)); }
+inline MediaItem* Stub_Rpr(StubItem* item)          { return reinterpret_cast<MediaItem*>(static_cast<StubObject*>(item)); }
+inline MediaItem_Take* Stub_Rpr(StubTake* take)     { return reinterpret_cast<MediaItem_Take*>(static_cast<StubObject*>(take)); }
+inline TrackEnvelope* Stub_Rpr(StubEnvelope* env)   { return reinterpret_cast<TrackEnvelope*>(static_cast<StubObject*>(env)); }
+inline ReaProject* Stub_Rpr(StubProject* proj)      { return reinterpret_cast<ReaProject*>(static_cast<StubObject*>(proj)); }
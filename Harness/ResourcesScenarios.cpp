@@ -0,0 +1,97 @@
+/******************************************************************************
+/ ResourcesScenarios.cpp
+/
+/ Copyright (c) 2026 SWS
+/
+/
+/ Permission is hereby granted, free of charge, to any person obtaining a copy
+/ of this software and associated documentation files (the "Software"), to deal
+/ in the Software without restriction, including without limitation the rights to
+/ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/ of the Software, and to permit persons to whom the Software is furnished to
+/ do so, subject to the following conditions:
+/
+/ The above copyright notice and this permission notice shall be included in all
+/ copies or substantial portions of the Software.
+/
+/ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+/ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+/ OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+/ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+/ HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+/ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+/ OTHER DEALINGS IN THE SOFTWARE.
+/
+******************************************************************************/
+
+#include "stdafx.h"
+#include "Harness.h"
+#include "ReaperStub.h"
+#include "../SnM/SnM.h"
+#include "../SnM/SnM_Resources.h"
+
+namespace {
+
+const char* const s_slotSections[] = { "FXChains", "TrackTemplates", "MediaFiles" };
+const int s_slotTypes[] = { SNM_SLOT_FXC, SNM_SLOT_TR, SNM_SLOT_MEDIA };
+
+// slot lists of S&M.ini as the Resources window writes them
+bool WriteSlotLists(int nbSlots)
+{
+	FILE* f = fopen(g_SNM_IniFn.Get(), "w");
+	if (!f)
+		return false;
+	for (int i = 0; i < 3; i++)
+	{
+		fprintf(f, "[%s]\nMax_slot=%d\n", s_slotSections[i], nbSlots);
+		for (int j = 1; j <= nbSlots; j++)
+			fprintf(f, "Slot%d=\"%s/slot%d.file\"\nDesc%d=\"Slot %d\"\n", j, s_slotSections[i], j, j, j);
+	}
+	return !fclose(f);
+}
+
+} // namespace
+
+// S&M Resources startup with large slot lists: ResourcesInit() with lazy init
+// off (slots loaded right away), then the slot loading on its own
+HARNESS_BENCH(resources_init)
+{
+	const int nbSlots = ctx.Size(2000, 50);
+	HARNESS_CHECK(r, WriteSlotLists(nbSlots));
+
+	HarnessTimer t;
+	HARNESS_CHECK(r, ResourcesInit());
+	r.Metric("init_ms", t.Ms());
+
+	char expected[64];
+	snprintf(expected, sizeof(expected), "TrackTemplates/slot%d.file", nbSlots);
+	for (int i = 0; i < 3; i++)
+		HARNESS_CHECK(r, g_SNM_ResSlots.Get(s_slotTypes[i])->IsLoaded() && g_SNM_ResSlots.Get(s_slotTypes[i])->GetSize() == nbSlots);
+	HARNESS_CHECK(r, !strcmp(g_SNM_ResSlots.Get(SNM_SLOT_TR)->Get(nbSlots - 1)->m_shortPath.Get(), expected));
+
+	// what lazy init defers: lists are read again on first access
+	for (int i = 0; i < g_SNM_ResSlots.GetSize(); i++)
+		g_SNM_ResSlots.Get(i)->DeferLoad();
+	HARNESS_CHECK(r, !g_SNM_ResSlots.Get(SNM_SLOT_FXC)->IsLoaded());
+	t.Reset();
+	int nbLoaded = 0;
+	for (int i = 0; i < g_SNM_ResSlots.GetSize(); i++)
+		nbLoaded += g_SNM_ResSlots.Get(i)->GetSize();
+	r.Metric("slot_load_ms", t.Ms());
+	r.Metric("slots", nbLoaded);
+	HARNESS_CHECK(r, nbLoaded == 3 * nbSlots);
+	HARNESS_CHECK(r, !strcmp(g_SNM_ResSlots.Get(SNM_SLOT_TR)->Get(nbSlots - 1)->m_shortPath.Get(), expected));
+
+	// on exit loaded lists are written back, lists never used are left as-is
+	g_SNM_ResSlots.Get(SNM_SLOT_FXC)->Get(0)->m_shortPath.Set("changed.RfxChain");
+	g_SNM_ResSlots.Get(SNM_SLOT_TR)->DeferLoad();
+	ResourcesExit();
+	Stub_FlushIniFiles();
+	char buf[SNM_MAX_PATH] = "";
+	GetPrivateProfileString("FXChains", "Slot1", "", buf, sizeof(buf), g_SNM_IniFn.Get());
+	HARNESS_CHECK(r, !strcmp(buf, "changed.RfxChain"));
+	GetPrivateProfileString("TrackTemplates", "Desc2", "", buf, sizeof(buf), g_SNM_IniFn.Get());
+	HARNESS_CHECK(r, !strcmp(buf, "Slot 2"));
+	HARNESS_CHECK(r, GetPrivateProfileInt("TrackTemplates", "Max_slot", 0, g_SNM_IniFn.Get()) == nbSlots);
+}
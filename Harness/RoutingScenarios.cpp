@@ -0,0 +1,98 @@
+/******************************************************************************
+/ RoutingScenarios.cpp
+/
+/ Copyright (c) 2026 SWS
+/
+/
+/ Permission is hereby granted, free of charge, to any person obtaining a copy
+/ of this software and associated documentation files (the "Software"), to deal
+/ in the Software without restriction, including without limitation the rights to
+/ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/ of the Software, and to permit persons to whom the Software is furnished to
+/ do so, subject to the following conditions:
+/
+/ The above copyright notice and this permission notice shall be included in all
+/ copies or substantial portions of the Software.
+/
+/ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+/ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+/ OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+/ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+/ HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+/ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+/ OTHER DEALINGS IN THE SOFTWARE.
+/
+******************************************************************************/
+
+#include "stdafx.h"
+#include "Harness.h"
+#include "ReaperStub.h"
+#include "../SnM/SnM.h"
+#include "../SnM/SnM_Chunk.h"
+#include "../SnM/SnM_Routing.h"
+
+// N sources x M cue busses (monitor mixes): pre-fader receives added with
+// one SNM_SendPatcher per bus (chunk edits) vs. one SNM_RoutingBatch
+HARNESS_BENCH(routing_matrix)
+{
+	const int nbSrcs = ctx.Size(300, 12), nbBusses = ctx.Size(64, 4);
+	StubProject* proj = Stub_GetProject();
+	for (int i = 0; i < nbSrcs + 2 * nbBusses; i++)
+		Stub_AddTrack(proj);
+	std::vector<MediaTrack*> tracks(nbSrcs + 2 * nbBusses);
+	for (int i = 0; i < nbSrcs + 2 * nbBusses; i++)
+		tracks[i] = CSurf_TrackFromID(i + 1, false);
+	MediaTrack** patcherBusses = &tracks[nbSrcs];
+	MediaTrack** batchBusses = patcherBusses + nbBusses;
+
+	int nbSets = Stub_GetObjectStateCalls(true);
+	HarnessTimer t;
+	for (int j = 0; j < nbBusses; j++)
+	{
+		SNM_SendPatcher p(patcherBusses[j]);
+		for (int i = 0; i < nbSrcs; i++)
+			p.AddReceive(tracks[i], 3, "0.5", "0.25");
+	}
+	r.Metric("patcher_ms", t.Ms());
+	r.Metric("patcher_chunk_sets", Stub_GetObjectStateCalls(true) - nbSets);
+
+	nbSets = Stub_GetObjectStateCalls(true);
+	t.Reset();
+	{
+		SNM_RoutingBatch batch;
+		for (int j = 0; j < nbBusses; j++)
+			for (int i = 0; i < nbSrcs; i++)
+				batch.AddReceive(tracks[i], batchBusses[j], 3, 0.5, 0.25);
+		HARNESS_CHECK(r, batch.Commit());
+	}
+	r.Metric("batch_ms", t.Ms());
+	r.Metric("batch_chunk_sets", Stub_GetObjectStateCalls(true) - nbSets);
+
+	// both busses of a pair end up with the same receives
+	int nbDiffs = 0;
+	static const char* const s_parms[] = { "P_SRCTRACK", "D_VOL", "D_PAN", "I_SENDMODE", "I_SRCCHAN", "I_DSTCHAN", "I_MIDIFLAGS", "B_MUTE" };
+	for (int j = 0; j < nbBusses; j++)
+	{
+		HARNESS_CHECK(r, GetTrackNumSends(patcherBusses[j], -1) == nbSrcs && GetTrackNumSends(batchBusses[j], -1) == nbSrcs);
+		for (int i = 0; i < nbSrcs; i++)
+			for (size_t k = 0; k < sizeof(s_parms) / sizeof(s_parms[0]); k++)
+				nbDiffs += GetTrackSendInfo_Value(patcherBusses[j], -1, i, s_parms[k]) != GetTrackSendInfo_Value(batchBusses[j], -1, i, s_parms[k]) ? 1 : 0;
+		HARNESS_CHECK(r, GetTrackSendInfo_Value(batchBusses[j], -1, nbSrcs - 1, "D_VOL") == 0.5);
+		HARNESS_CHECK(r, (MediaTrack*)GetSetTrackSendInfo(batchBusses[j], -1, nbSrcs - 1, "P_SRCTRACK", NULL) == tracks[nbSrcs - 1]);
+	}
+	HARNESS_CHECK(r, nbDiffs == 0);
+	HARNESS_CHECK(r, GetTrackNumSends(tracks[0], 0) == 2 * nbBusses);
+
+	// tear the batch busses down again
+	t.Reset();
+	{
+		SNM_RoutingBatch batch;
+		for (int j = 0; j < nbBusses; j++)
+			batch.RemoveReceives(batchBusses[j]);
+	}
+	r.Metric("batch_remove_ms", t.Ms());
+	HARNESS_CHECK(r, GetTrackNumSends(batchBusses[0], -1) == 0 && GetTrackNumSends(tracks[0], 0) == nbBusses);
+
+	r.Metric("receives", nbSrcs * nbBusses);
+}
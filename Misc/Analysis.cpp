@@ -29,240 +29,567 @@
 
 #include "Analysis.h"
 #include "../sws_waitdlg.h"
+#include "../Utility/SampleArena.h"
 
 #include <WDL/localize/localize.h>
 
 static void GetRMSOptions(double *target, double *windowSize);
 
-static bool AnalyzePCMSource(ANALYZE_PCM* a)
+#define ANALYZE_BLOCK   16384 // samples per GetSamples() call in non-windowed mode
+#define ANALYZE_WORKERS 4
+
+// Full analysis of a source, all channels. Copied into the caller's ANALYZE_PCM
+typedef struct ANALYZE_RESULT
+{
+	WDL_TypedBuf<double> peakVals;
+	WDL_TypedBuf<double> RMSs;
+	WDL_TypedBuf<INT64> peakSamples;
+	WDL_TypedBuf<INT64> peakRMSsamples;
+	double dPeakVal;
+	double dRMS;
+	INT64 peakSample;
+	INT64 peakRMSsample;
+	INT64 sampleCount;
+} ANALYZE_RESULT;
+
+typedef struct ANALYZE_JOB
+{
+	MediaItem* item;
+	PCM_source* pcm;      // zero-based duplicate of the item, owned
+	double dWindowSize;   // effective window (0.0 if larger than the item)
+	ANALYZE_RESULT result;
+	bool success;
+} ANALYZE_JOB;
+
+///////////////////////////////////////////////////////////////////////////////
+// Worker pool shared by the batch analyses (peak/RMS and transients): jobs are
+// taken in order by up to ANALYZE_WORKERS threads, each with its own sample
+// arena, while the calling thread shows a single wait dialog
+///////////////////////////////////////////////////////////////////////////////
+
+struct ANALYZE_POOL;
+typedef void (*ANALYZE_POOL_RUN)(ANALYZE_POOL* pool, int iJob, SWS_SampleArena* arena);
+
+typedef struct ANALYZE_POOL
+{
+	ANALYZE_POOL_RUN run;
+	void* ctx;            // batch data, for run()
+	int nJobs;
+	SWS_Mutex mutex;
+	int iNextJob;
+	int iRunning;
+	INT64 totalSamples;   // set by the caller, see AddAnalyzeProgress()
+	INT64 doneSamples;
+	double dProgress;
+} ANALYZE_POOL;
+
+// pool: optional, progress of the wait dialog
+static void AddAnalyzeProgress(ANALYZE_POOL* pool, int samples)
+{
+	if (!pool)
+		return;
+	SWS_SectionLock lock(&pool->mutex);
+	pool->doneSamples += samples;
+	if (pool->totalSamples > 0)
+		pool->dProgress = min(0.99, (double)pool->doneSamples / pool->totalSamples);
+}
+
+static unsigned WINAPI AnalyzePoolThread(void* pPool)
+{
+	ANALYZE_POOL* pool = static_cast<ANALYZE_POOL*>(pPool);
+	SWS_SampleArena arena;
+	for (;;)
+	{
+		int iJob = -1;
+		{
+			SWS_SectionLock lock(&pool->mutex);
+			if (pool->iNextJob < pool->nJobs)
+				iJob = pool->iNextJob++;
+		}
+		if (iJob < 0)
+			break;
+		pool->run(pool, iJob, &arena);
+	}
+
+	SWS_SectionLock lock(&pool->mutex);
+	if (!--pool->iRunning)
+		pool->dProgress = 1.0; // closes the wait dialog
+	return 0;
+}
+
+// runs all the jobs of the pool (run, ctx, nJobs and totalSamples are set by the caller)
+static void RunAnalyzePool(ANALYZE_POOL* pool, const char* title)
+{
+	pool->iNextJob = 0;
+	pool->doneSamples = 0;
+	pool->dProgress = 0.0;
+	if (pool->nJobs <= 0)
+		return;
+
+	pool->iRunning = min(ANALYZE_WORKERS, pool->nJobs);
+	HANDLE hThreads[ANALYZE_WORKERS];
+	const int nThreads = pool->iRunning;
+	for (int i = 0; i < nThreads; i++)
+	{
+		hThreads[i] = (HANDLE)_beginthreadex(NULL, 0, AnalyzePoolThread, pool, 0, NULL);
+		if (!hThreads[i])
+			AnalyzePoolThread(pool); // couldn't start a worker, process its share here
+	}
+
+	if (pool->dProgress < 1.0)
+	{
+		SWS_WaitDlg wait(title, &pool->dProgress);
+	}
+
+	for (int i = 0; i < nThreads; i++)
+	{
+		if (hThreads[i])
+		{
+			WaitForSingleObject(hThreads[i], INFINITE);
+			CloseHandle(hThreads[i]);
+		}
+	}
+}
+
+// returns a zero-based duplicate of the item's audio source, or NULL (MIDI, empty item, etc)
+static PCM_source* DuplicateItemSource(MediaItem* item)
+{
+	PCM_source* pcm = (PCM_source*)item;
+	if (!pcm || !GetActiveTake(item) || strcmp(pcm->GetType(), "MIDI") == 0 || strcmp(pcm->GetType(), "MIDIPOOL") == 0)
+		return NULL;
+
+	pcm = pcm->Duplicate();
+	if (pcm && !pcm->GetNumChannels())
+	{
+		delete pcm;
+		return NULL;
+	}
+	if (pcm)
+	{
+		double dZero = 0.0;
+		GetSetMediaItemInfo((MediaItem*)pcm, "D_POSITION", &dZero);
+	}
+	return pcm;
+}
+
+// peak of x[0], x[stride], ... x[(n-1)*stride] and its index (first one), sum of squares is added to *sumSquares
+// independent accumulators let the compiler keep them in SIMD lanes
+static double ChannelPeakAndSumSquares(const ReaSample* x, int n, int stride, int* peakIdx, double* sumSquares)
+{
+	double p0 = 0.0, p1 = 0.0, p2 = 0.0, p3 = 0.0;
+	double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+	int i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		const double a0 = x[i*stride], a1 = x[(i+1)*stride], a2 = x[(i+2)*stride], a3 = x[(i+3)*stride];
+		s0 += a0 * a0; s1 += a1 * a1; s2 += a2 * a2; s3 += a3 * a3;
+		p0 = max(p0, fabs(a0)); p1 = max(p1, fabs(a1)); p2 = max(p2, fabs(a2)); p3 = max(p3, fabs(a3));
+	}
+	for (; i < n; i++)
+	{
+		const double a = x[i*stride];
+		s0 += a * a;
+		p0 = max(p0, fabs(a));
+	}
+	*sumSquares += (s0 + s1) + (s2 + s3);
+
+	// position of the peak: second pass only when it is needed
+	const double peak = max(max(p0, p1), max(p2, p3));
+	*peakIdx = 0;
+	if (peak > 0.0)
+		for (i = 0; i < n; i++)
+			if (fabs(x[i*stride]) == peak)
+			{
+				*peakIdx = i;
+				break;
+			}
+	return peak;
+}
+
+// windowed RMS uses a running sum of squares: the window sum is compared (no sqrt per sample)
+// arena: sample buffers, reused across the items analyzed by a thread
+// progress: optional, incremented by the number of analyzed samples
+static bool AnalyzePCMSource(PCM_source* pcm, double dWindowSize, ANALYZE_RESULT* r, SWS_SampleArena* arena, ANALYZE_POOL* progress)
 {
 	// Init local transfer block "t" and sum of squares
 	PCM_source_transfer_t t={0,};
-	t.samplerate = a->pcm->GetSampleRate();
-	t.nch = a->pcm->GetNumChannels();
-	t.length = a->dWindowSize == 0.0 ? 16384 : (int)(a->dWindowSize * t.samplerate);
-	t.samples = new (nothrow) ReaSample[t.length * t.nch];
+	t.samplerate = pcm->GetSampleRate();
+	t.nch = pcm->GetNumChannels();
+	t.length = dWindowSize == 0.0 ? ANALYZE_BLOCK : (int)(dWindowSize * t.samplerate);
+	if (t.nch <= 0 || t.length <= 0)
+		return false;
 
+	SWS_SampleBuf samplesBuf(arena, t.length * t.nch);
+	SWS_SampleBuf prevBufBuf(arena, dWindowSize != 0.0 ? t.length * t.nch : 0);
+	t.samples = samplesBuf.Get();
 	if(!t.samples)
 		return false;
 
 	ReaSample* prevBuf = NULL;
-	INT64 tempPeakRMSsample = 0;
-	if (a->dWindowSize != 0.0)
+	if (dWindowSize != 0.0)
 	{
-		if((prevBuf = new (nothrow) ReaSample[t.length * t.nch]))
+		if((prevBuf = prevBufBuf.Get()))
 			memset(prevBuf, 0, t.length * t.nch * sizeof(*prevBuf));
 		else
 			return false;
 	}
 
-	double* dSumSquares = new double[t.nch];
+	WDL_TypedBuf<double> sumSquares, totalSquares, maxWindowSquares;
+	memset(sumSquares.ResizeOK(t.nch, false), 0, t.nch * sizeof(double));
+	memset(totalSquares.ResizeOK(t.nch, false), 0, t.nch * sizeof(double));
+	memset(maxWindowSquares.ResizeOK(t.nch, false), 0, t.nch * sizeof(double));
+	memset(r->peakVals.ResizeOK(t.nch, false), 0, t.nch * sizeof(double));
+	memset(r->RMSs.ResizeOK(t.nch, false), 0, t.nch * sizeof(double));
+	memset(r->peakSamples.ResizeOK(t.nch, false), 0, t.nch * sizeof(INT64));
+	r->peakRMSsamples.Resize(t.nch, false);
 	for (int i = 0; i < t.nch; i++)
-		dSumSquares[i] = 0.0;
-
-	// Init output variables.  Note can have different channel count.
-	for (int i = 0; i < a->iChannels; i++)
-	{
-		if (a->dPeakVals) a->dPeakVals[i] = 0.0;
-		if (a->dRMSs) a->dRMSs[i] = 0.0;
-		if (a->peakSamples) a->peakSamples[i] = 0;
-		if (a->peakRMSsamples) a->peakRMSsamples[i] = -666;
-	}
-	a->dPeakVal = 0.0;
-	a->dRMS = 0.0;
-	a->peakRMSsample = -666;
-	a->peakSample = 0;
-	a->dProgress = 0.0;
-	a->sampleCount = 0;
+		r->peakRMSsamples.Get()[i] = -666;
+	r->dPeakVal = 0.0;
+	r->dRMS = 0.0;
+	r->peakSample = 0;
+	r->peakRMSsample = -666;
+	r->sampleCount = 0;
 
-	INT64 totalSamples = (INT64)(a->pcm->GetLength() * t.samplerate);
+	double maxWindowSquaresAll = 0.0;
+	INT64 tempPeakRMSsample = 0;
 	int iFrame = 0;
 
-	a->pcm->GetSamples(&t);
+	pcm->GetSamples(&t);
 	while (t.samples_out)
 	{
-		for (int samp = 0; samp < t.samples_out; samp++)
+		const int n = t.samples_out;
+		for (int chan = 0; chan < t.nch; chan++)
 		{
-			for (int chan = 0; chan < t.nch; chan++)
+			int peakIdx;
+			const double peak = ChannelPeakAndSumSquares(t.samples + chan, n, t.nch, &peakIdx, &totalSquares.Get()[chan]);
+			if (peak > r->peakVals.Get()[chan])
 			{
-				int i = samp*t.nch + chan;
-				dSumSquares[chan] += t.samples[i] * t.samples[i];
-				double absamp = fabs(t.samples[i]);
-				if (absamp > a->dPeakVal)
-				{
-					a->dPeakVal = absamp;
-					a->peakSample = a->sampleCount;
-				}
+				r->peakVals.Get()[chan] = peak;
+				r->peakSamples.Get()[chan] = r->sampleCount + peakIdx;
+			}
 
-				if (a->dPeakVals && chan < a->iChannels && absamp > a->dPeakVals[chan])
-				{
-					a->dPeakVals[chan] = absamp;
-					if (a->peakSamples)
-						a->peakSamples[chan] = a->sampleCount;
-				}
-				if (a->dWindowSize != 0.0)
+			if (dWindowSize != 0.0)
+			{
+				double sum = sumSquares.Get()[chan];
+				double maxSum = maxWindowSquares.Get()[chan];
+				INT64 maxPos = r->peakRMSsamples.Get()[chan];
+				const ReaSample* x = t.samples + chan;
+				const ReaSample* old = prevBuf + chan;
+				for (int samp = 0, i = 0; samp < n; samp++, i += t.nch)
 				{
-					dSumSquares[chan] -= prevBuf[i] * prevBuf[i];
-					if (dSumSquares[chan] < 0.0) // Unlikely but possible with rounding errors
-						dSumSquares[chan] = 0.0;
-					double curRMS = sqrt(dSumSquares[chan] / t.length);
-					if (curRMS > a->dRMS) // Overall
-					{ 
-						a->dRMS = curRMS;
-						tempPeakRMSsample = a->sampleCount;
-					}
-					if (a->dRMSs && curRMS > a->dRMSs[chan]) // Single channel, if enabled
-					{ 
-						a->dRMSs[chan] = curRMS;
-						if (a->peakRMSsamples)
-							a->peakRMSsamples[chan] = a->sampleCount;
+					sum += x[i] * x[i] - old[i] * old[i];
+					if (sum < 0.0) // Unlikely but possible with rounding errors
+						sum = 0.0;
+					if (sum > maxSum)
+					{
+						maxSum = sum;
+						maxPos = r->sampleCount + samp;
 					}
-						
 				}
+				sumSquares.Get()[chan] = sum;
+				maxWindowSquares.Get()[chan] = maxSum;
+				r->peakRMSsamples.Get()[chan] = maxPos;
+			}
+		}
+
+		// overall peak: first channel reaching the highest peak at the earliest position
+		for (int chan = 0; chan < t.nch; chan++)
+		{
+			const double peak = r->peakVals.Get()[chan];
+			const INT64 pos = r->peakSamples.Get()[chan];
+			if (peak > r->dPeakVal || (peak == r->dPeakVal && peak > 0.0 && pos < r->peakSample))
+			{
+				r->dPeakVal = peak;
+				r->peakSample = pos;
 			}
-			a->sampleCount++;
 		}
-		if (a->dWindowSize != 0.0)
+
+		r->sampleCount += n;
+		if (dWindowSize != 0.0)
 		{	// Swap buffers in windowed mode for history
 			ReaSample* temp = t.samples;
 			t.samples = prevBuf;
 			prevBuf = temp;
 		}
 
-		a->dProgress = (double)a->sampleCount / totalSamples;
+		AddAnalyzeProgress(progress, n);
 
 		iFrame++;
 		t.time_s = (double)t.length * iFrame / t.samplerate;
 		// Get next block
 		t.samples_out = 0;
-		a->pcm->GetSamples(&t);
+		pcm->GetSamples(&t);
 	}
 
-	if (a->dWindowSize == 0.0)
+	if (dWindowSize == 0.0)
 	{
 		// Non-windowed mode.  Calculate the RMS for the entire item
 		// First per channel
-		if (a->dRMSs && a->sampleCount)
-			for (int i = 0; i < a->iChannels && i < t.nch; i++)
-				a->dRMSs[i] = sqrt(dSumSquares[i] / a->sampleCount);
-
-		// Then for all channels combined
 		double dSS = 0.0;
 		for (int i = 0; i < t.nch; i++)
-			dSS += dSumSquares[i];
-		a->dRMS = sqrt(dSS / (a->sampleCount * t.nch));
+		{
+			if (r->sampleCount)
+				r->RMSs.Get()[i] = sqrt(totalSquares.Get()[i] / r->sampleCount);
+			dSS += totalSquares.Get()[i];
+		}
+		// Then for all channels combined
+		r->dRMS = r->sampleCount ? sqrt(dSS / (r->sampleCount * t.nch)) : 0.0;
 	}
-	else // calculate pos. of peak RMS samples
-	{	
-		a->peakRMSsample = tempPeakRMSsample - t.length;
-
-		if (a->peakRMSsamples) {
-			for (int chan = 0; chan < t.nch; chan++) {
-				a->peakRMSsamples[chan] -= t.length;
+	else // max window RMS and pos. of peak RMS samples
+	{
+		for (int chan = 0; chan < t.nch; chan++)
+		{
+			const double maxSum = maxWindowSquares.Get()[chan];
+			r->RMSs.Get()[chan] = sqrt(maxSum / t.length);
+			if (maxSum > maxWindowSquaresAll || (maxSum == maxWindowSquaresAll && maxSum > 0.0 && r->peakRMSsamples.Get()[chan] < tempPeakRMSsample))
+			{
+				maxWindowSquaresAll = maxSum;
+				tempPeakRMSsample = r->peakRMSsamples.Get()[chan];
 			}
+			if (r->peakRMSsamples.Get()[chan] != -666)
+				r->peakRMSsamples.Get()[chan] -= t.length;
 		}
-
+		r->dRMS = sqrt(maxWindowSquaresAll / t.length);
+		r->peakRMSsample = tempPeakRMSsample - t.length;
 	}
-
-	delete[] t.samples;
-	delete[] prevBuf;
-	delete[] dSumSquares;
-
 	return true;
 }
 
-unsigned int WINAPI AnalyzePCMThread(void* pAnalyze)
+// pool->ctx: WDL_PtrList<ANALYZE_JOB>
+static void AnalyzeJob(ANALYZE_POOL* pool, int iJob, SWS_SampleArena* arena)
 {
-	ANALYZE_PCM *a = static_cast<ANALYZE_PCM *>(pAnalyze);
-	a->success = AnalyzePCMSource(a);
-	a->dProgress = 1.0; // closes the wait dialog
-	return 0;
+	ANALYZE_JOB* job = static_cast<WDL_PtrList<ANALYZE_JOB>*>(pool->ctx)->Get(iJob);
+	job->success = AnalyzePCMSource(job->pcm, job->dWindowSize, &job->result, arena, pool);
 }
 
-// return true for successful analysis
-// wraps AnalyzePCM to check item validity and create a wait dialog
-bool AnalyzeItem(MediaItem* item, ANALYZE_PCM* a)
+///////////////////////////////////////////////////////////////////////////////
+// Analysis cache of the interactive actions: results are reused until the
+// project changes (and as long as the item's take, source, range, volumes and
+// fades are the same). Not used by the ReaScript API: scripts can change what
+// the analysis depends on without a new project state.
+///////////////////////////////////////////////////////////////////////////////
+
+#define ANALYZE_FINGERPRINT 11
+
+typedef struct ANALYZE_CACHED
 {
-	a->dProgress = 0.0;
-	a->pcm = (PCM_source*)item;
+	double fingerprint[ANALYZE_FINGERPRINT];
+	ANALYZE_RESULT result;
+} ANALYZE_CACHED;
 
-	if (!a->pcm || strcmp(a->pcm->GetType(), "MIDI") == 0 || strcmp(a->pcm->GetType(), "MIDIPOOL") == 0)
-		return false;
+static std::map<std::pair<MediaItem*, double>, ANALYZE_CACHED> g_analyzeCache; // key: item, effective window size
+static int g_analyzeCacheState = -1;
 
-	a->pcm = a->pcm->Duplicate();
-	if (!a->pcm || !a->pcm->GetNumChannels())
-		return false;
+static void GetAnalyzeFingerprint(MediaItem* item, double* fp)
+{
+	MediaItem_Take* take = GetActiveTake(item);
+	fp[0] = (double)(INT_PTR)take;
+	fp[1] = (double)(INT_PTR)(take ? GetMediaItemTake_Source(take) : NULL);
+	fp[2] = take ? GetMediaItemTakeInfo_Value(take, "D_STARTOFFS") : 0.0;
+	fp[3] = take ? GetMediaItemTakeInfo_Value(take, "D_PLAYRATE") : 0.0;
+	fp[4] = take ? GetMediaItemTakeInfo_Value(take, "D_VOL") : 0.0;
+	fp[5] = take ? GetMediaItemTakeInfo_Value(take, "D_PAN") : 0.0;
+	fp[6] = take ? (double)TakeFX_GetCount(take) : 0.0;
+	fp[7] = GetMediaItemInfo_Value(item, "D_LENGTH");
+	fp[8] = GetMediaItemInfo_Value(item, "D_VOL");
+	fp[9] = GetMediaItemInfo_Value(item, "D_FADEINLEN") + GetMediaItemInfo_Value(item, "D_FADEINLEN_AUTO");
+	fp[10] = GetMediaItemInfo_Value(item, "D_FADEOUTLEN") + GetMediaItemInfo_Value(item, "D_FADEOUTLEN_AUTO");
+}
+
+static const ANALYZE_RESULT* GetCachedAnalysis(MediaItem* item, double dWindowSize, const double* fp)
+{
+	const int state = GetProjectStateChangeCount(NULL);
+	if (state != g_analyzeCacheState)
+	{
+		g_analyzeCache.clear();
+		g_analyzeCacheState = state;
+		return NULL;
+	}
+
+	std::map<std::pair<MediaItem*, double>, ANALYZE_CACHED>::const_iterator it = g_analyzeCache.find(std::make_pair(item, dWindowSize));
+	if (it == g_analyzeCache.end() || memcmp(it->second.fingerprint, fp, sizeof(it->second.fingerprint)))
+		return NULL;
+	return &it->second.result;
+}
+
+static void CopyAnalysis(const ANALYZE_RESULT* r, ANALYZE_PCM* a)
+{
+	for (int i = 0; i < a->iChannels; i++)
+	{
+		const bool inSource = i < r->peakVals.GetSize();
+		if (a->dPeakVals) a->dPeakVals[i] = inSource ? r->peakVals.Get()[i] : 0.0;
+		if (a->dRMSs) a->dRMSs[i] = inSource ? r->RMSs.Get()[i] : 0.0;
+		if (a->peakSamples) a->peakSamples[i] = inSource ? r->peakSamples.Get()[i] : 0;
+		if (a->peakRMSsamples) a->peakRMSsamples[i] = inSource ? r->peakRMSsamples.Get()[i] : -666;
+	}
+	a->dPeakVal = r->dPeakVal;
+	a->dRMS = r->dRMS;
+	a->peakSample = r->peakSample;
+	a->peakRMSsample = r->peakRMSsample;
+	a->sampleCount = r->sampleCount;
+}
 
-	double dZero = 0.0;
-	GetSetMediaItemInfo((MediaItem*)a->pcm, "D_POSITION", &dZero);
+// analyzes items on worker threads with a single wait dialog, a[i] is for items[i]
+// (inputs: dWindowSize, iChannels and the optional arrays, like AnalyzeItem)
+// useCache: reuse/store results in the analysis cache (interactive actions only)
+// returns the number of successfully analyzed items, see a[i].success
+int AnalyzeItems(MediaItem** items, ANALYZE_PCM* a, int count, bool useCache)
+{
+	WDL_PtrList_DeleteOnDestroy<ANALYZE_JOB> jobs;
+	WDL_PtrList<ANALYZE_JOB> itemJobs; // per item, NULL if cached or not analyzable
+	ANALYZE_POOL pool;
+	pool.run = AnalyzeJob;
+	pool.ctx = &jobs;
+	pool.totalSamples = 0;
 
 	const char* cName = NULL;
-	MediaItem_Take* take = GetMediaItemTake(item, -1);
-	if (take)
-		cName = (const char*)GetSetMediaItemTakeInfo(take, "P_NAME", NULL);
+	for (int i = 0; i < count; i++)
+	{
+		a[i].success = false;
+		a[i].dProgress = 0.0;
+		itemJobs.Add(NULL);
 
-	const double oldWinSize = a->dWindowSize;
-	if (a->dWindowSize > a->pcm->GetLength())
-		a->dWindowSize = 0.0;
+		PCM_source* pcm = DuplicateItemSource(items[i]);
+		if (!pcm)
+			continue;
 
-	HANDLE hThread = (HANDLE)_beginthreadex(NULL, 0, AnalyzePCMThread, a, 0, NULL);
+		// restore original window if it was larger than the item's length
+		const double dWindowSize = a[i].dWindowSize > pcm->GetLength() ? 0.0 : a[i].dWindowSize;
+
+		double fp[ANALYZE_FINGERPRINT];
+		if (useCache)
+			GetAnalyzeFingerprint(items[i], fp);
+		if (const ANALYZE_RESULT* r = useCache ? GetCachedAnalysis(items[i], dWindowSize, fp) : NULL)
+		{
+			CopyAnalysis(r, &a[i]);
+			a[i].success = true;
+			a[i].dProgress = 1.0;
+			delete pcm;
+			continue;
+		}
+
+		// share the job of an identical request in this batch
+		ANALYZE_JOB* job = NULL;
+		for (int j = 0; !job && j < jobs.GetSize(); j++)
+			if (jobs.Get(j)->item == items[i] && jobs.Get(j)->dWindowSize == dWindowSize)
+				job = jobs.Get(j);
+
+		if (job)
+			delete pcm;
+		else
+		{
+			job = jobs.Add(new ANALYZE_JOB);
+			job->item = items[i];
+			job->pcm = pcm;
+			job->dWindowSize = dWindowSize;
+			job->success = false;
+			pool.totalSamples += (INT64)(pcm->GetLength() * pcm->GetSampleRate());
+
+			if (!cName)
+				if (MediaItem_Take* take = GetMediaItemTake(items[i], -1))
+					cName = (const char*)GetSetMediaItemTakeInfo(take, "P_NAME", NULL);
+		}
+		itemJobs.Set(i, job);
+	}
 
 	WDL_String title;
-	title.AppendFormatted(100, __LOCALIZE_VERFMT("Please wait, analyzing %s...","sws_analysis"), cName ? cName : __LOCALIZE("item","sws_analysis"));
-	SWS_WaitDlg wait(title.Get(), &a->dProgress);
+	if (jobs.GetSize() == 1)
+		title.AppendFormatted(100, __LOCALIZE_VERFMT("Please wait, analyzing %s...","sws_analysis"), cName ? cName : __LOCALIZE("item","sws_analysis"));
+	else
+		title.Set(__LOCALIZE("Please wait, analyzing items...","sws_analysis"));
+	pool.nJobs = jobs.GetSize();
+	RunAnalyzePool(&pool, title.Get());
 
-	CloseHandle(hThread);
+	int analyzed = 0;
+	for (int i = 0; i < count; i++)
+	{
+		if (ANALYZE_JOB* job = itemJobs.Get(i))
+		{
+			if (job->success)
+			{
+				CopyAnalysis(&job->result, &a[i]);
+				a[i].success = true;
+			}
+			a[i].dProgress = 1.0;
+		}
+		if (a[i].success)
+			analyzed++;
+	}
 
-	// restore original window if it was larger than the item's length
-	a->dWindowSize = oldWinSize;
+	for (int i = 0; i < jobs.GetSize(); i++)
+	{
+		ANALYZE_JOB* job = jobs.Get(i);
+		delete job->pcm;
+		job->pcm = NULL;
+		if (useCache && job->success)
+		{
+			ANALYZE_CACHED& cached = g_analyzeCache[std::make_pair(job->item, job->dWindowSize)];
+			GetAnalyzeFingerprint(job->item, cached.fingerprint);
+			cached.result = job->result;
+		}
+	}
+	return analyzed;
+}
 
-	delete a->pcm;
-	return a->success;
+// return true for successful analysis
+bool AnalyzeItem(MediaItem* item, ANALYZE_PCM* a)
+{
+	return AnalyzeItems(&item, a, 1) == 1;
 }
 
 void DoAnalyzeItem(COMMAND_T*)
 {
 	WDL_TypedBuf<MediaItem*> items;
 	SWS_GetSelectedMediaItems(&items);
-	bool bDidWork = false;
+
+	// Analyze all items at once, then display the results
+	WDL_TypedBuf<MediaItem*> audioItems;
+	WDL_TypedBuf<ANALYZE_PCM> a;
 	for (int i = 0; i < items.GetSize(); i++)
 	{
 		MediaItem* item = items.Get()[i];
 		int iChannels = ((PCM_source*)item)->GetNumChannels();
 		if (iChannels)
 		{
-			bDidWork = true;
-			ANALYZE_PCM a;
-			memset(&a, 0, sizeof(a));
-			a.iChannels = iChannels;
-			a.dPeakVals = new double[iChannels];
-			a.dRMSs     = new double[iChannels];
-
-			if (AnalyzeItem(item, &a))
-			{
-				WDL_String str;
-				str.Set(__LOCALIZE("Peak level:","sws_analysis"));
-				for (int i = 0; i < iChannels; i++) {
-					str.Append(" ");
-					str.AppendFormatted(50, __LOCALIZE_VERFMT("Channel %d = %.2f dB","sws_analysis"), i+1, VAL2DB(a.dPeakVals[i]));
-				}
-				str.Append("\n");
-				str.Append(__LOCALIZE("RMS level:","sws_analysis"));
-				for (int i = 0; i < iChannels; i++) {
-					str.Append(" ");
-					str.AppendFormatted(50, __LOCALIZE_VERFMT("Channel %d = %.2f dB","sws_analysis"), i+1, VAL2DB(a.dRMSs[i]));
-				}
-				MessageBox(g_hwndParent, str.Get(), __LOCALIZE("Item analysis","sws_analysis"), MB_OK);
-			}
-			delete [] a.dPeakVals;
-			delete [] a.dRMSs;
+			ANALYZE_PCM pA;
+			memset(&pA, 0, sizeof(pA));
+			pA.iChannels = iChannels;
+			pA.dPeakVals = new double[iChannels];
+			pA.dRMSs     = new double[iChannels];
+			a.Add(pA);
+			audioItems.Add(item);
 		}
 	}
-	if (!bDidWork)
+	if (!audioItems.GetSize())
 	{
 		MessageBox(NULL, __LOCALIZE("No items selected to analyze.","sws_analysis"), __LOCALIZE("SWS - Error","sws_analysis"), MB_OK);
 		return;
 	}
+
+	AnalyzeItems(audioItems.Get(), a.Get(), audioItems.GetSize(), true);
+
+	for (int i = 0; i < a.GetSize(); i++)
+	{
+		ANALYZE_PCM* pA = a.Get() + i;
+		if (pA->success)
+		{
+			WDL_String str;
+			str.Set(__LOCALIZE("Peak level:","sws_analysis"));
+			for (int j = 0; j < pA->iChannels; j++) {
+				str.Append(" ");
+				str.AppendFormatted(50, __LOCALIZE_VERFMT("Channel %d = %.2f dB","sws_analysis"), j+1, VAL2DB(pA->dPeakVals[j]));
+			}
+			str.Append("\n");
+			str.Append(__LOCALIZE("RMS level:","sws_analysis"));
+			for (int j = 0; j < pA->iChannels; j++) {
+				str.Append(" ");
+				str.AppendFormatted(50, __LOCALIZE_VERFMT("Channel %d = %.2f dB","sws_analysis"), j+1, VAL2DB(pA->dRMSs[j]));
+			}
+			MessageBox(g_hwndParent, str.Get(), __LOCALIZE("Item analysis","sws_analysis"), MB_OK);
+		}
+		delete [] pA->dPeakVals;
+		delete [] pA->dRMSs;
+	}
 }
 
 void FindItemPeak(COMMAND_T*)
@@ -295,18 +622,19 @@ void OrganizeByVol(COMMAND_T* ct)
 		{
 			double dStart = *(double*)GetSetMediaItemInfo(items.Get()[0], "D_POSITION", NULL);
 			double* pVol = new double[items.GetSize()];
-			ANALYZE_PCM a;
-			memset(&a, 0, sizeof(a));
+			double dWindowSize = 0.0;
 			if (ct->user == 2)
 			{	// Windowed mode, set the window size
-				GetRMSOptions(NULL, &a.dWindowSize);
+				GetRMSOptions(NULL, &dWindowSize);
 			}
+			ANALYZE_PCM* a = new ANALYZE_PCM[items.GetSize()];
+			memset(a, 0, items.GetSize() * sizeof(*a));
 			for (int i = 0; i < items.GetSize(); i++)
-			{
-				pVol[i] = -1.0;
-				if (AnalyzeItem(items.Get()[i], &a))
-					pVol[i] = ct->user ? a.dRMS : a.dPeakVal;
-			}
+				a[i].dWindowSize = dWindowSize;
+			AnalyzeItems(items.Get(), a, items.GetSize(), true);
+			for (int i = 0; i < items.GetSize(); i++)
+				pVol[i] = a[i].success ? (ct->user ? a[i].dRMS : a[i].dPeakVal) : -1.0;
+			delete [] a;
 			// Sort and arrange items from min to max RMS
 			while (true)
 			{
@@ -336,19 +664,21 @@ void RMSNormalize(double dTargetDb, double dWindowSize)
 	WDL_TypedBuf<MediaItem*> items;
 	SWS_GetSelectedMediaItems(&items);
 	bool bDidWork = false;
-	ANALYZE_PCM a;
-	memset(&a, 0, sizeof(a));
-	a.dWindowSize = dWindowSize;
+	WDL_TypedBuf<ANALYZE_PCM> a;
+	memset(a.ResizeOK(items.GetSize(), false), 0, items.GetSize() * sizeof(ANALYZE_PCM));
+	for (int i = 0; i < items.GetSize(); i++)
+		a.Get()[i].dWindowSize = dWindowSize;
+	AnalyzeItems(items.Get(), a.Get(), items.GetSize(), true);
 
 	for (int i = 0; i < items.GetSize(); i++)
 	{
 		MediaItem* item = items.Get()[i];
 		MediaItem_Take* take = GetMediaItemTake(item, -1);
-		if (take && AnalyzeItem(item, &a) && a.dRMS != 0.0)
+		if (take && a.Get()[i].success && a.Get()[i].dRMS != 0.0)
 		{
 			bDidWork = true;
 			double dVol = *(double*)GetSetMediaItemTakeInfo(take, "D_VOL", NULL);
-			dVol *= DB2VAL(dTargetDb) / a.dRMS;
+			dVol *= DB2VAL(dTargetDb) / a.Get()[i].dRMS;
 			GetSetMediaItemTakeInfo(take, "D_VOL", &dVol);
 		}
 	}
@@ -364,16 +694,18 @@ void RMSNormalizeAll(double dTargetDb, double dWindowSize)
 	WDL_TypedBuf<MediaItem*> items;
 	SWS_GetSelectedMediaItems(&items);
 	double dMaxRMS = -DBL_MAX;
-	ANALYZE_PCM a;
-	memset(&a, 0, sizeof(a));
-	a.dWindowSize = dWindowSize;
+	WDL_TypedBuf<ANALYZE_PCM> a;
+	memset(a.ResizeOK(items.GetSize(), false), 0, items.GetSize() * sizeof(ANALYZE_PCM));
+	for (int i = 0; i < items.GetSize(); i++)
+		a.Get()[i].dWindowSize = dWindowSize;
+	AnalyzeItems(items.Get(), a.Get(), items.GetSize(), true);
 
 	for (int i = 0; i < items.GetSize(); i++)
 	{
-		MediaItem* item = items.Get()[i];
-		MediaItem_Take* take = GetMediaItemTake(item, -1);
-		if (take && AnalyzeItem(item, &a) && a.dRMS != 0.0 && a.dRMS > dMaxRMS)
-			dMaxRMS = a.dRMS;
+		MediaItem_Take* take = GetMediaItemTake(items.Get()[i], -1);
+		const ANALYZE_PCM* pA = a.Get() + i;
+		if (take && pA->success && pA->dRMS != 0.0 && pA->dRMS > dMaxRMS)
+			dMaxRMS = pA->dRMS;
 	}
 
 	if (dMaxRMS > -DBL_MAX)
@@ -436,6 +768,266 @@ static void SetRMSOptions(COMMAND_T*)
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Transient detection
+// Energy/spectral flux onset detection: each hop's log energy of the signal
+// and of its first difference (high frequency emphasis) are compared with the
+// previous hop. Peaks of the positive flux above an adaptive threshold are
+// reported as transients.
+///////////////////////////////////////////////////////////////////////////////
+
+#define TRANSIENT_HOP         256   // samples per analysis hop
+#define TRANSIENT_HOPS_BLOCK  64    // hops read per GetSamples() call
+#define TRANSIENT_AVG_HOPS    16    // flux history length for the adaptive threshold
+#define TRANSIENT_RETRIG      0.03  // minimum time between two transients (s)
+
+typedef struct TRANSIENT_JOB
+{
+	MediaItem* item;
+	PCM_source* pcm;               // zero-based duplicate of the item, owned
+	WDL_TypedBuf<double> positions; // out, relative to item start (s)
+	INT64 sampleCount;
+} TRANSIENT_JOB;
+
+typedef struct TRANSIENT_BATCH
+{
+	WDL_PtrList<TRANSIENT_JOB>* jobs;
+	double dSensitivity;
+	double dThreshold;
+} TRANSIENT_BATCH;
+
+// sums of squares of x[0..n-1] and of its first difference, prev is x[-1]
+// independent accumulators let the compiler keep them in SIMD lanes
+static void HopEnergy(const ReaSample* x, int n, ReaSample prev, double* e, double* d)
+{
+	double e0 = 0.0, e1 = 0.0, e2 = 0.0, e3 = 0.0;
+	double d0 = 0.0, d1 = 0.0, d2 = 0.0, d3 = 0.0;
+	int i = 0;
+	if (n > 0)
+	{
+		const double diff = x[0] - prev;
+		e0 = x[0] * x[0];
+		d0 = diff * diff;
+		i = 1;
+	}
+	for (; i + 4 <= n; i += 4)
+	{
+		const double a0 = x[i], a1 = x[i+1], a2 = x[i+2], a3 = x[i+3];
+		const double f0 = a0 - x[i-1], f1 = a1 - a0, f2 = a2 - a1, f3 = a3 - a2;
+		e0 += a0 * a0; e1 += a1 * a1; e2 += a2 * a2; e3 += a3 * a3;
+		d0 += f0 * f0; d1 += f1 * f1; d2 += f2 * f2; d3 += f3 * f3;
+	}
+	for (; i < n; i++)
+	{
+		const double f = x[i] - x[i-1];
+		e0 += x[i] * x[i];
+		d0 += f * f;
+	}
+	*e = e0 + e1 + e2 + e3;
+	*d = d0 + d1 + d2 + d3;
+}
+
+// sensitivity: 0.0-1.0, the higher the more transients
+// thresholdDb: hops quieter than this are never reported as transients
+// arena: optional, sample buffers reused across the items analyzed by a thread
+// progress: optional, incremented by the number of analyzed samples
+static bool DetectTransientsPCM(PCM_source* pcm, double sensitivity, double thresholdDb, WDL_TypedBuf<double>* positions, SWS_SampleArena* arena = NULL, ANALYZE_POOL* progress = NULL)
+{
+	PCM_source_transfer_t t={0,};
+	t.samplerate = pcm->GetSampleRate();
+	t.nch = pcm->GetNumChannels();
+	t.length = TRANSIENT_HOP * TRANSIENT_HOPS_BLOCK;
+	if (t.samplerate <= 0.0 || t.nch <= 0)
+		return false;
+
+	SWS_SampleArena localArena;
+	if (!arena)
+		arena = &localArena;
+	SWS_SampleBuf samplesBuf(arena, t.length * t.nch);
+	SWS_SampleBuf monoBuf(arena, t.length);
+	t.samples = samplesBuf.Get();
+	ReaSample* mono = monoBuf.Get();
+	if (!t.samples || !mono)
+		return false;
+
+	sensitivity = min(1.0, max(0.0, sensitivity));
+	const double delta = 0.5 + (1.0 - sensitivity) * 6.0; // in natural log units of energy
+	const double factor = 1.0 + (1.0 - sensitivity) * 2.0;
+	const double minLevel = DB2VAL(thresholdDb) * DB2VAL(thresholdDb);
+	const INT64 retrig = (INT64)(TRANSIENT_RETRIG * t.samplerate);
+
+	double history[TRANSIENT_AVG_HOPS];
+	memset(history, 0, sizeof(history));
+	double historySum = 0.0;
+	int historyPos = 0;
+
+	ReaSample prev = 0.0;
+	double prevLogE = log(1e-10), prevLogD = log(1e-10);
+	double candFlux = 0.0, candPrevFlux = 0.0, candThresh = 0.0;
+	bool candLoud = false;
+	INT64 candPos = -1, lastPos = -retrig, hopPos = 0;
+
+	positions->Resize(0, false);
+
+	int iFrame = 0;
+	pcm->GetSamples(&t);
+	while (t.samples_out > 0)
+	{
+		const int n = t.samples_out;
+		if (t.nch == 1)
+			memcpy(mono, t.samples, n * sizeof(ReaSample));
+		else
+		{
+			const double scale = 1.0 / t.nch;
+			for (int s = 0; s < n; s++)
+			{
+				const ReaSample* frame = t.samples + s * t.nch;
+				double sum = 0.0;
+				for (int c = 0; c < t.nch; c++)
+					sum += frame[c];
+				mono[s] = sum * scale;
+			}
+		}
+
+		for (int h = 0; h < n; h += TRANSIENT_HOP)
+		{
+			const int len = min(TRANSIENT_HOP, n - h);
+			double e, d;
+			HopEnergy(mono + h, len, prev, &e, &d);
+			prev = mono[h + len - 1];
+			e /= len;
+			d /= len;
+
+			const double logE = log(e + 1e-10), logD = log(d + 1e-10);
+			const double flux = max(0.0, logE - prevLogE) + max(0.0, logD - prevLogD);
+			prevLogE = logE;
+			prevLogD = logD;
+
+			// the candidate (previous hop) is a transient if it is a local flux peak
+			if (candPos >= 0 && candFlux > candPrevFlux && candFlux >= flux && candFlux > candThresh && (candLoud || e >= minLevel) && candPos - lastPos >= retrig)
+			{
+				positions->Add((double)candPos / t.samplerate);
+				lastPos = candPos;
+			}
+
+			candPrevFlux = candPos >= 0 ? candFlux : 0.0;
+			candFlux = flux;
+			candThresh = historySum / TRANSIENT_AVG_HOPS * factor + delta;
+			candLoud = e >= minLevel;
+			candPos = hopPos;
+
+			historySum += flux - history[historyPos];
+			history[historyPos] = flux;
+			historyPos = (historyPos + 1) % TRANSIENT_AVG_HOPS;
+			hopPos += len;
+		}
+
+		AddAnalyzeProgress(progress, n);
+
+		iFrame++;
+		t.time_s = (double)t.length * iFrame / t.samplerate;
+		t.samples_out = 0;
+		pcm->GetSamples(&t);
+	}
+
+	// transients at the very start of the source are ignored (no split to do there)
+	if (positions->GetSize() && positions->Get()[0] * t.samplerate < TRANSIENT_HOP)
+	{
+		memmove(positions->Get(), positions->Get() + 1, (positions->GetSize() - 1) * sizeof(double));
+		positions->Resize(positions->GetSize() - 1, false);
+	}
+
+	return true;
+}
+
+// pool->ctx: TRANSIENT_BATCH
+static void DetectTransientsJob(ANALYZE_POOL* pool, int iJob, SWS_SampleArena* arena)
+{
+	TRANSIENT_BATCH* b = static_cast<TRANSIENT_BATCH*>(pool->ctx);
+	TRANSIENT_JOB* job = b->jobs->Get(iJob);
+	if (!DetectTransientsPCM(job->pcm, b->dSensitivity, b->dThreshold, &job->positions, arena, pool))
+		job->positions.Resize(0, false);
+}
+
+// splits at transients, from the last one so that item stays the leftmost part
+static int SplitItemAtPositions(MediaItem* item, WDL_TypedBuf<double>* positions)
+{
+	const double dPos = *(double*)GetSetMediaItemInfo(item, "D_POSITION", NULL);
+	const double dLen = *(double*)GetSetMediaItemInfo(item, "D_LENGTH", NULL);
+	int splits = 0;
+	for (int i = positions->GetSize() - 1; i >= 0; i--)
+	{
+		const double t = positions->Get()[i];
+		if (t > 0.0 && t < dLen && SplitMediaItem(item, dPos + t))
+			splits++;
+	}
+	return splits;
+}
+
+// detects transients of all items on worker threads, then splits them in one go
+// returns the number of splits (the caller is responsible for the undo point)
+int SplitItemsAtTransients(WDL_TypedBuf<MediaItem*>* items, double sensitivity, double thresholdDb)
+{
+	WDL_PtrList_DeleteOnDestroy<TRANSIENT_JOB> jobs;
+	TRANSIENT_BATCH b;
+	b.jobs = &jobs;
+	b.dSensitivity = sensitivity;
+	b.dThreshold = thresholdDb;
+	ANALYZE_POOL pool;
+	pool.run = DetectTransientsJob;
+	pool.ctx = &b;
+	pool.totalSamples = 0;
+
+	for (int i = 0; i < items->GetSize(); i++)
+	{
+		if (PCM_source* pcm = DuplicateItemSource(items->Get()[i]))
+		{
+			TRANSIENT_JOB* job = new TRANSIENT_JOB;
+			job->item = items->Get()[i];
+			job->pcm = pcm;
+			job->sampleCount = (INT64)(pcm->GetLength() * pcm->GetSampleRate());
+			pool.totalSamples += job->sampleCount;
+			jobs.Add(job);
+		}
+	}
+	if (!jobs.GetSize())
+		return 0;
+
+	pool.nJobs = jobs.GetSize();
+	RunAnalyzePool(&pool, __LOCALIZE("Please wait, detecting transients...","sws_analysis"));
+
+	int splits = 0;
+	PreventUIRefresh(1);
+	for (int i = 0; i < jobs.GetSize(); i++)
+	{
+		TRANSIENT_JOB* job = jobs.Get(i);
+		delete job->pcm;
+		job->pcm = NULL;
+		splits += SplitItemAtPositions(job->item, &job->positions);
+	}
+	PreventUIRefresh(-1);
+	return splits;
+}
+
+// REAPER's transient detection settings (sensitivity 0.0-1.0, threshold in dB)
+static double GetTransientConfigVar(const char* name, double fallback)
+{
+	if (ConfigVar<double> cv{name})
+		return *cv;
+	else if (ConfigVar<float> cv{name})
+		return *cv;
+	return fallback;
+}
+
+void GetTransientOptions(double* sensitivityOut, double* thresholdOut)
+{
+	if (sensitivityOut)
+		*sensitivityOut = min(1.0, max(0.0, GetTransientConfigVar("transientsensitivity", 0.5)));
+
+	if (thresholdOut)
+		*thresholdOut = GetTransientConfigVar("transientthreshold", -40.0);
+}
+
 // ReaScript export
 void NF_GetRMSOptions(double *targetOut, double *winSizeOut)
 {
@@ -455,6 +1047,47 @@ bool NF_SetRMOptions(double target, double windowSize)
 	return false;
 }
 
+int NF_GetMediaItemTransients(MediaItem* item, double sensitivity, double thresholdDb, char* positionsOut, int positionsOut_sz)
+{
+	if (positionsOut && positionsOut_sz > 0)
+		*positionsOut = '\0';
+
+	PCM_source* pcm = item ? DuplicateItemSource(item) : NULL;
+	if (!pcm)
+		return 0;
+
+	WDL_TypedBuf<double> positions;
+	DetectTransientsPCM(pcm, sensitivity, thresholdDb, &positions);
+	delete pcm;
+
+	if (positionsOut && positionsOut_sz > 0)
+	{
+		WDL_FastString str;
+		for (int i = 0; i < positions.GetSize(); i++)
+			str.AppendFormatted(32, i ? ",%.6f" : "%.6f", positions.Get()[i]);
+		lstrcpyn(positionsOut, str.Get(), positionsOut_sz);
+	}
+	return positions.GetSize();
+}
+
+int NF_SplitMediaItemAtTransients(MediaItem* item, double sensitivity, double thresholdDb)
+{
+	PCM_source* pcm = item ? DuplicateItemSource(item) : NULL;
+	if (!pcm)
+		return 0;
+
+	WDL_TypedBuf<double> positions;
+	DetectTransientsPCM(pcm, sensitivity, thresholdDb, &positions);
+	delete pcm;
+
+	PreventUIRefresh(1);
+	const int splits = SplitItemAtPositions(item, &positions);
+	PreventUIRefresh(-1);
+	if (splits)
+		UpdateTimeline();
+	return splits;
+}
+
 //!WANT_LOCALIZE_1ST_STRING_BEGIN:sws_actions
 static COMMAND_T g_commandTable[] =
 {
@@ -52,7 +52,12 @@ typedef struct ANALYZE_PCM
 int AnalysisInit();
 
 bool AnalyzeItem(MediaItem* mi, ANALYZE_PCM* a);
+int AnalyzeItems(MediaItem** items, ANALYZE_PCM* a, int count, bool useCache = false); // one wait dialog, useCache: for the actions, results are reused until the project changes
+int SplitItemsAtTransients(WDL_TypedBuf<MediaItem*>* items, double sensitivity, double thresholdDb);
+void GetTransientOptions(double* sensitivityOut, double* thresholdOut);
 
 // #781 Export to ReaScript
 void NF_GetRMSOptions(double *targetOut, double *winSizeOut);
 bool NF_SetRMOptions(double target, double windowSize);
+int NF_GetMediaItemTransients(MediaItem* item, double sensitivity, double thresholdDb, char* positionsOut, int positionsOut_sz);
+int NF_SplitMediaItemAtTransients(MediaItem* item, double sensitivity, double thresholdDb);
@@ -28,6 +28,7 @@
 #include "stdafx.h"
 
 #include "padreEnvelopeProcessor.h"
+#include "../Breeder/BR_EnvelopeUtil.h"
 #include "../SnM/SnM_Item.h"
 
 #include <WDL/localize/localize.h>
@@ -172,58 +173,60 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::getTrackEnvelopeMinMax(TrackEnve
 	if(!envelope)
 		return eERRORCODE_NOENVELOPE;
 
-	char* envState = GetSetObjectState(envelope, "");
-	if(!envState)
-		return eERRORCODE_NOOBJSTATE;
-
 	dEnvMinVal = 0.0;
 	dEnvMaxVal = 1.0;
-	double dTmp[2];
-	int iTmp;
 
-	stringstream envStateStream;
-	envStateStream << envState;
-	std::vector<string> tokens;
-	while(!envStateStream.eof())
-	{
-		string str;
-		getline(envStateStream, str, '\n');
-		tokens.push_back(str);
-	}
-
-	for(vector<string>::const_iterator it = tokens.begin(); it !=tokens.end(); ++it)
+	// no need to get the state chunk (may have lots of points): type from the envelope name, range from the FX
+	bool bSend, bHwSend;
+	switch(GetEnvType(envelope, &bSend, &bHwSend))
 	{
 		// Track envelope: Volume
-		if(!strcmp(it->c_str(), "<VOLENV") || !strcmp(it->c_str(), "<VOLENV2"))
-		{
-			dEnvMaxVal = 2.0;
-			break;
-		}
+		case VOLUME :
+		case VOLUME_PREFX :
+			if(!bSend && !bHwSend)
+				dEnvMaxVal = 2.0;
+		break;
 
 		// Track envelope: Pan
-		if(!strcmp(it->c_str(), "<PANENV") || !strcmp(it->c_str(), "<PANENV2"))
-		{
-			dEnvMinVal = -1.0;
-			break;
-		}
+		case PAN :
+		case PAN_PREFX :
+			if(!bSend && !bHwSend)
+				dEnvMinVal = -1.0;
+		break;
 
-		// Track envelope: Param (VST index, min value, max value)
-		if(sscanf(it->c_str(), "<PARMENV %d %lf %lf", &iTmp, &dTmp[0], &dTmp[1]) == 3)
+		// Track envelope: Param (min value, max value)
+		case PARAMETER :
 		{
-			dEnvMinVal = dTmp[0];
-			dEnvMaxVal = dTmp[1];
-			break;
+			MediaTrack* track = (MediaTrack*)GetEnvelopeInfo_Value(envelope, "P_TRACK");
+			int fxCount = track ? TrackFX_GetCount(track) : 0;
+			for(int fx = 0; fx < fxCount; fx++)
+			{
+				int paramCount = TrackFX_GetNumParams(track, fx);
+				for(int param = 0; param < paramCount; param++)
+				{
+					if(GetFXEnvelope(track, fx, param, false) == envelope)
+					{
+						TrackFX_GetParam(track, fx, param, &dEnvMinVal, &dEnvMaxVal);
+						fx = fxCount;
+						break;
+					}
+				}
+			}
 		}
+		break;
 
-		if(!strcmp(it->c_str(), ">"))
-			break;
+		default :
+		break;
 	}
 
-	FreeHeapPtr(envState);
+	// points are read/written in the envelope's scaling mode (e.g. volume with fader scaling)
+	int scalingMode = GetEnvelopeScalingMode(envelope);
+	dEnvMinVal = ScaleToEnvelopeMode(scalingMode, dEnvMinVal);
+	dEnvMaxVal = ScaleToEnvelopeMode(scalingMode, dEnvMaxVal);
 	return eERRORCODE_OK;
 }
 
-void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, double dStartTime, double dEndTime, double dValMin, double dValMax, LfoWaveParams &waveParams, double dPrecision, LfoWaveParams* freqModulator)
+void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, vector<LfoPoint> &points, double dStartTime, double dEndTime, double dValMin, double dValMax, LfoWaveParams &waveParams, double dPrecision, LfoWaveParams* freqModulator)
 {
 	double dFreq, dDelay;
 	getFreqDelay(waveParams, dFreq, dDelay);
@@ -236,7 +239,6 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 	double dScale = dValMax - dOff;
 	double dSamplerate;
 	double dValue = 0.0;
-	char buffer[BUFFER_SIZE];
 
 	EnvShape tEnvShape = eENVSHAPE_LINEAR;
 	switch(waveParams.shape)
@@ -331,8 +333,7 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 	double dValueEnd = waveParams.offset + dMagnitude*dCarrierEnd;
 	dValueEnd = dScale*dValueEnd + dOff;
 
-	sprintf(buffer, "PT %lf %lf %d\n", dStartTime, dValueStart, tEnvShape);
-	envState.append(buffer);
+	points.push_back(LfoPoint(dStartTime, dValueStart, tEnvShape));
 
 //double dFreqMod = dFreq;
 //freqModulator = new LfoWaveParams();
@@ -343,10 +344,6 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 	{
 		case eWAVSHAPE_SINE :
 		{
-			for(double t = -dDelaySec; t<dLength; t += dSamplerate)
-			{
-				if(t>0.0)
-				{
 //if(freqModulator)
 //{
 //	double dFreqCarrier = WaveformGeneratorSawUp(t, freqModulator->freqHz, 1000.0*freqModulator->delayMsec);
@@ -356,12 +353,34 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 //	dSamplerate = 0.01;
 //}
 
-					dValue = waveParams.offset + dMagnitude*WaveformGeneratorSin(t, dFreq, dDelaySec);
-//dValue = waveParams.offset + dMagnitude*WaveformGeneratorSin(t, dFreqMod, dDelaySec);
-					dValue = dScale*dValue + dOff;
-					sprintf(buffer, "PT %lf %lf %d\n", t+dStartTime, dValue, tEnvShape);
-					envState.append(buffer);
+			// first sample after the start, t = k*dSamplerate - dDelaySec
+			int k = (int)(dDelaySec/dSamplerate) + 1;
+			while(k*dSamplerate - dDelaySec <= 0.0)
+				k++;
+
+			// computed by blocks: the inner loops have no dependencies and get vectorized
+			double dTime[LFO_BLOCK_SIZE], dWave[LFO_BLOCK_SIZE];
+			const double dOmega = 2.0*PI*dFreq;
+			for(;;)
+			{
+				int n = 0;
+				for(; n < LFO_BLOCK_SIZE; n++)
+				{
+					dTime[n] = (k+n)*dSamplerate - dDelaySec;
+					if(dTime[n] >= dLength)
+						break;
 				}
+				if(!n)
+					break;
+
+				for(int i = 0; i < n; i++)
+					dWave[i] = dScale*(waveParams.offset + dMagnitude*sin(dOmega*(dTime[i]+dDelaySec))) + dOff;
+				for(int i = 0; i < n; i++)
+					points.push_back(LfoPoint(dTime[i]+dStartTime, dWave[i], tEnvShape));
+
+				k += n;
+				if(n < LFO_BLOCK_SIZE)
+					break;
 			}
 		}
 		break;
@@ -379,8 +398,7 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 				{
 					dValue = waveParams.offset + dMagnitude*dFlipFlop;
 					dValue = dScale*dValue + dOff;
-					sprintf(buffer, "PT %lf %lf %d\n", t+dStartTime, dValue, tEnvShape);
-					envState.append(buffer);
+					points.push_back(LfoPoint(t+dStartTime, dValue, tEnvShape));
 					dFlipFlop = -dFlipFlop;
 				}
 			}
@@ -400,8 +418,7 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 					{
 						dValue = waveParams.offset + dMagnitude*dFlipFlop;
 						dValue = dScale*dValue + dOff;
-						sprintf(buffer, "PT %lf %lf %d\n", t+dStartTime, dValue, tEnvShape);
-						envState.append(buffer);
+						points.push_back(LfoPoint(t+dStartTime, dValue, tEnvShape));
 						dFlipFlop = -dFlipFlop;
 					}
 				}
@@ -424,8 +441,7 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 				{
 					dValue = waveParams.offset + dMagnitude*WaveformGeneratorRandom(t, dFreq, dDelaySec);
 					dValue = dScale*dValue + dOff;
-					sprintf(buffer, "PT %lf %lf %d\n", t+dStartTime, dValue, tEnvShape);
-					envState.append(buffer);
+					points.push_back(LfoPoint(t+dStartTime, dValue, tEnvShape));
 				}
 			}
 		}
@@ -435,204 +451,144 @@ void EnvelopeProcessor::writeLfoPoints(MediaItem_Take* take, string &envState, d
 		break;
 	}
 
-	sprintf(buffer, "PT %lf %lf %d\n", dEndTime, dValueEnd, tEnvShape);
-	envState.append(buffer);
+	points.push_back(LfoPoint(dEndTime, dValueEnd, tEnvShape));
 }
 
-EnvelopeProcessor::ErrorCode EnvelopeProcessor::processPoints(char* envState, string &newState, double dStartPos, double dEndPos, double dValMin, double dValMax, EnvModType envModType, double dStrength, double dOffset)
+// Removes points the envelope already passes through (within dTolerance): flat runs and collinear
+// linear segments. Points sharing a time (saw jumps) are kept
+void EnvelopeProcessor::thinLfoPoints(vector<LfoPoint> &points, double dTolerance)
 {
-	//if(!envelope)
-	//	return eERRORCODE_NOENVELOPE;
-
-	if(dStartPos==dEndPos)
-		return eERRORCODE_NULLTIMESELECTION;
-	double dLength = dEndPos-dStartPos;
+	if(points.size() < 3)
+		return;
 
-	double dEnvOffset = 0.5*(dValMin+dValMax);
-	double dEnvMagnitude = 0.5*(dValMax-dValMin);
+	vector<LfoPoint> thinned;
+	thinned.reserve(points.size());
+	thinned.push_back(points[0]);
+	size_t firstSkipped = 1;
 
-	//char* envState = GetSetObjectState(envelope, "");
-	if(!envState)
-		return eERRORCODE_NOOBJSTATE;
-
-	//string newState;
-	newState.clear();
-	char cPtValue[318];
-
-	double position, value;
-	int iTmp;
-	char* token = strtok(envState, "\n");
-
-	while(token != NULL)
+	for(size_t i = 1; i+1 < points.size(); i++)
 	{
-		// Position, value, shape
-		if(sscanf(token, "PT %lf %lf %d\n", &position, &value, &iTmp) == 3)
+		const LfoPoint &prev = thinned.back();
+		const LfoPoint &next = points[i+1];
+
+		// segment prev -> next must stay within tolerance of every point it replaces
+		// (bezier segments are curves: never thinned)
+		bool bRedundant = (prev.shape == eENVSHAPE_LINEAR || prev.shape == eENVSHAPE_SQUARE) && points[i].shape == prev.shape && next.time > prev.time && points[i].time > prev.time && points[i].time < next.time
+			&& i - firstSkipped < LFO_BLOCK_SIZE;
+		for(size_t j = firstSkipped; bRedundant && j <= i; j++)
 		{
-			if(position>=dEndPos)
-				break;
-			if(position>dStartPos)
-			{
-				stringstream currentLine;
-				currentLine << token;
-				std::vector<string> lineTokens;
-				while(!currentLine.eof())
-				{
-					string str;
-					getline(currentLine, str, ' ');
-					lineTokens.push_back(str);
-				}
-
-				string newLine;
-				int linePos = 0;
-				for(vector<string>::const_iterator it = lineTokens.begin(); it !=lineTokens.end(); ++it)
-				{
-					if(linePos == 2)
-					{
-						double dEnvNormValue = (value-dEnvOffset)/dEnvMagnitude;
-						double dCarrier = 1.0;
-						switch(envModType)
-						{
-							case eENVMOD_FADEIN :
-								dCarrier = (position-dStartPos)/dLength;
-								dCarrier = pow(dCarrier, dStrength);
-								//dCarrier = EnvSignalProcessorFade((position-dStartPos), (dEndPos-dStartPos), true);
-								dEnvNormValue = dCarrier*(dEnvNormValue - dOffset) + dOffset;
-							break;
-							case eENVMOD_FADEOUT :
-								dCarrier = (dEndPos-position)/dLength;
-								dCarrier = pow(dCarrier, dStrength);
-								//dCarrier = EnvSignalProcessorFade((position-dStartPos), (dEndPos-dStartPos), false);
-								dEnvNormValue = dCarrier*(dEnvNormValue - dOffset) + dOffset;
-							break;
-							case eENVMOD_AMPLIFY :
-								dEnvNormValue = dStrength*(dEnvNormValue + dOffset);
-							break;
-							default :
-							break;
-						}
-
-						value = dEnvMagnitude*dEnvNormValue + dEnvOffset;
-						if(value < dValMin)
-							value = dValMin;
-						if(value > dValMax)
-							value = dValMax;
-
-						sprintf(cPtValue, "%lf", value);
-						newLine.append(cPtValue);
-					}
-
-					else
-						newLine.append(*it);
-
-					newLine.append(" ");
-					linePos++;
-				}
-				newState.append(newLine);
-				newState.append("\n");
+			double dExpected = prev.value;
+			if(prev.shape != eENVSHAPE_SQUARE)
+				dExpected += (next.value - prev.value) * (points[j].time - prev.time) / (next.time - prev.time);
+			bRedundant = fabs(points[j].value - dExpected) <= dTolerance;
+		}
 
-				token = strtok(NULL, "\n");
-				continue;
-			}
+		if(!bRedundant)
+		{
+			thinned.push_back(points[i]);
+			firstSkipped = i+1;
 		}
+	}
 
-		if(!strcmp(token, ">"))
-			break;
+	thinned.push_back(points.back());
+	points.swap(thinned);
+}
 
-		newState.append(token);
-		newState.append("\n");
-		token = strtok(NULL, "\n");
-	}
+// Replaces the points of envelope in [dStartPos, dEndPos[
+EnvelopeProcessor::ErrorCode EnvelopeProcessor::insertLfoPoints(TrackEnvelope* envelope, double dStartPos, double dEndPos, double dValMin, double dValMax, vector<LfoPoint> &points)
+{
+	if(points.empty())
+		return eERRORCODE_UNKNOWN;
 
-	newState.append(token);
-	newState.append("\n");
-	token = strtok(NULL, "\n");
-	while(token != NULL)
-	{
-		newState.append(token);
-		newState.append("\n");
-		token = strtok(NULL, "\n");
-	}
+	thinLfoPoints(points, LFO_THIN_TOLERANCE * (dValMax - dValMin));
 
-//	FreeHeapPtr(envState);
-//
-//	if(GetSetObjectState(envelope, newState.c_str()))
-//		return eERRORCODE_UNKNOWN;
-//Undo_OnStateChangeEx("Envelope Processor", UNDO_STATE_ALL, -1);
+	DeleteEnvelopePointRange(envelope, dStartPos, dEndPos);
+
+	bool bNoSort = true;
+	for(vector<LfoPoint>::const_iterator point = points.begin(); point != points.end(); point++)
+		InsertEnvelopePoint(envelope, point->time, point->value, point->shape, 0.0, false, &bNoSort);
+	Envelope_SortPoints(envelope);
 
 	return eERRORCODE_OK;
 }
 
-EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateTrackLfo(TrackEnvelope* envelope, double dStartPos, double dEndPos, LfoWaveParams &waveParams, double dPrecision)
+// Modulates the points of envelope in ]dStartPos, dEndPos[, through the envelope point API
+EnvelopeProcessor::ErrorCode EnvelopeProcessor::processPoints(TrackEnvelope* envelope, double dStartPos, double dEndPos, double dValMin, double dValMax, EnvModType envModType, double dStrength, double dOffset)
 {
 	if(!envelope)
 		return eERRORCODE_NOENVELOPE;
 
 	if(dStartPos==dEndPos)
 		return eERRORCODE_NULLTIMESELECTION;
+	double dLength = dEndPos-dStartPos;
 
-	char* envState = GetSetObjectState(envelope, "");
-	if(!envState)
-		return eERRORCODE_NOOBJSTATE;
-
-	string newState;
-	double dValMin = 0.0;
-	double dValMax = 1.0;
-	double dTmp[2];
-	int iTmp;
+	double dEnvOffset = 0.5*(dValMin+dValMax);
+	double dEnvMagnitude = 0.5*(dValMax-dValMin);
 
-	//! \todo Use with GetMinMax()
-	char* token = strtok(envState, "\n");
-	while(token != NULL)
+	bool bNoSort = true; // positions don't change
+	int count = CountEnvelopePoints(envelope);
+	for(int i = max(0, GetEnvelopePointByTime(envelope, dStartPos)); i < count; i++)
 	{
-		if(!strcmp(token, "<VOLENV") || !strcmp(token, "<VOLENV2"))
-			dValMax = 2.0;
-
-		if(!strcmp(token, "<PANENV") || !strcmp(token, "<PANENV2"))
-			dValMin = -1.0;
-
-		// VST index, min value, max value
-		if(sscanf(token, "<PARMENV %d %lf %lf", &iTmp, &dTmp[0], &dTmp[1]) == 3)
-		{
-			dValMin = dTmp[0];
-			dValMax = dTmp[1];
-		}
+		double position, value;
+		if(!GetEnvelopePoint(envelope, i, &position, &value, NULL, NULL, NULL))
+			continue;
+		if(position>=dEndPos)
+			break;
+		if(position<=dStartPos)
+			continue;
 
-		// Position, value, shape
-		if(sscanf(token, "PT %lf %lf %d\n", &dTmp[0], &dTmp[1], &iTmp) == 3)
+		double dEnvNormValue = (value-dEnvOffset)/dEnvMagnitude;
+		double dCarrier = 1.0;
+		switch(envModType)
 		{
-			if(dTmp[0]>=dEndPos)
-				break;
-			if(dTmp[0]>dStartPos)
-			{
-				token = strtok(NULL, "\n");
-				continue;
-			}
+			case eENVMOD_FADEIN :
+				dCarrier = (position-dStartPos)/dLength;
+				dCarrier = pow(dCarrier, dStrength);
+				dEnvNormValue = dCarrier*(dEnvNormValue - dOffset) + dOffset;
+			break;
+			case eENVMOD_FADEOUT :
+				dCarrier = (dEndPos-position)/dLength;
+				dCarrier = pow(dCarrier, dStrength);
+				dEnvNormValue = dCarrier*(dEnvNormValue - dOffset) + dOffset;
+			break;
+			case eENVMOD_AMPLIFY :
+				dEnvNormValue = dStrength*(dEnvNormValue + dOffset);
+			break;
+			default :
+			break;
 		}
 
-		if(!strcmp(token, ">"))
-			break;
+		value = dEnvMagnitude*dEnvNormValue + dEnvOffset;
+		if(value < dValMin)
+			value = dValMin;
+		if(value > dValMax)
+			value = dValMax;
 
-		newState.append(token);
-		newState.append("\n");
-		token = strtok(NULL, "\n");
+		SetEnvelopePoint(envelope, i, NULL, &value, NULL, NULL, NULL, &bNoSort);
 	}
 
-	writeLfoPoints(nullptr, newState, dStartPos, dEndPos, dValMin, dValMax, waveParams, dPrecision);
+	return eERRORCODE_OK;
+}
 
-	newState.append(token);
-	newState.append("\n");
-	token = strtok(NULL, "\n");
-	while(token != NULL)
-	{
-		newState.append(token);
-		newState.append("\n");
-		token = strtok(NULL, "\n");
-	}
+EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateTrackLfo(TrackEnvelope* envelope, double dStartPos, double dEndPos, LfoWaveParams &waveParams, double dPrecision)
+{
+	if(!envelope)
+		return eERRORCODE_NOENVELOPE;
 
-	FreeHeapPtr(envState);
+	if(dStartPos==dEndPos)
+		return eERRORCODE_NULLTIMESELECTION;
 
-	if(GetSetObjectState(envelope, newState.c_str()))
-		return eERRORCODE_UNKNOWN;
+	double dValMin, dValMax;
+	ErrorCode res = getTrackEnvelopeMinMax(envelope, dValMin, dValMax);
+	if(res != eERRORCODE_OK)
+		return res;
+
+	// points are inserted directly: setting the state chunk would reparse the whole envelope
+	vector<LfoPoint> points;
+	writeLfoPoints(nullptr, points, dStartPos, dEndPos, dValMin, dValMax, waveParams, dPrecision);
+	res = insertLfoPoints(envelope, dStartPos, dEndPos, dValMin, dValMax, points);
+	if(res != eERRORCODE_OK)
+		return res;
 
 /* JFB commented: leads to "recursive" undo point, enabled at top level
 	Undo_OnStateChangeEx("Track Envelope LFO", UNDO_STATE_ALL, -1);
@@ -673,7 +629,7 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateSelectedTrackEnvLfo()
 	//Main_OnCommandEx(ID_ENVELOPE_DELETE_ALL_POINTS_TIMESEL, 0, 0);
 
 	ErrorCode res = generateTrackLfo(envelope, dStartPos, dEndPos, _parameters.waveParams, _parameters.precision);
-//UpdateTimeline();
+	UpdateTimeline();
 
 	Undo_EndBlock2(NULL, __LOCALIZE("Track envelope LFO","sws_undo"), UNDO_STATE_TRACKCFG);
 	return res;
@@ -716,57 +672,8 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateTakeLfo(MediaItem_Take*
 	//if(dStartPos==dEndPos)
 	//	return eERRORCODE_NULLTIMESELECTION;
 
-	string newState;
-	string envStateStr;
-	try {
-		envStateStr = envelope::GetEnvelopeStateChunkBig(envelope);
-	}
-	catch (const envelope::bad_get_env_chunk_big &) {
-		return eERRORCODE_NOOBJSTATE;
-	}
-	
-	char* envState = &envStateStr[0];
-	double dTmp[2];
-	int iTmp;
-	char* token = strtok(envState, "\n");
-	while(token != NULL)
-	{
-		// Position, value, shape
-		if(sscanf(token, "PT %lf %lf %d\n", &dTmp[0], &dTmp[1], &iTmp) == 3)
-		{
-			if(dTmp[0]>=dEndPos)
-				break;
-			if(dTmp[0]>dStartPos)
-			{
-				token = strtok(NULL, "\n");
-				continue;
-			}
-		}
-
-		if(!strcmp(token, ">"))
-			break;
-
-		newState.append(token);
-		newState.append("\n");
-		token = strtok(NULL, "\n");
-	}
-
-	writeLfoPoints(take, newState, dStartPos, dEndPos, dValMin, dValMax, waveParams, dPrecision);
-
-	newState.append(token);
-	newState.append("\n");
-	token = strtok(NULL, "\n");
-	while(token != NULL)
-	{
-		newState.append(token);
-		newState.append("\n");
-		token = strtok(NULL, "\n");
-	}
-
-
-
-//
-//ShowConsoleMsg(envState);
+	vector<LfoPoint> points;
+	writeLfoPoints(take, points, dStartPos, dEndPos, dValMin, dValMax, waveParams, dPrecision);
 
 /*
 //double dCursorPos = GetCursorPositionEx(0);
@@ -800,8 +707,9 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::generateTakeLfo(MediaItem_Take*
 writeLfoPoints(newState, dStartPos, dEndPos, dValMin, dValMax, dFreq, dStrength, dOffset, dDelay, tWaveShape, dPrecision);
 	newState.append(">\n");
 */
-	if(!newState.size() || !GetSetEnvelopeState(envelope, (char*)newState.c_str(), (int)newState.size()))
-		return eERRORCODE_UNKNOWN;
+	ErrorCode res = insertLfoPoints(envelope, dStartPos, dEndPos, dValMin, dValMax, points);
+	if(res != eERRORCODE_OK)
+		return res;
 
 /* JFB commented: "recursive" undo point, enabled at top level
 	Undo_OnStateChangeEx("Take Envelope LFO", UNDO_STATE_ALL, -1);
@@ -867,7 +775,7 @@ EnvelopeProcessor::MidiCcRemover::MidiCcRemover(int* pMidiCc)
 {
 }
 
-void EnvelopeProcessor::MidiCcRemover::process(MIDI_event_t* evt, MIDI_eventlist* evts, int &curPos, int &nextPos, int itemLengthSamples)
+bool EnvelopeProcessor::MidiCcRemover::filter(MIDI_event_t* evt, int itemLengthSamples, minstd_rand &rng)
 {
 	int statusByte = evt->midi_message[0] & 0xf0;
 	//int midiChannel = evt->midi_message[0] & 0x0f;
@@ -877,16 +785,14 @@ void EnvelopeProcessor::MidiCcRemover::process(MIDI_event_t* evt, MIDI_eventlist
 		case MIDI_CMD_CONTROL_CHANGE :
 		{
 			if(evt->midi_message[1] == *_pMidiCc)
-			{
-				evts->DeleteItem(curPos);
-				nextPos = curPos;
-			}
+				return false;
 		}
 		break;
 
 		default :
 		break;
 	}
+	return true;
 }
 
 EnvelopeProcessor::MidiCcLfo::MidiCcLfo(EnvLfoParams* pParameters)
@@ -990,13 +896,7 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::processSelectedTrackEnv()
 	if(res != eERRORCODE_OK)
 		return res;
 
-	char* envState = GetSetObjectState(envelope, "");
-	string newState;
-	res = processPoints(envState, newState, dStartPos, dEndPos, dValMin, dValMax, _envModParams.type, _envModParams.strength, _envModParams.offset);
-	if(GetSetObjectState(envelope, newState.c_str()))
-		res = eERRORCODE_UNKNOWN;
-	else
-		FreeHeapPtr(envState);
+	res = processPoints(envelope, dStartPos, dEndPos, dValMin, dValMax, _envModParams.type, _envModParams.strength, _envModParams.offset);
 
 //UpdateTimeline();
 /* JFB "recursive" undo point, enabled at top level
@@ -1094,13 +994,7 @@ EnvelopeProcessor::ErrorCode EnvelopeProcessor::processTakeEnv(MediaItem_Take* t
 	if(!envelope)
 		return eERRORCODE_NOENVELOPE;
 
-	string envStateStr = envelope::GetEnvelopeStateChunkBig(envelope);
-	char* envState = &envStateStr[0];
-	string newState;
-	ErrorCode res = processPoints(envState, newState, dStartPos, dEndPos, dValMin, dValMax, envModType, dStrength, dOffset);
-
-	if(!newState.size() || !GetSetEnvelopeState(envelope, (char*)newState.c_str(), (int)newState.size()))
-		res = eERRORCODE_UNKNOWN;
+	ErrorCode res = processPoints(envelope, dStartPos, dEndPos, dValMin, dValMax, envModType, dStrength, dOffset);
 
 /*JFB
 	Undo_OnStateChangeEx("Take Envelope LFO", UNDO_STATE_ALL, -1);
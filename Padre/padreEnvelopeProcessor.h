@@ -30,6 +30,8 @@
 using namespace std;
 
 #define	EPSILON_TIME	0.01
+#define	LFO_THIN_TOLERANCE	0.001	// max error of thinned LFO points, relative to the envelope range
+#define	LFO_BLOCK_SIZE	256
 
 enum EnvType { eENVTYPE_TRACK=0, eENVTYPE_TAKE=1, eENVTYPE_MIDICC=2 };
 enum EnvModType { eENVMOD_FADEIN, eENVMOD_FADEOUT, eENVMOD_AMPLIFY, eENVMOD_LAST };
@@ -51,6 +53,15 @@ struct LfoWaveParams
 	LfoWaveParams& operator=(const LfoWaveParams &params);
 };
 
+struct LfoPoint
+{
+	double time;
+	double value;
+	EnvShape shape;
+
+	LfoPoint(double t, double v, EnvShape s) : time(t), value(v), shape(s) {}
+};
+
 struct EnvLfoParams
 {
 	EnvType envType;
@@ -98,7 +109,7 @@ class EnvelopeProcessor
 
 			public:
 				MidiCcRemover(int* pMidiCc);
-				virtual void process(MIDI_event_t* evt, MIDI_eventlist* evts, int &curPos, int &nextPos, int itemLengthSamples);
+				virtual bool filter(MIDI_event_t* evt, int itemLengthSamples, minstd_rand &rng);
 		};
 
 		class MidiCcLfo : public MidiGeneratorBase
@@ -135,9 +146,11 @@ ErrorCode processSelectedTakes();
 	protected:
 		static void getFreqDelay(LfoWaveParams &waveParams, double &dFreq, double &dDelay);
 		static ErrorCode getTrackEnvelopeMinMax(TrackEnvelope* envelope, double &dEnvMinVal, double &dEnvMaxVal);
-		static void writeLfoPoints(MediaItem_Take* take, string &envState, double dStartTime, double dEndTime, double dValMin, double dValMax, LfoWaveParams &waveParams, double dPrecision = 0.1, LfoWaveParams* freqModulator = NULL);
+		static void writeLfoPoints(MediaItem_Take* take, vector<LfoPoint> &points, double dStartTime, double dEndTime, double dValMin, double dValMax, LfoWaveParams &waveParams, double dPrecision = 0.1, LfoWaveParams* freqModulator = NULL);
+		static void thinLfoPoints(vector<LfoPoint> &points, double dTolerance);
+		static ErrorCode insertLfoPoints(TrackEnvelope* envelope, double dStartPos, double dEndPos, double dValMin, double dValMax, vector<LfoPoint> &points);
 
-		static ErrorCode processPoints(char* envState, string &newState, double dStartPos, double dEndPos, double dValMin, double dValMax, EnvModType envModType, double dStrength = 1.0, double dOffset = 0.0);
+		static ErrorCode processPoints(TrackEnvelope* envelope, double dStartPos, double dEndPos, double dValMin, double dValMax, EnvModType envModType, double dStrength = 1.0, double dOffset = 0.0);
 
 		static ErrorCode generateTrackLfo(TrackEnvelope* envelope, double dStartPos, double dEndPos, LfoWaveParams &waveParams, double dPrecision = 0.1);
 		static ErrorCode generateTakeLfo(MediaItem_Take* take, double dStartPos, double dEndPos, TakeEnvType tTakeEnvType, LfoWaveParams &waveParams, double dPrecision = 0.1);
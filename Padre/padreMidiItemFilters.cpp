@@ -33,7 +33,7 @@ MidiFilterDeleteNotes::MidiFilterDeleteNotes()
 {
 }
 
-void MidiFilterDeleteNotes::process(MIDI_event_t* evt, MIDI_eventlist* evts, int &curPos, int &nextPos, int itemLengthSamples)
+bool MidiFilterDeleteNotes::filter(MIDI_event_t* evt, int itemLengthSamples, minstd_rand &rng)
 {
 	int statusByte = evt->midi_message[0] & 0xf0;
 	//int midiChannel = evt->midi_message[0] & 0x0f;
@@ -42,15 +42,12 @@ void MidiFilterDeleteNotes::process(MIDI_event_t* evt, MIDI_eventlist* evts, int
 	{
 		case MIDI_CMD_NOTE_ON :
 		case MIDI_CMD_NOTE_OFF :
-		{
-			evts->DeleteItem(curPos);
-			nextPos = curPos;
-		}
-		break;
+			return false;
 
 		default :
 		break;
 	}
+	return true;
 }
 
 MidiFilterDeleteControlChanges::MidiFilterDeleteControlChanges()
@@ -68,7 +65,7 @@ void MidiFilterDeleteControlChanges::removeCc(int cc)
 	_ccList.erase(cc);
 }
 
-void MidiFilterDeleteControlChanges::process(MIDI_event_t* evt, MIDI_eventlist* evts, int &curPos, int &nextPos, int itemLengthSamples)
+bool MidiFilterDeleteControlChanges::filter(MIDI_event_t* evt, int itemLengthSamples, minstd_rand &rng)
 {
 	int statusByte = evt->midi_message[0] & 0xf0;
 	//int midiChannel = evt->midi_message[0] & 0x0f;
@@ -77,29 +74,15 @@ void MidiFilterDeleteControlChanges::process(MIDI_event_t* evt, MIDI_eventlist*
 	{
 		case MIDI_CMD_CONTROL_CHANGE :
 		{
-			if(_ccList.empty())
-			{
-				evts->DeleteItem(curPos);
-				nextPos = curPos;
-			}
-
-			else
-			{
-				for(set<int>::iterator cc = _ccList.begin(); cc != _ccList.end(); cc++)
-				{
-					if(evt->midi_message[1] == *cc)
-					{
-						evts->DeleteItem(curPos);
-						nextPos = curPos;
-					}
-				}
-			}
+			if(_ccList.empty() || _ccList.count(evt->midi_message[1]))
+				return false;
 		}
 		break;
 
 		default :
 		break;
 	}
+	return true;
 }
 
 MidiFilterTranspose::MidiFilterTranspose()
@@ -112,7 +95,7 @@ MidiFilterTranspose::MidiFilterTranspose(int offset)
 {
 }
 
-void MidiFilterTranspose::process(MIDI_event_t* evt, MIDI_eventlist* evts, int &curPos, int &nextPos, int itemLengthSamples)
+bool MidiFilterTranspose::filter(MIDI_event_t* evt, int itemLengthSamples, minstd_rand &rng)
 {
 	int statusByte = evt->midi_message[0] & 0xf0;
 	//int midiChannel = evt->midi_message[0] & 0x0f;
@@ -133,6 +116,7 @@ void MidiFilterTranspose::process(MIDI_event_t* evt, MIDI_eventlist* evts, int &
 		default :
 		break;
 	}
+	return true;
 }
 
 MidiFilterRandomNotePos::MidiFilterRandomNotePos()
@@ -140,7 +124,7 @@ MidiFilterRandomNotePos::MidiFilterRandomNotePos()
 {
 }
 
-void MidiFilterRandomNotePos::process(MIDI_event_t* evt, MIDI_eventlist* evts, int &curPos, int &nextPos, int itemLengthSamples)
+bool MidiFilterRandomNotePos::filter(MIDI_event_t* evt, int itemLengthSamples, minstd_rand &rng)
 {
 	int statusByte = evt->midi_message[0] & 0xf0;
 	//int midiChannel = evt->midi_message[0] & 0x0f;
@@ -150,7 +134,8 @@ void MidiFilterRandomNotePos::process(MIDI_event_t* evt, MIDI_eventlist* evts, i
 		case MIDI_CMD_NOTE_ON :
 		case MIDI_CMD_NOTE_OFF :
 		{
-			evt->frame_offset += (rand()-RAND_MAX/2) / 8;
+			uniform_int_distribution<int> offset(0, RAND_MAX);
+			evt->frame_offset += (offset(rng)-RAND_MAX/2) / 8;
 		}
 		break;
 
@@ -160,6 +145,7 @@ void MidiFilterRandomNotePos::process(MIDI_event_t* evt, MIDI_eventlist* evts, i
 		default :
 		break;
 	}
+	return true;
 }
 
 MidiFilterShortenEndEvents::MidiFilterShortenEndEvents()
@@ -167,7 +153,7 @@ MidiFilterShortenEndEvents::MidiFilterShortenEndEvents()
 {
 }
 
-void MidiFilterShortenEndEvents::process(MIDI_event_t* evt, MIDI_eventlist* evts, int &curPos, int &nextPos, int itemLengthSamples)
+bool MidiFilterShortenEndEvents::filter(MIDI_event_t* evt, int itemLengthSamples, minstd_rand &rng)
 {
 	int length = 4096 + 64;
 
@@ -208,6 +194,7 @@ void MidiFilterShortenEndEvents::process(MIDI_event_t* evt, MIDI_eventlist* evts
 	//if( (statusByte == MIDI_CMD_CONTROL_CHANGE) && (cc == MIDI_CC123_ALL_NOTES_OFF) )
 	//{
 	//}
+	return true;
 }
 
 
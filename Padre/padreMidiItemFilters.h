@@ -32,7 +32,7 @@ class MidiFilterDeleteNotes : public MidiFilterBase
 	public:
 		MidiFilterDeleteNotes();
 
-		virtual void process(MIDI_event_t* evt, MIDI_eventlist* evts, int &curPos, int &nextPos, int itemLengthSamples);
+		virtual bool filter(MIDI_event_t* evt, int itemLengthSamples, minstd_rand &rng);
 };
 
 class MidiFilterDeleteControlChanges : public MidiFilterBase
@@ -45,7 +45,7 @@ class MidiFilterDeleteControlChanges : public MidiFilterBase
 
 		void addCc(int cc);
 		void removeCc(int cc);
-		virtual void process(MIDI_event_t* evt, MIDI_eventlist* evts, int &curPos, int &nextPos, int itemLengthSamples);
+		virtual bool filter(MIDI_event_t* evt, int itemLengthSamples, minstd_rand &rng);
 };
 
 class MidiFilterTranspose : public MidiFilterBase
@@ -58,7 +58,7 @@ class MidiFilterTranspose : public MidiFilterBase
 	public:
 		MidiFilterTranspose(int offset);
 
-		virtual void process(MIDI_event_t* evt, MIDI_eventlist* evts, int &curPos, int &nextPos, int itemLengthSamples);
+		virtual bool filter(MIDI_event_t* evt, int itemLengthSamples, minstd_rand &rng);
 };
 
 class MidiFilterRandomNotePos : public MidiFilterBase
@@ -66,7 +66,7 @@ class MidiFilterRandomNotePos : public MidiFilterBase
 	public:
 		MidiFilterRandomNotePos();
 
-		virtual void process(MIDI_event_t* evt, MIDI_eventlist* evts, int &curPos, int &nextPos, int itemLengthSamples);
+		virtual bool filter(MIDI_event_t* evt, int itemLengthSamples, minstd_rand &rng);
 };
 
 class MidiFilterShortenEndEvents : public MidiFilterBase
@@ -74,7 +74,7 @@ class MidiFilterShortenEndEvents : public MidiFilterBase
 	public:
 		MidiFilterShortenEndEvents();
 
-		virtual void process(MIDI_event_t* evt, MIDI_eventlist* evts, int &curPos, int &nextPos, int itemLengthSamples);
+		virtual bool filter(MIDI_event_t* evt, int itemLengthSamples, minstd_rand &rng);
 };
 
 
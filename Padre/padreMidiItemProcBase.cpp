@@ -67,6 +67,67 @@ bool MidiNoteKey::operator<(const MidiNoteKey& other) const
 	return false;
 }
 
+#define MIDIITEMPROC_MAX_THREADS	4
+
+void MidiEventBuffer::clear()
+{
+	_data.clear();
+	_events.clear();
+}
+
+void MidiEventBuffer::add(const MIDI_event_t* evt)
+{
+	// sysex messages run past midi_message[4], records are kept int aligned
+	int eventSize = (int)sizeof(MIDI_event_t);
+	if(evt->size > (int)sizeof(evt->midi_message))
+		eventSize += evt->size - (int)sizeof(evt->midi_message);
+
+	int offset = (int)_data.size();
+	_data.resize(offset + ((eventSize + 3) & ~3));
+	memcpy(&_data[offset], evt, eventSize);
+	_events.push_back(offset);
+}
+
+void MidiEventBuffer::load(MIDI_eventlist* evts)
+{
+	clear();
+	int pos = 0;
+	while(MIDI_event_t* evt = evts->EnumItems(&pos))
+		add(evt);
+}
+
+void MidiEventBuffer::store(MIDI_eventlist* evts)
+{
+	evts->Empty();
+	for(int i = 0; i < getSize(); i++)
+		evts->AddItem(get(i));
+}
+
+struct MidiEventOffsetLess
+{
+	const vector<unsigned char>* _data;
+	bool operator()(int lhs, int rhs) const
+	{
+		return ((const MIDI_event_t*)&(*_data)[lhs])->frame_offset < ((const MIDI_event_t*)&(*_data)[rhs])->frame_offset;
+	}
+};
+
+void MidiEventBuffer::compact(const vector<bool> &keep)
+{
+	// only record offsets move, event data stays in place
+	int nbKept = 0;
+	for(int i = 0; i < getSize(); i++)
+	{
+		if(keep[i])
+			_events[nbKept++] = _events[i];
+	}
+	_events.resize(nbKept);
+
+	// filters may move events: sorted events are appended by MIDI_eventlist::AddItem
+	MidiEventOffsetLess less = { &_data };
+	stable_sort(_events.begin(), _events.end(), less);
+}
+
 MidiFilterBase::MidiFilterBase()
 {
 }
@@ -330,19 +391,25 @@ void MidiItemProcessor::getSelectedMidiNotes(MediaItem* item, MIDI_eventlist* ev
 	}
 }
 
-void MidiItemProcessor::filterMidiEvents(MIDI_eventlist* evts, int itemLengthSamples)
+void MidiItemProcessor::filterMidiEvents(MidiEventBuffer* evts, int itemLengthSamples, minstd_rand &rng) const
 {
-	for(vector<MidiFilterBase*>::iterator filter = _filters.begin(); filter != _filters.end(); filter++)
-	{
-		int nextPos = 0;
-		int curPos = 0;
+	if(_filters.empty())
+		return;
 
-		while(MIDI_event_t* evt = evts->EnumItems(&nextPos))
+	vector<bool> keep(evts->getSize(), true);
+	for(int i = 0; i < evts->getSize(); i++)
+	{
+		MIDI_event_t* evt = evts->get(i);
+		for(vector<MidiFilterBase*>::const_iterator filter = _filters.begin(); filter != _filters.end(); filter++)
 		{
-			(*filter)->process(evt, evts, curPos, nextPos, itemLengthSamples);
-			curPos = nextPos;
+			if(!(*filter)->filter(evt, itemLengthSamples, rng))
+			{
+				keep[i] = false;
+				break;
+			}
 		}
 	}
+	evts->compact(keep);
 }
 
 void MidiItemProcessor::generateMidiEvents(MIDI_eventlist* evts, int itemLengthSamples)
@@ -351,43 +418,32 @@ void MidiItemProcessor::generateMidiEvents(MIDI_eventlist* evts, int itemLengthS
 		(*generator)->process(evts, itemLengthSamples);
 }
 
-void MidiItemProcessor::processTake(MediaItem_Take* take)
+struct MidiTakeJob
 {
-	MIDI_eventlist* evts = MIDI_eventlist_Create();
+	PCM_source* _source;
+	double _itemLength;
+	int _itemLengthSamples;
+	minstd_rand _rng;
+	MidiEventBuffer _events;
+};
+
+struct MidiTakeBatch
+{
+	const MidiItemProcessor* _processor;
+	vector<MidiTakeJob*>* _jobs;
+	int _thread;
+	int _nbThreads;
+};
 
-	if(getMidiEventsList(take, evts))
+unsigned WINAPI MidiItemProcessor::filterTakesThread(void* pBatch)
+{
+	MidiTakeBatch* batch = (MidiTakeBatch*)pBatch;
+	for(int i = batch->_thread; i < (int)batch->_jobs->size(); i += batch->_nbThreads)
 	{
-		if(PCM_source* source = GetMediaItemTake_Source(take))
-		{
-			MediaItem* item = GetMediaItemTake_Item(take);
-
-			double itemLength = *(double*)GetSetMediaItemInfo(item, "D_LENGTH", NULL);
-			int itemLengthSamples = (int)(MIDIITEMPROC_DEFAULT_SAMPLERATE * itemLength);
-
-//map<MIDI_event_t*, bool> selectedNotes;
-//selectedNotes.clear();
-//MidiItemProcessor::getSelectedMidiNotes(item, evts, selectedNotes);
-
-			filterMidiEvents(evts, itemLengthSamples);
-			generateMidiEvents(evts, itemLengthSamples);
-
-			midi_realtime_write_struct_t midiBlock;
-			midiBlock.global_time       = 0.0;
-			midiBlock.global_item_time  = 0.0;
-			midiBlock.srate             = MIDIITEMPROC_DEFAULT_SAMPLERATE;
-			midiBlock.length            = (int)(midiBlock.srate * itemLength);
-			//midiBlock.overwritemode     = -1;
-			midiBlock.overwritemode		= 1;		// replace flag
-			midiBlock.events            = evts;
-			midiBlock.item_playrate     = 1.0;
-			midiBlock.latency           = 0.0;
-			midiBlock.overwrite_actives = NULL;
-
-			source->Extended(PCM_SOURCE_EXT_ADDMIDIEVENTS, &midiBlock, NULL, NULL);
-		}
-
-		MIDI_eventlist_Destroy(evts);
+		MidiTakeJob* job = (*batch->_jobs)[i];
+		batch->_processor->filterMidiEvents(&job->_events, job->_itemLengthSamples, job->_rng);
 	}
+	return 0;
 }
 
 void MidiItemProcessor::processSelectedMidiTakes(bool bActiveOnly)
@@ -395,6 +451,10 @@ void MidiItemProcessor::processSelectedMidiTakes(bool bActiveOnly)
 	list<MediaItem*> items;
 	getSelectedMediaItems(items);
 
+	list<MediaItem*> updatedItems;
+	vector<MidiTakeJob*> jobs;
+	MIDI_eventlist* evts = MIDI_eventlist_Create();
+
 	for(list<MediaItem*>::iterator item = items.begin(); item != items.end(); item++)
 	{
 		switch(getMidiItemType(*item))
@@ -432,8 +492,78 @@ void MidiItemProcessor::processSelectedMidiTakes(bool bActiveOnly)
 			getMediaItemTakes(*item, takes, true);
 
 		for(list<MediaItem_Take*>::iterator take = takes.begin(); take != takes.end(); take++)
-			processTake(*take);
+		{
+			PCM_source* source = GetMediaItemTake_Source(*take);
+			if(!source || !getMidiEventsList(*take, evts))
+				continue;
+
+			MidiTakeJob* job = new MidiTakeJob;
+			job->_source = source;
+			job->_itemLength = *(double*)GetSetMediaItemInfo(*item, "D_LENGTH", NULL);
+			job->_itemLengthSamples = (int)(MIDIITEMPROC_DEFAULT_SAMPLERATE * job->_itemLength);
+			job->_rng.seed((unsigned int)rand());
+			job->_events.load(evts);
+			evts->Empty();
+			jobs.push_back(job);
+		}
+		updatedItems.push_back(*item);
+	}
+
+	// takes are read and written back on the main thread, only filtering runs on worker threads
+	int nbThreads = min((int)jobs.size(), MIDIITEMPROC_MAX_THREADS);
+	if(nbThreads > 1 && !_filters.empty())
+	{
+		MidiTakeBatch batches[MIDIITEMPROC_MAX_THREADS];
+		HANDLE hThreads[MIDIITEMPROC_MAX_THREADS];
+		for(int i = 0; i < nbThreads; i++)
+		{
+			batches[i]._processor = this;
+			batches[i]._jobs = &jobs;
+			batches[i]._thread = i;
+			batches[i]._nbThreads = nbThreads;
+			hThreads[i] = (HANDLE)_beginthreadex(NULL, 0, filterTakesThread, &batches[i], 0, NULL);
+			if(!hThreads[i])
+				filterTakesThread(&batches[i]); // couldn't start a worker, filter its share here
+		}
+		for(int i = 0; i < nbThreads; i++)
+		{
+			if(hThreads[i])
+			{
+				WaitForSingleObject(hThreads[i], INFINITE);
+				CloseHandle(hThreads[i]);
+			}
+		}
+	}
+	else
+	{
+		for(vector<MidiTakeJob*>::iterator job = jobs.begin(); job != jobs.end(); job++)
+			filterMidiEvents(&(*job)->_events, (*job)->_itemLengthSamples, (*job)->_rng);
+	}
 
+	for(vector<MidiTakeJob*>::iterator job = jobs.begin(); job != jobs.end(); job++)
+	{
+		(*job)->_events.store(evts);
+		generateMidiEvents(evts, (*job)->_itemLengthSamples);
+
+		midi_realtime_write_struct_t midiBlock;
+		midiBlock.global_time       = 0.0;
+		midiBlock.global_item_time  = 0.0;
+		midiBlock.srate             = MIDIITEMPROC_DEFAULT_SAMPLERATE;
+		midiBlock.length            = (int)(midiBlock.srate * (*job)->_itemLength);
+		//midiBlock.overwritemode     = -1;
+		midiBlock.overwritemode		= 1;		// replace flag
+		midiBlock.events            = evts;
+		midiBlock.item_playrate     = 1.0;
+		midiBlock.latency           = 0.0;
+		midiBlock.overwrite_actives = NULL;
+
+		(*job)->_source->Extended(PCM_SOURCE_EXT_ADDMIDIEVENTS, &midiBlock, NULL, NULL);
+		delete *job;
+	}
+	MIDI_eventlist_Destroy(evts);
+
+	for(list<MediaItem*>::iterator item = updatedItems.begin(); item != updatedItems.end(); item++)
+	{
 		UpdateItemInProject(*item);
 //		Undo_OnStateChange_Item(0, _name.c_str(), *item);
 	}
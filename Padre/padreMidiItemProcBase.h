@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <random>
+
 struct MidiNoteKey
 {
 	int _frameOffset;
@@ -40,6 +42,27 @@ struct MidiNoteKey
 	bool operator<(const MidiNoteKey& other) const;
 };
 
+// Contiguous copy of a take's MIDI events (MIDI_event_t records, sysex included)
+// Filters run on it without any REAPER call, so takes can be filtered on worker threads
+class MidiEventBuffer
+{
+	private:
+		vector<unsigned char> _data;
+		vector<int> _events;		// record offsets in _data, in event order
+
+	public:
+		void clear();
+		void add(const MIDI_event_t* evt);
+		void load(MIDI_eventlist* evts);
+		void store(MIDI_eventlist* evts);
+
+		int getSize() const { return (int)_events.size(); }
+		MIDI_event_t* get(int idx) { return (MIDI_event_t*)&_data[_events[idx]]; }
+
+		// Keeps events for which keep[idx] is true, sorted by frame offset
+		void compact(const vector<bool> &keep);
+};
+
 class MidiFilterBase
 {
 	protected:
@@ -48,7 +71,10 @@ class MidiFilterBase
 	public:
 		virtual ~MidiFilterBase();
 
-		virtual void process(MIDI_event_t* evt, MIDI_eventlist* evts, int &curPos, int &nextPos, int itemLengthSamples = -1) = 0;
+		// Modifies evt in place, returns false to delete it
+		// Filters of a MidiItemProcessor are chained per event: one pass over the take whatever the number of filters
+		// rng: random generator of the take being filtered (takes may be filtered on concurrent threads)
+		virtual bool filter(MIDI_event_t* evt, int itemLengthSamples, minstd_rand &rng) = 0;
 };
 
 class MidiGeneratorBase
@@ -77,9 +103,9 @@ class MidiItemProcessor
 		void clearFilters();
 		void clearGenerators();
 
-		void filterMidiEvents(MIDI_eventlist* evts, int itemLengthSamples);
+		void filterMidiEvents(MidiEventBuffer* evts, int itemLengthSamples, minstd_rand &rng) const;
 		void generateMidiEvents(MIDI_eventlist* evts, int itemLengthSamples);
-		void processTake(MediaItem_Take* take);
+		static unsigned WINAPI filterTakesThread(void* pBatch);
 
 	public:
 		static bool getMidiEventsList(MediaItem_Take* take, MIDI_eventlist* evts);
@@ -79,6 +79,8 @@
 #define SNM_CYCLACTION_EXPORT_FILE "%s\\S&M_Cyclactions_export.ini"
 #define SNM_KB_INI_FILE            "%s\\reaper-kb.ini"
 #define SNM_CONSOLE_FILE           "%s\\reaconsole_customcommands.txt"
+#define SNM_RES_INDEX_DIR          "%s\\S&M_Resources_cache"
+#define SNM_RES_INDEX_FILE         "%s\\%08X%08X.idx"
 #define SNM_REAPER_EXE_FILE        "%s\\reaper.exe"
 #define SNM_FONT_NAME              "MS Shell Dlg"
 #define SNM_FONT_HEIGHT            14
@@ -98,6 +100,8 @@
 #define SNM_CYCLACTION_EXPORT_FILE "%s/S&M_Cyclactions_export.ini"
 #define SNM_KB_INI_FILE            "%s/reaper-kb.ini"
 #define SNM_CONSOLE_FILE           "%s/reaconsole_customcommands.txt"
+#define SNM_RES_INDEX_DIR          "%s/S&M_Resources_cache"
+#define SNM_RES_INDEX_FILE         "%s/%08X%08X.idx"
 #ifdef __LP64__
 #define SNM_REAPER_EXE_FILE        "%s/REAPER64.app"
 #else
@@ -201,7 +205,7 @@ vezn/Q+t/AIQiCv/Q4iRxAAAAABJRU5ErkJggg==\n"
 // Misc global/common classes, vars, etc.
 ///////////////////////////////////////////////////////////////////////////////
 
-extern int g_SNM_Beta, g_SNM_LearnPitchAndNormOSC, g_SNM_MediaFlags, g_SNM_ToolbarRefreshFreq;
+extern int g_SNM_Beta, g_SNM_LearnPitchAndNormOSC, g_SNM_FXChainsProfile, g_SNM_MediaFlags, g_SNM_ToolbarRefreshFreq;
 extern WDL_FastString g_SNM_IniFn, g_SNM_CyclIniFn, g_SNM_DiffToolFn;
 extern bool g_SNM_ToolbarRefresh, g_SNM_ExtSubmenu;
 
@@ -52,29 +52,15 @@ bool g_cueBussDisableSave = false;
 // _destTr: destination track
 // _type:   reaper's type
 //          0=Post-Fader (Post-Pan), 1=Pre-FX, 2=deprecated, 3=Pre-Fader (Post-FX)
-// _p:      for multi-patch optimization, current destination track's SNM_SendPatcher
-bool AddReceiveWithVolPan(MediaTrack * _srcTr, MediaTrack * _destTr, int _type, SNM_SendPatcher* _p)
+// _batch:  routing transaction, receives are added when it is committed
+void AddReceiveWithVolPan(MediaTrack * _srcTr, MediaTrack * _destTr, int _type, SNM_RoutingBatch* _batch)
 {
-	bool update = false;
-	char vol[32] = "1.00000000000000";
-	char pan[32] = "0.00000000000000";
-
 	// if pre-fader, then re-copy track vol/pan
 	if (_type == 3)
-	{
-		SNM_ChunkParserPatcher p(_srcTr, false);
-		p.SetWantsMinimalState(true);
-		if (p.Parse(SNM_GET_CHUNK_CHAR, 1, "TRACK", "VOLPAN", 0, 1, vol, NULL, "MUTESOLO") > 0 &&
-			p.Parse(SNM_GET_CHUNK_CHAR, 1, "TRACK", "VOLPAN", 0, 2, pan, NULL, "MUTESOLO") > 0)
-		{
-			update = _p->AddReceive(_srcTr, _type, vol, pan) > 0;
-		}
-	}
-
+		_batch->AddReceive(_srcTr, _destTr, _type, GetMediaTrackInfo_Value(_srcTr, "D_VOL"), GetMediaTrackInfo_Value(_srcTr, "D_PAN"));
 	// default volume
-	if (!update && snprintfStrict(vol, sizeof(vol), "%.14f", *ConfigVar<double>("defsendvol")) > 0)
-		update = _p->AddReceive(_srcTr, _type, vol, pan) > 0;
-	return update;
+	else
+		_batch->AddReceive(_srcTr, _destTr, _type, *ConfigVar<double>("defsendvol"), 0.0);
 }
 
 // _type: 0=Post-Fader (Post-Pan), 1=Pre-FX, 2=deprecated, 3=Pre-Fader (Post-FX)
@@ -99,6 +85,7 @@ bool CueBuss(const char* _undoMsg, const char* _busName, int _type, bool _showRo
 	bool updated = false;
 	MediaTrack * cueTr = NULL;
 	SNM_SendPatcher* p = NULL;
+	SNM_RoutingBatch rcvs; // all receives in one go, once the cue buss chunk is committed
 	for (int i=1; i <= GetNumTracks(); i++) // skip master
 	{
 		MediaTrack* tr = CSurf_TrackFromID(i, false);
@@ -127,7 +114,7 @@ bool CueBuss(const char* _undoMsg, const char* _busName, int _type, bool _showRo
 
 			// add a send
 			if (cueTr && p && tr != cueTr)
-				AddReceiveWithVolPan(tr, cueTr, _type, p);
+				AddReceiveWithVolPan(tr, cueTr, _type, &rcvs);
 		}
 	}
 
@@ -181,6 +168,7 @@ bool CueBuss(const char* _undoMsg, const char* _busName, int _type, bool _showRo
 
 		p->Commit();
 		delete p;
+		updated |= rcvs.Commit();
 
 		if (updated)
 		{
@@ -229,8 +229,8 @@ bool IsCondStatement(const char* _cmd) {
 // _cmdStr:   custom id to explode
 // _cmds:     output list of exploded commands
 //            it is up to the caller to unalloc items!
-// _macros:   to optimize accesses to reaper-kb.ini, 
-//            if NULL, macros won't be exploded, no file access
+// _macros:   if NULL, macros won't be exploded, no file access
+//            (reaper-kb.ini is cached, see LoadKbIni())
 // _consoles: to optimize accesses to reaconsole_customcommands.txt
 //
 // return values:
@@ -281,15 +281,10 @@ int ExplodeMacro(int _section, const char* _cmdStr,
 	 // want macro explosion?
 	if (_macros)
 	{
-		bool loadOk = true;
-		if (!_macros->GetSize()) {
-			loadOk = LoadKbIni(_macros);
-			_macros->Add(new WDL_FastString);
-		}
-		if (!loadOk) return -1;
+		if (!LoadKbIni()) return -1;
 
 		WDL_PtrList_DeleteOnDestroy<WDL_FastString> subCmds;
-		int r = GetMacroOrScript(_cmdStr, SNM_GetActionSectionUniqueId(_section), _macros, &subCmds);
+		int r = GetMacroOrScript(_cmdStr, SNM_GetActionSectionUniqueId(_section), &subCmds);
 		if (r==0)
 		{
 			return -1;
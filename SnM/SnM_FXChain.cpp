@@ -41,6 +41,45 @@
 
 WDL_FastString g_fXChainClipboard;
 
+
+// per-target timings of FX chain paste/set, printed in the console
+// when FXChainsProfile=1 in the [General] section of S&M.ini
+class SNM_FXChainTimer
+{
+public:
+	SNM_FXChainTimer(const char* _title) : m_title(_title), m_count(0), m_total(0.0), m_start(0.0) {}
+	~SNM_FXChainTimer()
+	{
+		if (m_count)
+		{
+			WDL_FastString header;
+			header.SetFormatted(256, "%s: %d target(s), %.2f ms\n", m_title, m_count, m_total * 1000.0);
+			m_report.Insert(header.Get(), 0);
+			ShowConsoleMsg(m_report.Get());
+		}
+	}
+	void Start() {
+		if (g_SNM_FXChainsProfile) m_start = time_precise();
+	}
+	// _native: true if the target was updated via the API rather than via its state chunk
+	void Stop(const char* _target, int _idx, bool _native)
+	{
+		if (g_SNM_FXChainsProfile)
+		{
+			double t = time_precise() - m_start;
+			m_report.AppendFormatted(256, "  %8.2f ms  %s %d%s\n", t * 1000.0, _target, _idx, _native ? " (native)" : "");
+			m_total += t;
+			m_count++;
+		}
+	}
+
+private:
+	const char* m_title;
+	WDL_FastString m_report;
+	int m_count;
+	double m_total, m_start;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // Take FX chains
 ///////////////////////////////////////////////////////////////////////////////
@@ -96,84 +135,210 @@ int CopyTakeFXChain(WDL_FastString* _fxChain, int _startSelItem)
 	return -1;
 }
 
-void PasteTakeFXChain(const char* _title, WDL_FastString* _chain, bool _activeOnly)
+// native API copy of _count FX of _srcTk (from _srcFirst) at the end of _destTk's FX chain
+// return false if some FX could not be copied (_destTk is left untouched then)
+static bool CopyTakeFXRange(MediaItem_Take* _srcTk, int _srcFirst, int _count, MediaItem_Take* _destTk)
 {
-	bool updated = false;
-	if (_chain && _chain->GetLength())
-	{
-		for (int i = 1; i <= GetNumTracks(); i++) // skip master
-		{
-			MediaTrack* tr = CSurf_TrackFromID(i, false);
-			for (int j = 0; tr && j < GetTrackNumMediaItems(tr); j++)
-			{
-				MediaItem* item = GetTrackMediaItem(tr,j);
-				if (item && *(bool*)GetSetMediaItemInfo(item,"B_UISEL",NULL))
-				{
-					SNM_TakeParserPatcher p(item, CountTakes(item));
-					int tkIdx = (_activeOnly ? *(int*)GetSetMediaItemInfo(item, "I_CURTAKE", NULL) : 0);
-					bool done = false;
-					while (!done && tkIdx >= 0)
-					{
-						WDL_FastString takeChunk;
-						int tkPos, tklen;
-						if (p.GetTakeChunk(tkIdx, &takeChunk, &tkPos, &tklen)) 
-						{
-							SNM_ChunkParserPatcher ptk(&takeChunk, false);
+	const int destFirst = TakeFX_GetCount(_destTk);
+	for (int i=0; i < _count; i++)
+		TakeFX_CopyToTake(_srcTk, _srcFirst+i, _destTk, destFirst+i, false);
+	if (TakeFX_GetCount(_destTk) == destFirst + _count)
+		return true;
+	for (int i=TakeFX_GetCount(_destTk)-1; i >= destFirst; i--)
+		TakeFX_Delete(_destTk, i);
+	return false;
+}
 
-							// fx chain exists for this take?
-							// note: eolTakeFx is '\n' position + 1
-							int eolTkFx = ptk.Parse(SNM_GET_SUBCHUNK_OR_LINE_EOL, 1, "TAKEFX", "<TAKEFX", 0);
+static void RemoveAllTakeFX(MediaItem_Take* _tk)
+{
+	for (int i=TakeFX_GetCount(_tk)-1; i >= 0; i--)
+		TakeFX_Delete(_tk, i);
+}
 
-							// paste fx chain (just before the end of the current TAKEFX)
-							if (eolTkFx > 0) {
-								ptk.GetChunk()->Insert(_chain->Get(), eolTkFx-2); //-2: before ">\n"
-							}
-							// set/create fx chain (after SOURCE)
-							else 
-							{
-								int eolSrc = ptk.Parse(SNM_GET_SUBCHUNK_OR_LINE_EOL, 1, "SOURCE", "<SOURCE", 0);
-								if (eolSrc > 0) {
-									WDL_FastString newTakeFx;
-									MakeChunkTakeFX(&newTakeFx, _chain);
-									ptk.GetChunk()->Insert(newTakeFx.Get(), eolSrc);
-								}
-							}
-							updated = p.ReplaceTake(tkPos, tklen, ptk.GetChunk());
-						}
-						else done = true;
+// TAKEFX_NCH (take FX channels) has no API equivalent: such chains go through item state chunks
+static bool CanCopyTakeFXNatively(WDL_FastString* _chain) {
+	return !_chain || !strstr(_chain->Get(), "TAKEFX_NCH");
+}
 
-						if (_activeOnly) done = true;
-						else tkIdx++;
-					}
-				}
+static void GetTargetTakes(MediaItem* _item, bool _activeOnly, WDL_PtrList<MediaItem_Take>* _takesOut)
+{
+	if (_activeOnly) {
+		if (MediaItem_Take* tk = GetActiveTake(_item))
+			_takesOut->Add(tk);
+	}
+	else {
+		for (int i=0; i < CountTakes(_item); i++)
+			if (MediaItem_Take* tk = GetTake(_item, i))
+				_takesOut->Add(tk);
+	}
+}
+
+// native API update of the takes of _item, see ApplyTakeFXChain()
+// return false if some FX could not be copied (takes are left untouched then)
+static bool ApplyTakeFXNatively(MediaItem* _item, bool _activeOnly, bool _set, MediaItem_Take* _srcTk, int _srcFirst, int _srcCount, bool* _updated)
+{
+	WDL_PtrList<MediaItem_Take> takes;
+	GetTargetTakes(_item, _activeOnly, &takes);
+
+	// clear
+	if (!_srcTk)
+	{
+		for (int i=0; i < takes.GetSize(); i++)
+		{
+			*_updated |= (TakeFX_GetCount(takes.Get(i)) > 0);
+			RemoveAllTakeFX(takes.Get(i));
+		}
+		return true;
+	}
+
+	// paste: all or nothing, roll back the takes already done if a copy fails
+	if (!_set)
+	{
+		for (int i=0; i < takes.GetSize(); i++)
+		{
+			if (!CopyTakeFXRange(_srcTk, _srcFirst, _srcCount, takes.Get(i)))
+			{
+				while (--i >= 0)
+					for (int j=0; j < _srcCount; j++)
+						TakeFX_Delete(takes.Get(i), TakeFX_GetCount(takes.Get(i))-1);
+				return false;
 			}
 		}
+		*_updated |= (takes.GetSize() > 0);
+		return true;
 	}
-	if (updated)
-		Undo_OnStateChangeEx2(NULL, _title, UNDO_STATE_ALL, -1);
+
+	// set: takes already done are set again by the state chunk if a copy fails
+	for (int i=0; i < takes.GetSize(); i++)
+	{
+		MediaItem_Take* tk = takes.Get(i);
+		const int prevCount = TakeFX_GetCount(tk);
+		if (!CopyTakeFXRange(_srcTk, _srcFirst, _srcCount, tk))
+			return false;
+		for (int j=prevCount-1; j >= 0; j--)
+			TakeFX_Delete(tk, j);
+		*_updated = true;
+	}
+	return true;
 }
 
-// _chain: NULL clears the FX chain
-void SetTakeFXChain(const char* _title, WDL_FastString* _chain, bool _activeOnly)
+// _set=false: paste (insert at the end of the current FX chains)
+// _set=true: set/replace, _chain==NULL clears the FX chains
+// the chain is parsed into the 1st selected item's state chunk only, takes of
+// other selected items get a native API copy of these FX (their state chunks,
+// possibly huge, are neither read nor rewritten) unless the chain sets TAKEFX_NCH
+static bool ApplyTakeFXChain(const char* _title, WDL_FastString* _chain, bool _activeOnly, bool _set)
 {
 	bool updated = false;
+	const bool native = CanCopyTakeFXNatively(_chain);
+	MediaItem_Take* srcTk = NULL; // take holding the freshly applied FX
+	int srcFirst = 0, srcCount = 0;
+
+	SNM_FXChainTimer timer(_title);
+	PreventUIRefresh(1);
 	for (int i = 1; i <= GetNumTracks(); i++) // skip master
 	{
 		MediaTrack* tr = CSurf_TrackFromID(i, false);
 		for (int j = 0; tr && j < GetTrackNumMediaItems(tr); j++)
 		{
 			MediaItem* item = GetTrackMediaItem(tr,j);
-			if (item && *(bool*)GetSetMediaItemInfo(item,"B_UISEL",NULL))
+			if (!item || !*(bool*)GetSetMediaItemInfo(item,"B_UISEL",NULL))
+				continue;
+
+			timer.Start();
+			if (native && (!_chain || srcTk) && ApplyTakeFXNatively(item, _activeOnly, _set, srcTk, srcFirst, srcCount, &updated))
+			{
+				timer.Stop("item", j+1, true);
+				continue;
+			}
+
+			// the meat
+			MediaItem_Take* firstTk = NULL;
+			int nbFx = 0;
+			{
+				WDL_PtrList<MediaItem_Take> takes;
+				GetTargetTakes(item, _activeOnly, &takes);
+				if ((firstTk = takes.Get(0)))
+					nbFx = _set ? 0 : TakeFX_GetCount(firstTk);
+			}
+
+			if (_set)
 			{
 				SNM_FXChainTakePatcher p(item);
 				updated |= p.SetFXChain(_chain, _activeOnly);
+			} // commit
+			else
+			{
+				SNM_TakeParserPatcher p(item, CountTakes(item));
+				int tkIdx = (_activeOnly ? *(int*)GetSetMediaItemInfo(item, "I_CURTAKE", NULL) : 0);
+				bool done = false;
+				while (!done && tkIdx >= 0)
+				{
+					WDL_FastString takeChunk;
+					int tkPos, tklen;
+					if (p.GetTakeChunk(tkIdx, &takeChunk, &tkPos, &tklen)) 
+					{
+						SNM_ChunkParserPatcher ptk(&takeChunk, false);
+
+						// fx chain exists for this take?
+						// note: eolTakeFx is '\n' position + 1
+						int eolTkFx = ptk.Parse(SNM_GET_SUBCHUNK_OR_LINE_EOL, 1, "TAKEFX", "<TAKEFX", 0);
+
+						// paste fx chain (just before the end of the current TAKEFX)
+						if (eolTkFx > 0) {
+							ptk.GetChunk()->Insert(_chain->Get(), eolTkFx-2); //-2: before ">\n"
+						}
+						// set/create fx chain (after SOURCE)
+						else 
+						{
+							int eolSrc = ptk.Parse(SNM_GET_SUBCHUNK_OR_LINE_EOL, 1, "SOURCE", "<SOURCE", 0);
+							if (eolSrc > 0) {
+								WDL_FastString newTakeFx;
+								MakeChunkTakeFX(&newTakeFx, _chain);
+								ptk.GetChunk()->Insert(newTakeFx.Get(), eolSrc);
+							}
+						}
+						updated |= p.ReplaceTake(tkPos, tklen, ptk.GetChunk());
+					}
+					else done = true;
+
+					if (_activeOnly) done = true;
+					else tkIdx++;
+				}
+			} // commit
+			timer.Stop("item", j+1, false);
+
+			// take pointers are kept by the state chunk update, refetched anyway
+			if (native && _chain && !srcTk && firstTk)
+			{
+				WDL_PtrList<MediaItem_Take> takes;
+				GetTargetTakes(item, _activeOnly, &takes);
+				if (MediaItem_Take* tk = takes.Get(0))
+				{
+					srcFirst = nbFx;
+					srcCount = TakeFX_GetCount(tk) - nbFx;
+					if (srcCount > 0)
+						srcTk = tk;
+				}
 			}
 		}
 	}
-	if (updated)
-		Undo_OnStateChangeEx2(NULL, _title, UNDO_STATE_ALL, -1);
+	PreventUIRefresh(-1);
+	return updated;
 }
 
+void PasteTakeFXChain(const char* _title, WDL_FastString* _chain, bool _activeOnly)
+{
+	if (_chain && _chain->GetLength() && ApplyTakeFXChain(_title, _chain, _activeOnly, false))
+		Undo_OnStateChangeEx2(NULL, _title, UNDO_STATE_ITEMS, -1);
+}
+
+// _chain: NULL clears the FX chain
+void SetTakeFXChain(const char* _title, WDL_FastString* _chain, bool _activeOnly)
+{
+	if (ApplyTakeFXChain(_title, _chain, _activeOnly, true))
+		Undo_OnStateChangeEx2(NULL, _title, UNDO_STATE_ITEMS, -1);
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 // Track FX chains
@@ -200,64 +365,135 @@ bool SetTrackChannelsForFXChain(MediaTrack* _tr, WDL_FastString* _chain)
 	return false;
 }
 
-void PasteTrackFXChain(const char* _title, WDL_FastString* _chain, bool _inputFX)
-{
-	bool updated = false;
-	if (_chain && _chain->GetLength())
-	{
-		for (int i=0; i <= GetNumTracks(); i++) // incl. master
-		{
-			MediaTrack* tr = CSurf_TrackFromID(i, false);
-			if (tr && *(int*)GetSetMediaTrackInfo(tr, "I_SELECTED", NULL))
-			{
-				// (try to) set track channels
-				updated |= SetTrackChannelsForFXChain(tr, _chain);
+static int GetTrackFXCount(MediaTrack* _tr, bool _inputFX) {
+	return _inputFX ? TrackFX_GetRecCount(_tr) : TrackFX_GetCount(_tr);
+}
 
-				// the meat
-				bool patch = false;
-				SNM_FXChainTrackPatcher p(tr);
-				WDL_FastString currentFXChain;
-				int pos = p.GetSubChunk(_inputFX ? "FXCHAIN_REC" : "FXCHAIN", 2, 0, &currentFXChain, "<ITEM");
+// native API copy of _count FX of _srcTr (from _srcFirst) at the end of _destTr's FX chain
+// i.e. only the FX are rewritten, not the whole track state (items, envelopes, etc..)
+// return false if some FX could not be copied (_destTr is left untouched then)
+static bool CopyTrackFXRange(MediaTrack* _srcTr, int _srcFirst, int _count, MediaTrack* _destTr, bool _inputFX)
+{
+	const int flag = _inputFX ? 0x1000000 : 0;
+	const int destFirst = GetTrackFXCount(_destTr, _inputFX);
+	for (int i=0; i < _count; i++)
+		TrackFX_CopyToTrack(_srcTr, flag | (_srcFirst+i), _destTr, flag | (destFirst+i), false);
+	if (GetTrackFXCount(_destTr, _inputFX) == destFirst + _count)
+		return true;
+	for (int i=GetTrackFXCount(_destTr, _inputFX)-1; i >= destFirst; i--)
+		TrackFX_Delete(_destTr, flag | i);
+	return false;
+}
 
-				// paste (well.. insert at the end of the current FX chain)
-				if (pos >= 0) 
-				{
-					patch = true;
-					p.GetChunk()->Insert(_chain->Get(), pos + currentFXChain.GetLength() - 2); // -2: before ">\n"
-					p.IncUpdates();
-				}
-				// create fx chain
-				else 
-					patch = p.SetFXChain(_chain, _inputFX);
+static void RemoveAllTrackFX(MediaTrack* _tr, bool _inputFX)
+{
+	const int flag = _inputFX ? 0x1000000 : 0;
+	for (int i=GetTrackFXCount(_tr, _inputFX)-1; i >= 0; i--)
+		TrackFX_Delete(_tr, flag | i);
+}
 
-				updated |= patch;
-			}
-		}
-	}
-	if (updated)
-		Undo_OnStateChangeEx2(NULL, _title, UNDO_STATE_ALL, -1);
+// master's input FX are the monitoring FX: not part of its state chunk, keep the chunk path
+static bool CanCopyTrackFXNatively(int _trIdx, bool _inputFX) {
+	return (_trIdx > 0 || !_inputFX);
 }
 
-// _chain: NULL to clear
-void SetTrackFXChain(const char* _title, WDL_FastString* _chain, bool _inputFX)
+// _set=false: paste (insert at the end of the current FX chain)
+// _set=true: set/replace, _chain==NULL clears the FX chain
+// the chain is parsed into the 1st selected track's state chunk only, other
+// selected tracks get a native API copy of these FX (much faster with big
+// projects: their state chunks, possibly huge, are neither read nor rewritten)
+static bool ApplyTrackFXChain(const char* _title, WDL_FastString* _chain, bool _inputFX, bool _set)
 {
 	bool updated = false;
+	MediaTrack* srcTr = NULL; // track holding the freshly applied FX
+	int srcFirst = 0, srcCount = 0;
+
+	SNM_FXChainTimer timer(_title);
+	PreventUIRefresh(1);
 	for (int i=0; i <= GetNumTracks(); i++) // incl. master
 	{
 		MediaTrack* tr = CSurf_TrackFromID(i, false);
 		if (tr && *(int*)GetSetMediaTrackInfo(tr, "I_SELECTED", NULL))
 		{
+			timer.Start();
+
 			// (try to) set track channels
 			updated |= SetTrackChannelsForFXChain(tr, _chain);
 
+			if (CanCopyTrackFXNatively(i, _inputFX))
+			{
+				// clear
+				if (!_chain)
+				{
+					updated |= (GetTrackFXCount(tr, _inputFX) > 0);
+					RemoveAllTrackFX(tr, _inputFX);
+					timer.Stop("track", i, true);
+					continue;
+				}
+				// copy FX applied to a previous track
+				if (srcTr)
+				{
+					if (_set) RemoveAllTrackFX(tr, _inputFX);
+					if (CopyTrackFXRange(srcTr, srcFirst, srcCount, tr, _inputFX)) {
+						updated = true;
+						timer.Stop("track", i, true);
+						continue;
+					}
+					// could not copy all FX (should not happen): back to the state chunk
+				}
+			}
+
 			// the meat
-			SNM_FXChainTrackPatcher p(tr);
-			bool patch = p.SetFXChain(_chain, _inputFX);
-			updated |= patch;
+			const int nbFx = _set ? 0 : GetTrackFXCount(tr, _inputFX);
+			{
+				SNM_FXChainTrackPatcher p(tr);
+				if (_set)
+				{
+					updated |= p.SetFXChain(_chain, _inputFX);
+				}
+				else
+				{
+					WDL_FastString currentFXChain;
+					int pos = p.GetSubChunk(_inputFX ? "FXCHAIN_REC" : "FXCHAIN", 2, 0, &currentFXChain, "<ITEM");
+
+					// paste (well.. insert at the end of the current FX chain)
+					if (pos >= 0) 
+					{
+						p.GetChunk()->Insert(_chain->Get(), pos + currentFXChain.GetLength() - 2); // -2: before ">\n"
+						p.IncUpdates();
+						updated = true;
+					}
+					// create fx chain
+					else
+						updated |= p.SetFXChain(_chain, _inputFX);
+				}
+			} // commit
+			timer.Stop("track", i, false);
+
+			if (_chain && !srcTr && CanCopyTrackFXNatively(i, _inputFX))
+			{
+				srcFirst = nbFx;
+				srcCount = GetTrackFXCount(tr, _inputFX) - nbFx;
+				if (srcCount > 0)
+					srcTr = tr;
+			}
 		}
 	}
-	if (updated)
-		Undo_OnStateChangeEx2(NULL, _title, UNDO_STATE_ALL, -1);
+	PreventUIRefresh(-1);
+	return updated;
+}
+
+void PasteTrackFXChain(const char* _title, WDL_FastString* _chain, bool _inputFX)
+{
+	if (_chain && _chain->GetLength() && ApplyTrackFXChain(_title, _chain, _inputFX, false))
+		Undo_OnStateChangeEx2(NULL, _title, UNDO_STATE_FX|UNDO_STATE_TRACKCFG, -1);
+}
+
+// _chain: NULL to clear
+void SetTrackFXChain(const char* _title, WDL_FastString* _chain, bool _inputFX)
+{
+	if (ApplyTrackFXChain(_title, _chain, _inputFX, true))
+		Undo_OnStateChangeEx2(NULL, _title, UNDO_STATE_FX|UNDO_STATE_TRACKCFG, -1);
 }
 
 // returns the first copied track idx (1-based, 0 = master)
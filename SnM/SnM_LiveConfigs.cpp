@@ -145,6 +145,8 @@ SNM_WindowManager<LiveConfigsWnd> g_lcWndMgr(LIVECFG_WND_ID);
 SNM_MultiWindowManager<LiveConfigMonitorWnd> g_monWndsMgr(LIVECFG_MON_WND_ID);
 
 SWSProjConfig<WDL_PtrList_DOD<LiveConfig> > g_liveConfigs;
+// marked dirty by edits (see LiveConfigUndo()), config switches and track list changes
+static SWSProjExtState g_lcState("Live Configs");
 WDL_PtrList<LiveConfigItem> g_clipboardConfigs; // for cut/copy/paste
 int g_configId = 0; // the current *displayed/edited* config id
 
@@ -153,6 +155,14 @@ char g_lcBigFontName[64] = SNM_DYN_FONT_NAME;
 int* g_reaPref_fadeLen = NULL;
 
 
+// live config edits end here, so that the next undo point serializes them
+static void LiveConfigUndo(int _flags)
+{
+	g_lcState.SetDirty();
+	Undo_OnStateChangeEx2(NULL, UNDO_STR, _flags, -1);
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Presets helpers
 // Format of v1 presets (deprecated): 
@@ -713,7 +723,7 @@ void LiveConfigView::SetItemText(SWS_ListItem* _item, int _iCol, const char* _st
 				pItem->m_desc.Set(_str);
 				pItem->m_desc.Ellipsize(32,32);
 				Update();
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+				LiveConfigUndo(UNDO_STATE_MISCCFG);
 				break;
 			case COL_ACTION_ON:
 			case COL_ACTION_OFF:
@@ -729,7 +739,7 @@ void LiveConfigView::SetItemText(SWS_ListItem* _item, int _iCol, const char* _st
 				else
 					pItem->m_offAction.Set(_str);
 				Update();
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+				LiveConfigUndo(UNDO_STATE_MISCCFG);
 				break;
 		}
 	}
@@ -981,7 +991,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 				}
 
 				int nbSends = lc->SetInputTrack(inputTr, true); // always obey (ignore lc->m_autoSends)
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_ALL, -1);
+				LiveConfigUndo(UNDO_STATE_ALL);
 
 				Update();
 
@@ -1027,31 +1037,31 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 							break;
 					}
 			lc->m_options ^= 1;
-			Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+			LiveConfigUndo(UNDO_STATE_MISCCFG);
 			break;
 		case SELSCROLL_MSG:
 			lc->m_options ^= 64;
-			Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+			LiveConfigUndo(UNDO_STATE_MISCCFG);
 			break;
 		case OFFLINE_OTHERS_MSG:
 			lc->m_options ^= 2;
-			Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+			LiveConfigUndo(UNDO_STATE_MISCCFG);
 			break;
 		case DISARM_OTHERS_MSG:
 			lc->m_options ^= 4;
-			Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+			LiveConfigUndo(UNDO_STATE_MISCCFG);
 			break;
 		case CC123_MSG:
 			lc->m_options ^= 8;
-			Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+			LiveConfigUndo(UNDO_STATE_MISCCFG);
 			break;
 		case IGNORE_EMPTY_MSG:
 			lc->m_options ^= 16;
-			Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+			LiveConfigUndo(UNDO_STATE_MISCCFG);
 			break;
 		case AUTOSENDS_MSG:
 			lc->m_options ^= 32;
-			Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+			LiveConfigUndo(UNDO_STATE_MISCCFG);
 			break;
 
 		case INS_UP_MSG:
@@ -1086,7 +1096,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 				if (updt)
 				{
 					Update(); // preserve list view selection
-					Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_ALL, -1); // UNDO_STATE_ALL: possible routing updates above
+					LiveConfigUndo(UNDO_STATE_ALL); // UNDO_STATE_ALL: possible routing updates above
 				}
 			}
 			break;
@@ -1122,7 +1132,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 
 			if (updt) {
 				Update();
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_ALL, -1); // UNDO_STATE_ALL: possible routing updates above
+				LiveConfigUndo(UNDO_STATE_ALL); // UNDO_STATE_ALL: possible routing updates above
 			}
 			break;
 		}
@@ -1139,7 +1149,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 			}
 			if (updt) {
 				Update();
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+				LiveConfigUndo(UNDO_STATE_MISCCFG);
 			}
 			break;
 		}
@@ -1172,7 +1182,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 			}
 			if (updt) {
 				Update();
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+				LiveConfigUndo(UNDO_STATE_MISCCFG);
 			}
 			break;
 		}
@@ -1186,7 +1196,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 			}
 			if (updt) {
 				Update();
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+				LiveConfigUndo(UNDO_STATE_MISCCFG);
 			}
 			break;
 		}
@@ -1209,7 +1219,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 			}
 			if (updt) {
 				Update();
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+				LiveConfigUndo(UNDO_STATE_MISCCFG);
 			}
 			break;
 		}
@@ -1224,7 +1234,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 			}
 			if (updt) {
 				Update();
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+				LiveConfigUndo(UNDO_STATE_MISCCFG);
 			}
 			break;
 		}
@@ -1251,7 +1261,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 				}
 				if (updt) {
 					Update();
-					Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+					LiveConfigUndo(UNDO_STATE_MISCCFG);
 				}
 			}
 			break;
@@ -1271,7 +1281,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 			}
 			if (updt) {
 				Update();
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+				LiveConfigUndo(UNDO_STATE_MISCCFG);
 			}
 			break;
 		}
@@ -1291,7 +1301,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 			PreventUIRefresh(-1);
 			if (updt) {
 				Update();
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_ALL, -1);  // UNDO_STATE_ALL: possible routing updates above
+				LiveConfigUndo(UNDO_STATE_ALL);  // UNDO_STATE_ALL: possible routing updates above
 			}
 			break;
 		}
@@ -1306,7 +1316,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 			}
 			if (updt) {
 				Update();
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+				LiveConfigUndo(UNDO_STATE_MISCCFG);
 			}
 			break;
 		}
@@ -1349,7 +1359,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 			if (HIWORD(wParam)==CBN_SELCHANGE)
 			{
 				lc->SetInputTrack(m_cbInputTr.GetCurSel() ? CSurf_TrackFromID(m_cbInputTr.GetCurSel(), false) : NULL, !!(lc->m_options&32));
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_ALL, -1); // UNDO_STATE_ALL: SetInputTrack() might update the project
+				LiveConfigUndo(UNDO_STATE_ALL); // UNDO_STATE_ALL: SetInputTrack() might update the project
 				Update();
 			}
 			break;
@@ -1388,7 +1398,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 
 				if (updt) {
 					Update();
-					Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_ALL, -1); // UNDO_STATE_ALL: possible routing updates above
+					LiveConfigUndo(UNDO_STATE_ALL); // UNDO_STATE_ALL: possible routing updates above
 				}
 			}
 			else if (item && LOWORD(wParam)>=LEARN_PRESETS_START_MSG && LOWORD(wParam)<=LEARN_PRESETS_END_MSG) 
@@ -1402,7 +1412,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 					item->m_fxChain.Set("");
 					item->m_trTemplate.Set("");
 					Update();
-					Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+					LiveConfigUndo(UNDO_STATE_MISCCFG);
 				}
 				break;
 			}
@@ -1414,7 +1424,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 					item->m_fxChain.Set("");
 					item->m_trTemplate.Set("");
 					Update();
-					Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+					LiveConfigUndo(UNDO_STATE_MISCCFG);
 				}
 			}
 			else if (LOWORD(wParam) >= OSC_START_MSG && LOWORD(wParam) <= OSC_END_MSG) 
@@ -1430,7 +1440,7 @@ void LiveConfigsWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 					APPLY_MASK|PRELOAD_MASK,
 					APPLY_MASK|PRELOAD_MASK,
 					2); // osc only
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+				LiveConfigUndo(UNDO_STATE_MISCCFG);
 			}
 			else
 				Main_OnCommand((int)wParam, (int)lParam);
@@ -1447,11 +1457,13 @@ INT_PTR LiveConfigsWnd::OnUnhandledMsg(UINT uMsg, WPARAM wParam, LPARAM lParam)
 				case KNBID_CC_DELAY:
 					lc->m_ccDelay = m_knobCC.GetSliderPosition();
 					m_vwndCC.SetValue(lc->m_ccDelay);
+					g_lcState.SetDirty();
 					ScheduledJob::Schedule(new UndoJob(UNDO_STR, UNDO_STATE_MISCCFG));
 					break;
 				case KNBID_FADE:
 					lc->m_fade = m_knobFade.GetSliderPosition();
 					m_vwndFade.SetValue(lc->m_fade);
+					g_lcState.SetDirty();
 					ScheduledJob::Schedule(new UndoJob(UNDO_STR, UNDO_STATE_MISCCFG));
 					break;
 			}
@@ -1881,7 +1893,7 @@ bool LiveConfigsWnd::Insert(int _dir)
 				item = ccConfs->Get(delItemIdx);
 				ccConfs->Delete(delItemIdx, false); // do not delete now (still displayed..)
 				Update();
-				Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+				LiveConfigUndo(UNDO_STATE_MISCCFG);
 				DELETE_NULL(item); // ok to del now that the update is done
 				SelectByCCValue(g_configId, _dir>0 ? pos : pos-1);
 				return true;
@@ -1993,7 +2005,7 @@ static bool ProcessExtensionLine(const char *line, ProjectStateContext *ctx, boo
 	return false;
 }
 
-static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct project_config_extension_t *reg)
+static void SerializeLiveConfigs(ProjectStateContext *ctx)
 {
 	GUID g; 
 	char strId[128] = "";
@@ -2063,8 +2075,14 @@ static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct pr
 	}
 }
 
+static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct project_config_extension_t *reg)
+{
+	g_lcState.Save(ctx, isUndo, SerializeLiveConfigs);
+}
+
 static void BeginLoadProjectState(bool isUndo, struct project_config_extension_t *reg)
 {
+	g_lcState.BeginLoad(isUndo);
 	g_liveConfigs.Cleanup();
 
 	while (g_liveConfigs.Get()->GetSize() < SNM_LIVECFG_NB_CONFIGS)
@@ -2091,6 +2109,7 @@ void LiveConfigsSetTrackTitle() {
 // ScheduledJob because of multi-notifs
 void LiveConfigsTrackListChange()
 {
+	g_lcState.SetDirty(); // configs of removed tracks, input track
 	// check consistency of all live configs
 	for (int i=0; i<g_liveConfigs.Get()->GetSize(); i++)
 	{
@@ -2468,6 +2487,7 @@ void ApplyLiveConfigJob::Init(ScheduledJob* _replacedJob)
 	if (LiveConfig* lc = g_liveConfigs.Get()->Get(m_cfgId))
 	{
 		lc->m_curMidiVal = GetIntValue();
+		g_lcState.SetDirty();
 
 		// ui/osc update: the controller value is "changing" (e.g. grayed in monitors)
 		// no editor update though: it does not display "changing" values, only "solid" ones
@@ -2522,6 +2542,7 @@ void ApplyLiveConfigJob::Perform()
 	{
 		char buf[SNM_MAX_ACTION_NAME_LEN]="";
 		snprintf(buf, sizeof(buf), __LOCALIZE_VERFMT("Apply Live Config %d, value %d","sws_undo"), m_cfgId+1, absval);
+		g_lcState.SetDirty();
 		Undo_EndBlock2(NULL, buf, UNDO_STATE_ALL);
 	}
 
@@ -2567,6 +2588,7 @@ void PreloadLiveConfigJob::Init(ScheduledJob* _replacedJob)
 	if (LiveConfig* lc = g_liveConfigs.Get()->Get(m_cfgId))
 	{
 		lc->m_curPreloadMidiVal = GetIntValue();
+		g_lcState.SetDirty();
 
 		// ui/osc update
 		if (!IsImmediate())
@@ -2622,6 +2644,7 @@ void PreloadLiveConfigJob::Perform()
 	{
 		char buf[SNM_MAX_ACTION_NAME_LEN]="";
 		snprintf(buf, sizeof(buf), __LOCALIZE_VERFMT("Preload Live Config %d, value: %d","sws_undo"), m_cfgId+1, absval);
+		g_lcState.SetDirty();
 		Undo_EndBlock2(NULL, buf, UNDO_STATE_ALL);
 	}
 
@@ -3028,7 +3051,7 @@ void UpdateEnableLiveConfig(int _cfgId, int _val)
 		lc->m_enable = _val<0 ? !lc->m_enable : _val;
 		if (!lc->m_enable)
 			lc->m_curMidiVal = lc->m_activeMidiVal = lc->m_curPreloadMidiVal = lc->m_preloadMidiVal = -1;
-		Undo_OnStateChangeEx2(NULL, UNDO_STR, UNDO_STATE_MISCCFG, -1);
+		LiveConfigUndo(UNDO_STATE_MISCCFG);
 
 		if (g_configId == _cfgId)
 			if (LiveConfigsWnd* w = g_lcWndMgr.Get())
@@ -3069,6 +3092,7 @@ void UpdateOption(COMMAND_T* _ct, int _val, int _bit)
 		else if (_val>0) lc->m_options |= _bit;
 		else lc->m_options &= ~_bit;
 
+		g_lcState.SetDirty();
 		Undo_OnStateChangeEx2(NULL, SWS_CMD_SHORTNAME(_ct), UNDO_STATE_MISCCFG, -1);
 		// RefreshToolbar()) not required..
 	}
@@ -3161,6 +3185,7 @@ void UpdateTinyFadesLiveConfig(COMMAND_T* _ct, int _val)
 	if (LiveConfig* lc = g_liveConfigs.Get()->Get((int)_ct->user))
 	{
 		lc->m_fade = _val<0 ? (lc->m_fade>0 ? 0 : DEF_FADE) : _val;
+		g_lcState.SetDirty();
 		Undo_OnStateChangeEx2(NULL, SWS_CMD_SHORTNAME(_ct), UNDO_STATE_MISCCFG, -1);
 
 		if (LiveConfigsWnd* w = g_lcWndMgr.Get())
@@ -92,6 +92,8 @@ SNM_WindowManager<NotesWnd> g_notesWndMgr(NOTES_WND_ID);
 SWSProjConfig<WDL_PtrList_DOD<SNM_TrackNotes> > g_SNM_TrackNotes;
 SWSProjConfig<WDL_PtrList_DOD<SNM_RegionSubtitle> > g_pRegionSubs; // for markers too..
 SWSProjConfig<WDL_FastString> g_prjNotes; // extra project notes
+// marked dirty by notes edits and track list changes, subtitles of removed markers/regions are checked on save
+static SWSProjExtState g_notesState("Notes");
 // global notes #647, saved in <REAPER Resource Path>/SWS_GlobalNotes.txt 
 // (no SWSProjConfig, one instance across all projects, i.e. global)
 WDL_FastString g_globalNotes; 
@@ -766,6 +768,7 @@ void NotesWnd::SaveCurrentExtraProjectNotes(bool _wantUndo)
 {
 	GetWindowText(m_edit, g_lastText, sizeof(g_lastText));
 	g_prjNotes.Get()->Set(g_lastText); // CRLF removed only when saving the project..
+	g_notesState.SetDirty();
 	if (_wantUndo)
 		Undo_OnStateChangeEx2(NULL, __LOCALIZE("Edit exta project notes","sws_undo"), UNDO_STATE_MISCCFG, -1);
 	else
@@ -798,6 +801,7 @@ void NotesWnd::SaveCurrentTrackNotes(bool _wantUndo)
 			notes->SetNotes(g_lastText); // CRLF removed only when saving the project
 		else
 			g_SNM_TrackNotes.Get()->Add(new SNM_TrackNotes(nullptr, TrackToGuid(g_trNote), g_lastText));
+		g_notesState.SetDirty();
 
 		if (_wantUndo)
 			Undo_OnStateChangeEx2(NULL, __LOCALIZE("Edit track notes","sws_undo"), UNDO_STATE_MISCCFG, -1); //JFB TODO? -1 to replace?
@@ -864,6 +868,7 @@ void NotesWnd::SaveCurrentMkrRgnNameOrSub(int _type, bool _wantUndo)
 			}
 			if (!found)
 				g_pRegionSubs.Get()->Add(new SNM_RegionSubtitle(nullptr, g_lastMarkerRegionId, g_lastText));
+			g_notesState.SetDirty();
 			if (_wantUndo)
 				Undo_OnStateChangeEx2(NULL, IsRegion(g_lastMarkerRegionId) ? __LOCALIZE("Edit region subtitle","sws_undo") : __LOCALIZE("Edit marker subtitle","sws_undo"), UNDO_STATE_MISCCFG, -1);
 			else
@@ -1365,6 +1370,7 @@ bool ImportSubRipFile(const char* _fn)
 	
 	if (ok)
 	{
+		g_notesState.SetDirty();
 		UpdateTimeline(); // redraw the ruler (andd arrange view)
 		if (firstPos > 0.0)
 			SetEditCurPos2(NULL, firstPos, true, false);
@@ -1524,7 +1530,7 @@ static bool ProcessExtensionLine(const char *line, ProjectStateContext *ctx, boo
 	return false;
 }
 
-static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct project_config_extension_t *reg)
+static void SerializeNotes(ProjectStateContext *ctx)
 {
 	char line[SNM_MAX_CHUNK_LINE_LENGTH] = "";
 	char strId[128] = "";
@@ -1556,34 +1562,47 @@ static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct pr
 		}
 	}
 
-	// write global notes to file (only when cur. project is saved)
-	if (!isUndo && IsActiveProjectInLoadSave())
+	// save region/marker subs (removed ones were pruned in SaveExtensionConfig)
+	for (int i=0; i<g_pRegionSubs.Get()->GetSize(); i++)
 	{
-		WriteGlobalNotesToFile();
-		
+		if (SNM_RegionSubtitle* sub = g_pRegionSubs.Get()->Get(i))
+		{
+			if (snprintfStrict(line, sizeof(line), "<S&M_SUBTITLE %d\n|", sub->GetId()) > 0)
+				if (GetNotesChunkFromString(sub->GetNotes(), &formatedNotes, line))
+					StringToExtensionConfig(&formatedNotes, ctx);
+		}
 	}
+}
 
-	// save region/marker subs
+static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct project_config_extension_t *reg)
+{
+	// marker/region removals are only polled (see UpdateMarkerRegionRun()), check subs here
 	for (int i=0; i<g_pRegionSubs.Get()->GetSize(); i++)
 	{
-		if (SNM_RegionSubtitle* sub = g_pRegionSubs.Get()->Get(i))
+		SNM_RegionSubtitle* sub = g_pRegionSubs.Get()->Get(i);
+		if (!sub->GetNotesLength())
+			g_pRegionSubs.Get()->Delete(i--, true);
+		else if (!sub->IsValid())
 		{
-			if (sub->GetNotesLength() && sub->IsValid())
-			{
-				if (snprintfStrict(line, sizeof(line), "<S&M_SUBTITLE %d\n|", sub->GetId()) > 0)
-					if (GetNotesChunkFromString(sub->GetNotes(), &formatedNotes, line))
-						StringToExtensionConfig(&formatedNotes, ctx);
-			}
-			else
-			{
-				g_pRegionSubs.Get()->Delete(i--, true);
-			}
+			g_pRegionSubs.Get()->Delete(i--, true);
+			g_notesState.SetDirty();
 		}
 	}
+
+	g_notesState.Save(ctx, isUndo, SerializeNotes);
+
+	// write global notes to file (only when cur. project is saved)
+	if (!isUndo && IsActiveProjectInLoadSave())
+	{
+		WriteGlobalNotesToFile();
+		
+	}
 }
 
 static void BeginLoadProjectState(bool isUndo, struct project_config_extension_t *reg)
 {
+	g_notesState.BeginLoad(isUndo);
+
 	g_prjNotes.Cleanup();
 	g_prjNotes.Get()->Set("");
 
@@ -1613,6 +1632,7 @@ void NotesSetTrackTitle()
 // this is our only notification of active project tab change, so update everything
 // (ScheduledJob because of multi-notifs)
 void NotesSetTrackListChange() {
+	g_notesState.SetDirty(); // notes of removed tracks
 	ScheduledJob::Schedule(new NotesUpdateJob(SNM_SCHEDJOB_ASYNC_DELAY_OPT));
 }
 
@@ -1724,6 +1744,7 @@ void NF_SetSWSTrackNotes(MediaTrack* track, const char* buf)
 		return;
 
 	MarkProjectDirty(NULL);
+	g_notesState.SetDirty();
 
 	if (SNM_TrackNotes* notes = SNM_TrackNotes::find(track))
 	{
@@ -1796,6 +1817,7 @@ bool NFDoSetSWSMarkerRegionSub(const char* mkrRgnSubIn, int mkrRgnIdxNumberIn)
 				if (mkrRgnId == g_pRegionSubs.Get()->Get(i)->GetId()) // mkrRgn sub exists, update it
 				{
 					g_pRegionSubs.Get()->Get(i)->SetNotes(mkrRgnSubIn);
+					g_notesState.SetDirty();
 					return true;
 				}
 			}
@@ -1804,6 +1826,7 @@ bool NFDoSetSWSMarkerRegionSub(const char* mkrRgnSubIn, int mkrRgnIdxNumberIn)
 			if (mkrRgnExists)
 			{
 				g_pRegionSubs.Get()->Add(new SNM_RegionSubtitle(nullptr, mkrRgnId, mkrRgnSubIn));
+				g_notesState.SetDirty();
 				return true;
 			}
 			else // mkrRgn isn't present in project
@@ -1831,6 +1854,7 @@ void JB_SetSWSExtraProjectNotes(ReaProject* project, const char* buf)
 	MarkProjectDirty(project);
 
 	g_prjNotes.Get(project)->Set(buf);
+	g_notesState.SetDirty(project);
 
 	// update displayed text if the project is frontmost, the Notes window is visible and notes for project extra are displayed
 	if (g_prjNotes.Get(project) == g_prjNotes.Get(NULL))
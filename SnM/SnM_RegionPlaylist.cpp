@@ -99,6 +99,7 @@ enum {
 
 SNM_WindowManager<RegionPlaylistWnd> g_rgnplWndMgr(RGNPL_WND_ID);
 SWSProjConfig<RegionPlaylists> g_pls;
+static SWSProjExtState g_plsState("Region Playlists"); // playlist edits end with PlaylistUndo()
 SNM_OscCSurf* g_osc = NULL;
 
 
@@ -136,6 +137,12 @@ RegionPlaylist* GetPlaylist(int _plId = -1) {
 	return g_pls.Get()->Get(_plId);
 }
 
+// playlist edits end here, so that the next undo point serializes them
+static void PlaylistUndo() {
+	g_plsState.SetDirty();
+	Undo_OnStateChangeEx2(NULL, UNDO_PLAYLIST_STR, UNDO_STATE_MISCCFG, -1);
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // RegionPlaylist
@@ -340,6 +347,7 @@ void RegionPlaylistView::UpdateCompact()
 					if (infinite)
 						pl->Get(i-1)->m_cnt *= (-1);
 					pl->Delete(i, true);
+					g_plsState.SetDirty();
 				}
 	Update();
 }
@@ -406,7 +414,7 @@ void RegionPlaylistView::SetItemText(SWS_ListItem* item, int iCol, const char* s
 		{
 			case COL_RGN_COUNT:
 				pItem->m_cnt = str && *str ? atoi(str) : 0;
-				Undo_OnStateChangeEx2(NULL, UNDO_PLAYLIST_STR, UNDO_STATE_MISCCFG, -1); 
+				PlaylistUndo(); 
 				PlaylistResync();
 				break;
 			case COL_RGN_NAME:
@@ -501,7 +509,7 @@ void RegionPlaylistView::OnEndDrag()
 {
 	UpdateCompact();
 	if (m_draggedItems.GetSize()) {
-		Undo_OnStateChangeEx2(NULL, UNDO_PLAYLIST_STR, UNDO_STATE_MISCCFG, -1);
+		PlaylistUndo();
 		m_draggedItems.Empty(false);
 		PlaylistResync();
 	}
@@ -766,7 +774,7 @@ void RegionPlaylistWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 				// leading to unsynchronized dropdown box vs list view)
 				GetListView()->EditListItemEnd(false);
 				g_pls.Get()->m_editId = m_cbPlaylist.GetCurSel();
-				Undo_OnStateChangeEx2(NULL, UNDO_PLAYLIST_STR, UNDO_STATE_MISCCFG, -1);
+				PlaylistUndo();
 				Update();
 			}
 			break;
@@ -782,7 +790,7 @@ void RegionPlaylistWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 				{
 					g_pls.Get()->m_editId = g_pls.Get()->GetSize()-1;
 					FillPlaylistCombo();
-					Undo_OnStateChangeEx2(NULL, UNDO_PLAYLIST_STR, UNDO_STATE_MISCCFG, -1); 
+					PlaylistUndo(); 
 					Update();
 				}
 			}
@@ -811,7 +819,7 @@ void RegionPlaylistWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 					g_pls.Get()->Delete(g_pls.Get()->m_editId, false); // no deletion yet (still used in GUI)
 					g_pls.Get()->m_editId = BOUNDED(g_pls.Get()->m_editId-1, 0, g_pls.Get()->GetSize()-1);
 					FillPlaylistCombo();
-					Undo_OnStateChangeEx2(NULL, UNDO_PLAYLIST_STR, UNDO_STATE_MISCCFG, -1); 
+					PlaylistUndo(); 
 					Update();
 				}
 			} // + delItems cleanup
@@ -825,7 +833,7 @@ void RegionPlaylistWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 				{
 					GetPlaylist()->m_name.Set(newName);
 					FillPlaylistCombo();
-					Undo_OnStateChangeEx2(NULL, UNDO_PLAYLIST_STR, UNDO_STATE_MISCCFG, -1); 
+					PlaylistUndo(); 
 					Update();
 				}
 			}
@@ -873,7 +881,7 @@ void RegionPlaylistWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 			}
 			if (updt)
 			{
-				Undo_OnStateChangeEx2(NULL, UNDO_PLAYLIST_STR, UNDO_STATE_MISCCFG, -1);
+				PlaylistUndo();
 				PlaylistResync();
 				Update();
 			} // + delItems cleanup
@@ -888,7 +896,7 @@ void RegionPlaylistWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 			}
 			if (updt)
 			{
-				Undo_OnStateChangeEx2(NULL, UNDO_PLAYLIST_STR, UNDO_STATE_MISCCFG, -1); 
+				PlaylistUndo(); 
 				PlaylistResync();
 				Update();
 			}
@@ -942,7 +950,7 @@ void RegionPlaylistWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 						int slot = pl->Find(item);
 						if (slot >= 0 && pl->Insert(slot, newItem))
 						{
-							Undo_OnStateChangeEx2(NULL, UNDO_PLAYLIST_STR, UNDO_STATE_MISCCFG, -1); 
+							PlaylistUndo(); 
 							PlaylistResync();
 							Update();
 							GetListView()->SelectByItem((SWS_ListItem*)newItem);
@@ -953,7 +961,7 @@ void RegionPlaylistWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 				// empty list, no selection, etc.. => add
 				if (pl->Add(newItem))
 				{
-					Undo_OnStateChangeEx2(NULL, UNDO_PLAYLIST_STR, UNDO_STATE_MISCCFG, -1); 
+					PlaylistUndo(); 
 					PlaylistResync();
 					Update();
 					GetListView()->SelectByItem((SWS_ListItem*)newItem);
@@ -964,7 +972,7 @@ void RegionPlaylistWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 				RgnPlaylistItem* newItem = new RgnPlaylistItem(GetMarkerRegionIdFromIndex(NULL, LOWORD(wParam)-ADD_REGION_START_MSG));
 				if (GetPlaylist() && GetPlaylist()->Add(newItem))
 				{
-					Undo_OnStateChangeEx2(NULL, UNDO_PLAYLIST_STR, UNDO_STATE_MISCCFG, -1); 
+					PlaylistUndo(); 
 					PlaylistResync();
 					Update();
 					GetListView()->SelectByItem((SWS_ListItem*)newItem);
@@ -2098,6 +2106,7 @@ void AppendPasteCropPlaylist(RegionPlaylist* _playlist, const AppendPasteCropPla
 	g_pls.Get()->m_editId = g_pls.Get()->Find(_playlist);
 	if (g_pls.Get()->m_editId < 0)
 		g_pls.Get()->m_editId = 0; // just in case..
+	g_plsState.SetDirty();
 
 	if (_mode == CROP_PROJECT)
 	{
@@ -2172,6 +2181,7 @@ void AppendPasteCropPlaylist(RegionPlaylist* _playlist, const AppendPasteCropPla
 	// new project: the playlist is empty at this point
 	g_pls.Get()->Add(dupPlaylist);
 	g_pls.Get()->m_editId = 0;
+	g_plsState.SetDirty();
 
 	PreventUIRefresh(-1);
 	SNM_UIRefresh(NULL);
@@ -2249,7 +2259,7 @@ static bool ProcessExtensionLine(const char *line, ProjectStateContext *ctx, boo
 	return false;
 }
 
-static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct project_config_extension_t *reg)
+static void SerializePlaylists(ProjectStateContext *ctx)
 {
 	for (int j=0; j < g_pls.Get()->GetSize(); j++)
 	{
@@ -2270,8 +2280,14 @@ static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct pr
 	}
 }
 
+static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct project_config_extension_t *reg)
+{
+	g_plsState.Save(ctx, isUndo, SerializePlaylists);
+}
+
 static void BeginLoadProjectState(bool isUndo, struct project_config_extension_t *reg)
 {
+	g_plsState.BeginLoad(isUndo);
 	g_pls.Cleanup();
 	g_pls.Get()->Empty(true);
 	g_pls.Get()->m_editId=0;
@@ -2404,7 +2420,7 @@ void AddAllRegionsToPlaylist(COMMAND_T *ct)
 		return;
 	}
 
-	Undo_OnStateChangeEx2(nullptr, UNDO_PLAYLIST_STR, UNDO_STATE_MISCCFG, -1);
+	PlaylistUndo();
 	PlaylistResync();
 	if (w)
 		w->Update();
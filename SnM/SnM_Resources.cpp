@@ -387,7 +387,7 @@ void UntieAllResFileFromProject(ReaProject* _prj, const char* _prjPath, int _typ
 ///////////////////////////////////////////////////////////////////////////////
 
 ResourceList::ResourceList(const char* _resDir, const char* _name, const char* _ext, int _flags)
-	: m_name(_name), m_ext(_ext), m_flags(_flags), WDL_PtrList<ResourceItem>()
+	: m_name(_name), m_ext(_ext), m_flags(_flags), m_loaded(true), WDL_PtrList<ResourceItem>()
 {
 	char tmp[512]="";
 
@@ -432,6 +432,36 @@ ResourceList::ResourceList(const char* _resDir, const char* _name, const char* _
 		m_exts.Add(new WDL_FastString("WAV*"));
 }
 
+// reads the slots from S&M.ini, no-op if already done
+// note: the ini section name depends on the type index, lists are loaded
+// before custom types are renumbered, see FlushCustomTypesIniFile()
+void ResourceList::Load()
+{
+	if (m_loaded)
+		return;
+	m_loaded = true;
+
+	int type = g_SNM_ResSlots.Find(this);
+	if (type < 0)
+		return;
+
+	char iniSec[64]="", maxSlotCount[16]="", key[32]="", path[SNM_MAX_PATH]="", desc[128]="";
+	GetIniSectionName(type, iniSec, sizeof(iniSec));
+
+	//JFB TODO? would be faster to read section in one go..
+	GetPrivateProfileString(iniSec, "Max_slot", "0", maxSlotCount, sizeof(maxSlotCount), g_SNM_IniFn.Get()); 
+	int cnt = atoi(maxSlotCount);
+	for (int j=0; j<cnt; j++)
+	{
+		*path = *desc = '\0';
+		if (snprintfStrict(key, sizeof(key), "Slot%d", j+1) > 0)
+			GetPrivateProfileString(iniSec, key, "", path, sizeof(path), g_SNM_IniFn.Get());
+		if (snprintfStrict(key, sizeof(key), "Desc%d", j+1) > 0)
+			GetPrivateProfileString(iniSec, key, "", desc, sizeof(desc), g_SNM_IniFn.Get());
+		WDL_PtrList<ResourceItem>::Add(new ResourceItem(path, desc));
+	}
+}
+
 // _path: short resource path or full path
 ResourceItem* ResourceList::AddSlot(const char* _path, const char* _desc)
 {
@@ -726,6 +756,13 @@ void ResourcesView::OnItemDblClk(SWS_ListItem* item, int iCol) {
 	Perform(g_dblClickPrefs[g_resType]);
 }
 
+void ResourcesView::OnItemSelChanged(SWS_ListItem* item, int iState)
+{
+	if ((iState & LVIS_SELECTED) && IsImageWndDisplayed(NULL))
+		if (ResourceList* fl = g_SNM_ResSlots.Get(g_resType))
+			PrefetchImageSlots(g_resType, fl->Find((ResourceItem*)item));
+}
+
 void ResourcesView::GetItemList(SWS_ListItemList* pList)
 {
 	ResourceList* fl = g_SNM_ResSlots.Get(g_resType);
@@ -734,32 +771,41 @@ void ResourcesView::GetItemList(SWS_ListItemList* pList)
 
 	if (IsFiltered())
 	{
-		char buf[SNM_MAX_PATH] = "";
-		LineParser lp(false);
-		if (!lp.parse(g_filter.Get()))
+		// parse the filter only when it has changed
+		static LineParser s_filterTokens(false);
+		static WDL_FastString s_parsedFilter;
+		static bool s_filterOk = false;
+		if (strcmp(s_parsedFilter.Get(), g_filter.Get())) {
+			s_parsedFilter.Set(g_filter.Get());
+			s_filterOk = !s_filterTokens.parse(g_filter.Get());
+		}
+
+		if (s_filterOk)
 		{
+			char name[SNM_MAX_PATH] = "", path[SNM_MAX_PATH] = "";
 			for (int i=0; i < fl->GetSize(); i++)
 			{
 				if (ResourceItem* item = fl->Get(i))
 				{
+					// get name and path once per slot, not per token
+					if (g_filterPref&1)
+						GetFilenameNoExt(item->m_shortPath.Get(), name, sizeof(name));
+					*path = '\0';
+					if ((g_filterPref&2) && fl->GetFullPath(i, path, sizeof(path))) {
+						if (char* p = strrchr(path, PATH_SLASH_CHAR)) *p = '\0';
+						else *path = '\0';
+					}
+
 					bool match = false;
-					for (int j=0; !match && j < lp.getnumtokens(); j++)
+					for (int j=0; !match && j < s_filterTokens.getnumtokens(); j++)
 					{
+						const char* token = s_filterTokens.gettoken_str(j);
 						if (g_filterPref&1) // name
-						{
-							GetFilenameNoExt(item->m_shortPath.Get(), buf, sizeof(buf));
-							match |= (stristr(buf, lp.gettoken_str(j)) != NULL);
-						}
-						if (!match && (g_filterPref&2)) // path
-						{
-							if (fl->GetFullPath(i, buf, sizeof(buf)))
-								if (char* p = strrchr(buf, PATH_SLASH_CHAR)) {
-									*p = '\0';
-									match |= (stristr(buf, lp.gettoken_str(j)) != NULL);
-								}
-						}
+							match |= (stristr(name, token) != NULL);
+						if (!match && (g_filterPref&2) && *path) // path
+							match |= (stristr(path, token) != NULL);
 						if (!match && (g_filterPref&4)) // comment
-							match |= (stristr(item->m_comment.Get(), lp.gettoken_str(j)) != NULL);
+							match |= (stristr(item->m_comment.Get(), token) != NULL);
 					}
 					if (match)
 						pList->Add((SWS_ListItem*)item);
@@ -2538,6 +2584,314 @@ void AutoSave(int _type, bool _ow, int _flags)
 	}
 }
 
+// persistent index of the files found under an auto-fill directory
+// each directory is stored with its modification time so that a refresh only
+// lists the directories that changed since the last auto-fill (adding, removing
+// or renaming a file updates the modification time of its parent directory)
+// note: mtimes have a 1 second resolution, a directory modified in the second
+// it was listed (or later, e.g. clock skew) is listed again on next refresh
+// index files live in SNM_RES_INDEX_DIR, see PruneResourceFileIndexes()
+class ResourceFileIndex
+{
+public:
+	ResourceFileIndex(const char* _rootDir) : m_rootDir(_rootDir), m_dirs(true, DeleteDir), m_loaded(false), m_dirty(false) {
+		m_rootDir.remove_trailing_dirchars();
+	}
+	~ResourceFileIndex() { m_dirs.DeleteAll(); }
+	void Refresh(const char* _fileFilter, WDL_PtrList<WDL_String>* _filesOut);
+private:
+	struct IndexedDir {
+		IndexedDir(time_t _mtime = 0, time_t _scanTime = 0) : m_mtime(_mtime), m_scanTime(_scanTime), m_visited(false) {}
+		time_t m_mtime, m_scanTime; // m_scanTime: when the directory was listed
+		bool m_visited;
+		WDL_PtrList_DeleteOnDestroy<WDL_FastString> m_files, m_subDirs; // names only
+	};
+	static void DeleteDir(IndexedDir* _dir) { delete _dir; }
+	static bool CompileFileFilter(const char* _fileFilter, WDL_StringKeyedArray<bool>* _extsOut);
+	void GetIndexFn(char* _fn, int _fnSz);
+	void Load();
+	void Save();
+	void RefreshDir(const char* _dir, WDL_StringKeyedArray<bool>* _exts, bool _allFiles, WDL_PtrList<WDL_String>* _filesOut);
+
+	WDL_FastString m_rootDir;
+	WDL_StringKeyedArray<IndexedDir*> m_dirs; // key: full path
+	bool m_loaded, m_dirty;
+};
+
+// file indexes, key: auto-fill directory
+// note: shared by all resource types/bookmarks that use the same auto-fill directory
+static void DeleteResourceFileIndex(ResourceFileIndex* _idx) { delete _idx; }
+WDL_StringKeyedArray<ResourceFileIndex*> g_resFileIndexes(true, DeleteResourceFileIndex);
+
+// _fileFilter: see ResourceList::GetFileFilter(), e.g. "*.wav;*.mp3|..."
+// returns true if all files are accepted ("*" or "*.*"), _extsOut is left empty then
+// note: no file is accepted if this returns false with empty _extsOut
+bool ResourceFileIndex::CompileFileFilter(const char* _fileFilter, WDL_StringKeyedArray<bool>* _extsOut)
+{
+	if (!_fileFilter || !strcmp("*", _fileFilter))
+		return true;
+
+	char ext[64];
+	const char* p = _fileFilter;
+	while ((p = strstr(p, "*.")))
+	{
+		p += 2;
+		int len = 0;
+		while (*p && *p!=';' && *p!='|' && *p!=' ' && *p!=')' && len < sizeof(ext)-1)
+			ext[len++] = *p++;
+		ext[len] = '\0';
+		if (!strcmp(ext, "*")) {
+			_extsOut->DeleteAll();
+			return true;
+		}
+		if (len)
+			_extsOut->AddUnsorted(ext, true);
+	}
+	_extsOut->Resort();
+	return false;
+}
+
+void ResourceFileIndex::GetIndexFn(char* _fn, int _fnSz)
+{
+	WDL_UINT64 h = FNV64(FNV64_IV, (const unsigned char*)m_rootDir.Get(), m_rootDir.GetLength());
+	char dir[SNM_MAX_PATH]="";
+	snprintf(dir, sizeof(dir), SNM_RES_INDEX_DIR, GetResourcePath());
+	snprintf(_fn, _fnSz, SNM_RES_INDEX_FILE, dir, (unsigned int)(h>>32), (unsigned int)(h&0xFFFFFFFF));
+}
+
+// index file format, one entry per line:
+// R<tab><auto-fill directory> first line, checked on load (hash collision) and when pruning
+// D<tab><mtime><tab><scan time><tab><full path> starts a directory
+// F<tab><name> and S<tab><name> are the files and sub-directories of the previous D line
+void ResourceFileIndex::Load()
+{
+	m_loaded = true;
+
+	char fn[SNM_MAX_PATH]="";
+	GetIndexFn(fn, sizeof(fn));
+	FILE* f = fopenUTF8(fn, "r");
+	if (!f)
+		return;
+
+	char line[SNM_MAX_PATH+64]="";
+	IndexedDir* dir = NULL;
+	bool root = false;
+	while (fgets(line, sizeof(line), f))
+	{
+		if (char* eol = (char*)FindFirstRN(line))
+			*eol = '\0';
+		if (!line[0] || line[1] != '\t')
+			continue;
+
+		if (!root)
+		{
+			if (line[0] != 'R' || strcmp(line+2, m_rootDir.Get()))
+				break;
+			root = true;
+			continue;
+		}
+
+		switch (line[0])
+		{
+			case 'D':
+			{
+				char* scanTime = strchr(line+2, '\t');
+				char* path = scanTime ? strchr(++scanTime, '\t') : NULL;
+				dir = NULL;
+				if (path && *(++path))
+				{
+					dir = new IndexedDir((time_t)strtoll(line+2, NULL, 10), (time_t)strtoll(scanTime, NULL, 10));
+					m_dirs.AddUnsorted(path, dir);
+				}
+				break;
+			}
+			case 'F':
+				if (dir) dir->m_files.Add(new WDL_FastString(line+2));
+				break;
+			case 'S':
+				if (dir) dir->m_subDirs.Add(new WDL_FastString(line+2));
+				break;
+		}
+	}
+	fclose(f);
+	m_dirs.Resort();
+}
+
+void ResourceFileIndex::Save()
+{
+	char fn[SNM_MAX_PATH]="";
+	GetIndexFn(fn, sizeof(fn));
+	if (!FileOrDirExists(fn))
+	{
+		char dir[SNM_MAX_PATH]="";
+		snprintf(dir, sizeof(dir), SNM_RES_INDEX_DIR, GetResourcePath());
+		CreateDirectory(dir, NULL);
+	}
+	if (FILE* f = fopenUTF8(fn, "w"))
+	{
+		fprintf(f, "R\t%s\n", m_rootDir.Get());
+		const char* path;
+		for (int i=0; i < m_dirs.GetSize(); i++)
+		{
+			IndexedDir* dir = m_dirs.Enumerate(i, &path);
+			if (!dir || !path)
+				continue;
+			fprintf(f, "D\t%lld\t%lld\t%s\n", (long long)dir->m_mtime, (long long)dir->m_scanTime, path);
+			for (int j=0; j < dir->m_files.GetSize(); j++)
+				fprintf(f, "F\t%s\n", dir->m_files.Get(j)->Get());
+			for (int j=0; j < dir->m_subDirs.GetSize(); j++)
+				fprintf(f, "S\t%s\n", dir->m_subDirs.Get(j)->Get());
+		}
+		fclose(f);
+		m_dirty = false;
+	}
+}
+
+void ResourceFileIndex::RefreshDir(const char* _dir, WDL_StringKeyedArray<bool>* _exts, bool _allFiles, WDL_PtrList<WDL_String>* _filesOut)
+{
+	time_t mtime = 0;
+	if (!GetFileOrDirInfo(_dir, &mtime))
+		return;
+
+	IndexedDir* dir = m_dirs.Get(_dir, NULL);
+	if (dir && dir->m_visited) // symlink loop
+		return;
+
+	// new or modified directory: list it again (not recursive)
+	if (!dir || dir->m_mtime != mtime || dir->m_mtime >= dir->m_scanTime)
+	{
+		if (!dir) {
+			dir = new IndexedDir;
+			m_dirs.Insert(_dir, dir);
+		}
+		dir->m_mtime = mtime;
+		dir->m_scanTime = time(NULL);
+		dir->m_files.Empty(true);
+		dir->m_subDirs.Empty(true);
+
+		WDL_DirScan ds;
+		if (!ds.First(_dir))
+		{
+			do 
+			{
+				const char* curFn = ds.GetCurrentFN();
+				if (!strcmp(curFn, ".") || !strcmp(curFn, "..")) 
+					continue;
+				if (IsDirNoRecurse(ds)) dir->m_subDirs.Add(new WDL_FastString(curFn));
+				else dir->m_files.Add(new WDL_FastString(curFn));
+			}
+			while(!ds.Next());
+		}
+		m_dirty = true;
+	}
+	dir->m_visited = true;
+
+	WDL_FastString fn;
+	for (int i=0; i < dir->m_files.GetSize(); i++)
+	{
+		const char* name = dir->m_files.Get(i)->Get();
+		if (_allFiles || _exts->Exists(GetFileExtension(name)))
+		{
+			fn.SetFormatted(SNM_MAX_PATH, "%s%c%s", _dir, PATH_SLASH_CHAR, name);
+			_filesOut->Add(new WDL_String(fn.Get()));
+		}
+	}
+	for (int i=0; i < dir->m_subDirs.GetSize(); i++)
+	{
+		fn.SetFormatted(SNM_MAX_PATH, "%s%c%s", _dir, PATH_SLASH_CHAR, dir->m_subDirs.Get(i)->Get());
+		RefreshDir(fn.Get(), _exts, _allFiles, _filesOut);
+	}
+}
+
+// fills _filesOut with the full paths of all files matching _fileFilter (recursive)
+// note: it is up to the caller to free _filesOut (use WDL_PtrList_DeleteOnDestroy)
+void ResourceFileIndex::Refresh(const char* _fileFilter, WDL_PtrList<WDL_String>* _filesOut)
+{
+	if (!m_loaded)
+		Load();
+
+	for (int i=0; i < m_dirs.GetSize(); i++)
+		if (IndexedDir* dir = m_dirs.Enumerate(i))
+			dir->m_visited = false;
+
+	WDL_StringKeyedArray<bool> exts(false);
+	bool allFiles = CompileFileFilter(_fileFilter, &exts);
+	RefreshDir(m_rootDir.Get(), &exts, allFiles, _filesOut);
+
+	// purge deleted directories
+	for (int i=m_dirs.GetSize()-1; i >= 0; i--)
+	{
+		IndexedDir* dir = m_dirs.Enumerate(i);
+		if (!dir || !dir->m_visited) {
+			m_dirs.DeleteByIndex(i);
+			m_dirty = true;
+		}
+	}
+
+	if (m_dirty)
+		Save();
+}
+
+// deletes index files of auto-fill directories that do not exist anymore and
+// the oldest ones beyond SNM_RES_INDEX_MAX, done once per session (on first auto-fill)
+#define SNM_RES_INDEX_MAX	64
+static void PruneResourceFileIndexes()
+{
+	static bool s_pruned = false;
+	if (s_pruned)
+		return;
+	s_pruned = true;
+
+	char dir[SNM_MAX_PATH]="";
+	snprintf(dir, sizeof(dir), SNM_RES_INDEX_DIR, GetResourcePath());
+
+	struct IndexFile { WDL_String m_fn; time_t m_mtime; };
+	WDL_PtrList_DeleteOnDestroy<IndexFile> kept;
+	WDL_DirScan ds;
+	if (!ds.First(dir))
+	{
+		char line[SNM_MAX_PATH+64];
+		do
+		{
+			if (IsDirNoRecurse(ds) || !HasFileExtension(ds.GetCurrentFN(), "idx"))
+				continue;
+
+			IndexFile* idx = new IndexFile;
+			WDL_String& fn = idx->m_fn;
+			ds.GetCurrentFullFN(&fn);
+			bool keep = false;
+			if (FILE* f = fopenUTF8(fn.Get(), "r"))
+			{
+				if (fgets(line, sizeof(line), f) && line[0]=='R' && line[1]=='\t')
+				{
+					if (char* eol = (char*)FindFirstRN(line))
+						*eol = '\0';
+					keep = FileOrDirExists(line+2);
+				}
+				fclose(f);
+			}
+
+			if (!keep || !GetFileOrDirInfo(fn.Get(), &idx->m_mtime)) {
+				DeleteFile(fn.Get());
+				delete idx;
+				continue;
+			}
+			kept.Add(idx);
+		}
+		while(!ds.Next());
+	}
+
+	while (kept.GetSize() > SNM_RES_INDEX_MAX)
+	{
+		int oldest = 0;
+		for (int i=1; i < kept.GetSize(); i++)
+			if (kept.Get(i)->m_mtime < kept.Get(oldest)->m_mtime)
+				oldest = i;
+		DeleteFile(kept.Get(oldest)->m_fn.Get());
+		kept.Delete(oldest, true);
+	}
+}
+
 // recursive from auto-fill path
 void AutoFill(int _type)
 {
@@ -2553,14 +2907,32 @@ void AutoFill(int _type)
 	char fileFilter[2048] = ""; // filters need some room!
 	fl->GetFileFilter(fileFilter, sizeof(fileFilter), false);
 
+	PruneResourceFileIndexes();
+	ResourceFileIndex* idx = g_resFileIndexes.Get(GetAutoFillDir(_type), NULL);
+	if (!idx) {
+		idx = new ResourceFileIndex(GetAutoFillDir(_type));
+		g_resFileIndexes.Insert(GetAutoFillDir(_type), idx);
+	}
+
 	WDL_PtrList_DeleteOnDestroy<WDL_String> files; 
-	ScanFiles(&files, GetAutoFillDir(_type), fileFilter, true);
+	idx->Refresh(fileFilter, &files);
 	if (int sz = files.GetSize())
+	{
+		// existing slots, case insensitive like FindByPath()
+		char fullpath[SNM_MAX_PATH];
+		WDL_StringKeyedArray<bool> slotPaths(false);
+		for (int i=0; i < fl->GetSize(); i++)
+			if (fl->GetFullPath(i, fullpath, sizeof(fullpath)))
+				slotPaths.AddUnsorted(fullpath, true);
+		slotPaths.Resort();
+
 		for (int i=0; i<sz; i++)
-			if (fl->FindByPath(files.Get(i)->Get()) < 0) { // skip if already present
+			if (!slotPaths.Exists(files.Get(i)->Get())) { // skip if already present
 				TieResFileToProject(files.Get(i)->Get(), _type);
 				fl->AddSlot(files.Get(i)->Get());
+				slotPaths.Insert(files.Get(i)->Get(), true);
 			}
+	}
 
 	if (startSlot != fl->GetSize())
 	{
@@ -2775,8 +3147,9 @@ void FlushCustomTypesIniFile()
 	char iniSec[64]="";
 	for (int i=SNM_NUM_DEFAULT_SLOTS; i<g_SNM_ResSlots.GetSize(); i++)
 	{
-		if (g_SNM_ResSlots.Get(i))
+		if (ResourceList* list = g_SNM_ResSlots.Get(i))
 		{
+			list->Load(); // before its section is flushed
 			GetIniSectionName(i, iniSec, sizeof(iniSec));
 			WritePrivateProfileStruct(iniSec, NULL, NULL, 0, g_SNM_IniFn.Get()); // flush section
 			WritePrivateProfileString(RES_INI_SEC, iniSec, NULL, g_SNM_IniFn.Get());
@@ -2797,15 +3170,6 @@ void FlushCustomTypesIniFile()
 	}
 }
 
-void ReadSlotIniFile(const char* _key, int _slot, char* _path, int _pathSize, char* _desc, int _descSize)
-{
-	char buf[32];
-	if (snprintfStrict(buf, sizeof(buf), "Slot%d", _slot+1) > 0)
-		GetPrivateProfileString(_key, buf, "", _path, _pathSize, g_SNM_IniFn.Get());
-	if (snprintfStrict(buf, sizeof(buf), "Desc%d", _slot+1) > 0)
-		GetPrivateProfileString(_key, buf, "", _desc, _descSize, g_SNM_IniFn.Get());
-}
-
 // adds bookmarks and custom slot types from the S&M.ini file
 void AddCustomTypesFromIniFile()
 {
@@ -3161,6 +3525,13 @@ void ResourcesUpdate() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static void LoadAllSlotLists()
+{
+	for (int i=0; i < g_SNM_ResSlots.GetSize(); i++)
+		if (ResourceList* list = g_SNM_ResSlots.Get(i))
+			list->Load();
+}
+
 int ResourcesInit()
 {
 	// localization
@@ -3261,24 +3632,12 @@ int ResourcesInit()
 		}
 	}
 
-	// read slots from ini file
-	char desc[128]="", maxSlotCount[16]="";
+	// slots are read from the ini file on first access (2 ini reads per slot:
+	// the slow part of this init), or right now when lazy init is off
 	for (int i=0; i < g_SNM_ResSlots.GetSize(); i++)
-	{
 		if (ResourceList* list = g_SNM_ResSlots.Get(i))
-		{
-			GetIniSectionName(i, iniSec, sizeof(iniSec));
-			
-			//JFB TODO? would be faster to read section in one go..
-			GetPrivateProfileString(iniSec, "Max_slot", "0", maxSlotCount, sizeof(maxSlotCount), g_SNM_IniFn.Get()); 
-			list->EmptySafe(true);
-			int cnt = atoi(maxSlotCount);
-			for (int j=0; j<cnt; j++) {
-				ReadSlotIniFile(iniSec, j, path, sizeof(path), desc, sizeof(desc));
-				list->Add(new ResourceItem(path, desc));
-			}
-		}
-	}
+			list->DeferLoad();
+	SWSDeferInit("S&M Resources slots", LoadAllSlotLists);
 
 	// instanciate the window if needed, can be NULL
 	g_resWndMgr.Init();
@@ -3292,6 +3651,7 @@ int ResourcesInit()
 void ResourcesExit()
 {
 	plugin_register("-projectconfig", &s_projectconfig);
+	g_resFileIndexes.DeleteAll();
 
 	WDL_PtrList_DeleteOnDestroy<WDL_FastString> iniSections;
 	GetIniSectionNames(&iniSections);
@@ -3372,6 +3732,8 @@ void ResourcesExit()
 
 	for (int i=0; i < g_SNM_ResSlots.GetSize(); i++)
 	{
+		if (!g_SNM_ResSlots.Get(i)->IsLoaded()) // never used: the ini section is up to date
+			continue;
 		iniSection.str({});
 		iniSection << "Max_slot=" << g_SNM_ResSlots.Get(i)->GetSize() << '\0';
 		for (int j=0; j < g_SNM_ResSlots.Get(i)->GetSize(); j++)
@@ -3424,6 +3786,10 @@ enum {
   IMGID=IMGWND_LAST_MSG
 };
 
+#define IMG_DECODE_TIMER			1
+#define IMG_DECODE_TIMER_FREQ		50
+#define IMG_PREFETCH_SLOTS			2 // prefetched slots before/after the selected one
+
 int g_lastImgSlot = -1;
 bool g_stretchPref = false;
 char g_lastImgFnPref[SNM_MAX_PATH] =  "";
@@ -3437,7 +3803,7 @@ ImageWnd::ImageWnd()
 {
 	m_id.Set(IMG_WND_ID);
 	m_stretch = g_stretchPref;
-	m_img.SetImage(g_lastImgFnPref);
+	m_img.SetImage(g_lastImgFnPref, m_stretch ? SNM_IMG_MAX_DIM : 0);
 
 	// Must call SWS_DockWnd::Init() to restore parameters and open the window if necessary
 	Init();
@@ -3450,17 +3816,43 @@ void ImageWnd::OnInitDlg()
 	
 	m_img.SetID(IMGID);
 	m_parentVwnd.AddChild(&m_img);
+	if (m_img.IsPending())
+		SetTimer(m_hwnd, IMG_DECODE_TIMER, IMG_DECODE_TIMER_FREQ, NULL);
 	RequestRedraw();
 }
 
+// images are decoded asynchronously, see SNM_ImageCache
+// large images are downscaled when stretched only (displayed as is otherwise)
+void ImageWnd::SetImage(const char* _fn)
+{
+	m_img.SetImage(_fn, m_stretch ? SNM_IMG_MAX_DIM : 0);
+	if (m_img.IsPending() && m_hwnd)
+		SetTimer(m_hwnd, IMG_DECODE_TIMER, IMG_DECODE_TIMER_FREQ, NULL);
+}
+
+void ImageWnd::OnTimer(WPARAM wParam)
+{
+	if (wParam == IMG_DECODE_TIMER)
+	{
+		if (m_img.Poll())
+			RequestRedraw();
+		if (!m_img.IsPending())
+			KillTimer(m_hwnd, IMG_DECODE_TIMER);
+	}
+}
+
 void ImageWnd::OnCommand(WPARAM wParam, LPARAM lParam)
 {
 	switch(LOWORD(wParam))
 	{
 		case STRETCH_TO_FIT_MSG:
+		{
+			WDL_FastString fn(GetFilename());
 			m_stretch = !m_stretch;
+			SetImage(fn.Get());
 			RequestRedraw();
 			break;
+		}
 		default:
 			Main_OnCommand((int)wParam, (int)lParam);
 			break;
@@ -3532,6 +3924,7 @@ void ImageExit()
 	}
 
 	g_imgWndMgr.Delete();
+	g_SNM_ImageCache.Stop();
 }
 
 void OpenImageWnd(COMMAND_T* _ct)
@@ -3573,6 +3966,28 @@ void ClearImageWnd(COMMAND_T*) {
 	}
 }
 
+// decodes the images of _slot and its neighbours in background (no-op for non image slots),
+// pending requests for previously prefetched slots are cancelled
+void PrefetchImageSlots(int _slotType, int _slot)
+{
+	ResourceList* fl = g_SNM_ResSlots.Get(_slotType);
+	if (!fl || _slot<0 || GetTypeForUser(_slotType) != SNM_SLOT_IMG)
+		return;
+
+	g_SNM_ImageCache.CancelRequests();
+
+	ImageWnd* w = g_imgWndMgr.Get();
+	int maxDim = (w ? w->IsStretched() : g_stretchPref) ? SNM_IMG_MAX_DIM : 0;
+	char fn[SNM_MAX_PATH]="";
+	for (int i=0; i <= IMG_PREFETCH_SLOTS*2; i++)
+	{
+		// selected slot first, then next/previous ones alternatively
+		int slot = _slot + ((i&1) ? (i+1)/2 : -(i/2));
+		if (slot>=0 && slot<fl->GetSize() && !fl->Get(slot)->IsDefault() && fl->GetFullPath(slot, fn, sizeof(fn)))
+			g_SNM_ImageCache.Request(fn, maxDim, true);
+	}
+}
+
 int IsImageWndDisplayed(COMMAND_T*)
 {
 	if (ImageWnd* w = g_imgWndMgr.Get())
@@ -3679,6 +4094,71 @@ void ResourcesAutoSave(COMMAND_T* _ct)
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+// FX chain files cache
+///////////////////////////////////////////////////////////////////////////////
+
+#define SNM_FXCHAIN_CACHE_SIZE	16
+
+// FX chain files, as loaded and cleaned up for pasting, so that applying
+// the same slot again (to other tracks/takes) does not re-read/re-parse it.
+// An entry is reused as long as its file's date and size are unchanged.
+struct FXChainFileCacheEntry
+{
+	WDL_FastString m_fn, m_chain;
+	time_t m_mtime;
+	WDL_INT64 m_size;
+};
+
+// most recently used first
+static WDL_PtrList_DeleteOnDestroy<FXChainFileCacheEntry> g_fxChainFileCache;
+
+bool LoadFXChainFile(const char* _fn, WDL_FastString* _chain)
+{
+	time_t mtime;
+	WDL_INT64 size;
+	if (!_chain || !GetFileOrDirInfo(_fn, &mtime, &size))
+		return false;
+
+	for (int i=0; i < g_fxChainFileCache.GetSize(); i++)
+	{
+		FXChainFileCacheEntry* e = g_fxChainFileCache.Get(i);
+		if (!strcmp(e->m_fn.Get(), _fn))
+		{
+			if (e->m_mtime == mtime && e->m_size == size)
+			{
+				g_fxChainFileCache.Delete(i, false);
+				g_fxChainFileCache.Insert(0, e);
+				_chain->Set(&e->m_chain);
+				return true;
+			}
+			g_fxChainFileCache.Delete(i, true); // stale
+			break;
+		}
+	}
+
+	if (!LoadChunk(_fn, _chain))
+		return false;
+
+	// remove all fx param envelopes
+	// (were saved for track fx chains before SWS v2.1.0 #11)
+	{
+		SNM_ChunkParserPatcher p(_chain);
+		p.RemoveSubChunk("PARMENV", 1, -1);
+	}
+
+	FXChainFileCacheEntry* e = new FXChainFileCacheEntry;
+	e->m_fn.Set(_fn);
+	e->m_chain.Set(_chain);
+	e->m_mtime = mtime;
+	e->m_size = size;
+	g_fxChainFileCache.Insert(0, e);
+	while (g_fxChainFileCache.GetSize() > SNM_FXCHAIN_CACHE_SIZE)
+		g_fxChainFileCache.Delete(g_fxChainFileCache.GetSize()-1, true);
+	return true;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Track FX chain slots
 ///////////////////////////////////////////////////////////////////////////////
@@ -3690,14 +4170,8 @@ void ApplyTracksFXChainSlot(int _slotType, const char* _title, int _slot, bool _
 	if (fnStr && SNM_CountSelectedTracks(NULL, true))
 	{
 		WDL_FastString chain;
-		if (LoadChunk(fnStr->Get(), &chain))
+		if (LoadFXChainFile(fnStr->Get(), &chain))
 		{
-			// remove all fx param envelopes
-			// (were saved for track fx chains before SWS v2.1.0 #11)
-			{
-				SNM_ChunkParserPatcher p(&chain);
-				p.RemoveSubChunk("PARMENV", 1, -1);
-			}
 			if (_set) SetTrackFXChain(_title, &chain, _inputFX);
 			else  PasteTrackFXChain(_title, &chain, _inputFX);
 		}
@@ -3769,14 +4243,8 @@ void ApplyTakesFXChainSlot(int _slotType, const char* _title, int _slot, bool _a
 	if (fnStr && CountSelectedMediaItems(NULL))
 	{
 		WDL_FastString chain;
-		if (LoadChunk(fnStr->Get(), &chain))
+		if (LoadFXChainFile(fnStr->Get(), &chain))
 		{
-			// remove all fx param envelopes
-			// (were saved for track fx chains before SWS v2.1.0 #11)
-			{
-				SNM_ChunkParserPatcher p(&chain);
-				p.RemoveSubChunk("PARMENV", 1, -1);
-			}
 			if (_set) SetTakeFXChain(_title, &chain, _activeOnly);
 			else PasteTakeFXChain(_title, &chain, _activeOnly);
 		}
@@ -4355,6 +4823,7 @@ void ShowNextPreviousImageSlot(COMMAND_T* _ct)
 		g_lastImgSlot += (int)_ct->user;
 		if (g_lastImgSlot<0) g_lastImgSlot = sz-1;
 		else if (g_lastImgSlot>=sz) g_lastImgSlot = 0;
+		PrefetchImageSlots(g_tiedSlotActions[SNM_SLOT_IMG], g_lastImgSlot);
 	}
 	ShowImageSlot(g_tiedSlotActions[SNM_SLOT_IMG], SWS_CMD_SHORTNAME(_ct), sz ? g_lastImgSlot : -1); // -1: err msg (empty list)
 }
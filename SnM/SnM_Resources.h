@@ -76,6 +76,24 @@ class ResourceList : public WDL_PtrList<ResourceItem>
   public:
 	ResourceList(const char* _resDir, const char* _desc, const char* _ext, int _flags);
 	~ResourceList() { m_exts.Empty(true); }
+
+	// slots are read from S&M.ini on first access (see Load()), hide the
+	// WDL_PtrList accessors so that nothing can see a list not loaded yet
+	ResourceItem** GetList() { Load(); return WDL_PtrList<ResourceItem>::GetList(); }
+	ResourceItem* Get(INT_PTR _index) { Load(); return WDL_PtrList<ResourceItem>::Get(_index); }
+	int GetSize() { Load(); return WDL_PtrList<ResourceItem>::GetSize(); }
+	int Find(const ResourceItem* _item) { Load(); return WDL_PtrList<ResourceItem>::Find(_item); }
+	ResourceItem* Add(ResourceItem* _item) { Load(); return WDL_PtrList<ResourceItem>::Add(_item); }
+	ResourceItem* Set(int _index, ResourceItem* _item) { Load(); return WDL_PtrList<ResourceItem>::Set(_index, _item); }
+	ResourceItem* Insert(int _index, ResourceItem* _item) { Load(); return WDL_PtrList<ResourceItem>::Insert(_index, _item); }
+	void Delete(int _index, bool _wantDelete=false) { Load(); WDL_PtrList<ResourceItem>::Delete(_index, _wantDelete); }
+	void Empty(bool _wantDelete=false) { Load(); WDL_PtrList<ResourceItem>::Empty(_wantDelete); }
+	void EmptySafe(bool _wantDelete=false) { Load(); WDL_PtrList<ResourceItem>::EmptySafe(_wantDelete); }
+
+	void Load();
+	void DeferLoad() { WDL_PtrList<ResourceItem>::Empty(true); m_loaded = false; }
+	bool IsLoaded() { return m_loaded; }
+
 	int GetNonEmptySize() { int cnt=0; for(int i=0; i<GetSize(); i++) if (!Get(i)->IsDefault()) cnt++; return cnt; }  
 	ResourceItem* AddSlot(const char* _path="", const char* _desc="");
 	ResourceItem* InsertSlot(int _slot, const char* _path="", const char* _desc="");
@@ -100,6 +118,7 @@ protected:
 	WDL_FastString m_name;				// used in user messages, etc..
 	WDL_FastString m_ext;				// file extensions w/o '.' (ex: "rfxchain"), "" means all supported media file extensions
 	int m_flags;						// see bitmask definition above
+	bool m_loaded;						// false until the slots have been read from S&M.ini
 private:
 	WDL_PtrList<WDL_FastString> m_exts;	// split file extensions
 };
@@ -115,6 +134,7 @@ protected:
 	bool IsEditListItemAllowed(SWS_ListItem* item, int iCol);
 	void SetItemText(SWS_ListItem* item, int iCol, const char* str);
 	void OnItemDblClk(SWS_ListItem* item, int iCol);
+	void OnItemSelChanged(SWS_ListItem* item, int iState);
 	void GetItemList(SWS_ListItemList* pList);
 	void OnBeginDrag(SWS_ListItem* item);
 };
@@ -210,13 +230,14 @@ class ImageWnd : public SWS_DockWnd
 public:
 	ImageWnd();
 	void OnCommand(WPARAM wParam, LPARAM lParam);
-	void SetImage(const char* _fn) { m_img.SetImage(_fn); }
+	void SetImage(const char* _fn);
 	void SetStretch(bool _stretch) { m_stretch = _stretch; }
 	bool IsStretched() { return m_stretch; }
 	void RequestRedraw() { m_parentVwnd.RequestRedraw(NULL); }
 	const char* GetFilename() { return m_img.GetFilename(); }
 protected:
 	void OnInitDlg();
+	void OnTimer(WPARAM wParam=0);
 	HMENU OnContextMenu(int x, int y, bool* wantDefaultItems);
 	void DrawControls(LICE_IBitmap* _bm, const RECT* _r, int* _tooltipHeight = NULL);
 	bool GetToolTipString(int _xpos, int _ypos, char* _bufOut, int _bufOutSz);
@@ -230,6 +251,7 @@ void ImageExit();
 void OpenImageWnd(COMMAND_T*);
 bool OpenImageWnd(const char* _fn);
 void ClearImageWnd(COMMAND_T*);
+void PrefetchImageSlots(int _slotType, int _slot);
 int IsImageWndDisplayed(COMMAND_T*);
 
 void ResourcesDeleteAllSlots(COMMAND_T*);
@@ -248,6 +270,7 @@ void ResourcesAutoSaveTrTemplate(COMMAND_T*);
 void ResourcesAutoSave(COMMAND_T*);
 
 // fx chain slots
+bool LoadFXChainFile(const char* _fn, WDL_FastString* _chain);
 void ApplyTracksFXChainSlot(int _slotType, const char* _title, int _slot, bool _set, bool _inputFX);
 bool AutoSaveTrackFXChainSlots(int _slotType, const char* _dirPath, WDL_PtrList<ResourceItem>* _owSlots, bool _nameFromFx, bool _inputFX);
 void LoadSetTrackFXChainSlot(COMMAND_T*);
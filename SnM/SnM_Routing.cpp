@@ -35,6 +35,111 @@
 
 #include <WDL/localize/localize.h>
 
+///////////////////////////////////////////////////////////////////////////////
+// SNM_RoutingBatch
+///////////////////////////////////////////////////////////////////////////////
+
+void SNM_RoutingBatch::AddReceive(MediaTrack* _srcTr, MediaTrack* _destTr, int _type, double _vol, double _pan)
+{
+	if (!_srcTr || !_destTr || _srcTr == _destTr)
+		return;
+
+	const int defSndFlags = *ConfigVar<int>("defsendflag");
+	Addition* a = m_adds.Add(new Addition);
+	a->m_src = _srcTr;
+	a->m_dest = _destTr;
+	a->m_io.m_mute = false;
+	a->m_io.m_phase = 0;
+	a->m_io.m_mono = 0;
+	a->m_io.m_vol = _vol;
+	a->m_io.m_pan = _pan;
+	a->m_io.m_panl = -1.0;
+	a->m_io.m_mode = _type;
+	a->m_io.m_srcChan = (defSndFlags & 512) != 512 ? 0 : -1; // audio
+	a->m_io.m_destChan = 0;
+	a->m_io.m_midi = (defSndFlags & 256) != 256 ? 0 : 31; // midi
+}
+
+void SNM_RoutingBatch::AddReceive(MediaTrack* _srcTr, MediaTrack* _destTr, const SNM_SndRcv* _io)
+{
+	if (!_srcTr || !_destTr || _srcTr == _destTr || !_io)
+		return;
+
+	Addition* a = m_adds.Add(new Addition);
+	a->m_src = _srcTr;
+	a->m_dest = _destTr;
+	a->m_io = *_io;
+}
+
+void SNM_RoutingBatch::RemoveSends(MediaTrack* _srcTr)
+{
+	if (_srcTr) {
+		Removal r = { _srcTr, NULL };
+		m_removals.Add(r);
+	}
+}
+
+void SNM_RoutingBatch::RemoveReceives(MediaTrack* _destTr, MediaTrack* _srcTr)
+{
+	if (_destTr) {
+		Removal r = { _srcTr, _destTr };
+		m_removals.Add(r);
+	}
+}
+
+bool SNM_RoutingBatch::Commit()
+{
+	if (!GetSize())
+		return false;
+
+	bool updated = false;
+	PreventUIRefresh(1);
+
+	for (int i=0; i < m_removals.GetSize(); i++)
+	{
+		const Removal* r = m_removals.Get()+i;
+		if (r->m_dest)
+		{
+			for (int idx=GetTrackNumSends(r->m_dest, -1)-1; idx>=0; idx--)
+				if (!r->m_src || (MediaTrack*)GetSetTrackSendInfo(r->m_dest, -1, idx, "P_SRCTRACK", NULL) == r->m_src)
+					updated |= RemoveTrackSend(r->m_dest, -1, idx);
+		}
+		else
+		{
+			for (int idx=GetTrackNumSends(r->m_src, 0)-1; idx>=0; idx--)
+				updated |= RemoveTrackSend(r->m_src, 0, idx);
+		}
+	}
+
+	for (int i=0; i < m_adds.GetSize(); i++)
+	{
+		Addition* a = m_adds.Get(i);
+		const int idx = CreateTrackSend(a->m_src, a->m_dest);
+		if (idx < 0)
+			continue;
+
+		SNM_SndRcv* io = &a->m_io;
+		bool mute = io->m_mute, phase = io->m_phase != 0, mono = io->m_mono != 0;
+		GetSetTrackSendInfo(a->m_src, 0, idx, "B_MUTE", &mute);
+		GetSetTrackSendInfo(a->m_src, 0, idx, "B_PHASE", &phase);
+		GetSetTrackSendInfo(a->m_src, 0, idx, "B_MONO", &mono);
+		GetSetTrackSendInfo(a->m_src, 0, idx, "D_VOL", &io->m_vol);
+		GetSetTrackSendInfo(a->m_src, 0, idx, "D_PAN", &io->m_pan);
+		GetSetTrackSendInfo(a->m_src, 0, idx, "D_PANLAW", &io->m_panl);
+		GetSetTrackSendInfo(a->m_src, 0, idx, "I_SENDMODE", &io->m_mode);
+		GetSetTrackSendInfo(a->m_src, 0, idx, "I_SRCCHAN", &io->m_srcChan);
+		GetSetTrackSendInfo(a->m_src, 0, idx, "I_DSTCHAN", &io->m_destChan);
+		GetSetTrackSendInfo(a->m_src, 0, idx, "I_MIDIFLAGS", &io->m_midi);
+		updated = true;
+	}
+
+	PreventUIRefresh(-1);
+	m_adds.Empty(true);
+	m_removals.Resize(0);
+	return updated;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Cut/copy/paste routings + track with routings
 // Note: these functions/actions ignore routing envelopes
@@ -123,17 +228,27 @@ void CopySendsReceives(bool _noIntra, WDL_PtrList<MediaTrack>* _trs,
 	// return addedRcvs || addedRcvs;
 }
 
-bool PasteSendsReceives(bool _send, MediaTrack* _tr, SndRcvClipboard* _ios,
-		int _trIdx, WDL_PtrList<SNM_ChunkParserPatcher>* _ps)
+// _ps:    chunk patchers (e.g. track being patched by a template), or
+// _batch: native routing transaction
+static bool PasteSendsReceives(bool _send, MediaTrack* _tr, SndRcvClipboard* _ios,
+		int _trIdx, WDL_PtrList<SNM_ChunkParserPatcher>* _ps, SNM_RoutingBatch* _batch)
 {
 	bool updated = false;
-	if (_tr && _ps && _ios && _ios->Get(_trIdx))
+	if (_tr && (_ps || _batch) && _ios && _ios->Get(_trIdx))
 	{
 		for (int j=0; j < _ios->Get(_trIdx)->GetSize(); j++)
 		{
 			SNM_SndRcv* io = _ios->Get(_trIdx)->Get(j);
 			if (MediaTrack* tr = GuidToTrack(_send ? &io->m_dest : &io->m_src))
 			{
+				if (_batch)
+				{
+					if (tr != _tr) {
+						_batch->AddReceive(_send ? _tr : tr, _send ? tr : _tr, io);
+						updated = true;
+					}
+					continue;
+				}
 				SNM_SendPatcher* p = (SNM_SendPatcher*)SNM_FindCPPbyObject(_ps, _send ? tr : _tr);
 				if (!p) {
 					p = new SNM_SendPatcher(_send ? tr : _tr); 
@@ -146,6 +261,8 @@ bool PasteSendsReceives(bool _send, MediaTrack* _tr, SndRcvClipboard* _ios,
 	return updated;
 }
 
+// _ps: optional, chunk patchers of tracks being patched (committed by the caller),
+//      routings are added with a SNM_RoutingBatch otherwise
 bool PasteSendsReceives(WDL_PtrList<MediaTrack>* _trs,
 		SndRcvClipboard* _snds, SndRcvClipboard* _rcvs,
 		WDL_PtrList<SNM_ChunkParserPatcher>* _ps)
@@ -153,8 +270,9 @@ bool PasteSendsReceives(WDL_PtrList<MediaTrack>* _trs,
 	bool updated = false;
 
 	// a same track can be multi-patched
-	// => patch everything in one go thanks to this list
-	WDL_PtrList<SNM_ChunkParserPatcher>* ps = (_ps ? _ps : new WDL_PtrList<SNM_ChunkParserPatcher>);
+	// => patch everything in one go thanks to the patcher list or the batch
+	SNM_RoutingBatch batch;
+	SNM_RoutingBatch* b = _ps ? NULL : &batch;
 
 	for (int i=0; i<_trs->GetSize(); i++)
 	{
@@ -162,20 +280,21 @@ bool PasteSendsReceives(WDL_PtrList<MediaTrack>* _trs,
 		if ((!_snds || _trs->GetSize()==_snds->GetSize()) &&
 		    (!_rcvs || _trs->GetSize()==_rcvs->GetSize()))
 		{
-			updated |= PasteSendsReceives(true, _trs->Get(i), _snds, i, ps);
-			updated |= PasteSendsReceives(false, _trs->Get(i), _rcvs, i, ps);
+			updated |= PasteSendsReceives(true, _trs->Get(i), _snds, i, _ps, b);
+			updated |= PasteSendsReceives(false, _trs->Get(i), _rcvs, i, _ps, b);
 		}
 		// otherwise: merge all copied routings into dest tracks
 		//JFB TODO? "intra pasted routings" to manage?
 		else
 		{
 			for (int j=0; _snds && j<_snds->GetSize(); j++)
-				updated |= PasteSendsReceives(true, _trs->Get(i), _snds, j, ps);
+				updated |= PasteSendsReceives(true, _trs->Get(i), _snds, j, _ps, b);
 			for (int j=0; _rcvs && j<_rcvs->GetSize(); j++)
-				updated |= PasteSendsReceives(false, _trs->Get(i), _rcvs, j, ps);
+				updated |= PasteSendsReceives(false, _trs->Get(i), _rcvs, j, _ps, b);
 		}
 	}
-	if (!_ps) ps->Empty(true); // + auto commit if needed
+	if (b)
+		updated = b->Commit();
 	return updated;
 }
 
@@ -234,11 +353,11 @@ void CutRoutings(COMMAND_T* _ct)
 	SNM_GetSelectedTracks(NULL, &trs, false);
 	if (trs.GetSize())
 	{
-		WDL_PtrList<SNM_ChunkParserPatcher> ps;
+		SNM_RoutingBatch batch;
 		CopySendsReceives(false, &trs, &g_sndClipboard, &g_rcvClipboard);
-		updated |= RemoveSends(&trs, &ps);
-		updated |= RemoveReceives(&trs, &ps);
-		ps.Empty(true); // auto-commit, if needed
+		RemoveSends(&trs, &batch);
+		RemoveReceives(&trs, &batch);
+		updated = batch.Commit();
 	}
 	if (updated)
 		Undo_OnStateChangeEx2(NULL, SWS_CMD_SHORTNAME(_ct), UNDO_STATE_ALL, -1);
@@ -318,25 +437,21 @@ void PasteReceives(COMMAND_T* _ct)
 ///////////////////////////////////////////////////////////////////////////////
 
 // primitive
-bool RemoveSends(WDL_PtrList<MediaTrack>* _trs, WDL_PtrList<SNM_ChunkParserPatcher>* _ps)
+// _batch: optional, the removal is applied right away otherwise
+bool RemoveSends(WDL_PtrList<MediaTrack>* _trs, SNM_RoutingBatch* _batch)
 {
 	bool updated = false;
-	WDL_PtrList<SNM_ChunkParserPatcher>* ps = (_ps ? _ps : new WDL_PtrList<SNM_ChunkParserPatcher>);
-	for (int j=1; j <= GetNumTracks(); j++) // skip master
-	{
-		if (MediaTrack* trSrc = CSurf_TrackFromID(j, false))
-		{
-			SNM_SendPatcher* p = (SNM_SendPatcher*)SNM_FindCPPbyObject(ps, trSrc);
-			if (!p) {
-				p = new SNM_SendPatcher(trSrc); 
-				ps->Add(p);
+	SNM_RoutingBatch batch;
+	SNM_RoutingBatch* b = (_batch ? _batch : &batch);
+	for (int i=0; i < _trs->GetSize(); i++)
+		if (MediaTrack* tr = _trs->Get(i))
+			if (GetTrackNumSends(tr, 0) > 0)
+			{
+				b->RemoveSends(tr);
+				updated = true;
 			}
-			for (int i=0; i < _trs->GetSize(); i++)
-//				if (_trs->Get(i) != trSrc)
-					updated |= (p->RemoveReceivesFrom(_trs->Get(i)) > 0);
-		}
-	}
-	if (!_ps) ps->Empty(true); // auto-commit if needed
+	if (!_batch)
+		updated = batch.Commit();
 	return updated;
 }
 
@@ -352,21 +467,21 @@ void RemoveSends(COMMAND_T* _ct)
 }
 
 // primitive
-bool RemoveReceives(WDL_PtrList<MediaTrack>* _trs, WDL_PtrList<SNM_ChunkParserPatcher>* _ps)
+// _batch: optional, the removal is applied right away otherwise
+bool RemoveReceives(WDL_PtrList<MediaTrack>* _trs, SNM_RoutingBatch* _batch)
 {
 	bool updated = false;
-	WDL_PtrList<SNM_ChunkParserPatcher>* ps = (_ps ? _ps : new WDL_PtrList<SNM_ChunkParserPatcher>);
+	SNM_RoutingBatch batch;
+	SNM_RoutingBatch* b = (_batch ? _batch : &batch);
 	for (int i=0; i < _trs->GetSize(); i++)
 		if (MediaTrack* tr = _trs->Get(i))
-		{
-			SNM_SendPatcher* p = (SNM_SendPatcher*)SNM_FindCPPbyObject(ps, tr);
-			if (!p) {
-				p = new SNM_SendPatcher(tr); 
-				ps->Add(p);
+			if (GetTrackNumSends(tr, -1) > 0)
+			{
+				b->RemoveReceives(tr);
+				updated = true;
 			}
-			updated |= (p->RemoveReceives() > 0); 
-		}
-	if (!_ps) ps->Empty(true); // auto-commit if needed
+	if (!_batch)
+		updated = batch.Commit();
 	return updated;
 }
 
@@ -388,10 +503,10 @@ void RemoveRoutings(COMMAND_T* _ct)
 	SNM_GetSelectedTracks(NULL, &trs, false);
 	if (trs.GetSize())
 	{
-		WDL_PtrList<SNM_ChunkParserPatcher> ps;
-		updated |= RemoveSends(&trs, &ps);
-		updated |= RemoveReceives(&trs, &ps);
-		ps.Empty(true); // auto-commit, if needed
+		SNM_RoutingBatch batch;
+		RemoveSends(&trs, &batch);
+		RemoveReceives(&trs, &batch);
+		updated = batch.Commit();
 	}
 	if (updated)
 		Undo_OnStateChangeEx2(NULL, SWS_CMD_SHORTNAME(_ct), UNDO_STATE_ALL, -1); 
@@ -65,6 +65,31 @@ public:
 
 
 typedef WDL_PtrList_DeleteOnDestroy<WDL_PtrList_DeleteOnDestroy<SNM_SndRcv>> SndRcvClipboard;
+
+// Routing transaction: collects receive additions/removals, applies them in one go
+// with the native send API on Commit() (or on destruction), no track chunk round trip.
+// Removals are applied before additions. No undo point: up to the caller.
+// Note: tracks with a pending SNM_SendPatcher must be committed first (it would overwrite changes)
+class SNM_RoutingBatch
+{
+public:
+	SNM_RoutingBatch() {}
+	~SNM_RoutingBatch() { Commit(); }
+	// _type: 0=Post-Fader (Post-Pan), 1=Pre-FX, 2=deprecated, 3=Pre-Fader (Post-FX), default send flags (audio/MIDI)
+	void AddReceive(MediaTrack* _srcTr, MediaTrack* _destTr, int _type, double _vol, double _pan);
+	void AddReceive(MediaTrack* _srcTr, MediaTrack* _destTr, const SNM_SndRcv* _io);
+	void RemoveSends(MediaTrack* _srcTr); // track sends only (not hw outputs)
+	void RemoveReceives(MediaTrack* _destTr, MediaTrack* _srcTr = NULL); // _srcTr==NULL: all receives
+	int GetSize() const { return m_adds.GetSize() + m_removals.GetSize(); }
+	bool Commit(); // true if something was updated
+
+private:
+	struct Addition { MediaTrack* m_src; MediaTrack* m_dest; SNM_SndRcv m_io; };
+	struct Removal { MediaTrack* m_src; MediaTrack* m_dest; }; // m_dest==NULL: sends of m_src
+	WDL_PtrList_DeleteOnDestroy<Addition> m_adds;
+	WDL_TypedBuf<Removal> m_removals;
+};
+
 void CopySendsReceives(bool _noIntra, WDL_PtrList<MediaTrack>* _trs, SndRcvClipboard* _snds, SndRcvClipboard* _rcvs, bool forceFlush = true);
 bool PasteSendsReceives(WDL_PtrList<MediaTrack>* _trs, SndRcvClipboard* _snds, SndRcvClipboard* _rcvs, WDL_PtrList<SNM_ChunkParserPatcher>* _ps);
 void CopyWithIOs(COMMAND_T*);
@@ -80,9 +105,9 @@ void CopyReceives(COMMAND_T*);
 void CutReceives(COMMAND_T*);
 void PasteReceives(COMMAND_T*);
 
-bool RemoveSends(WDL_PtrList<MediaTrack>* _trs, WDL_PtrList<SNM_ChunkParserPatcher>* _ps);
+bool RemoveSends(WDL_PtrList<MediaTrack>* _trs, SNM_RoutingBatch* _batch);
 void RemoveSends(COMMAND_T*);
-bool RemoveReceives(WDL_PtrList<MediaTrack>* _trs, WDL_PtrList<SNM_ChunkParserPatcher>* _ps);
+bool RemoveReceives(WDL_PtrList<MediaTrack>* _trs, SNM_RoutingBatch* _batch);
 void RemoveReceives(COMMAND_T*);
 void RemoveRoutings(COMMAND_T*);
 
@@ -137,6 +137,29 @@ bool FileOrDirExists(const char* _fn)
 	return false;
 }
 
+// returns false if _fn does not exist, optionally gets its modification time and size otherwise
+bool GetFileOrDirInfo(const char* _fn, time_t* _mtime, WDL_INT64* _size)
+{
+	if (_fn && *_fn && *_fn!='.')
+	{
+		WDL_FastString fn(_fn);
+		fn.remove_trailing_dirchars();
+
+		struct stat s;
+#ifdef _WIN32
+		if (statUTF8(fn.Get(), &s) == 0)
+#else
+		if (stat(fn.Get(), &s) == 0)
+#endif
+		{
+			if (_mtime) *_mtime = s.st_mtime;
+			if (_size) *_size = (WDL_INT64)s.st_size;
+			return true;
+		}
+	}
+	return false;
+}
+
 // FileOrDirExists() and FileOrDirExistsErrMsg() are intentionally not merged
 // (would impact other project members' code...)
 bool FileOrDirExistsErrMsg(const char* _fn, bool _errMsg)
@@ -294,37 +317,56 @@ void GetFullResourcePath(const char* _resSubDir, const char* _shortFn, char* _fu
 
 // _trim: if true, remove empty lines + left trim
 // _approxMaxlen: if >0, truncate arround _approxMaxlen bytes
-// note: WDL's ProjectCreateFileRead() seems very slow..
+// notes:
+// - the file is read in one go and lines are normalized in place ("\r\n" -> "\n"),
+//   way faster than line by line reads for big track templates, FX chains, etc..
+// - WDL's ProjectCreateFileRead() seems very slow..
 bool LoadChunk(const char* _fn, WDL_FastString* _chunkOut, bool _trim, int _approxMaxlen)
 {
 	if (_chunkOut && _fn && *_fn)
 	{
 		_chunkOut->Set("");
-		if (FILE* f = fopenUTF8(_fn, "r"))
+		if (FILE* f = fopenUTF8(_fn, "rb"))
 		{
-			char line[SNM_MAX_CHUNK_LINE_LENGTH]="";
-			while(fgets(line, sizeof(line), f) && *line)
+			fseek(f, 0, SEEK_END);
+			const long sz = ftell(f);
+			rewind(f);
+
+			WDL_HeapBuf hb;
+			char* buf = sz>0 ? (char*)hb.ResizeOK(sz+1, false) : NULL;
+			const int len = buf ? (int)fread(buf, 1, sz, f) : 0;
+			fclose(f);
+			if (sz>0 && !buf)
+				return false;
+			if (!len)
+				return true;
+
+			// one pass, in place: the write pointer never gets ahead of the read pointer
+			const char* rd = buf;
+			const char* end = buf+len;
+			char* wr = buf;
+			while (rd < end)
 			{
-				if (_trim) //JFB!! useless with SNM_ChunkParserPatcher v2, TBC: v2 supports "\r\n"?
+				const char* eol = (const char*)memchr(rd, '\n', end-rd);
+				const char* next = eol ? eol+1 : end;
+				if (!eol) eol = end;
+				if (eol>rd && eol[-1]=='\r') eol--;
+
+				if (_trim)
+					while (rd<eol && (*rd == ' ' || *rd == '\t')) rd++;
+				if (!_trim || rd<eol) // empty lines are removed when trimming
 				{
-					char* p = line;
-					while(*p && (*p == ' ' || *p == '\t')) p++;
-					if (*p && *p!='\n' && *p!='\r')
-					{
-						// "\r\n" -> "\n"
-						if (const char* eol = FindFirstRN(p)) {
-							_chunkOut->Append(p, (int)(eol-p));
-							_chunkOut->Append("\n");
-						}
-					}
+					memmove(wr, rd, eol-rd);
+					wr += eol-rd;
+					if (next>eol || _trim) // keep the last line as-is when not trimming
+						*wr++ = '\n';
 				}
-				else
-					_chunkOut->Append(line);
+				rd = next;
 
-				if (_approxMaxlen && _chunkOut->GetLength() > _approxMaxlen)
+				if (_approxMaxlen && wr-buf > _approxMaxlen)
 					break;
 			}
-			fclose(f);
+			_chunkOut->Set(buf, (int)(wr-buf));
 			return true;
 		}
 	}
@@ -340,9 +382,10 @@ bool SaveChunk(const char* _fn, WDL_FastString* _chunk, bool _indent)
 		if (_indent) p.Indent();
 		if (FILE* f = fopenUTF8(_fn, "w"))
 		{
-			fputs(p.GetUpdates() ? p.GetChunk()->Get() : _chunk->Get(), f); // avoids p.Commit(), faster
+			const WDL_FastString* chunk = p.GetUpdates() ? p.GetChunk() : _chunk; // avoids p.Commit(), faster
+			const bool ok = fwrite(chunk->Get(), 1, chunk->GetLength(), f) == (size_t)chunk->GetLength();
 			fclose(f);
-			return true;
+			return ok;
 		}
 	}
 	return false;
@@ -873,6 +916,53 @@ double SeekPlay(double _pos, bool _moveView)
 // Action helpers
 ///////////////////////////////////////////////////////////////////////////////
 
+// sorted command ids of action sections (+ their index in the action list),
+// rebuilt when the action list changes
+// note: the list can be edited in place (same pointer and count): a hit is
+//       checked against the action list, a miss rebuilds the ids first
+struct SNM_SectionCmdIds
+{
+	const KbdCmd* m_list;
+	int m_cnt;
+	std::vector<std::pair<int,int> > m_ids; // command id, action list index
+};
+
+static void BuildSectionCmdIds(KbdSectionInfo* _section, SNM_SectionCmdIds* _ids)
+{
+	_ids->m_list = _section->action_list;
+	_ids->m_cnt = _section->action_list_cnt;
+	_ids->m_ids.resize(_ids->m_cnt);
+	for (int i=0; i<_ids->m_cnt; i++)
+		_ids->m_ids[i] = std::make_pair((int)_section->action_list[i].cmd, i);
+	std::sort(_ids->m_ids.begin(), _ids->m_ids.end());
+}
+
+// 1: found and still in the action list, 0: not found, -1: stale hit
+static int FindSectionCmdId(KbdSectionInfo* _section, const SNM_SectionCmdIds& _ids, int _cmdId)
+{
+	std::vector<std::pair<int,int> >::const_iterator it = std::lower_bound(_ids.m_ids.begin(), _ids.m_ids.end(), std::make_pair(_cmdId, -1));
+	if (it == _ids.m_ids.end() || it->first != _cmdId)
+		return 0;
+	return (it->second < _section->action_list_cnt && (int)_section->action_list[it->second].cmd == _cmdId) ? 1 : -1;
+}
+
+static bool IsCmdInSection(KbdSectionInfo* _section, int _cmdId)
+{
+	static std::map<KbdSectionInfo*, SNM_SectionCmdIds> s_sections;
+	SNM_SectionCmdIds& ids = s_sections[_section];
+	bool rebuilt = false;
+	if (ids.m_list != _section->action_list || ids.m_cnt != _section->action_list_cnt || (int)ids.m_ids.size() != _section->action_list_cnt)
+	{
+		BuildSectionCmdIds(_section, &ids);
+		rebuilt = true;
+	}
+	const int found = FindSectionCmdId(_section, ids, _cmdId);
+	if (found == 1 || rebuilt)
+		return found == 1;
+	BuildSectionCmdIds(_section, &ids);
+	return FindSectionCmdId(_section, ids, _cmdId) == 1;
+}
+
 // "fixes" the API's NamedCommandLookup, e.g. NamedCommandLookup("65534")
 // returns "65534" although this action doesn't exist
 // _hardCheck: if true, do more tests on the returned command id because the 
@@ -896,15 +986,8 @@ int SNM_NamedCommandLookup(const char* _custId, KbdSectionInfo* _section, bool _
 		// make sure things like -666 won't match
 		if (cmdId)
 		{
-			bool found = false;
 			KbdSectionInfo* section = _section ? _section : SNM_GetActionSection(SNM_SEC_IDX_MAIN);
-			for (int i=0; i<section->action_list_cnt; i++) {
-				if (section->action_list[i].cmd == cmdId) {
-					found = true;
-					break;
-				}
-			}
-			if (!found)
+			if (!IsCmdInSection(section, cmdId))
 				cmdId = 0;
 		}
 	}
@@ -925,32 +1008,104 @@ const char* SNM_GetTextFromCmd(int _cmdId, KbdSectionInfo* _section)
 	return kbd_getTextFromCmd(_cmdId, _section);
 }
 
-bool LoadKbIni(WDL_PtrList<WDL_FastString>* _out)
+///////////////////////////////////////////////////////////////////////////////
+// reaper-kb.ini macros/scripts catalogue
+// loaded once, indexed by section + custom id, reloaded when the file changes
+///////////////////////////////////////////////////////////////////////////////
+
+struct SNM_KbIniEntry
 {
-	char buf[SNM_MAX_PATH] = "";
-	if (_out && snprintfStrict(buf, sizeof(buf), SNM_KB_INI_FILE, GetResourcePath()) > 0)
+	int m_type; // 1=macro, 2=script
+	WDL_FastString m_name;
+	WDL_PtrList_DeleteOnDestroy<WDL_FastString> m_cmds;
+};
+
+static WDL_PtrList_DeleteOnDestroy<SNM_KbIniEntry> s_kbEntries;
+static std::map<std::string, SNM_KbIniEntry*> s_kbIndex; // "<section unique id> <lowercase custom id>"
+static time_t s_kbMtime = 0, s_kbLoadTime = 0;
+static WDL_INT64 s_kbSize = -1;
+
+static std::string GetKbIniKey(int _sectionUniqueId, const char* _custId)
+{
+	char secId[32] = "";
+	snprintf(secId, sizeof(secId), "%d ", _sectionUniqueId);
+	std::string k(secId);
+	for (const char* p = _custId; *p; p++)
+		k += (char)tolower((unsigned char)*p);
+	return k;
+}
+
+// returns false if reaper-kb.ini cannot be read
+// note: cheap when the file did not change (the user can create new macros, though..)
+// mtimes have a 1 second resolution: a file modified in the second it was loaded
+// (or later, e.g. clock skew) is loaded again on next call
+bool LoadKbIni()
+{
+	char fn[SNM_MAX_PATH] = "";
+	if (snprintfStrict(fn, sizeof(fn), SNM_KB_INI_FILE, GetResourcePath()) <= 0)
+		return false;
+
+	time_t mtime;
+	WDL_INT64 size;
+	if (!GetFileOrDirInfo(fn, &mtime, &size))
+		return false;
+	if (mtime == s_kbMtime && size == s_kbSize && mtime < s_kbLoadTime)
+		return true;
+
+	const time_t loadTime = time(NULL);
+	WDL_FastString content;
+	if (!LoadChunk(fn, &content))
+		return false;
+
+	s_kbEntries.Empty(true);
+	s_kbIndex.clear();
+	s_kbMtime = mtime;
+	s_kbSize = size;
+	s_kbLoadTime = loadTime;
+
+	LineParser lp(false);
+	const char* line = content.Get();
+	while (*line)
 	{
-		_out->Empty(true);
-		if (FILE* f = fopenUTF8(buf, "r"))
+		const char* eol = strchr(line, '\n');
+		const int len = eol ? (int)(eol-line) : (int)strlen(line);
+		if (len>3 && (!_strnicmp(line,"ACT",3) || !_strnicmp(line,"SCR",3)))
 		{
-			while(fgets(buf, sizeof(buf), f) && *buf)
-				if (!_strnicmp(buf,"ACT",3) || !_strnicmp(buf,"SCR",3))
-					_out->Add(new WDL_FastString(buf));
-			fclose(f);
-			return true;
+			WDL_FastString lineStr;
+			lineStr.Set(line, len);
+
+			int success;
+			if (!lp.parse(lineStr.Get()) && lp.getnumtokens()>=5)
+			{
+				int secId = lp.gettoken_int(2, &success);
+				const int type = !_stricmp(lp.gettoken_str(0), "ACT") ? 1 : !_stricmp(lp.gettoken_str(0), "SCR") ? 2 : 0;
+				if (success && type)
+				{
+					std::string key = GetKbIniKey(secId, lp.gettoken_str(3));
+					if (s_kbIndex.find(key) == s_kbIndex.end()) // 1st one wins
+					{
+						SNM_KbIniEntry* entry = s_kbEntries.Add(new SNM_KbIniEntry);
+						entry->m_type = type;
+						entry->m_name.Set(lp.gettoken_str(4));
+						for (int i=5; i<lp.getnumtokens(); i++)
+							entry->m_cmds.Add(new WDL_FastString(lp.gettoken_str(i)));
+						s_kbIndex[key] = entry;
+					}
+				}
+			}
 		}
+		line = eol ? eol+1 : line+len;
 	}
-	return false;
+	return true;
 }
 
 // returns 1 for a macro, 2 for a script, 0 if not found
 // _custId: custom id (both formats are allowed: "bla" and "_bla")
-// _inMacroScripts: to optimize accesses to reaper-kb.ini, required
 // _outCmds: optionnal, if any it is up to the caller to unalloc items
-// note: no cache here (the user can create new macros...)
-int GetMacroOrScript(const char* _custId, int _sectionUniqueId, WDL_PtrList<WDL_FastString>* _inMacroScripts, WDL_PtrList<WDL_FastString>* _outCmds, WDL_FastString* _outName)
+// note: based on the catalogue loaded by LoadKbIni(), call it first
+int GetMacroOrScript(const char* _custId, int _sectionUniqueId, WDL_PtrList<WDL_FastString>* _outCmds, WDL_FastString* _outName)
 {
-	if (!_custId || !_inMacroScripts)
+	if (!_custId)
 		return 0;
 
 	if (*_custId == '_')
@@ -959,41 +1114,17 @@ int GetMacroOrScript(const char* _custId, int _sectionUniqueId, WDL_PtrList<WDL_
 	if (_outCmds)
 		_outCmds->Empty(true);
 
-	int found = 0;
-	for (int i=0; i<_inMacroScripts->GetSize(); i++)
-	{
-		if (const char* cmd = _inMacroScripts->Get(i) ? _inMacroScripts->Get(i)->Get() : "")
-		{
-			LineParser lp(false);
-			if (!lp.parse(cmd) && 
-				lp.getnumtokens()>=5 &&
-				!_stricmp(lp.gettoken_str(3), _custId))
-			{
-				int success, iniSecId = lp.gettoken_int(2, &success);
-				if (success && iniSecId==_sectionUniqueId)
-				{
-					found = !_stricmp(lp.gettoken_str(0), "ACT") ? 1 : !_stricmp(lp.gettoken_str(0), "SCR") ? 2 : 0;
-					if (found)
-					{
-						if (_outName)
-							_outName->Set(lp.gettoken_str(4));
-						if (_outCmds)
-						{
-							for (int i=5; i<lp.getnumtokens(); i++)
-							{
-								WDL_FastString* cmd = new WDL_FastString;
-								const char* p = FindFirstRN(lp.gettoken_str(i)); // there are some "\r\n" sometimes
-								cmd->Set(lp.gettoken_str(i), p ? (int)(p-lp.gettoken_str(i)) : 0);
-								_outCmds->Add(cmd);
-							}
-						}
-					}
-					break;
-				}
-			}
-		}
-	}
-	return found;
+	std::map<std::string, SNM_KbIniEntry*>::const_iterator it = s_kbIndex.find(GetKbIniKey(_sectionUniqueId, _custId));
+	if (it == s_kbIndex.end())
+		return 0;
+
+	const SNM_KbIniEntry* entry = it->second;
+	if (_outName)
+		_outName->Set(entry->m_name.Get());
+	if (_outCmds)
+		for (int i=0; i<entry->m_cmds.GetSize(); i++)
+			_outCmds->Add(new WDL_FastString(entry->m_cmds.Get(i)->Get()));
+	return entry->m_type;
 }
 
 // test if an action name or a custom id is a macro/script one
@@ -1201,14 +1332,6 @@ bool IsTakePolarityFlipped(MediaItem_Take* take)
 // Other util funcs
 ///////////////////////////////////////////////////////////////////////////////
 
-#ifdef _SNM_MISC
-
-#ifdef _WIN32
-#define FNV64_IV ((WDL_UINT64)(0xCBF29CE484222325i64))
-#else
-#define FNV64_IV ((WDL_UINT64)(0xCBF29CE484222325LL))
-#endif
-
 WDL_UINT64 FNV64(WDL_UINT64 h, const unsigned char* data, int sz)
 {
 	int i;
@@ -1224,6 +1347,8 @@ WDL_UINT64 FNV64(WDL_UINT64 h, const unsigned char* data, int sz)
 	return h;
 }
 
+#ifdef _SNM_MISC
+
 // _strOut[65] by definition..
 bool FNV64(const char* _strIn, char* _strOut)
 {
@@ -39,6 +39,7 @@ const char* GetFilenameWithExt(const char* _fullFn);
 bool Filenamize(char* _fnInOut, bool _checkOnly = false);
 bool IsValidFilenameErrMsg(const char* _fn, bool _errMsg);
 bool FileOrDirExists(const char* _fn);
+bool GetFileOrDirInfo(const char* _fn, time_t* _mtime = NULL, WDL_INT64* _size = NULL);
 bool FileOrDirExistsErrMsg(const char* _fn, bool _errMsg = true);
 bool SNM_DeleteFile(const char* _filename, bool _recycleBin);
 bool SNM_DeletePeakFile(const char* _fn, bool _recycleBin);
@@ -81,8 +82,8 @@ double SeekPlay(double _pos, bool _moveView = false);
 
 int SNM_NamedCommandLookup(const char* _custId, KbdSectionInfo* _section = NULL, bool _hardCheck = false);
 const char* SNM_GetTextFromCmd(int _cmdId, KbdSectionInfo* _section);
-bool LoadKbIni(WDL_PtrList<WDL_FastString>* _out);
-int GetMacroOrScript(const char* _customId, int _sectionUniqueId, WDL_PtrList<WDL_FastString>* _inMacroScripts, WDL_PtrList<WDL_FastString>* _outCmds, WDL_FastString* _outName = NULL);
+bool LoadKbIni();
+int GetMacroOrScript(const char* _customId, int _sectionUniqueId, WDL_PtrList<WDL_FastString>* _outCmds, WDL_FastString* _outName = NULL);
 enum class ActionType { Unknown, Custom, ReaScript };
 ActionType GetActionType(const char* _cmd, bool _cmdIsName = true);
 bool IsMacroOrScript(const char* _cmd, bool _cmdIsName = true);
@@ -99,8 +100,14 @@ bool GetSectionURL(bool _alr, KbdSectionInfo* _section, char* _sectionURL, int _
 // Get/SetMediaItemTakeInfo_Value(*,"D_VOL") uses negative value (sign flip) if take polarity is flipped
 bool IsTakePolarityFlipped(MediaItem_Take* take);
 
-#ifdef _SNM_MISC
+#ifdef _WIN32
+#define FNV64_IV ((WDL_UINT64)(0xCBF29CE484222325i64))
+#else
+#define FNV64_IV ((WDL_UINT64)(0xCBF29CE484222325LL))
+#endif
+
 WDL_UINT64 FNV64(WDL_UINT64 h, const unsigned char* data, int sz);
+#ifdef _SNM_MISC
 bool FNV64(const char* _strIn, char* _strOut);
 #endif
 
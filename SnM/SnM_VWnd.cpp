@@ -491,6 +491,10 @@ void SNM_ToolbarButton::SetGrayed(bool _grayed)
 // SNM_ImageVWnd
 ///////////////////////////////////////////////////////////////////////////////
 
+SNM_ImageVWnd::~SNM_ImageVWnd() {
+	if (m_cached) ReleaseImage(); // other images (e.g. logo) are not owned
+}
+
 int SNM_ImageVWnd::GetWidth() {
 	if (m_img) return m_img->getWidth();
 	return 0;
@@ -501,17 +505,54 @@ int SNM_ImageVWnd::GetHeight() {
 	return 0;
 }
 
-void SNM_ImageVWnd::SetImage(const char* _fn)
+void SNM_ImageVWnd::ReleaseImage()
 {
+	if (m_cached) g_SNM_ImageCache.Release(m_img);
+	else delete m_img;
+	m_img = NULL;
+	m_cached = false;
+}
+
+// non blocking: the image is decoded asynchronously if not cached yet, 
+// see IsPending() and Poll()
+// _maxDim: downscale the image to fit this size (0 for full size)
+void SNM_ImageVWnd::SetImage(const char* _fn, int _maxDim)
+{
+	ReleaseImage();
+	m_pending = false;
+	m_maxDim = _maxDim;
 	if (_fn && *_fn)
-		if ((m_img = LICE_LoadPNG(_fn, NULL))) {
+	{
+		bool failed;
+		if ((m_img = g_SNM_ImageCache.Acquire(_fn, m_maxDim, true, &failed)) || !failed)
+		{
 			m_fn.Set(_fn);
+			m_cached = (m_img != NULL);
+			m_pending = !m_cached;
 			return;
 		}
-	DELETE_NULL(m_img);
+	}
 	m_fn.Set("");
 }
 
+// returns true when a pending image has been decoded or has failed (i.e. needs redraw)
+bool SNM_ImageVWnd::Poll()
+{
+	if (m_pending && m_fn.GetLength())
+	{
+		bool failed;
+		// re-request: no-op if still queued, the request may have been cancelled
+		if ((m_img = g_SNM_ImageCache.Acquire(m_fn.Get(), m_maxDim, true, &failed)) || failed)
+		{
+			m_cached = (m_img != NULL);
+			m_pending = false;
+			if (failed) m_fn.Set("");
+			return true;
+		}
+	}
+	return false;
+}
+
 
 void SNM_ImageVWnd::OnPaint(LICE_IBitmap *drawbm, int origin_x, int origin_y, RECT *cliprect, int rscale) {
 	if (m_img)
@@ -525,6 +566,252 @@ void SNM_ImageVWnd::OnPaint(LICE_IBitmap *drawbm, int origin_x, int origin_y, RE
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+// SNM_ImageCache
+///////////////////////////////////////////////////////////////////////////////
+
+SNM_ImageCache g_SNM_ImageCache;
+
+SNM_ImageCache::SNM_ImageCache(int _maxImages)
+	: m_maxImages(_maxImages), m_thread(NULL), m_wakeUp(NULL), m_quit(false) {}
+
+// the cache must be stopped before the extension gets unloaded, see ImageExit()
+void SNM_ImageCache::Stop()
+{
+	if (m_thread)
+	{
+		m_quit = true;
+		SetEvent(m_wakeUp);
+		WaitForSingleObject(m_thread, INFINITE);
+		CloseHandle(m_thread);
+		m_thread = NULL;
+	}
+	if (m_wakeUp)
+	{
+		CloseHandle(m_wakeUp);
+		m_wakeUp = NULL;
+	}
+
+	SWS_SectionLock lock(&m_mutex);
+	m_requests.Empty(true);
+	m_failed.Empty(true);
+	for (int i=m_entries.GetSize()-1; i>=0; i--)
+		if (!m_entries.Get(i)->m_refs)
+			Delete(i);
+}
+
+// filename + max dimension, '\n' cannot be part of a filename
+void SNM_ImageCache::GetKey(const char* _fn, int _maxDim, WDL_FastString* _key)
+{
+	_key->Set(_fn);
+	_key->AppendFormatted(16, "\n%d", _maxDim);
+}
+
+// assumes m_mutex is locked, _e becomes the most recently used entry
+void SNM_ImageCache::Add(Entry* _e)
+{
+	m_entries.Add(_e);
+	m_index.Insert(_e->m_key.Get(), _e);
+}
+
+// assumes m_mutex is locked
+void SNM_ImageCache::Delete(int _idx)
+{
+	if (Entry* e = m_entries.Get(_idx))
+	{
+		if (!e->m_stale)
+			m_index.Delete(e->m_key.Get());
+		m_entries.Delete(_idx, true);
+	}
+}
+
+// assumes m_mutex is locked, never evicts images in use
+void SNM_ImageCache::Evict()
+{
+	int nbEntries = m_entries.GetSize();
+	for (int i=0; i < m_entries.GetSize(); )
+	{
+		Entry* e = m_entries.Get(i);
+		if (!e->m_refs && (e->m_stale || nbEntries > m_maxImages)) {
+			if (!e->m_stale) nbEntries--;
+			Delete(i);
+		}
+		else i++;
+	}
+}
+
+// returns the decoded image (it is up to the caller to Release() it) or
+// NULL if not decoded yet, in which case the image is requested (optional)
+// _failed: optional, true if the file could not be decoded (reported once,
+//          the next call requests it again)
+LICE_IBitmap* SNM_ImageCache::Acquire(const char* _fn, int _maxDim, bool _request, bool* _failed)
+{
+	if (_failed) *_failed = false;
+	if (!_fn || !*_fn)
+		return NULL;
+
+	time_t mtime = 0;
+	WDL_INT64 size = 0;
+	GetFileOrDirInfo(_fn, &mtime, &size);
+
+	WDL_FastString key;
+	GetKey(_fn, _maxDim, &key);
+	{
+		SWS_SectionLock lock(&m_mutex);
+		for (int i=0; i < m_failed.GetSize(); i++)
+			if (!strcmp(m_failed.Get(i)->Get(), key.Get())) {
+				m_failed.Delete(i, true);
+				if (_failed) *_failed = true;
+				return NULL;
+			}
+
+		if (Entry* e = Find(key.Get()))
+		{
+			if (e->m_mtime == mtime && e->m_size == size)
+			{
+				e->m_refs++;
+				m_entries.Delete(m_entries.Find(e), false); // most recently used
+				m_entries.Add(e);
+				return e->m_img;
+			}
+			// modified since decoded
+			m_index.Delete(key.Get());
+			e->m_stale = true;
+			Evict();
+		}
+	}
+	if (_request)
+		Request(_fn, _maxDim);
+	return NULL;
+}
+
+void SNM_ImageCache::Release(LICE_IBitmap* _img)
+{
+	if (!_img)
+		return;
+	SWS_SectionLock lock(&m_mutex);
+	for (int i=0; i < m_entries.GetSize(); i++)
+		if (m_entries.Get(i)->m_img == _img) {
+			m_entries.Get(i)->m_refs--;
+			break;
+		}
+	Evict();
+}
+
+// _maxDim: downscale the image to fit this size (0 for full size)
+// _prefetch: false to decode this image before any other pending request
+void SNM_ImageCache::Request(const char* _fn, int _maxDim, bool _prefetch)
+{
+	if (!_fn || !*_fn)
+		return;
+
+	{
+		WDL_FastString key;
+		GetKey(_fn, _maxDim, &key);
+
+		SWS_SectionLock lock(&m_mutex);
+		if (Find(key.Get())) // modified files are detected by Acquire()
+			return;
+		for (int i=0; i < m_requests.GetSize(); i++)
+		{
+			Req* req = m_requests.Get(i);
+			if (req->m_maxDim == _maxDim && !strcmp(req->m_fn.Get(), _fn)) {
+				if (_prefetch) return;
+				m_requests.Delete(i, true);
+				break;
+			}
+		}
+		if (_prefetch) m_requests.Add(new Req(_fn, _maxDim));
+		else m_requests.Insert(0, new Req(_fn, _maxDim));
+	}
+
+	if (!m_thread) {
+		m_quit = false;
+		if (!m_wakeUp) m_wakeUp = CreateEvent(NULL, FALSE, FALSE, NULL);
+		m_thread = (HANDLE)_beginthreadex(NULL, 0, DecodeThread, (void*)this, 0, NULL);
+	}
+	SetEvent(m_wakeUp);
+}
+
+// cancels pending requests (e.g. prefetched slots that are not selected anymore)
+// note: the image being decoded, if any, still gets cached
+void SNM_ImageCache::CancelRequests()
+{
+	SWS_SectionLock lock(&m_mutex);
+	m_requests.Empty(true);
+}
+
+LICE_IBitmap* SNM_ImageCache::Decode(const char* _fn, int _maxDim)
+{
+	LICE_IBitmap* img = LICE_LoadPNG(_fn, NULL);
+	if (!img)
+		return NULL;
+
+	int w = img->getWidth(), h = img->getHeight();
+	if (_maxDim > 0 && (w > _maxDim || h > _maxDim))
+	{
+		double ratio = (double)_maxDim / (w > h ? w : h);
+		int dw = max(1, int(w*ratio + 0.5)), dh = max(1, int(h*ratio + 0.5));
+		LICE_MemBitmap* scaled = new LICE_MemBitmap(dw, dh);
+		LICE_Clear(scaled, 0);
+		LICE_ScaledBlit(scaled, img, 0, 0, dw, dh, 0.0f, 0.0f, (float)w, (float)h, 1.0f, LICE_BLIT_MODE_COPY|LICE_BLIT_FILTER_BILINEAR);
+		delete img;
+		img = scaled;
+	}
+	return img;
+}
+
+unsigned WINAPI SNM_ImageCache::DecodeThread(void* _cache)
+{
+	SNM_ImageCache* cache = (SNM_ImageCache*)_cache;
+	WDL_FastString fn, key;
+	int maxDim = 0;
+	while (!cache->m_quit)
+	{
+		fn.Set("");
+		{
+			SWS_SectionLock lock(&cache->m_mutex);
+			if (Req* req = cache->m_requests.Get(0)) {
+				fn.Set(req->m_fn.Get());
+				maxDim = req->m_maxDim;
+				cache->m_requests.Delete(0, true);
+			}
+		}
+
+		if (!fn.GetLength()) {
+			WaitForSingleObject(cache->m_wakeUp, INFINITE);
+			continue;
+		}
+
+		// file info first: a file modified while decoding gets decoded again
+		time_t mtime = 0;
+		WDL_INT64 size = 0;
+		bool exists = GetFileOrDirInfo(fn.Get(), &mtime, &size);
+		LICE_IBitmap* img = exists ? Decode(fn.Get(), maxDim) : NULL;
+		GetKey(fn.Get(), maxDim, &key);
+
+		SWS_SectionLock lock(&cache->m_mutex);
+		if (!img)
+		{
+			int i = cache->m_failed.GetSize();
+			while (--i >= 0 && strcmp(cache->m_failed.Get(i)->Get(), key.Get()));
+			if (i < 0) {
+				if (cache->m_failed.GetSize() >= cache->m_maxImages) // e.g. failed prefetches, never acquired
+					cache->m_failed.Delete(0, true);
+				cache->m_failed.Add(new WDL_FastString(key.Get()));
+			}
+		}
+		else if (!cache->Find(key.Get())) {
+			cache->Add(new Entry(key.Get(), img, mtime, size));
+			cache->Evict();
+		}
+		else
+			delete img;
+	}
+	return 0;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // SNM_Logo
 ///////////////////////////////////////////////////////////////////////////////
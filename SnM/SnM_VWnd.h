@@ -114,18 +114,78 @@ protected:
 	int m_nbRows;
 };
 
+#define SNM_IMG_MAX_DIM		2048 // stretched images are downscaled to fit this size
+
+// asynchronous image decoder + bounded LRU cache of decoded images
+// images are decoded in a worker thread, downscaled to fit _maxDim if > 0
+// entries are keyed by filename and _maxDim, files modified since they were decoded
+// (mtime or size) are decoded again, files that could not be decoded are not cached
+// note: Acquire(), Release(), Request() and CancelRequests() are main thread only
+class SNM_ImageCache
+{
+public:
+	SNM_ImageCache(int _maxImages = 32);
+	~SNM_ImageCache() { Stop(); }
+	LICE_IBitmap* Acquire(const char* _fn, int _maxDim = 0, bool _request = true, bool* _failed = NULL);
+	void Release(LICE_IBitmap* _img);
+	void Request(const char* _fn, int _maxDim = 0, bool _prefetch = false);
+	void CancelRequests();
+	void Stop();
+private:
+	struct Entry {
+		Entry(const char* _key, LICE_IBitmap* _img, time_t _mtime, WDL_INT64 _size)
+			: m_key(_key), m_img(_img), m_mtime(_mtime), m_size(_size), m_refs(0), m_stale(false) {}
+		~Entry() { delete m_img; }
+		WDL_FastString m_key;
+		LICE_IBitmap* m_img;
+		time_t m_mtime;
+		WDL_INT64 m_size;
+		int m_refs;
+		bool m_stale; // file modified: not indexed anymore, deleted once released
+	};
+	struct Req {
+		Req(const char* _fn, int _maxDim) : m_fn(_fn), m_maxDim(_maxDim) {}
+		WDL_FastString m_fn;
+		int m_maxDim;
+	};
+	static unsigned WINAPI DecodeThread(void* _cache);
+	static LICE_IBitmap* Decode(const char* _fn, int _maxDim);
+	static void GetKey(const char* _fn, int _maxDim, WDL_FastString* _key);
+	Entry* Find(const char* _key) { return m_index.Get(_key, NULL); }
+	void Add(Entry* _e);
+	void Delete(int _idx);
+	void Evict();
+
+	SWS_Mutex m_mutex;
+	WDL_PtrList<Entry> m_entries; // LRU first
+	WDL_StringKeyedArray<Entry*> m_index; // same entries (but stale ones), see GetKey()
+	WDL_PtrList_DeleteOnDestroy<Req> m_requests; // pending, first one is decoded next
+	WDL_PtrList_DeleteOnDestroy<WDL_FastString> m_failed; // keys of files that could not be decoded, reported once by Acquire()
+	int m_maxImages;
+	HANDLE m_thread, m_wakeUp; // m_wakeUp: signaled when requests are queued or on Stop()
+	volatile bool m_quit;
+};
+
+extern SNM_ImageCache g_SNM_ImageCache;
+
 class SNM_ImageVWnd : public WDL_VWnd {
 public:
-	SNM_ImageVWnd(LICE_IBitmap* _img = NULL) : WDL_VWnd(), m_img(_img) {}
+	SNM_ImageVWnd(LICE_IBitmap* _img = NULL) : WDL_VWnd(), m_img(_img), m_maxDim(0), m_cached(false), m_pending(false) {}
+	virtual ~SNM_ImageVWnd();
 	virtual const char *GetType() { return "SNM_ImageVWnd"; }
 	virtual const char* GetFilename() { return m_fn.Get(); }
 	virtual int GetWidth();
 	virtual int GetHeight();
-	virtual void SetImage(const char* _fn);
+	virtual void SetImage(const char* _fn, int _maxDim = 0);
+	virtual bool IsPending() { return m_pending; }
+	virtual bool Poll();
 	virtual void OnPaint(LICE_IBitmap *drawbm, int origin_x, int origin_y, RECT *cliprect, int rscale);
 protected:
+	void ReleaseImage();
 	LICE_IBitmap* m_img;
 	WDL_FastString m_fn;
+	int m_maxDim;
+	bool m_cached, m_pending; // m_cached: m_img is owned by g_SNM_ImageCache
 };
 
 //JFB TODO: hyperlink
@@ -82,6 +82,7 @@ public:
 
 // Globals
 static SWSProjConfig<ProjSnapshot> g_ss;
+static SWSProjExtState g_ssState("Snapshots"); // snapshot changes end with a window update, which marks it dirty
 SWS_SnapshotsWnd* g_pSSWnd=NULL;
 void PasteSnapshot(COMMAND_T*);
 void MergeSnapshot(Snapshot* ss);
@@ -447,6 +448,7 @@ int SWS_SnapshotsView::OnNotify(WPARAM wParam, LPARAM lParam)
 void SWS_SnapshotsView::SetItemText(SWS_ListItem* item, int iCol, const char* str)
 {
 	Snapshot* ss = (Snapshot*)item;
+	g_ssState.SetDirty();
 	switch (iCol)
 	{
 	case 1:
@@ -527,7 +529,10 @@ void SWS_SnapshotsView::OnItemClk(SWS_ListItem* item, int iCol, int iKeyState)
 		g_ss.Get()->m_pCurSnapshot = ss;
 		const std::string safes = g_bFilterSafes ? GetSavedSafesGuidList() : std::string();
 		if (ss->UpdateReaper(g_bApplyFilterOnRecall ? g_iMask : ALL_MASK, g_bSelOnly_OnRecall, g_bHideNewOnRecall, g_bFilterSafes, safes))
+		{
+			g_ssState.SetDirty(); // deleted tracks were removed
 			Update();
+		}
 		if (g_record)
 			Main_OnCommand(1013, 0); // resume recording after recall
 	}
@@ -536,6 +541,7 @@ void SWS_SnapshotsView::OnItemClk(SWS_ListItem* item, int iCol, int iKeyState)
 	{
 		g_ss.Get()->m_pCurSnapshot = g_ss.Get()->m_snapshots.Set(g_ss.Get()->m_snapshots.Find(ss), new Snapshot(ss->m_iSlot, g_iMask, g_bSelOnly_OnSave, ss->m_cName, ss->m_cNotes, ss->m_cScreenSet));
 		delete ss;
+		g_ssState.SetDirty();
 		Update();
 	}
 	// Delete (alt click)
@@ -615,6 +621,8 @@ SWS_SnapshotsWnd::~SWS_SnapshotsWnd()
 
 void SWS_SnapshotsWnd::Update()
 {
+	g_ssState.SetDirty(); // even if hidden
+
 	static bool bRecurseCheck = false;
 	if (!IsValidWindow() || bRecurseCheck || !m_pLists.GetSize() || m_pLists.Get(0)->UpdatesDisabled())
 		return;
@@ -1396,6 +1404,7 @@ void DeleteSnapshot(Snapshot *ss)
 		g_ss.Get()->m_pCurSnapshot = NULL;
 
 	const int iSlot = ss->m_iSlot;
+	g_ssState.SetDirty();
 	g_ss.Get()->m_snapshots.Delete(g_ss.Get()->m_snapshots.Find(ss), true);
 
 	// clean up gaps rather than search for them on insert
@@ -1470,7 +1479,7 @@ static bool ProcessExtensionLine(const char *line, ProjectStateContext *ctx, boo
 	return false;
 }
 
-static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct project_config_extension_t *reg)
+static void SerializeSnapshots(ProjectStateContext *ctx)
 {
 	WDL_FastString chunk;
 	char line[4096];
@@ -1484,8 +1493,14 @@ static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct pr
 	}
 }
 
+static void SaveExtensionConfig(ProjectStateContext *ctx, bool isUndo, struct project_config_extension_t *reg)
+{
+	g_ssState.Save(ctx, isUndo, SerializeSnapshots);
+}
+
 static void BeginLoadProjectState(bool isUndo, struct project_config_extension_t *reg)
 {
+	g_ssState.BeginLoad(isUndo);
 	DeleteAllSnapshots();
 	g_ss.Cleanup();
 	UpdateSnapshotsDialog();
@@ -0,0 +1,122 @@
+/******************************************************************************
+/ SampleArena.h
+/
+/ Copyright (c) 2026 SWS
+/
+/
+/ Permission is hereby granted, free of charge, to any person obtaining a copy
+/ of this software and associated documentation files (the "Software"), to deal
+/ in the Software without restriction, including without limitation the rights to
+/ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/ of the Software, and to permit persons to whom the Software is furnished to
+/ do so, subject to the following conditions:
+/
+/ The above copyright notice and this permission notice shall be included in all
+/ copies or substantial portions of the Software.
+/
+/ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+/ EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+/ OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+/ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+/ HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+/ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+/ OTHER DEALINGS IN THE SOFTWARE.
+/
+******************************************************************************/
+
+#pragma once
+
+// SWS_SampleArena: recycles sample buffers of analysis loops (GetSamples(),
+// GetAudioAccessorSamples()...) instead of allocating one per block or per item.
+// Buffers are 64-byte aligned and rounded up to a power of two size class, a
+// released buffer is handed out again for any request of the same class.
+// Not thread-safe: each analysis thread owns its arena (thread-local storage is
+// avoided on purpose, it isn't reliable in dynamically loaded DLLs on Windows XP).
+//
+// Usage:
+// SWS_SampleArena arena;
+// while (...)
+// {
+//     SWS_SampleBuf buf(&arena, frames * nch); // no heap allocation after the first block
+//     GetAudioAccessorSamples(..., buf.Get());
+// }
+class SWS_SampleArena
+{
+public:
+	SWS_SampleArena() : m_allocCount(0), m_requestCount(0) {}
+	~SWS_SampleArena()
+	{
+		for (int i = 0; i < NB_CLASSES; i++)
+			for (int j = 0; j < m_free[i].GetSize(); j++)
+				free(Header(m_free[i].Get(j))->raw);
+	}
+
+	// contents are undefined, returns NULL if count <= 0 or out of memory
+	ReaSample* Get(int count)
+	{
+		if (count <= 0)
+			return NULL;
+		m_requestCount++;
+		int sizeClass = MIN_CLASS;
+		while (sizeClass < NB_CLASSES - 1 && (1 << sizeClass) < count)
+			sizeClass++;
+		if ((1 << sizeClass) < count)
+			return NULL;
+
+		if (int n = m_free[sizeClass].GetSize())
+		{
+			ReaSample* buf = m_free[sizeClass].Get(n - 1);
+			m_free[sizeClass].Delete(n - 1);
+			return buf;
+		}
+
+		void* raw = malloc(((size_t)1 << sizeClass) * sizeof(ReaSample) + ALIGN + sizeof(BufHeader));
+		if (!raw)
+			return NULL;
+		m_allocCount++;
+		INT_PTR aligned = ((INT_PTR)raw + sizeof(BufHeader) + ALIGN - 1) & ~(INT_PTR)(ALIGN - 1);
+		ReaSample* buf = (ReaSample*)aligned;
+		Header(buf)->raw = raw;
+		Header(buf)->sizeClass = sizeClass;
+		return buf;
+	}
+
+	void Release(ReaSample* buf)
+	{
+		if (buf)
+			m_free[Header(buf)->sizeClass].Add(buf);
+	}
+
+	// Heap allocations vs. Get() calls, allocations stop growing once the arena is warm
+	int GetAllocCount() const   { return m_allocCount; }
+	int GetRequestCount() const { return m_requestCount; }
+
+private:
+	enum { ALIGN = 64, MIN_CLASS = 6, NB_CLASSES = 28 };
+	struct BufHeader
+	{
+		void* raw;
+		int sizeClass;
+	};
+	static BufHeader* Header(ReaSample* buf) { return (BufHeader*)buf - 1; }
+
+	WDL_PtrList<ReaSample> m_free[NB_CLASSES];
+	int m_allocCount, m_requestCount;
+};
+
+// Scoped buffer from a SWS_SampleArena, released when going out of scope
+class SWS_SampleBuf
+{
+public:
+	SWS_SampleBuf(SWS_SampleArena* arena, int count) : m_arena(arena), m_buf(arena->Get(count)) {}
+	~SWS_SampleBuf() { m_arena->Release(m_buf); }
+	ReaSample* Get() { return m_buf; }
+
+private:
+	SWS_SampleBuf(const SWS_SampleBuf&);
+	SWS_SampleBuf& operator=(const SWS_SampleBuf&);
+
+	SWS_SampleArena* m_arena;
+	ReaSample* m_buf;
+};
@@ -30,6 +30,7 @@
 #include "../SnM/SnM_Dlg.h"
 #include "Parameters.h"
 #include "../SnM/SnM_Util.h"
+#include "../Misc/Analysis.h"
 
 #include <WDL/localize/localize.h>
 
@@ -222,66 +223,18 @@ void DoNudgeSamples(COMMAND_T* ct)
 
 void DoSplitItemsAtTransients(COMMAND_T* ct)
 {
-	MediaTrack* MunRaita;
-	MediaItem* CurItem;
-	bool ItemSelected=false;
-
-	int ItemCounter=0;
-	const int numItems=CountSelectedMediaItems(NULL);
-	MediaItem** MediaItemsInProject = new MediaItem*[numItems];
-	int i, j;
-	for (i=0;i<GetNumTracks();i++)
-	{
-		MunRaita = CSurf_TrackFromID(i+1,FALSE);
-		int numItemsTrack=GetTrackNumMediaItems(MunRaita);
+	WDL_TypedBuf<MediaItem*> items;
+	SWS_GetSelectedMediaItems(&items);
+	if (!items.GetSize())
+		return;
 
-		for (j=0;j<numItemsTrack;j++)
-		{
-			CurItem = GetTrackMediaItem(MunRaita,j);
-			ItemSelected=*(bool*)GetSetMediaItemInfo(CurItem,"B_UISEL",NULL);
-			if (ItemSelected==TRUE)
-			{
-				//CurrentPos=*(double*)GetSetMediaItemInfo(CurItem,"D_POSITION",NULL);
-				//if (ItemCounter==0) MinTime=CurrentPos;
-				//if (ItemCounter>0 && CurrentPos<MinTime) MinTime=CurrentPos;
-				MediaItemsInProject[ItemCounter]=CurItem;
-				ItemCounter++;
-			}
-		}
-	}
+	double dSensitivity, dThreshold;
+	GetTransientOptions(&dSensitivity, &dThreshold);
 
 	Undo_BeginBlock();
-	for (i=0;i<numItems;i++)
-	{
-		Main_OnCommand(40289,0); // unselect all items
-		CurItem=MediaItemsInProject[i];
-		bool SelStatus=true;
-		GetSetMediaItemInfo(CurItem,"B_UISEL",&SelStatus);
-		double SelItemPos=*(double*)GetSetMediaItemInfo(CurItem,"D_POSITION",NULL);
-		double SelItemLen=*(double*)GetSetMediaItemInfo(CurItem,"D_LENGTH",NULL);
-		SetEditCurPos(SelItemPos,false,false); // edit cursor now at the beginning of selected item
-		int NumSplits=0;
-		double CurPos=GetCursorPosition();
-		double LastCurPos;
-		while (CurPos<=(SelItemLen+SelItemPos))
-		{
-			LastCurPos=CurPos;
-			Main_OnCommand(40375,0); // go to next transient in item
-			Main_OnCommand(40012,0); // split at edit cursor
-			CurPos=GetCursorPosition();
-
-			if (LastCurPos==CurPos)
-				NumSplits++;
-
-			if (NumSplits>3) // we will believe after 3 futile iterations that this IS the last transient of the item
-				break;
-		}
-	}
-
-	delete[] MediaItemsInProject;
-	//adjustZoom(CurrentHZoom, 0, false, -1);
-	UpdateTimeline();
-	Undo_EndBlock(SWS_CMD_SHORTNAME(ct),0);
+	if (SplitItemsAtTransients(&items, dSensitivity, dThreshold))
+		UpdateTimeline();
+	Undo_EndBlock(SWS_CMD_SHORTNAME(ct), UNDO_STATE_ITEMS);
 }
 
 void DoNudgeItemVols(bool UseConf,bool Positive,double TheNudgeAmount)
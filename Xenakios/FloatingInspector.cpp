@@ -153,6 +153,10 @@ void DoTglFltItemInspector(COMMAND_T*)
 	}
 	else
 	{
+		if (!g_hItemInspector)
+			g_hItemInspector = CreateDialog(g_hInst, MAKEINTRESOURCE(IDD_ITEM_INSPECTOR), g_hwndParent, (DLGPROC)MyItemInspectorDlgProc);
+		if (!g_hItemInspector)
+			return;
 		g_ItemInspectorVisible = true;
 		SetTimer(g_hItemInspector, 1, 200, NULL);
 		ShowWindow(g_hItemInspector, SW_SHOW);
@@ -29,9 +29,14 @@
 
 #include "../Breeder/BR_Util.h"
 #include "../SnM/SnM_Dlg.h"
+#include "../SnM/SnM_Util.h"
 
 #include <WDL/localize/localize.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+
 using namespace std;
 
 HWND g_hMediaDlg=0;
@@ -130,9 +135,8 @@ void GetAllProjectTakes(vector<t_project_take>& ATakeList)
 
 void GetProjectFileList(vector<t_mediafile_status>& AMediaList)
 {
-	vector<string> ProjectFiles;
 	vector<string> TempList;
-	vector<int> vecusedcount;
+	set<string> TempSet;
 	int i;
 	int j;
 	int k;
@@ -172,17 +176,8 @@ void GetProjectFileList(vector<t_mediafile_status>& AMediaList)
 								else
 									FName.assign("no file...");
 							}
-							if (!ispurelyMIDI)
-							{
-								int Matches=0;
-								for (int L=0;L<(int)TempList.size();L++)
-								{
-									if (FName.compare(TempList[L])==0)
-										Matches++;
-								}
-								if (Matches==0)
-									TempList.push_back(FName);
-							}
+							if (!ispurelyMIDI && TempSet.insert(FName).second)
+								TempList.push_back(FName);
 						}
 					}
 				}
@@ -203,16 +198,11 @@ void GetProjectFileList(vector<t_mediafile_status>& AMediaList)
 	}
 }
 
-int IsFileUsedInProject(string AFile)
+// number of times AFile is listed in g_RProjectFiles, see UpdateProjFolderList()
+int IsFileUsedInProject(const string& AFile, const unordered_map<string,int>& ProjectFileCounts)
 {
-	int Matches=0;
-	int i;
-	for (i=0;i<(int)g_RProjectFiles.size();i++)
-	{
-		if (AFile.compare(g_RProjectFiles[i].FileName)==0) Matches++;
-	}
-	return Matches;
-	//if (Matches>0) return true; else return false;
+	unordered_map<string,int>::const_iterator it=ProjectFileCounts.find(AFile);
+	return it!=ProjectFileCounts.end() ? it->second : 0;
 }
 
 vector<string> g_ProjFolFiles;
@@ -247,6 +237,10 @@ void UpdateProjFolderList(HWND hList, bool onlyUnused)
 	GetProjectPath(buf,2048);
 
 	SearchDirectory(g_ProjFolFiles,buf,NULL,true);
+	unordered_map<string,int> ProjectFileCounts;
+	for (i=0;i<(int)g_RProjectFiles.size();i++)
+		ProjectFileCounts[g_RProjectFiles[i].FileName]++;
+
 	int j=0;
 	bool HidePaths=false;
 	if (IsDlgButtonChecked(g_hMediaDlg,IDC_HIDEPATHS) == BST_CHECKED)
@@ -269,7 +263,7 @@ void UpdateProjFolderList(HWND hList, bool onlyUnused)
 
 		item.iItem=j;
 		item.iSubItem = 0;
-		int UsedInProject=IsFileUsedInProject(g_ProjFolFiles[i]);
+		int UsedInProject=IsFileUsedInProject(g_ProjFolFiles[i],ProjectFileCounts);
 		if (onlyUnused)
 		{
 			if (UsedInProject==0)
@@ -356,6 +350,9 @@ WDL_DLGRET MulMatchesFoundDlgProc(HWND hwnd, UINT Message, WPARAM wParam, LPARAM
 				ListView_SetItemText(GetDlgItem(hwnd,IDC_MULMATCHLIST),i,1,buf);
 #endif
 			}
+			// matches are ranked, preselect the best one
+			if (g_MatchingFiles.size())
+				ListView_SetItemState(GetDlgItem(hwnd,IDC_MULMATCHLIST),0,LVIS_SELECTED|LVIS_FOCUSED,LVIS_SELECTED|LVIS_FOCUSED);
 			return 0;
 		}
 		case WM_COMMAND:
@@ -390,20 +387,180 @@ WDL_DLGRET MulMatchesFoundDlgProc(HWND hwnd, UINT Message, WPARAM wParam, LPARAM
 
 bool g_ScanFinished=false;
 
-vector<string> FoundMediaFiles;
 char g_FolderName[1024] = "";
 
-unsigned int WINAPI DirScanThreadFunc(void*)
+// Media files found by the scan, indexed by file name (without path)
+unordered_map<string, vector<string> > g_FoundMediaFiles;
+
+// Multi-threaded crawler: directories to scan are shared between the worker
+// threads, each worker indexes the media files it finds and merges its index
+// into g_FoundMediaFiles when there's nothing left to scan.
+// Idle workers sleep on g_ScanCond until directories are queued, the scan is
+// over (no busy worker left) or aborted.
+#define MEDIA_SCAN_THREADS 4
+
+std::mutex g_ScanMutex; // also protects g_CurrentScanFile while scanning
+std::condition_variable g_ScanCond;
+vector<string> g_ScanPendingDirs;
+int g_ScanBusyWorkers=0;
+int g_ScanRunningWorkers=0;
+std::atomic<int> g_ScanNumFiles(0);
+
+void AbortDirScan()
 {
-	FoundMediaFiles.clear();
-	SearchDirectory(FoundMediaFiles, g_FolderName, NULL, true);
-	g_ScanStatus = 0;
+	std::lock_guard<std::mutex> lock(g_ScanMutex);
+	g_bAbortScan=true;
+	g_ScanCond.notify_all();
+}
+
+unsigned int WINAPI DirScanWorkerFunc(void*)
+{
+	unordered_map<string, vector<string> > FoundFiles;
+	string Dir;
+	bool Busy=false;
+	while (!g_bAbortScan)
+	{
+		{
+			std::unique_lock<std::mutex> lock(g_ScanMutex);
+			if (Busy)
+			{
+				if (--g_ScanBusyWorkers==0 && g_ScanPendingDirs.empty())
+					g_ScanCond.notify_all(); // scan over, wake up idle workers
+				Busy=false;
+			}
+			g_ScanCond.wait(lock, [] { return g_bAbortScan || g_ScanPendingDirs.size() || !g_ScanBusyWorkers; });
+			if (g_bAbortScan || g_ScanPendingDirs.empty())
+				break; // aborted, or nothing left to scan and no worker can add new directories
+			Dir=g_ScanPendingDirs.back();
+			g_ScanPendingDirs.pop_back();
+			g_ScanBusyWorkers++;
+			Busy=true;
+		}
+
+		vector<string> SubDirs;
+		WDL_DirScan ds;
+		if (!ds.First(Dir.c_str()))
+		{
+			WDL_String FoundFile;
+			do
+			{
+				const char* FN=ds.GetCurrentFN();
+				if (strcmp(FN, ".") == 0 || strcmp(FN, "..") == 0)
+					continue;
+				ds.GetCurrentFullFN(&FoundFile);
+				if (IsDirNoRecurse(ds))
+					SubDirs.push_back(FoundFile.Get());
+				else
+				{
+					const char* Ext=strrchr(FN, '.');
+					if (Ext && IsMediaExtension(Ext+1, false))
+					{
+						FoundFiles[FN].push_back(FoundFile.Get());
+						g_ScanNumFiles++;
+					}
+				}
+			}
+			while (!ds.Next() && !g_bAbortScan);
+
+			std::lock_guard<std::mutex> lock(g_ScanMutex);
+			lstrcpyn(g_CurrentScanFile, Dir.c_str(), 1024);
+		}
+
+		if (SubDirs.size())
+		{
+			std::lock_guard<std::mutex> lock(g_ScanMutex);
+			g_ScanPendingDirs.insert(g_ScanPendingDirs.end(), SubDirs.begin(), SubDirs.end());
+			g_ScanCond.notify_all();
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(g_ScanMutex);
+	if (Busy && --g_ScanBusyWorkers==0)
+		g_ScanCond.notify_all();
+	for (unordered_map<string, vector<string> >::iterator it=FoundFiles.begin(); it!=FoundFiles.end(); ++it)
+	{
+		vector<string>& Paths=g_FoundMediaFiles[it->first];
+		Paths.insert(Paths.end(), it->second.begin(), it->second.end());
+	}
+	if (--g_ScanRunningWorkers==0)
+		g_ScanStatus=0;
 	return 0;
 }
 
+// Returns the number of started worker threads, their handles are added to Threads
+int StartDirScan(vector<HANDLE>& Threads)
+{
+	g_FoundMediaFiles.clear();
+	g_ScanPendingDirs.clear();
+	g_ScanPendingDirs.push_back(g_FolderName);
+	g_ScanBusyWorkers=0;
+	g_ScanNumFiles=0;
+	g_ScanRunningWorkers=MEDIA_SCAN_THREADS;
+	for (int i=0;i<MEDIA_SCAN_THREADS;i++)
+	{
+		if (HANDLE hThread=(HANDLE)_beginthreadex(NULL, 0, DirScanWorkerFunc, 0, 0, 0))
+			Threads.push_back(hThread);
+		else
+		{
+			std::lock_guard<std::mutex> lock(g_ScanMutex);
+			if (--g_ScanRunningWorkers==0)
+				g_ScanStatus=0;
+		}
+	}
+	return (int)Threads.size();
+}
+
+// Number of trailing path components (parent directories) in common, case insensitive
+// Both kinds of path separators are accepted (e.g. projects moved from another OS)
+int GetPathSimilarity(const string& PathA, const string& PathB)
+{
+	int Score=0;
+	int a=(int)PathA.size()-1, b=(int)PathB.size()-1;
+	// skip file names, same by definition
+	while (a>=0 && PathA[a]!='\\' && PathA[a]!='/') a--;
+	while (b>=0 && PathB[b]!='\\' && PathB[b]!='/') b--;
+	while (a>0 && b>0)
+	{
+		int a2=a-1, b2=b-1;
+		while (a2>=0 && PathA[a2]!='\\' && PathA[a2]!='/') a2--;
+		while (b2>=0 && PathB[b2]!='\\' && PathB[b2]!='/') b2--;
+		if (a-a2!=b-b2 || _strnicmp(PathA.c_str()+a2+1, PathB.c_str()+b2+1, a-a2-1))
+			break;
+		Score++;
+		a=a2;
+		b=b2;
+	}
+	return Score;
+}
+
+// Returns the candidates for a missing file, best match first:
+// most parent directories in common first, then non empty files
+void GetRankedMatchingFiles(const string& MissingFile, vector<string>& Matches)
+{
+	Matches.clear();
+	string::size_type pos=MissingFile.find_last_of("\\/");
+	string ShortName=(pos==string::npos) ? MissingFile : MissingFile.substr(pos+1);
+	unordered_map<string, vector<string> >::iterator it=g_FoundMediaFiles.find(ShortName);
+	if (it==g_FoundMediaFiles.end())
+		return;
+
+	vector<pair<int,int> > Scores; // (score, index)
+	for (int i=0;i<(int)it->second.size();i++)
+	{
+		int Score=GetPathSimilarity(MissingFile, it->second[i])*2;
+		WDL_INT64 Size=0;
+		if (GetFileOrDirInfo(it->second[i].c_str(), NULL, &Size) && Size>0)
+			Score++;
+		Scores.push_back(make_pair(-Score, i)); // stable order for equal scores
+	}
+	sort(Scores.begin(), Scores.end());
+	for (int i=0;i<(int)Scores.size();i++)
+		Matches.push_back(it->second[Scores[i].second]);
+}
+
 WDL_DLGRET ScanProgDlgProc(HWND hwnd, UINT Message, WPARAM wParam, LPARAM lParam)
 {
-	static HANDLE hThread = NULL;
+	static vector<HANDLE> hThreads;
 
 	if (INT_PTR r = SNM_HookThemeColorsMessage(hwnd, Message, wParam, lParam))
 		return r;
@@ -414,7 +571,8 @@ WDL_DLGRET ScanProgDlgProc(HWND hwnd, UINT Message, WPARAM wParam, LPARAM lParam
 			{
 				g_ScanStatus=1;
 				g_bAbortScan=false;
-				hThread = (HANDLE)_beginthreadex(NULL, 0, DirScanThreadFunc, 0, 0, 0);
+				hThreads.clear();
+				StartDirScan(hThreads);
 				SetTimer(hwnd,1717,250,NULL);
 				return 0;
 			}
@@ -422,7 +580,12 @@ WDL_DLGRET ScanProgDlgProc(HWND hwnd, UINT Message, WPARAM wParam, LPARAM lParam
 			{
 				if (wParam==1717)
 				{
-					SetDlgItemText(hwnd,IDC_SCANFILE,g_CurrentScanFile);
+					char buf[1100];
+					{
+						std::lock_guard<std::mutex> lock(g_ScanMutex);
+						snprintf(buf, sizeof(buf), "%d: %s", g_ScanNumFiles.load(), g_CurrentScanFile);
+					}
+					SetDlgItemText(hwnd,IDC_SCANFILE,buf);
 					if (g_ScanStatus==0)
 					{
 						KillTimer(hwnd,1717);
@@ -435,20 +598,31 @@ WDL_DLGRET ScanProgDlgProc(HWND hwnd, UINT Message, WPARAM wParam, LPARAM lParam
 			{
 				g_hScanProgressDlg=0;
 				EndDialog(hwnd,0);
-				if (hThread)
-					CloseHandle(hThread);
+				if (g_ScanStatus)
+					AbortDirScan();
+				for (int i=0;i<(int)hThreads.size();i++)
+				{
+					WaitForSingleObject(hThreads[i], INFINITE);
+					CloseHandle(hThreads[i]);
+				}
+				hThreads.clear();
 				return 0;
 			}
 		case WM_COMMAND:
 			{
 				if (LOWORD(wParam==IDC_ABORT))
 				{
-					g_bAbortScan=true;
+					AbortDirScan();
 					return 0;
 				}
 				if (wParam==0xff)
 				{
-					SetDlgItemText(g_hScanProgressDlg,IDC_SCANFILE,g_CurrentScanFile);
+					char buf[1024];
+					{
+						std::lock_guard<std::mutex> lock(g_ScanMutex);
+						lstrcpyn(buf, g_CurrentScanFile, sizeof(buf));
+					}
+					SetDlgItemText(g_hScanProgressDlg,IDC_SCANFILE,buf);
 #ifdef _WIN32 // TODO is this necessary?  what to do for OSX?
 					RedrawWindow(g_hScanProgressDlg, NULL, NULL, RDW_INVALIDATE | RDW_UPDATENOW);
 #else
@@ -467,87 +641,52 @@ void FindMissingFiles()
 {
 	if (BrowseForDirectory("Select search folder", NULL, g_FolderName, 1024))
 	{
-		char FullFilename[2048];
-		char FullFilenameB[2048];
-		char Shortfilename[2048];
-		char ShortfilenameB[2048];
-
 		DialogBox(g_hInst,MAKEINTRESOURCE(IDD_SCANPROGR),g_hMediaDlg,(DLGPROC)ScanProgDlgProc);
 		g_ScanStatus=0;
 		g_ScanFinished=true;
 		SetForegroundWindow(g_hMediaDlg);
 		vector<t_project_take> ProjectTakes;
-		vector<t_project_take> TakesMissingFiles;
 		GetAllProjectTakes(ProjectTakes);
+
+		// missing files, with the takes using them
+		vector<string> MissingFiles;
+		map<string, vector<MediaItem_Take*> > TakesMissingFiles;
 		int i;
 		for (i=0;i<(int)ProjectTakes.size();i++)
+		{
 			if (ProjectTakes[i].FileMissing==true)
-				TakesMissingFiles.push_back(ProjectTakes[i]);
+			{
+				vector<MediaItem_Take*>& Takes=TakesMissingFiles[ProjectTakes[i].FileName];
+				if (!Takes.size())
+					MissingFiles.push_back(ProjectTakes[i].FileName);
+				Takes.push_back(ProjectTakes[i].TheTake);
+			}
+		}
 		Main_OnCommand(40100,0); // set all media offline
-		int SanityCheck=(int)TakesMissingFiles.size();
-		i=0;
 
-		bool TakesLeft=true;
-		if (TakesMissingFiles.size()==0) TakesLeft=false;
-		while (TakesLeft==true)
+		for (i=0;i<(int)MissingFiles.size();i++)
 		{
-			t_project_take TempTake;
-			TempTake=TakesMissingFiles[i];
-			int FileMatches=0;
-			strcpy(FullFilename,TakesMissingFiles[i].FileName.c_str());
-			ExtractFileNameEx(FullFilename,Shortfilename,false);
-			g_MatchingFiles.clear();
-			int j;
-			for (j=0;j<(int)FoundMediaFiles.size();j++)
-			{
-				strcpy(FullFilenameB,FoundMediaFiles[j].c_str());
-				ExtractFileNameEx(FullFilenameB,ShortfilenameB,false);
-				if (strcmp(Shortfilename,ShortfilenameB)==0)
-				{
-					FileMatches++;
-					g_MatchingFiles.push_back(FoundMediaFiles[j]);
-				}
-			}
+			GetRankedMatchingFiles(MissingFiles[i], g_MatchingFiles);
 			string TheMatchingFile;
-			TheMatchingFile.assign(TakesMissingFiles[i].FileName);
-			if (g_MatchingFiles.size()==0)
-				TakesMissingFiles.erase(TakesMissingFiles.begin()+i);
-			else if (g_MatchingFiles.size()==1)
-			{
+			if (g_MatchingFiles.size()==1)
 				TheMatchingFile.assign(g_MatchingFiles[0]);
-				ReplaceTakeSourceFile(TakesMissingFiles[i].TheTake,TheMatchingFile);
-				TakesMissingFiles.erase(TakesMissingFiles.begin()+i);
-			}
 			else if (g_MatchingFiles.size()>1)
 			{
 				g_SelectedMatchFile=-1;
 				DialogBox(g_hInst,MAKEINTRESOURCE(IDD_MULMATCH),g_hMediaDlg , (DLGPROC)MulMatchesFoundDlgProc);
 				if (g_SelectedMatchFile>=0)
-				{
 					TheMatchingFile.assign(g_MatchingFiles[g_SelectedMatchFile]);
-					ReplaceTakeSourceFile(TakesMissingFiles[i].TheTake,TheMatchingFile);
-				}
-				TakesMissingFiles.erase(TakesMissingFiles.begin()+i);
 			}
-			// Searching remaining takes using the same file...
-			int k;
-			for (k=0;k<(int)TakesMissingFiles.size();k++)
+			// replace file in all takes using it
+			if (TheMatchingFile.size())
 			{
-				if (TakesMissingFiles[k].FileName.compare(FullFilename)==0)
-				{
-					// replace file
-					ReplaceTakeSourceFile(TakesMissingFiles[k].TheTake,TheMatchingFile);
-					TakesMissingFiles.erase(TakesMissingFiles.begin()+k);
-				}
-			}
-			if (TakesMissingFiles.size()==0) TakesLeft=false;
-			SanityCheck--;
-			if (SanityCheck<0)
-			{
-				// Sanity check, exiting while (TakesMissingFiles.size()>0)
-				break;
+				vector<MediaItem_Take*>& Takes=TakesMissingFiles[MissingFiles[i]];
+				for (int k=0;k<(int)Takes.size();k++)
+					ReplaceTakeSourceFile(Takes[k],TheMatchingFile);
 			}
 		}
+		g_FoundMediaFiles.clear();
+
 		Main_OnCommand(40101,0); // set all media online
 		Main_OnCommand(40047,0); // build any missing peaks
 		Undo_OnStateChangeEx("Find missing project media",4,-1);
@@ -69,7 +69,7 @@ int GetActiveTakes(WDL_PtrList<MediaItem_Take> *MediaTakes)
 // Returns number of files found with desired extension
 // if extension is == NULL, looks for Media Files with Reaper's builtin IsMediaExtension
 char g_CurrentScanFile[1024] = "";
-bool g_bAbortScan = false;
+std::atomic<bool> g_bAbortScan(false);
 int SearchDirectory(vector<string> &refvecFiles, const char* cDir, const char* cExt, bool bSubdirs)
 {
 	WDL_DirScan ds;
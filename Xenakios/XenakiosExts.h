@@ -344,7 +344,7 @@ int XenSingleStringQueryDlg(HWND hParent,const char *QueryTitle,char *QueryResul
 // XenUtils.cpp functions, globals:
 extern std::vector<std::string> g_filenames;
 extern char g_CurrentScanFile[1024];
-extern bool g_bAbortScan;
+extern std::atomic<bool> g_bAbortScan; // read by the media scan threads
 int GetActiveTakes(WDL_PtrList<MediaItem_Take> *MediaTakes);
 int SearchDirectory(vector<string> &refvecFiles, const char* cDir, const char* cExt, bool bSubdirs = true);
 // Browse fcns to match SWELL
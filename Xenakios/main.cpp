@@ -730,12 +730,10 @@ int XenakiosInit()
 
 	SWSRegisterCommands(g_XenCommandTable);
 
-	InitCommandParams();
+	SWSDeferInit("Xenakios command parameters", InitCommandParams); // only used by actions
 
 	InitUndoKeyUpHandler01();
-	g_hItemInspector = CreateDialog(g_hInst, MAKEINTRESOURCE(IDD_ITEM_INSPECTOR), g_hwndParent, (DLGPROC)MyItemInspectorDlgProc);
-	if (g_hItemInspector != NULL)
-		ShowWindow(g_hItemInspector, SW_HIDE);
+	// the item inspector is created when first shown
 
 	srand ((unsigned int)time(NULL));
 
@@ -680,44 +680,38 @@ void RestoreArrangeViewSlot(COMMAND_T* ct)      { g_stdAS[(int)ct->user].Get()->
 // Point is in client coords
 MediaTrack* TrackAtPoint(HWND hTrackView, int iY, int* iOffset, int* iYMin, int* iYMax)
 {
+	// Find the current track (binary search on TCP positions)
+	int iTrackY, iTrackH;
+	MediaTrack* tr = GetTcpTrackFromY(iY, &iTrackY, &iTrackH);
+	if (tr)
+	{
+		if (iYMin)
+			*iYMin = iTrackY;
+		if (iYMax)
+			*iYMax = iTrackY + iTrackH;
+		if (iOffset)
+			*iOffset = iY - iTrackY;
+		return tr;
+	}
+
+	// Set extents if outside of std region
 	SCROLLINFO si = { sizeof(SCROLLINFO), };
 	si.fMask = SIF_ALL;
 	CoolSB_GetScrollInfo(hTrackView, SB_VERT, &si);
-
 	int iVPos = -si.nPos; // Account for current scroll pos
-	int iTrack = 0;
-	int iTrackH = 0;
-
-	// Find the current track #
-	while (iTrack <= GetNumTracks())
+	for (int iTrack = GetNumTracks(); iTrack >= 0; iTrack--)
 	{
 		MediaTrack* track = CSurf_TrackFromID(iTrack, false);
-		iTrackH = *(int*)GetSetMediaTrackInfo(track, "I_WNDH", NULL);
-		iTrackH += GetTrackSpacerSize(track);
-		if (iVPos + iTrackH > iY)
+		if (TcpVis(track))
+		{
+			iVPos = (int)GetMediaTrackInfo_Value(track, "I_TCPY") + (int)GetMediaTrackInfo_Value(track, "I_WNDH");
 			break;
-		if (iTrack == 0 && TcpVis(track) && iTrackH != 0)
-			iTrackH += GetMasterTcpGap();
-		iVPos += iTrackH;
-		iTrack++;
+		}
 	}
-
-	// Set extents if outside of std region
 	if (iYMin)
 		*iYMin = iVPos;
 	if (iYMax)
 		*iYMax = iVPos;
-
-	if (iTrack <= GetNumTracks())
-	{
-		if (iYMin)
-			*iYMin = iVPos;
-		if (iYMax)
-			*iYMax = iVPos + iTrackH;
-		if (iOffset)
-			*iOffset = iY - iVPos;
-		return CSurf_TrackFromID(iTrack, false);
-	}
 	return NULL;
 }
 
@@ -749,22 +743,15 @@ MediaItem* ItemAtPoint(HWND hTrackView, POINT p, RECT* rExtents, MediaTrack** pT
 	double dPos = (p.x + si.nPos) / GetHZoomLevel();
 
 	// Then, maybe find an item
-	for (int i = 0; i < GetTrackNumMediaItems(tr); i++)
+	MediaItem* mi = GetItemAtPosition(tr, dPos);
+	if (mi && rExtents)
 	{
-		MediaItem* mi = GetTrackMediaItem(tr, i);
 		double dStart = *(double*)GetSetMediaItemInfo(mi, "D_POSITION", NULL);
 		double dEnd   = *(double*)GetSetMediaItemInfo(mi, "D_LENGTH", NULL) + dStart;
-		if (dPos >= dStart && dPos <= dEnd)
-		{
-			if (rExtents)
-			{
-				rExtents->left  = (int)(GetHZoomLevel() * dStart + 0.5) - si.nPos;
-				rExtents->right = (int)(GetHZoomLevel() * dEnd + 0.5) - si.nPos;
-			}
-			return mi;
-		}
+		rExtents->left  = (int)(GetHZoomLevel() * dStart + 0.5) - si.nPos;
+		rExtents->right = (int)(GetHZoomLevel() * dEnd + 0.5) - si.nPos;
 	}
-	return NULL;
+	return mi;
 }
 
 // Class for saving/restoring the zoom state.  This is a lighter-weight version
@@ -14,9 +14,14 @@ PitchShiftSource *PitchShiftSource::create(PCM_source *src)
 
 PitchShiftSource::PitchShiftSource(PCM_source *src)
   : m_pitch { 0.0 }, m_rate { 1.0 }, m_volume { 1.0 }, m_pan { 0.0 },
-    m_fadeInLen { 0.0 }, m_fadeOutLen { 0.0 }, m_flags { PreservePitch },
-    m_mode { -1 }, m_src { src->Duplicate() },
-    m_playTime { 0.0 }, m_writeTime { 0.0 }, m_fadeOutEnd { 0.0 }
+    m_fadeInLen { 0.0 }, m_fadeOutLen { 0.0 }, m_mode { -1 },
+    m_preservePitch { true }, m_tempoShiftSerial { 0 }, m_fadeOutEnd { 0.0 },
+    m_curPitch { 0.0 }, m_curRate { 1.0 }, m_curMode { -1 },
+    m_curPreservePitch { true }, m_curTempoShiftSerial { 0 },
+    m_rampVolume { 1.0 }, m_rampPan { 0.0 }, m_rampStarted { false },
+    m_flags { 0 }, m_src { src->Duplicate() },
+    m_playTime { 0.0 }, m_writeTime { 0.0 }, m_position { 0.0 },
+    m_peakChans { 0 }
 {
 }
 
@@ -30,7 +35,7 @@ PitchShiftSource_Audio::PitchShiftSource_Audio(PCM_source *src)
     m_ps { ReaperGetPitchShiftAPI(REAPER_PITCHSHIFT_API_VER) }
 {
   updateTempoShift();
-  m_peaks.resize(GetNumChannels());
+  allocPeaks(GetNumChannels());
 }
 
 PitchShiftSource_Audio::~PitchShiftSource_Audio()
@@ -42,7 +47,7 @@ PitchShiftSource_MIDI::PitchShiftSource_MIDI(PCM_source *src)
   : PitchShiftSource { src }
 {
   updateTempoShift();
-  m_peaks.resize(16);
+  allocPeaks(16);
 }
 
 int PitchShiftSource::GetNumChannels()
@@ -61,13 +66,13 @@ double PitchShiftSource::GetLength()
 {
   // Returning a truncated length (m_fadeOutLen) here would cause
   // a 1 buffer glitch when it kicks in.
-  WDL_MutexLockShared lock { &m_mutex };
   return sourceLength();
 }
 
 double PitchShiftSource_Audio::sourceLength() const
 {
-  return m_src->GetLength() / m_rate;
+  // the rate the audio thread renders at, a new m_rate applies from its next block
+  return m_src->GetLength() / m_curRate.load(std::memory_order_relaxed);
 }
 
 double PitchShiftSource_MIDI::sourceLength() const
@@ -77,93 +82,151 @@ double PitchShiftSource_MIDI::sourceLength() const
 
 bool PitchShiftSource::isPastEnd(const double position)
 {
-  WDL_MutexLockShared lock { &m_mutex };
-  const double length { m_fadeOutEnd ? m_fadeOutEnd : sourceLength() };
-  return position >= length || m_flags & StopServiced;
+  const double fadeOutEnd { m_fadeOutEnd.load(std::memory_order_relaxed) };
+  const double length { fadeOutEnd ? fadeOutEnd : sourceLength() };
+  return position >= length || m_flags.load(std::memory_order_relaxed) & StopServiced;
+}
+
+void PitchShiftSource::allocPeaks(const size_t chans)
+{
+  m_peaks.reset(new std::atomic<double>[chans]);
+  for(size_t c = 0; c < chans; ++c)
+    m_peaks[c].store(0.0, std::memory_order_relaxed);
+  m_peakChans = chans;
+  m_blockPeaks.resize(chans);
 }
 
 bool PitchShiftSource::readPeak(const size_t chan, double *out)
 {
-  if(chan >= m_peaks.size())
+  if(chan >= m_peakChans)
     return false;
 
-  WDL_MutexLockExclusive lock { &m_mutex };
-  Peak &peak { m_peaks[chan] };
-  peak.read = true;
-  *out = peak.max;
+  // mark as read by negating, the audio thread restarts from its next block
+  std::atomic<double> &peak { m_peaks[chan] };
+  double value { peak.load(std::memory_order_relaxed) };
+  while(!std::signbit(value) &&
+      !peak.compare_exchange_weak(value, -value, std::memory_order_relaxed)) {}
+  *out = std::fabs(value);
   return true;
 }
 
+void PitchShiftSource::publishPeaks()
+{
+  for(size_t c = 0; c < m_peakChans; ++c) {
+    std::atomic<double> &peak { m_peaks[c] };
+    double value { peak.load(std::memory_order_relaxed) };
+    while(!peak.compare_exchange_weak(value,
+        std::max(std::signbit(value) ? 0.0 : value, m_blockPeaks[c]),
+        std::memory_order_relaxed)) {}
+  }
+}
+
 void PitchShiftSource::GetSamples(PCM_source_transfer_t *tx)
 {
   Block block { tx };
   block.sampleTime = 1.0 / tx->samplerate;
-
-  {
-    WDL_MutexLockShared lock { &m_mutex };
-    const double effectiveLength = m_fadeOutEnd ? m_fadeOutEnd : sourceLength();
-    block.fadeOutStart = effectiveLength - m_fadeOutLen;
-    block.isSeek = m_writeTime != tx->time_s;
-    if(block.isSeek && tx->time_s == 0.0 && !(m_flags & (ManualSeek | Looping)))
-      m_flags |= WrappedAround;
-    writeSamples(block);
+  block.fadeInLen  = m_fadeInLen.load(std::memory_order_relaxed);
+  block.fadeOutLen = m_fadeOutLen.load(std::memory_order_relaxed);
+  block.volume     = m_volume.load(std::memory_order_relaxed);
+  block.pan        = m_pan.load(std::memory_order_relaxed);
+  if(!m_rampStarted) {
+    m_rampVolume  = block.volume;
+    m_rampPan     = block.pan;
+    m_rampStarted = true;
   }
 
-  WDL_MutexLockExclusive lock { &m_mutex };
+  applyTempoShift();
 
-  for(Peak &peak : m_peaks) {
-    if(peak.read)
-      peak = {};
-  }
-  if(!(m_flags & WrappedAround))
+  const double fadeOutEnd { m_fadeOutEnd.load(std::memory_order_relaxed) };
+  double writeTime { m_writeTime.load(std::memory_order_relaxed) };
+  block.fadeOutStart = (fadeOutEnd ? fadeOutEnd : sourceLength()) - block.fadeOutLen;
+  block.isSeek = writeTime != tx->time_s;
+  block.flags = m_flags.load(std::memory_order_acquire);
+  if(block.isSeek && tx->time_s == 0.0 && !(block.flags & (ManualSeek | Looping)))
+    block.flags = m_flags.fetch_or(WrappedAround, std::memory_order_acq_rel) | WrappedAround;
+  writeSamples(block);
+
+  std::fill(m_blockPeaks.begin(), m_blockPeaks.end(), 0.0);
+  if(!(block.flags & WrappedAround))
     writePeaks(tx);
+  publishPeaks();
 
   if(block.isSeek)
-    m_writeTime = tx->time_s;
-  m_writeTime += tx->length * block.sampleTime;
-
-  // update flags (even though they're MIDI ones) once we have a write lock
-  if(m_flags & StopRequest)
-    m_flags |= StopServiced;
-  m_flags &= ~(AllNotesOff | StopRequest);
+    writeTime = tx->time_s;
+  writeTime += tx->length * block.sampleTime;
+  m_writeTime.store(writeTime, std::memory_order_relaxed);
+  m_position.store(writeTime, std::memory_order_relaxed);
+
+  // update flags (even though they're MIDI ones), only clearing what this
+  // block has seen so that requests made meanwhile are kept for the next one
+  int serviced { block.flags & (AllNotesOff | StopRequest) };
   if(block.isSeek) // wait until a seek is received to avoid a race condition
-    m_flags &= ~ManualSeek;
+    serviced |= block.flags & ManualSeek;
+  if(block.flags & StopRequest)
+    m_flags.fetch_or(StopServiced, std::memory_order_acq_rel);
+  m_flags.fetch_and(~serviced, std::memory_order_acq_rel);
+}
+
+void PitchShiftSource::applyTempoShift()
+{
+  const unsigned int serial { m_tempoShiftSerial.load(std::memory_order_acquire) };
+  if(serial == m_curTempoShiftSerial)
+    return;
+
+  m_curTempoShiftSerial = serial;
+  m_curPitch = m_pitch.load(std::memory_order_relaxed);
+  m_curRate  = m_rate.load(std::memory_order_relaxed);
+  m_curMode  = m_mode.load(std::memory_order_relaxed);
+  m_curPreservePitch = m_preservePitch.load(std::memory_order_relaxed);
+  updateTempoShift();
 }
 
-double PitchShiftSource::computeGain(const Block &block,
+double PitchShiftSource::computeFade(const Block &block,
   const double time, const int samplesUntilNextCall)
 {
   const double
-    fadeIn { m_playTime < m_fadeInLen ? m_playTime / m_fadeInLen : 1.0 },
-    timeInFadeOut { m_fadeOutLen ? time - block.fadeOutStart : 0.0 },
-    fadeOut { timeInFadeOut > 0 ? 1 - (timeInFadeOut / m_fadeOutLen) : 1.0 };
+    fadeIn { m_playTime < block.fadeInLen ? m_playTime / block.fadeInLen : 1.0 },
+    timeInFadeOut { block.fadeOutLen ? time - block.fadeOutStart : 0.0 },
+    fadeOut { timeInFadeOut > 0 ? 1 - (timeInFadeOut / block.fadeOutLen) : 1.0 };
   m_playTime += samplesUntilNextCall * block.sampleTime;
-  return m_volume * std::max(0.0, fadeIn * fadeOut);
+  return std::max(0.0, fadeIn * fadeOut);
 }
 
 void PitchShiftSource_Audio::writeSamples(const Block &block)
 {
-  if(m_rate == 1.0 && m_pitch == 0.0) {
+  if(m_curRate == 1.0 && m_curPitch == 0.0) {
     m_src->GetSamples(block.tx);
     m_readTime = 0;
   }
   else
     getShiftedSamples(block);
 
-  // no pan law
-  const double pan[] {
-    m_pan > 0 ? 1.0 - m_pan : 1.0, // left
-    m_pan < 0 ? m_pan + 1.0 : 1.0, // right
-  };
+  // ramp from the previous block's volume and pan to avoid zipper noise
+  const int samples { block.tx->samples_out };
+  const double
+    volumeStep { samples ? (block.volume - m_rampVolume) / samples : 0.0 },
+    panStep    { samples ? (block.pan    - m_rampPan)    / samples : 0.0 };
 
   ReaSample *sample { block.tx->samples },
-            *lastSample { sample + (block.tx->samples_out * block.tx->nch) };
+            *lastSample { sample + (samples * block.tx->nch) };
   for(double time { block.tx->time_s }; sample < lastSample; sample += block.tx->nch) {
-    const double gain { computeGain(block, time, 1) };
+    m_rampVolume += volumeStep;
+    m_rampPan    += panStep;
+
+    // no pan law
+    const double pan[] {
+      m_rampPan > 0 ? 1.0 - m_rampPan : 1.0, // left
+      m_rampPan < 0 ? m_rampPan + 1.0 : 1.0, // right
+    };
+
+    const double gain { m_rampVolume * computeFade(block, time, 1) };
     for(int i {}; i < block.tx->nch; ++i)
       sample[i] *= gain * pan[i & 1];
     time += block.sampleTime;
   }
+
+  m_rampVolume = block.volume; // no rounding drift
+  m_rampPan    = block.pan;
 }
 
 void PitchShiftSource_Audio::getShiftedSamples(const Block &block)
@@ -171,14 +234,15 @@ void PitchShiftSource_Audio::getShiftedSamples(const Block &block)
   m_ps->set_srate(block.tx->samplerate);
   m_ps->set_nch(block.tx->nch);
 
-  const double bufSizeMul { m_rate > 1.0 ? m_rate : 1.0 };
+  const double curRate { m_curRate.load(std::memory_order_relaxed) },
+               bufSizeMul { curRate > 1.0 ? curRate : 1.0 };
   PCM_source_transfer_t sourceBlock {};
   sourceBlock.samplerate = block.tx->samplerate;
   sourceBlock.nch = block.tx->nch;
   sourceBlock.length = static_cast<int>(block.tx->length * bufSizeMul);
 
   if(block.isSeek || !m_readTime) {
-    m_readTime  = block.tx->time_s * m_rate;
+    m_readTime  = block.tx->time_s * m_curRate;
     m_ps->Reset(); // to give immediate feedback with very slow play rates
   }
 
@@ -211,18 +275,20 @@ void PitchShiftSource_MIDI::writeSamples(const Block &block)
   if(!block.tx->midi_events) // null when outputting to a hardware output
     return;
 
-  if(block.isSeek || m_flags & (AllNotesOff | StopRequest))
+  if(block.isSeek || block.flags & (AllNotesOff | StopRequest))
     addCCAllChans(block.tx->midi_events, MIDI_event_t::CC_ALL_NOTES_OFF, 0);
 
-  if(m_flags & (StopRequest | StopServiced))
+  if(block.flags & (StopRequest | StopServiced))
     return;
 
   m_src->GetSamples(block.tx);
 
-  const double gain { computeGain(block, block.tx->time_s, block.tx->length) };
+  const double gain { block.volume * computeFade(block, block.tx->time_s, block.tx->length) };
+  m_rampVolume = block.volume;
+  m_rampPan    = block.pan;
   for(int i = 0; MIDI_event_t *event { block.tx->midi_events->EnumItems(&i) };) {
     if(event->is_note())
-      event->midi_message[1] = clamp7b(event->midi_message[1] + static_cast<int>(m_pitch));
+      event->midi_message[1] = clamp7b(event->midi_message[1] + static_cast<int>(m_curPitch));
     if(event->is_note_on())
       event->midi_message[2] = clamp7b(static_cast<int>(event->midi_message[2] * gain));
   }
@@ -240,12 +306,12 @@ void PitchShiftSource_MIDI::addCCAllChans(MIDI_eventlist *events,
 
 void PitchShiftSource_Audio::writePeaks(const PCM_source_transfer_t *block)
 {
-  const size_t peakChans { std::min<size_t>(m_peaks.size(), block->nch) };
+  const size_t peakChans { std::min<size_t>(m_blockPeaks.size(), block->nch) };
   for(ReaSample *sample { block->samples },
                 *lastSample { sample + (block->samples_out * block->nch) };
       sample < lastSample; sample += block->nch) {
     for(size_t c = 0; c < peakChans; ++c)
-      GetDoubleMaxAbsValue(&m_peaks[c].max, &sample[c]);
+      GetDoubleMaxAbsValue(&m_blockPeaks[c], &sample[c]);
   }
 }
 
@@ -257,50 +323,47 @@ void PitchShiftSource_MIDI::writePeaks(const PCM_source_transfer_t *block)
   for(int i = 0; MIDI_event_t *event { block->midi_events->EnumItems(&i) };) {
     if(event->is_note_on()) {
       const double value { event->midi_message[2] / 127.0 };
-      GetDoubleMaxAbsValue(&m_peaks[event->midi_message[0] & 0xF].max, &value);
+      GetDoubleMaxAbsValue(&m_blockPeaks[event->midi_message[0] & 0xF], &value);
     }
   }
 }
 
 void PitchShiftSource_Audio::updateTempoShift()
 {
-  double shift { pow(2.0, m_pitch / 12.0) };
-  if(!(m_flags & PreservePitch))
-    shift *= m_rate;
+  double shift { pow(2.0, m_curPitch / 12.0) };
+  if(!m_curPreservePitch)
+    shift *= m_curRate;
 
-  m_ps->SetQualityParameter(m_mode);
-  m_ps->set_tempo(m_rate);
+  m_ps->SetQualityParameter(m_curMode);
+  m_ps->set_tempo(m_curRate);
   m_ps->set_shift(shift);
 
   // to have getShiftedSamples reset m_readTime and m_ps next time it's used
-  if(m_rate == 1.0 && m_pitch == 0.0)
+  if(m_curRate == 1.0 && m_curPitch == 0.0)
     m_writeTime = 0.0;
 }
 
 void PitchShiftSource_MIDI::updateTempoShift()
 {
-  m_flags |= AllNotesOff;
+  m_flags.fetch_or(AllNotesOff, std::memory_order_acq_rel);
 
-  double tempo { 120 * m_rate };
+  double tempo { 120 * m_curRate };
   m_src->Extended(PCM_SOURCE_EXT_SETPREVIEWTEMPO, &tempo, nullptr, nullptr);
 }
 
 void PitchShiftSource::setVolume(const double volume)
 {
-  // OK to read unlocked: only called/modified from the main thread
-  if(volume == m_volume || volume < 0)
-    return; // don't exclusively lock the mutex for no reason
+  if(volume < 0)
+    return;
 
-  WDL_MutexLockExclusive lock { &m_mutex };
   m_volume = volume;
 }
 
 void PitchShiftSource::setPan(const double pan)
 {
-  if(pan == m_pan || pan < -1 || pan > 1)
+  if(pan < -1 || pan > 1)
     return;
 
-  WDL_MutexLockExclusive lock { &m_mutex };
   m_pan = pan;
 }
 
@@ -310,9 +373,8 @@ void PitchShiftSource::setPlayRate(const double playRate)
   if(playRate < 0.01 || playRate > 100 || playRate == m_rate)
     return;
 
-  WDL_MutexLockExclusive lock { &m_mutex };
   m_rate = playRate;
-  updateTempoShift();
+  publishTempoShift();
 }
 
 void PitchShiftSource::setPitch(const double pitch)
@@ -320,21 +382,17 @@ void PitchShiftSource::setPitch(const double pitch)
   if(pitch == m_pitch)
     return;
 
-  WDL_MutexLockExclusive lock { &m_mutex };
   m_pitch = pitch;
-  updateTempoShift();
+  publishTempoShift();
 }
 
 void PitchShiftSource::setPreservePitch(const bool preservePitch)
 {
-  if(preservePitch == !!(m_flags & PreservePitch))
+  if(preservePitch == m_preservePitch)
     return;
 
-  WDL_MutexLockExclusive lock { &m_mutex };
-  m_flags &= ~PreservePitch;
-  if(preservePitch)
-    m_flags |= PreservePitch;
-  updateTempoShift();
+  m_preservePitch = preservePitch;
+  publishTempoShift();
 }
 
 void PitchShiftSource::setMode(const int mode)
@@ -342,56 +400,48 @@ void PitchShiftSource::setMode(const int mode)
   if(mode == m_mode)
     return;
 
-  WDL_MutexLockExclusive lock { &m_mutex };
   m_mode = mode;
-  updateTempoShift();
+  publishTempoShift();
 }
 
 void PitchShiftSource::setFadeInLen(const double len)
 {
-  if(len == m_fadeInLen)
-    return;
-
-  WDL_MutexLockExclusive lock { &m_mutex };
   m_fadeInLen = len;
 }
 
 void PitchShiftSource::setFadeOutLen(const double len)
 {
-  if(len == m_fadeOutLen)
-    return;
-
-  WDL_MutexLockExclusive lock { &m_mutex };
   m_fadeOutLen = len;
 }
 
 bool PitchShiftSource::startFadeOut()
 {
-  if(!m_fadeOutLen)
+  const double fadeOutLen { m_fadeOutLen };
+  if(!fadeOutLen)
     return false;
 
-  WDL_MutexLockExclusive lock { &m_mutex };
-  m_fadeOutEnd = m_writeTime + m_fadeOutLen;
+  m_fadeOutEnd = m_writeTime.load(std::memory_order_relaxed) + fadeOutLen;
   return true;
 }
 
 bool PitchShiftSource_MIDI::requestStop()
 {
-  WDL_MutexLockExclusive lock { &m_mutex };
-  if(m_flags & StopServiced) {
-    m_flags &= ~StopServiced;
+  if(m_flags.fetch_and(~StopServiced, std::memory_order_acq_rel) & StopServiced)
     return true;
-  }
-  m_flags |= StopRequest;
+  m_flags.fetch_or(StopRequest, std::memory_order_acq_rel);
   return false;
 }
 
 void PitchShiftSource::seekOrLoop(const bool isSeek, const bool looping)
 {
-  WDL_MutexLockExclusive lock { &m_mutex };
-  m_flags &= ~(Looping | WrappedAround);
+  int set { 0 };
   if(isSeek)
-    m_flags |= ManualSeek;
+    set |= ManualSeek;
   if(looping)
-    m_flags |= Looping;
+    set |= Looping;
+
+  // in one step: the audio thread must not see a seek with neither Looping nor ManualSeek set
+  int flags { m_flags.load(std::memory_order_relaxed) };
+  while(!m_flags.compare_exchange_weak(flags, (flags & ~(Looping | WrappedAround)) | set,
+      std::memory_order_acq_rel)) {}
 }
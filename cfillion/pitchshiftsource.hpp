@@ -27,8 +27,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <vector>
-#include <WDL/mutex.h>
 
 class PitchShiftSource : public PCM_source {
 public:
@@ -55,6 +56,9 @@ public:
   void   PeaksBuild_Finish() override {}
 
   // only safe to call from the main thread
+  // nothing here locks: the audio thread picks up new parameters at the start
+  // of its next block (volume and pan are ramped over that block) and
+  // publishes its position, flags and peaks after each block
   bool   isPastEnd(double position);
   double getVolume() { return m_volume; }
   void   setVolume(double v);
@@ -64,7 +68,7 @@ public:
   void   setPlayRate(double);
   double getPitch() { return m_pitch; }
   void   setPitch(double);
-  bool   getPreservePitch() { return m_flags & PreservePitch; }
+  bool   getPreservePitch() { return m_preservePitch; }
   void   setPreservePitch(bool);
   int    getMode() { return m_mode; }
   void   setMode(int);
@@ -74,21 +78,21 @@ public:
   void   setFadeOutLen(double);
   bool   startFadeOut();
   bool   readPeak(size_t, double *);
+  // end of the last block written (ahead of the audible position by the preview buffer)
+  double getPosition() const { return m_position.load(std::memory_order_relaxed); }
+  void   setPosition(double pos) { m_position.store(pos, std::memory_order_relaxed); }
   virtual bool requestStop() { return true; }
   void seekOrLoop(bool isSeek, bool looping);
 
 protected:
   struct Block {
     PCM_source_transfer_t *tx;
-    double sampleTime, fadeOutStart;
+    double sampleTime, fadeInLen, fadeOutLen, fadeOutStart;
+    double volume, pan; // targets, ramped to from m_rampVolume/m_rampPan
+    int flags;
     bool isSeek;
   };
-  struct Peak {
-    bool read;
-    double max;
-  };
   enum Flags {
-    PreservePitch = 1<<0,
     AllNotesOff   = 1<<1,
     StopRequest   = 1<<2,
     StopServiced  = 1<<3,
@@ -97,22 +101,46 @@ protected:
     Looping       = 1<<6,
   };
 
-  // must lock m_mutex before using these
+  // audio thread only (sourceLength is also called from the main thread)
   virtual double sourceLength() const = 0;
   virtual void writeSamples(const Block &) = 0;
   virtual void writePeaks(const PCM_source_transfer_t *) = 0;
   virtual void updateTempoShift() = 0;
-  double computeGain(const Block &, double time, int samplesUntilNextCall);
-
-  double m_pitch, m_rate, m_volume, m_pan, m_fadeInLen, m_fadeOutLen;
-  int m_flags, m_mode;
+  double computeFade(const Block &, double time, int samplesUntilNextCall);
+  void publishTempoShift() { m_tempoShiftSerial.fetch_add(1, std::memory_order_release); }
+  void applyTempoShift();
+  void allocPeaks(size_t chans);
+  void publishPeaks();
+
+  // written by the main thread, read by the audio thread
+  std::atomic<double> m_pitch, m_rate, m_volume, m_pan, m_fadeInLen, m_fadeOutLen;
+  std::atomic<int> m_mode;
+  std::atomic<bool> m_preservePitch;
+  std::atomic<unsigned int> m_tempoShiftSerial;
+  std::atomic<double> m_fadeOutEnd;
+
+  // audio thread copies of the above (constructors aside)
+  // m_curRate is atomic for sourceLength(), only the audio thread writes it
+  double m_curPitch;
+  std::atomic<double> m_curRate;
+  int m_curMode;
+  bool m_curPreservePitch;
+  unsigned int m_curTempoShiftSerial;
+  double m_rampVolume, m_rampPan;
+  bool m_rampStarted;
+
+  // shared by both threads, updated with atomic bit operations
+  std::atomic<int> m_flags;
 
-  WDL_SharedMutex m_mutex;
   PCM_source *m_src;
-  double m_playTime;  // for fade-ins, position-independent
-  double m_writeTime; // for seek detection and fade-outs
-  double m_fadeOutEnd;
-  std::vector<Peak> m_peaks;
+  double m_playTime;                // for fade-ins, position-independent
+  std::atomic<double> m_writeTime;  // for seek detection and fade-outs
+  std::atomic<double> m_position;   // published after each block, see getPosition()
+
+  // peaks since the last read, a negative (or -0.0) peak has been read
+  std::unique_ptr<std::atomic<double>[]> m_peaks;
+  size_t m_peakChans;
+  std::vector<double> m_blockPeaks; // audio thread
 };
 
 class PitchShiftSource_Audio final : public PitchShiftSource {
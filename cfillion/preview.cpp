@@ -116,8 +116,16 @@ bool CF_Preview::isDangling()
     break;
   }
 
+  // the audible position: the one published by the source is ahead by the
+  // preview buffer, stopping on it would cut the end of the preview
+  double position;
+  {
+    LockPreviewMutex lock { m_reg };
+    position = m_reg.curpos;
+  }
+
   // checking state to not miss destroying previews after fade-outs
-  if((!m_reg.loop || m_state != Playing) && m_src->isPastEnd(getPosition()))
+  if((!m_reg.loop || m_state != Playing) && m_src->isPastEnd(position))
     return true;
   else if(!m_reg.project)
     return false;
@@ -136,6 +144,8 @@ bool CF_Preview::play(const bool obeyMeasureAlign)
   constexpr int flags { Buffered | Varispeed };
   const double measureAlign { obeyMeasureAlign ? m_measureAlign : 0.0 };
 
+  m_src->setPosition(m_reg.curpos); // not playing: safe to read unlocked
+
   if(m_reg.project ? !!PlayTrackPreview2Ex(m_reg.project, &m_reg, flags, measureAlign)
                    : !!PlayPreviewEx(&m_reg, flags, measureAlign)) {
     m_state = Playing;
@@ -200,6 +210,10 @@ CF_Preview::PreviewInst &CF_Preview::writableInst()
 
 double CF_Preview::getPosition()
 {
+  // published by the source after each block, no need to contend with the audio thread
+  if(m_state != Idle)
+    return m_src->getPosition();
+
   LockPreviewMutex lock { m_reg };
   return m_reg.curpos;
 }
@@ -208,6 +222,7 @@ void CF_Preview::setPosition(const double newpos)
 {
   LockPreviewMutex lock { m_reg };
   m_src->seekOrLoop(m_reg.curpos != newpos, m_reg.loop);
+  m_src->setPosition(newpos);
   m_reg.curpos = newpos;
 }
 
@@ -69,6 +69,7 @@
 #include <numeric>
 #include <ctime>
 #include <limits>
+#include <atomic>
 
 #include <reaper_plugin.h>
 #include "reaper/sws_rpf_wrapper.h"
@@ -75,6 +75,85 @@ static WDL_IntKeyedArray<COMMAND_T*> g_commands; // no valdispose (cmds can be a
 static int g_iFirstCommand;
 static int g_iLastCommand;
 
+// Startup profiling, the report is printed in the console once REAPER is running
+// when [SWS] StartupProfile=1 in reaper.ini
+typedef struct STARTUP_STEP
+{
+	const char* name;
+	double dTime; // seconds
+	bool deferred;
+} STARTUP_STEP;
+
+typedef struct DEFERRED_INIT
+{
+	const char* name;
+	void (*init)();
+} DEFERRED_INIT;
+
+static WDL_TypedBuf<STARTUP_STEP> g_startupSteps;
+static WDL_TypedBuf<DEFERRED_INIT> g_deferredInits;
+static double g_dStepStart = 0.0;
+static bool g_bLazyInit = false;
+
+static bool EndStartupStep(const char* name, bool ok, bool deferred = false)
+{
+	STARTUP_STEP step = { name, time_precise() - g_dStepStart, deferred };
+	g_startupSteps.Add(step);
+	g_dStepStart = time_precise();
+	return ok;
+}
+#define TIMED_INIT(x) (g_dStepStart = time_precise(), EndStartupStep(#x, !!(x)))
+
+static void PrintStartupProfile()
+{
+	if (!GetPrivateProfileInt(SWS_INI, "StartupProfile", 0, get_ini_file()))
+		return;
+
+	double dTotal = 0.0, dDeferred = 0.0;
+	WDL_FastString str;
+	for (int i = 0; i < g_startupSteps.GetSize(); i++)
+	{
+		const STARTUP_STEP* step = g_startupSteps.Get() + i;
+		str.AppendFormatted(256, "  %8.2f ms  %s%s\n", step->dTime * 1000.0, step->name, step->deferred ? " (deferred)" : "");
+		if (step->deferred)
+			dDeferred += step->dTime;
+		else
+			dTotal += step->dTime;
+	}
+	WDL_FastString header;
+	header.SetFormatted(256, "SWS startup: %.2f ms (lazy init %s, %.2f ms deferred)\n", dTotal * 1000.0, g_bLazyInit ? "on" : "off", dDeferred * 1000.0);
+	str.Insert(header.Get(), 0);
+	ShowConsoleMsg(str.Get());
+}
+
+void SWSDeferInit(const char* name, void (*init)())
+{
+	if (!g_bLazyInit || g_bInitDone)
+	{
+		init();
+		return;
+	}
+	DEFERRED_INIT d = { name, init };
+	g_deferredInits.Add(d);
+}
+
+void SWSRunDeferredInits()
+{
+	static bool s_running = false; // an init step could run an action
+	if (s_running || !g_deferredInits.GetSize())
+		return;
+
+	s_running = true;
+	for (int i = 0; i < g_deferredInits.GetSize(); i++)
+	{
+		g_dStepStart = time_precise();
+		g_deferredInits.Get()[i].init();
+		EndStartupStep(g_deferredInits.Get()[i].name, true, true);
+	}
+	g_deferredInits.Resize(0);
+	s_running = false;
+}
+
 bool hookCommandProc(int iCmd, int flag)
 {
 	static WDL_PtrList<const char> sReentrantCmds;
@@ -97,6 +176,8 @@ bool hookCommandProc(int iCmd, int flag)
 	// Ignore commands that don't have anything to do with us from this point forward
 	if (COMMAND_T* cmd = SWSGetCommandByID(iCmd))
 	{
+		SWSRunDeferredInits();
+
 		// For continuous actions
 		if (BR_SwsActionHook(cmd, flag, NULL))
 			return true;
@@ -140,6 +221,8 @@ bool hookCommandProc2(KbdSectionInfo* sec, int cmdId, int val, int valhw, int re
 	// Ignore commands that don't have anything to do with us from this point forward
 	if (COMMAND_T* cmd = SWSGetCommandByID(cmdId))
 	{
+		SWSRunDeferredInits();
+
 		// Main section actions can be run from the alt sections transparently.
 		// Previously cycle actions could be added in the alt-recording section
 		// so checking the original secId is needed for backward compatibility.
@@ -479,6 +562,10 @@ static void importExtensionAPI()
 {
 	plugin_register("-timer", (void*)importExtensionAPI);
 
+	// REAPER is running
+	SWSRunDeferredInits();
+	PrintStartupProfile();
+
 	// import functions exposed by third-party extensions
 	osara_isShortcutHelpEnabled = (decltype(osara_isShortcutHelpEnabled))plugin_getapi("osara_isShortcutHelpEnabled");
 
@@ -541,6 +628,7 @@ public:
 		m_bAutoColorTrackAsync = true;
 		AutoColorMarkerRegion(false);
 		SNM_CSurfSetTrackListChange();
+		ConsoleTrackListChange();
 		m_iACIgnore = GetNumTracks() + 1;
 	}
 	// For every SetTrackListChange we get NumTracks+1 SetTrackTitle calls, but we only
@@ -549,6 +637,7 @@ public:
 	void SetTrackTitle(MediaTrack *tr, const char *c)
 	{
 		ScheduleTracklistUpdate();
+		ConsoleTrackListChange();
 		if (!m_iACIgnore)
 		{
 			m_bAutoColorTrackAsync = true;
@@ -904,6 +993,7 @@ error:
 		IMPAPI(GetSetAutomationItemInfo);
 		IMPAPI(GetSetEnvelopeState);
 		IMPAPI(GetSetMediaItemInfo);
+		IMPAPI(GetSetMediaItemInfo_String);
 		IMPAPI(GetSetMediaItemTakeInfo);
 		IMPAPI(GetSetMediaItemTakeInfo_String);
 		IMPAPI(GetMediaSourceLength); // v5.0pre3+
@@ -994,10 +1084,12 @@ error:
 		IMPAPI(MIDI_EnumSelTextSysexEvts);
 		IMPAPI(MIDI_eventlist_Create);
 		IMPAPI(MIDI_eventlist_Destroy);
+		IMPAPI(MIDI_GetAllEvts);
 		IMPAPI(MIDI_GetCC);
 		IMPAP_OPT(MIDI_GetCCShape); // v6.0
 		IMPAPI(MIDI_GetEvt);
 		IMPAPI(MIDI_GetGrid)
+		IMPAPI(MIDI_GetHash);
 		IMPAPI(MIDI_GetNote);
 		IMPAPI(MIDI_GetPPQPos_EndOfMeasure);
 		IMPAPI(MIDI_GetPPQPos_StartOfMeasure);
@@ -1119,6 +1211,8 @@ error:
 		IMPAPI(StopTrackPreview);
 		IMPAPI(StopTrackPreview2);
 		IMPAPI(stringToGuid);
+		IMPAPI(TakeFX_CopyToTake); // v5.95+
+		IMPAPI(TakeFX_Delete);     // v5.95+
 		IMPAPI(TakeFX_GetChainVisible);
 		IMPAPI(TakeFX_GetCount);
 		IMPAPI(TakeFX_GetFloatingWindow);
@@ -1159,6 +1253,7 @@ error:
 		IMPAPI(TrackFX_GetParamName);
 		IMPAPI(TrackFX_GetPreset);
 		IMPAPI(TrackFX_GetPresetIndex);
+		IMPAPI(TrackFX_GetRecCount);
 		IMPAPI(TrackFX_GetUserPresetFilename); // v5.15pre1+
 		IMPAPI(TrackFX_NavigatePresets);
 		IMPAPI(TrackFX_GetOffline); // v5.95+
@@ -1269,51 +1364,52 @@ error:
 			ERR_RETURN("Toggle action hook error.")
 
 		// Call plugin specific init
-		if (!AutoColorInit())
+		g_bLazyInit = GetPrivateProfileInt(SWS_INI, "LazyInit", 0, get_ini_file()) ? true : false;
+		if (!TIMED_INIT(AutoColorInit()))
 			ERR_RETURN("Auto Color init error.")
-		if (!ColorInit())
+		if (!TIMED_INIT(ColorInit()))
 			ERR_RETURN("Color init error.")
-		if (!MarkerListInit())
+		if (!TIMED_INIT(MarkerListInit()))
 			ERR_RETURN("Marker list init error.")
-		if (!MarkerActionsInit())
+		if (!TIMED_INIT(MarkerActionsInit()))
 			ERR_RETURN("Marker action init error.")
-		if (!ConsoleInit())
+		if (!TIMED_INIT(ConsoleInit()))
 			ERR_RETURN("ReaConsole init error.")
-		if (!FreezeInit())
+		if (!TIMED_INIT(FreezeInit()))
 			ERR_RETURN("Freeze init error.")
-		if (!SnapshotsInit()) // must be called before SNM_Init registers dynamic actions
+		if (!TIMED_INIT(SnapshotsInit())) // must be called before SNM_Init registers dynamic actions
 			ERR_RETURN("Snapshots init error.")
-		if (!TrackListInit())
+		if (!TIMED_INIT(TrackListInit()))
 			ERR_RETURN("Tracklist init error.")
-		if (!ProjectListInit())
+		if (!TIMED_INIT(ProjectListInit()))
 			ERR_RETURN("Project List init error.")
-		if (!ProjectMgrInit())
+		if (!TIMED_INIT(ProjectMgrInit()))
 			ERR_RETURN("Project Mgr init error.")
-		if (!XenakiosInit())
+		if (!TIMED_INIT(XenakiosInit()))
 			ERR_RETURN("Xenakios init error.")
-		if (!MiscInit())
+		if (!TIMED_INIT(MiscInit()))
 			ERR_RETURN("Misc init error.")
-		if (!ZoomInit(false))
+		if (!TIMED_INIT(ZoomInit(false)))
 			ERR_RETURN("Zoom init error.")
-		if(!FNGExtensionInit())
+		if (!TIMED_INIT(FNGExtensionInit()))
 			ERR_RETURN("Fingers init error.")
-		if (!PadreInit())
+		if (!TIMED_INIT(PadreInit()))
 			ERR_RETURN("Padre init error.")
-		if (!AboutBoxInit())
+		if (!TIMED_INIT(AboutBoxInit()))
 			ERR_RETURN("About box init error.")
-		if (!AutorenderInit())
+		if (!TIMED_INIT(AutorenderInit()))
 			ERR_RETURN("Autorender init error.")
-		if (!IXInit())
+		if (!TIMED_INIT(IXInit()))
 			ERR_RETURN("IX init error.")
-		if (!BR_Init())
+		if (!TIMED_INIT(BR_Init()))
 			ERR_RETURN("Breeder init error.")
-		if (!WOL_Init())
+		if (!TIMED_INIT(WOL_Init()))
 			ERR_RETURN("Wol init error.")
-		if (!nofish_Init())
+		if (!TIMED_INIT(nofish_Init()))
 			ERR_RETURN("nofish init error.")
-		if (!snooks_Init())
+		if (!TIMED_INIT(snooks_Init()))
 			ERR_RETURN("snooks init error.")
-		if (!SNM_Init(rec)) // keep it as the last init (for cycle actions)
+		if (!TIMED_INIT(SNM_Init(rec))) // keep it as the last init (for cycle actions)
 			ERR_RETURN("S&M init error.")
 
 		// above specific inits went well
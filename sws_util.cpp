@@ -726,6 +726,131 @@ void AdjustTakesStartOffset(MediaItem *item, const double adjustment)
 	UpdateItemInProject(item);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// SWSProjExtState
+///////////////////////////////////////////////////////////////////////////////
+
+// Passes lines through to REAPER's context and keeps a copy of them
+class SWS_RecordingStateContext : public ProjectStateContext
+{
+public:
+	SWS_RecordingStateContext(ProjectStateContext* ctx, WDL_TypedBuf<char>* lines) : m_ctx(ctx), m_lines(lines) { m_lines->Resize(0, false); }
+	void AddLine(const char* fmt, ...)
+	{
+		va_list args;
+		va_start(args, fmt);
+		m_line.SetAppendFormattedArgs(false, 65536, fmt, args);
+		va_end(args);
+
+		m_ctx->AddLine("%s", m_line.Get());
+		const int size = m_lines->GetSize();
+		if (char* p = m_lines->ResizeOK(size + m_line.GetLength() + 1, false))
+			memcpy(p + size, m_line.Get(), m_line.GetLength() + 1);
+	}
+	int GetLine(char* buf, int buflen) { return m_ctx->GetLine(buf, buflen); }
+	WDL_INT64 GetOutputSize()          { return m_ctx->GetOutputSize(); }
+	int GetTempFlag()                  { return m_ctx->GetTempFlag(); }
+	void SetTempFlag(int flag)         { m_ctx->SetTempFlag(flag); }
+
+private:
+	ProjectStateContext* m_ctx;
+	WDL_TypedBuf<char>* m_lines;
+	WDL_FastString m_line;
+};
+
+// Function-local: states are globals of other modules, constructed in any order
+static WDL_PtrList<SWSProjExtState>& ProjExtStates()
+{
+	static WDL_PtrList<SWSProjExtState> s_states;
+	return s_states;
+}
+
+SWSProjExtState::SWSProjExtState(const char* name, bool undoRelevant)
+: m_name(name), m_undoRelevant(undoRelevant),
+  m_serializeCount(0), m_cacheHitCount(0), m_undoSkipCount(0), m_serializeTime(0.0), m_writeTime(0.0)
+{
+	ProjExtStates().Add(this);
+}
+
+SWSProjExtState::~SWSProjExtState()
+{
+	ProjExtStates().Delete(ProjExtStates().Find(this));
+}
+
+void SWSProjExtState::Save(ProjectStateContext* ctx, bool isUndo, void (*serialize)(ProjectStateContext*))
+{
+	if (isUndo && !m_undoRelevant)
+	{
+		m_undoSkipCount++;
+		return;
+	}
+
+	const double t0 = time_precise();
+	Blob* blob = m_blobs.Get();
+	if (!m_undoRelevant) // only saved to file, no copy needed
+	{
+		serialize(ctx);
+		m_serializeCount++;
+		m_serializeTime += time_precise() - t0;
+	}
+	else if (blob->dirty || !isUndo) // always serialize for real saves
+	{
+		SWS_RecordingStateContext recorder(ctx, &blob->lines);
+		serialize(&recorder);
+		blob->dirty = false;
+		m_serializeCount++;
+		m_serializeTime += time_precise() - t0;
+	}
+	else
+	{
+		const char* p = blob->lines.Get();
+		const char* end = p + blob->lines.GetSize();
+		while (p < end)
+		{
+			ctx->AddLine("%s", p); // "%s" needed, see http://github.com/reaper-oss/sws/issues/358
+			p += strlen(p) + 1;
+		}
+		m_cacheHitCount++;
+		m_writeTime += time_precise() - t0;
+	}
+
+	// Printed in the console on project saves when [SWS] ProjStateProfile=1 in reaper.ini
+	if (!isUndo && GetPrivateProfileInt(SWS_INI, "ProjStateProfile", 0, get_ini_file()))
+	{
+		WDL_FastString str("SWS project state, ");
+		AppendStats(&str);
+		ShowConsoleMsg(str.Get());
+	}
+}
+
+bool SWSProjExtState::BeginLoad(bool isUndo)
+{
+	if (isUndo && !m_undoRelevant)
+		return false;
+
+	// State is about to be replaced: drop the copy, and the ones of closed projects
+	m_blobs.Cleanup();
+	SetDirty();
+	return true;
+}
+
+void SWSProjExtState::SetDirty(ReaProject* proj)
+{
+	m_blobs.Get(proj ? proj : GetCurrentProjectInLoadSave())->dirty = true;
+}
+
+void SWSProjExtState::AppendStats(WDL_FastString* str) const
+{
+	str->AppendFormatted(256, "%s: %d serialized (%.3f ms), %d cached (%.3f ms), %d undo skipped\n",
+		m_name, m_serializeCount, m_serializeTime * 1000.0, m_cacheHitCount, m_writeTime * 1000.0, m_undoSkipCount);
+}
+
+void SWSProjExtState::GetStats(WDL_FastString* str)
+{
+	for (int i = 0; i < ProjExtStates().GetSize(); i++)
+		ProjExtStates().Get(i)->AppendStats(str);
+}
+
 const char* SWS_GetSourceFileName(PCM_source* src)
 {
 	if (src && !src->GetFileName())
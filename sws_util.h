@@ -100,11 +100,12 @@ typedef struct COMMAND_T
 template<class PTRTYPE> class SWSProjConfig
 {
 protected:
-	WDL_PtrList<void> m_projects;
-	WDL_PtrList<PTRTYPE> m_data;
+	WDL_PtrKeyedArray<PTRTYPE*> m_data; // keyed by ReaProject*
+	ReaProject* m_lastProj;             // last hit: nearly all calls are for the same project
+	PTRTYPE* m_lastData;
 
 public:
-	SWSProjConfig() {}
+	SWSProjConfig() : m_lastProj(NULL), m_lastData(NULL) {}
 	virtual ~SWSProjConfig() { Empty(); }
 	PTRTYPE* Get()
 	{
@@ -114,39 +115,105 @@ public:
 	{
 		if (!pProj)
 			pProj = EnumProjects(-1, NULL, 0); // this is necessary
-		int i = m_projects.Find(pProj);
-		if (i >= 0)
-			return m_data.Get(i);
-		m_projects.Add(pProj);
-		return m_data.Add(new PTRTYPE);
+		if (pProj == m_lastProj && m_lastData)
+			return m_lastData;
+
+		PTRTYPE* data = m_data.Get((INT_PTR)pProj);
+		if (!data)
+		{
+			data = new PTRTYPE;
+			m_data.Insert((INT_PTR)pProj, data);
+		}
+		m_lastProj = pProj;
+		m_lastData = data;
+		return data;
 	}
 	int GetNumProj() { return m_data.GetSize(); }
 	void Empty()
 	{
-		m_projects.Empty();
-		m_data.Empty(true);
+		for (int i = 0; i < m_data.GetSize(); i++)
+			delete m_data.Enumerate(i);
+		m_data.DeleteAll();
+		m_lastProj = NULL;
+		m_lastData = NULL;
+	}
+	// Drops the data of a project (i.e. when it gets closed)
+	void Remove(ReaProject* pProj)
+	{
+		if (PTRTYPE* data = m_data.Get((INT_PTR)pProj))
+		{
+			if (pProj == m_lastProj)
+			{
+				m_lastProj = NULL;
+				m_lastData = NULL;
+			}
+			m_data.Delete((INT_PTR)pProj);
+			delete data;
+		}
 	}
+	// Drops the data of closed projects
 	void Cleanup()
 	{
-		if (m_projects.GetSize())
+		if (m_data.GetSize())
 		{
-			for (int i = m_projects.GetSize() - 1; i >= 0; i--)
+			WDL_PtrList<ReaProject> openProjects;
+			int j = 0;
+			while (ReaProject* pProj = EnumProjects(j++, NULL, 0))
+				openProjects.Add(pProj);
+
+			for (int i = m_data.GetSize() - 1; i >= 0; i--)
 			{
-				int j = 0;
-				ReaProject* pProj;
-				while ((pProj = EnumProjects(j++, NULL, 0)))
-					if (m_projects.Get(i) == pProj)
-						break;
-				if (!pProj)
-				{
-					m_projects.Delete(i);
-					m_data.Delete(i, true);
-				}
+				INT_PTR pProj = 0;
+				m_data.Enumerate(i, &pProj);
+				if (openProjects.Find((ReaProject*)pProj) < 0)
+					Remove((ReaProject*)pProj);
 			}
 		}
 	}
 };
 
+// Memoized project extension state (see project_config_extension_t)
+// SaveExtensionConfig goes through Save(): the serializer only runs when the
+// project's state was marked dirty (and always when saving to file), else the
+// lines written by the last save are written again as-is. Modules whose state
+// is not undo-relevant are not serialized in undo states at all.
+class SWSProjExtState
+{
+public:
+	SWSProjExtState(const char* name, bool undoRelevant = true);
+	~SWSProjExtState();
+
+	void Save(ProjectStateContext* ctx, bool isUndo, void (*serialize)(ProjectStateContext*));
+	// Call from BeginLoadProjectState, returns false if the load should be ignored
+	bool BeginLoad(bool isUndo);
+	void SetDirty(ReaProject* proj = NULL); // NULL: project in load/save, or current project
+
+	// Timing counters
+	const char* GetName() const   { return m_name; }
+	int GetSerializeCount() const { return m_serializeCount; }
+	int GetCacheHitCount() const  { return m_cacheHitCount; }
+	int GetUndoSkipCount() const  { return m_undoSkipCount; }
+	double GetSerializeTime() const { return m_serializeTime; } // seconds
+	double GetWriteTime() const     { return m_writeTime; }     // seconds, cached writes
+	void AppendStats(WDL_FastString* str) const;
+	static void GetStats(WDL_FastString* str); // all modules
+
+private:
+	struct Blob
+	{
+		WDL_TypedBuf<char> lines; // null-terminated lines, back to back
+		bool dirty;
+		Blob() : dirty(true) {}
+	};
+
+	const char* m_name;
+	bool m_undoRelevant;
+	SWSProjConfig<Blob> m_blobs;
+
+	int m_serializeCount, m_cacheHitCount, m_undoSkipCount;
+	double m_serializeTime, m_writeTime;
+};
+
 extern REAPER_PLUGIN_HINSTANCE g_hInst;
 extern HWND g_hwndParent;
 extern double g_d0;
@@ -220,6 +287,13 @@ int IsSwsAction(const char* _actionName);
 
 HMENU SWSCreateMenuFromCommandTable(COMMAND_T pCommands[], HMENU hMenu = NULL, int* iIndex = NULL);;
 
+// Startup, sws_extension.cpp
+// Runs init() now, or when [SWS] LazyInit=1 in reaper.ini, once REAPER is running or before
+// the first SWS action, whichever comes first. For init steps only needed by actions/windows
+// of a module: actions themselves must still be registered from the module's init function
+void SWSDeferInit(const char* name, void (*init)());
+void SWSRunDeferredInits();
+
 // Utility functions, sws_util.cpp
 void SaveWindowPos(HWND hwnd, const char* cKey);
 void RestoreWindowPos(HWND hwnd, const char* cKey, bool bRestoreSize = true);